@@ -1,6 +1,5 @@
 // AudioConfigPanel.hpp — Pre-render Audio config window (ImGui)
 #pragma once
-#ifdef _WIN32
 
 #include "imgui.h"
 #include "bass_backend.hpp"
@@ -14,6 +13,8 @@
 
 #include <filesystem>
 #include <cstdlib>
+#include <functional>
+#include <vector>
 
 inline std::string GetConfigPath(const std::string& filename) {
 #ifdef _WIN32
@@ -25,6 +26,15 @@ inline std::string GetConfigPath(const std::string& filename) {
         std::filesystem::create_directories(dir, ec);
         return dir + "\\" + filename;
     }
+#else
+    const char* xdg  = std::getenv("XDG_CONFIG_HOME");
+    const char* home = std::getenv("HOME");
+    if ((xdg && *xdg) || home) {
+        std::string dir = (xdg && *xdg) ? std::string(xdg) + "/jidi-player" : std::string(home) + "/.config/jidi-player";
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        return dir + "/" + filename;
+    }
 #endif
     return filename; // Fallback to working directory
 }
@@ -41,7 +51,14 @@ static char   s_SfPathBuf[512]       = "";
 static int    s_SampleRate           = 48000;
 static int    s_LatencyMs            = 10;
 static bool   s_NeedRestartPlayback  = false;
-static float  s_LowVelScaleMaxSec   = 0.5f;  
+static int    s_RtShards             = 1;
+static int    s_RtShardKey           = 0;
+static int    s_RtSynth              = 0;
+static int    s_PreRenderSynth       = 0;
+
+// Soundfonts listed in JIDIC.json, waiting to be loaded (deferred at startup)
+struct PendingSoundFont { std::string path; bool enabled; };
+static std::vector<PendingSoundFont> s_PendingSoundFonts;
 
 inline void ToggleAudioConfigPanel() { s_AudioPanelOpen = !s_AudioPanelOpen; }
 inline bool IsAudioConfigPanelOpen() { return s_AudioPanelOpen; }
@@ -80,6 +97,13 @@ inline std::string ExtractJsonString(const std::string& line) {
     return "";
 }
 
+// "Sound Effects" is on while the event filter strips none of CC / pitch bend /
+// program / pressure (the Event Filter panel can strip them one by one).
+inline bool SfxFromFilter() {
+    const EventFilterConfig fc = g_EventFilter.GetConfig();
+    return !(fc.stripCC || fc.stripPitchBend || fc.stripProgram || fc.stripPressure);
+}
+
 inline void SaveAudioConfig() {
     std::string path = GetConfigPath("JIDIC.json");
     std::ofstream out(path);
@@ -91,13 +115,16 @@ inline void SaveAudioConfig() {
         out << "  \"AudioMode\": " << (int)cur.mode << ",\n";
         out << "  \"Voices\": " << cur.voices << ",\n";
         out << "  \"VelIgnore\": " << (int)cur.velocityIgnore << ",\n";
-        out << "  \"SfxEnabled\": " << (cur.sfxEnabled ? 1 : 0) << ",\n";
+        out << "  \"SfxEnabled\": " << (SfxFromFilter() ? 1 : 0) << ",\n";
         out << "  \"Volume\": " << g_BassEngine.GetVolume() << ",\n";
         out << "  \"PreRenderBufSec\": " << cur.preRenderBufferSec << ",\n";
         out << "  \"SampleRate\": " << cur.sampleRate << ",\n";
         out << "  \"LatencyMs\": " << cur.latencyMs << ",\n";
-        out << "  \"LowVelScaleMaxSec\": " << cur.lowVelScaleMaxSec << ",\n";
         out << "  \"LowBufferMinVoices\": " << cur.lowBufferMinVoices << ",\n";
+        out << "  \"RtShards\": " << cur.rtShards << ",\n";
+        out << "  \"RtShardKey\": " << (int)cur.rtShardKey << ",\n";
+        out << "  \"RtSynth\": " << (int)cur.rtSynth << ",\n";
+        out << "  \"PreRenderSynth\": " << (int)cur.preRenderSynth << ",\n";
         
         // --- 2. Background and Particle Settings ---
         out << "  \"BgColorR\": " << g_bgColorF[0] << ",\n";
@@ -129,6 +156,8 @@ inline void SaveAudioConfig() {
         out << "  \"LagSimEnabled\": " << (lagEnabled ? 1 : 0) << ",\n";
         out << "  \"LagSimEps\": " << s_lagSimEps << ",\n";
         out << "  \"LagSmoothRender\": " << (g_AudioEngine.GetLagSmoothRender() ? 1 : 0) << ",\n";
+        out << "  \"BurstSpreadUs\": " << g_AudioEngine.GetBurstSpreadMicros() << ",\n";
+        out << "  \"BurstSpreadMinEvents\": " << g_AudioEngine.GetBurstSpreadMinEvents() << ",\n";
         
         // --- 5. Loop Settings ---
         out << "  \"LoopEnabled\": " << (isLoop ? 1 : 0) << ",\n";
@@ -144,6 +173,7 @@ inline void SaveAudioConfig() {
         out << "  \"ScrollSpeed\": " << ScrollSpeed << ",\n";
         out << "  \"MidiSpeed\": " << MidiSpeed << ",\n";
         out << "  \"ViewerType\": " << (int)g_viewerType << ",\n";
+        out << "  \"TimeDomainScroll\": " << (g_timeDomainScroll ? 1 : 0) << ",\n";
         
         // --- 7. Soundfonts ---
         const auto& fonts = g_BassEngine.GetSoundFonts();
@@ -168,7 +198,6 @@ inline void PreInitAudioConfig() {
         while (std::getline(in, line)) {
             if (line.find("\"SampleRate\"") != std::string::npos) cfg.sampleRate = ExtractJsonInt(line);
             else if (line.find("\"LatencyMs\"") != std::string::npos) cfg.latencyMs = ExtractJsonInt(line);
-            else if (line.find("\"LowVelScaleMaxSec\"") != std::string::npos) cfg.lowVelScaleMaxSec = ExtractJsonFloat(line);
             else if (line.find("\"LowBufferMinVoices\"") != std::string::npos) cfg.lowBufferMinVoices = ExtractJsonInt(line);
         }
         g_BassEngine.ApplyConfig(cfg);
@@ -177,14 +206,32 @@ inline void PreInitAudioConfig() {
     }
 }
 
-// Completes full runtime config loading
-inline void LoadAudioConfig() {
+// Loads (and clears) the soundfonts collected by LoadAudioConfig, in file order
+inline void LoadPendingSoundFonts(const std::function<void(size_t done, size_t total)>& progress = {}) {
+    std::vector<PendingSoundFont> pending;
+    pending.swap(s_PendingSoundFonts);
+    for (size_t i = 0; i < pending.size(); ++i) {
+        if (progress) progress(i, pending.size());
+        if (g_BassEngine.AddSoundFont(pending[i].path)) {
+            size_t idx = g_BassEngine.GetSoundFonts().size() - 1;
+            g_BassEngine.SetSoundFontEnabled(idx, pending[i].enabled);
+        }
+    }
+    if (progress) progress(pending.size(), pending.size());
+}
+
+// Completes full runtime config loading. With deferHeavy the soundfonts stay in
+// s_PendingSoundFonts and the background texture is left to the caller — the
+// startup path loads both on background tasks.
+inline void LoadAudioConfig(bool deferHeavy = false) {
 	std::string path = GetConfigPath("JIDIC.json");
     std::ifstream in(path);
     if (in.is_open()) {
         BassConfig cfg = g_BassEngine.GetConfig();
         std::string line;
         bool lagSimEnabled = false;
+        int burstUs  = 0;
+        int burstMin = (int)BurstSpreader::kDefaultMinEvents;
         bool vsync = true;
         bool fullscreen = false;
 
@@ -196,10 +243,10 @@ inline void LoadAudioConfig() {
             else if (line.find("\"SfxEnabled\"") != std::string::npos) cfg.sfxEnabled = ExtractJsonInt(line) != 0;
             else if (line.find("\"Volume\"") != std::string::npos) g_BassEngine.SetVolume(ExtractJsonFloat(line));
             else if (line.find("\"PreRenderBufSec\"") != std::string::npos) cfg.preRenderBufferSec = ExtractJsonFloat(line);
-            else if (line.find("\"LowVelScaleMaxSec\"") != std::string::npos) {
-                cfg.lowVelScaleMaxSec = ExtractJsonFloat(line);
-                s_LowVelScaleMaxSec = cfg.lowVelScaleMaxSec;
-            }
+            else if (line.find("\"RtShards\"") != std::string::npos) cfg.rtShards = std::clamp(ExtractJsonInt(line), 1, ShardedSynth::kMaxShards);
+            else if (line.find("\"RtShardKey\"") != std::string::npos) cfg.rtShardKey = (ShardKey)(ExtractJsonInt(line) != 0);
+            else if (line.find("\"RtSynth\"") != std::string::npos) cfg.rtSynth = (RtSynth)(ExtractJsonInt(line) != 0);
+            else if (line.find("\"PreRenderSynth\"") != std::string::npos) cfg.preRenderSynth = (RtSynth)(ExtractJsonInt(line) != 0);
             
             // Background Color Components
             else if (line.find("\"BgColorR\"") != std::string::npos) g_bgColorF[0] = ExtractJsonFloat(line);
@@ -234,6 +281,8 @@ inline void LoadAudioConfig() {
             else if (line.find("\"LagSimEnabled\"") != std::string::npos) lagSimEnabled = ExtractJsonInt(line) != 0;
             else if (line.find("\"LagSimEps\"") != std::string::npos) s_lagSimEps = ExtractJsonInt(line);
             else if (line.find("\"LagSmoothRender\"") != std::string::npos) g_AudioEngine.SetLagSmoothRender(ExtractJsonInt(line) != 0);
+            else if (line.find("\"BurstSpreadUs\"") != std::string::npos) burstUs = ExtractJsonInt(line);
+            else if (line.find("\"BurstSpreadMinEvents\"") != std::string::npos) burstMin = ExtractJsonInt(line);
             
             // Loop Mode
             else if (line.find("\"LoopEnabled\"") != std::string::npos) {
@@ -254,7 +303,8 @@ inline void LoadAudioConfig() {
                 MidiSpeed = ExtractJsonFloat(line);
                 g_AudioEngine.SetSpeed(MidiSpeed);
             }
-            else if (line.find("\"ViewerType\"") != std::string::npos) g_viewerType = (ViewerType)ExtractJsonInt(line);
+            else if (line.find("\"ViewerType\"") != std::string::npos) g_viewerType = (ViewerType)std::clamp(ExtractJsonInt(line), 0, (int)ViewerType::FallingNotes);
+            else if (line.find("\"TimeDomainScroll\"") != std::string::npos) g_timeDomainScroll = ExtractJsonInt(line) != 0;
             
             // Soundfont Lines
             else if (line.find("\"path\"") != std::string::npos) {
@@ -264,10 +314,7 @@ inline void LoadAudioConfig() {
                     if (secondQuote != std::string::npos) {
                         std::string path = line.substr(firstQuote + 1, secondQuote - firstQuote - 1);
                         bool enabled = (line.find("\"enabled\": 1") != std::string::npos);
-                        if (g_BassEngine.AddSoundFont(path)) {
-                            size_t idx = g_BassEngine.GetSoundFonts().size() - 1;
-                            g_BassEngine.SetSoundFontEnabled(idx, enabled);
-                        }
+                        s_PendingSoundFonts.push_back({ path, enabled });
                     }
                 }
             }
@@ -281,6 +328,10 @@ inline void LoadAudioConfig() {
         s_SfxEnabled = cfg.sfxEnabled;
         s_PreRenderBufSec = cfg.preRenderBufferSec;
         s_Volume = g_BassEngine.GetVolume();
+        s_RtShards   = cfg.rtShards;
+        s_RtShardKey = (int)cfg.rtShardKey;
+        s_RtSynth    = (int)cfg.rtSynth;
+        s_PreRenderSynth = (int)cfg.preRenderSynth;
         
         // Synchronize and recompute absolute RGB Colors from floating coordinates
         g_backgroundColor = {
@@ -302,8 +353,10 @@ inline void LoadAudioConfig() {
             (unsigned char)(g_bgImageTintF[3] * 255.0f)
         };
         
+        if (!deferHeavy) LoadPendingSoundFonts();
+
         // Load the background texture if set
-        if (g_bgImageShow && strlen(g_bgImagePath) > 0) {
+        if (!deferHeavy && g_bgImageShow && strlen(g_bgImagePath) > 0) {
             if (g_bgImageTex.id != 0) UnloadTexture(g_bgImageTex);
             g_bgImageTex = LoadTexture(g_bgImagePath);
             if (g_bgImageTex.id != 0) {
@@ -313,6 +366,8 @@ inline void LoadAudioConfig() {
         
         // Apply Lag Simulation status to the Engine
         g_AudioEngine.SetSimulateEventsPerSecond(lagSimEnabled ? s_lagSimEps : 0);
+        g_AudioEngine.SetBurstSpread((uint32_t)std::clamp(burstUs, 0, (int)BurstSpreader::kMaxWindowMicros),
+                                     (uint32_t)std::clamp(burstMin, 1, 1 << 20));
         
         // Apply VSync state
         if (vsync) SetWindowState(FLAG_VSYNC_HINT);
@@ -431,34 +486,57 @@ inline void DrawAudioConfigPanel()
             g_BassEngine.SetVelocityIgnore((uint8_t)s_VelIgnore);
         }
 
+        // Shortcut for the Event Filter's strip rules, which own the state
+        s_SfxEnabled = SfxFromFilter();
         if (ImGui::Checkbox("Sound Effects (Soundfont)", &s_SfxEnabled)) g_BassEngine.SetSfxEnabled(s_SfxEnabled);
 
         ImGui::SetNextItemWidth(160.f);
         if (ImGui::SliderFloat("Volume##vol", &s_Volume, 0.f, 1.f, "%.2f")) g_BassEngine.SetVolume(s_Volume);
 
-        ImGui::Spacing();
-        ImGui::Separator();
-        ImGui::TextDisabled("Low-Buffer Velocity Scaling (Pre-Render mode)");
-        ImGui::SetNextItemWidth(160.f);
-        if (ImGui::SliderFloat("Low-vel scale window (s)##lvs", &s_LowVelScaleMaxSec, 0.0f, 2.0f, "%.2f s")) {
-            BassConfig cfg2 = g_BassEngine.GetConfig();
-            cfg2.lowVelScaleMaxSec = s_LowVelScaleMaxSec;
-            g_BassEngine.ApplyConfig(cfg2);
-        }
-        ImGui::SameLine();
-        if (ImGui::Button("Off##lvsoff")) {
-            s_LowVelScaleMaxSec = 0.0f;
-            BassConfig cfg2 = g_BassEngine.GetConfig();
-            cfg2.lowVelScaleMaxSec = 0.0f;
-            g_BassEngine.ApplyConfig(cfg2);
-        }
-        ImGui::TextDisabled("0.5s = silence when buf<0.5s; 0 = disabled; 0.01 = 10ms threshold");
-
         ImGui::Unindent(8.f);
     }
 
     ImGui::Spacing();
 
+    if (cur.mode == AudioMode::BassMIDI_RT) {
+        ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.12f, 0.22f, 0.32f, 1.f));
+        ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.18f, 0.32f, 0.46f, 1.f));
+        ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.22f, 0.40f, 0.58f, 1.f));
+        bool shardOpen = ImGui::CollapsingHeader("Real-Time Sharding");
+        ImGui::PopStyleColor(3);
+
+        if (shardOpen) {
+            ImGui::Indent(8.f);
+            ImGui::Spacing();
+
+            static const char* kKeyLabels[]   = { "By channel", "By track" };
+            static const char* kSynthLabels[] = { "BassMIDI (soundfonts)", "Built-in synth" };
+            bool changed = false;
+            ImGui::SetNextItemWidth(160.f);
+            changed |= ImGui::SliderInt("Synth instances##rtsh", &s_RtShards, 1, ShardedSynth::kMaxShards);
+            ImGui::SetNextItemWidth(160.f);
+            changed |= ImGui::Combo("Routing##rtkey", &s_RtShardKey, kKeyLabels, 2);
+            ImGui::SetNextItemWidth(160.f);
+            changed |= ImGui::Combo("Synth##rtsyn", &s_RtSynth, kSynthLabels, 2);
+            if (changed) {
+                g_BassEngine.SetRtSharding(s_RtShards, (ShardKey)s_RtShardKey, (RtSynth)s_RtSynth);
+            }
+            ImGui::TextDisabled("1 instance + BassMIDI = original single stream");
+
+            auto stats = g_BassEngine.GetShardStats();
+            if (!stats.empty()) {
+                ImGui::Spacing();
+                for (size_t i = 0; i < stats.size(); ++i) {
+                    const auto& st = stats[i];
+                    ImGui::Text("#%zu  keys %3d  voices %5d  render %7.1f us  events %llu",
+                                i, st.routeKeys, st.voices, st.renderUs, (unsigned long long)st.events);
+                }
+            }
+            ImGui::Unindent(8.f);
+        }
+        ImGui::Spacing();
+    }
+
     bool isPR = (cur.mode == AudioMode::BassMIDI_PreRender);
     if (isPR) {
         ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.22f, 0.12f, 0.32f, 1.f));
@@ -475,6 +553,12 @@ inline void DrawAudioConfigPanel()
             if (ImGui::SliderFloat("Buffer Size (sec)##prbuf", &s_PreRenderBufSec, 1.0f, 1800.0f, "%.1f")) {
                 g_BassEngine.SetPreRenderBufferSec(s_PreRenderBufSec);
             }
+            static const char* kPrSynthLabels[] = { "BassMIDI (soundfonts)", "Built-in synth" };
+            ImGui::SetNextItemWidth(200.f);
+            if (ImGui::Combo("Synth##prsyn", &s_PreRenderSynth, kPrSynthLabels, 2)) {
+                g_BassEngine.SetPreRenderSynth((RtSynth)s_PreRenderSynth);
+            }
+            ImGui::TextDisabled("Built-in seeks from state snapshots (constant seek latency)");
             ImGui::Spacing();
 
             auto prStatus = g_BassEngine.GetPreRenderStatus();
@@ -612,5 +696,3 @@ inline void DrawAudioConfigPanel()
 
     ImGui::End();
 }
-
-#endif // _WIN32
\ No newline at end of file
@@ -0,0 +1,60 @@
+// =============================================================
+// CapturePanel.hpp
+// =============================================================
+#pragma once
+#include "imgui.h"
+#include "frame_capture.hpp"
+
+// Screenshot / burst controls for g_FrameCapture. F2 and Shift+F2 in the main
+// loop do the same with the settings chosen here.
+static int           s_CaptureBurstEvery  = 2;
+static CaptureFormat s_CaptureBurstFormat = CaptureFormat::QOI;
+static CaptureFormat s_CaptureShotFormat  = CaptureFormat::PNG;
+
+inline void DrawCapturePanel()
+{
+    ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.28f, 0.14f, 0.26f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.38f, 0.20f, 0.36f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.48f, 0.26f, 0.46f, 1.00f));
+    bool open = ImGui::CollapsingHeader("Capture");
+    ImGui::PopStyleColor(3);
+    if (!open) return;
+
+    ImGui::Indent(8.0f);
+    ImGui::Spacing();
+
+    static const char* kFormats[] = { "PNG", "QOI (fast)" };
+
+    // ── Screenshot ────────────────────────────────────────────
+    int shotFmt = (int)s_CaptureShotFormat;
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::Combo("Screenshot format##cpsf", &shotFmt, kFormats, 2)) s_CaptureShotFormat = (CaptureFormat)shotFmt;
+    ImGui::SameLine();
+    if (ImGui::Button("Take (F2)")) g_FrameCapture.RequestScreenshot(s_CaptureShotFormat);
+
+    // ── Burst ─────────────────────────────────────────────────
+    ImGui::BeginDisabled(g_FrameCapture.IsBursting());
+    ImGui::SetNextItemWidth(120.0f);
+    ImGui::SliderInt("Every Nth frame##cpbn", &s_CaptureBurstEvery, 1, 60);
+    int burstFmt = (int)s_CaptureBurstFormat;
+    ImGui::SetNextItemWidth(120.0f);
+    if (ImGui::Combo("Burst format##cpbf", &burstFmt, kFormats, 2)) s_CaptureBurstFormat = (CaptureFormat)burstFmt;
+    ImGui::EndDisabled();
+
+    if (!g_FrameCapture.IsBursting()) {
+        if (ImGui::Button("Start burst (Shift+F2)")) g_FrameCapture.StartBurst(s_CaptureBurstEvery, s_CaptureBurstFormat);
+    } else {
+        if (ImGui::Button("Stop burst (Shift+F2)")) g_FrameCapture.StopBurst();
+        ImGui::SameLine();
+        ImGui::TextDisabled("%s", g_FrameCapture.BurstFolder().c_str());
+    }
+
+    // ── Stats ─────────────────────────────────────────────────
+    const FrameCapture::Stats s = g_FrameCapture.GetStats();
+    ImGui::TextDisabled("Readback: %s", s.usingPbo ? "PBO ring" : "direct");
+    ImGui::TextDisabled("Written %llu / queued %llu  (pending %zu, failed %llu, stalls %llu)",
+        (unsigned long long)s.written, (unsigned long long)s.queued, s.pending,
+        (unsigned long long)s.failed, (unsigned long long)s.stalls);
+
+    ImGui::Unindent(8.0f);
+}
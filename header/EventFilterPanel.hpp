@@ -0,0 +1,86 @@
+// =============================================================
+// EventFilterPanel.hpp
+// =============================================================
+#pragma once
+#include "imgui.h"
+#include "event_filter.hpp"
+#include "track_masks.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+
+// Edits g_EventFilter. The main loop notices the generation bump and rebinds
+// playback / pre-render to the recompiled stream, so nothing is applied here.
+// Velocity ignore stays in the Audio Config panel and syncs from there; its
+// Sound Effects checkbox is a shortcut that sets or clears all four strip rules.
+inline void DrawEventFilterPanel()
+{
+    ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.12f, 0.26f, 0.30f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.16f, 0.36f, 0.42f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.20f, 0.46f, 0.54f, 1.00f));
+    bool open = ImGui::CollapsingHeader("Event Filter");
+    ImGui::PopStyleColor(3);
+    if (!open) return;
+
+    ImGui::Indent(8.0f);
+    ImGui::Spacing();
+
+    EventFilterConfig cfg = g_EventFilter.GetConfig();
+
+    // ── Key range ─────────────────────────────────────────────
+    int lo = cfg.keyLow, hi = cfg.keyHigh;
+    ImGui::SetNextItemWidth(140.0f);
+    if (ImGui::SliderInt("Lowest key##efkl", &lo, 0, 127))  cfg.keyLow  = (uint8_t)std::min(lo, (int)cfg.keyHigh);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(140.0f);
+    if (ImGui::SliderInt("Highest key##efkh", &hi, 0, 127)) cfg.keyHigh = (uint8_t)std::max(hi, (int)cfg.keyLow);
+
+    // ── Short notes ───────────────────────────────────────────
+    int minTicks = (int)cfg.minNoteTicks;
+    ImGui::SetNextItemWidth(140.0f);
+    if (ImGui::DragInt("Min note length (ticks)##efmn", &minTicks, 1.0f, 0, 65535))
+        cfg.minNoteTicks = (uint32_t)std::clamp(minTicks, 0, 65535);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Notes shorter than this are removed together with their note-off.\n0 = keep everything.");
+
+    // ── Channel-state stripping ───────────────────────────────
+    ImGui::Checkbox("Strip CC##efcc", &cfg.stripCC);
+    ImGui::SameLine();
+    ImGui::Checkbox("Strip pitch bend##efpb", &cfg.stripPitchBend);
+    ImGui::SameLine();
+    ImGui::Checkbox("Strip program##efpc", &cfg.stripProgram);
+    ImGui::SameLine();
+    ImGui::Checkbox("Strip pressure##efcp", &cfg.stripPressure);
+
+    // ── Channel mutes ─────────────────────────────────────────
+    // The track list's mutes (TrackMasks), applied live by the dispatcher
+    ImGui::TextDisabled("Channel mute");
+    for (int ch = 0; ch < 16; ++ch) {
+        bool muted = g_TrackMasks.ChannelMuted((uint8_t)ch);
+        char label[8];
+        snprintf(label, sizeof(label), "%d", ch + 1);
+        ImGui::PushID(ch);
+        if (ImGui::Checkbox(label, &muted))
+            g_TrackMasks.SetChannelMuted((uint8_t)ch, muted);
+        ImGui::PopID();
+        if (ch % 8 != 7) ImGui::SameLine();
+    }
+
+    if (ImGui::SmallButton("Reset filter")) {
+        // Keep the rule owned by the Audio Config panel
+        EventFilterConfig def;
+        def.velocityIgnore = cfg.velocityIgnore;
+        cfg = def;
+    }
+
+    g_EventFilter.SetConfig(cfg);   // no-op unless something changed
+
+    // ── Result of the last compile ────────────────────────────
+    auto fs = g_EventFilter.Get();
+    ImGui::TextDisabled("%zu events  |  %zu notes / %zu other dropped  |  %.1f ms",
+                        fs->Events().size(), fs->droppedNotes, fs->droppedOther, fs->compileMs);
+    if (cfg.velocityIgnore)
+        ImGui::TextDisabled("Velocity ignore %d (set in Audio Config)", (int)cfg.velocityIgnore);
+
+    ImGui::Unindent(8.0f);
+}
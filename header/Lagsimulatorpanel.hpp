@@ -4,6 +4,8 @@
 #pragma once
 #include "imgui.h"
 #include "midioutput.hpp"
+#include "emulated_sink.hpp"
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
@@ -193,4 +195,120 @@ inline void DrawLagSimulatorPanel(MidiOutputEngine& engine)
     ImGui::PopStyleColor();
 
     ImGui::Unindent(8.0f);
-}
\ No newline at end of file
+}
+
+// ---------------------------------------------------------------
+// Emulated Sink - replaces the MIDI device with a modelled synth
+// (queue depth, per-event / per-voice cost, overflow policy) so
+// back-pressure can be reproduced without audio hardware.
+// ---------------------------------------------------------------
+inline void DrawEmulatedSinkPanel()
+{
+    ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.22f, 0.12f, 0.32f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.32f, 0.18f, 0.46f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.42f, 0.22f, 0.58f, 1.00f));
+    bool open = ImGui::CollapsingHeader("Emulated Sink");
+    ImGui::PopStyleColor(3);
+    if (!open) return;
+
+    ImGui::Indent(8.0f);
+    ImGui::Spacing();
+
+    bool enabled = g_EmulatedSink.IsEnabled();
+    if (ImGui::Checkbox("Send MIDI to emulated sink", &enabled))
+        g_EmulatedSink.SetEnabled(enabled);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Replaces KDMAPI / BassMIDI output with a modelled synth.\n"
+                          "Its queue fills and blocks playback like a real overloaded device.");
+
+    SinkModelConfig cfg = g_EmulatedSink.GetConfig();
+    static const char* kOverflowLabels[] = { "Block sender", "Drop newest", "Drop note-ons" };
+    int queueDepth = (int)cfg.queueDepth;
+    int maxVoices  = (int)cfg.maxVoices;
+    int overflow   = (int)cfg.overflow;
+    float eventNs  = (float)cfg.eventCostNs;
+    float voiceNs  = (float)cfg.voiceCostNs;
+    bool changed = false;
+    ImGui::PushItemWidth(160.0f);
+    changed |= ImGui::InputInt("Queue depth", &queueDepth, 256, 4096);
+    changed |= ImGui::InputFloat("Cost / event (ns)", &eventNs, 50.0f, 1000.0f, "%.0f");
+    changed |= ImGui::InputFloat("Cost / voice (ns)", &voiceNs, 0.5f, 10.0f, "%.1f");
+    changed |= ImGui::InputInt("Max voices", &maxVoices, 256, 4096);
+    changed |= ImGui::Combo("When full", &overflow, kOverflowLabels, 3);
+    ImGui::PopItemWidth();
+    if (changed) {
+        cfg.queueDepth  = (uint32_t)std::clamp(queueDepth, 1, 1 << 24);
+        cfg.eventCostNs = std::clamp(eventNs, 0.0f, 1.0e7f);
+        cfg.voiceCostNs = std::clamp(voiceNs, 0.0f, 1.0e6f);
+        cfg.maxVoices   = (uint32_t)std::clamp(maxVoices, 1, 1 << 20);
+        cfg.overflow    = (SinkOverflow)overflow;
+        g_EmulatedSink.Configure(cfg);
+    }
+
+    if (enabled) {
+        const SinkStats st = g_EmulatedSink.GetStats();
+        ImGui::Spacing();
+        ImGui::Text("Events %llu   dropped %llu   blocked %llu (%.1f ms)",
+                    (unsigned long long)st.accepted, (unsigned long long)st.dropped,
+                    (unsigned long long)st.blocked, st.blockedNs / 1e6);
+        ImGui::Text("Latency p50 %.2f ms  p99 %.2f ms  max %.2f ms",
+                    st.p50LatencyNs / 1e6, st.p99LatencyNs / 1e6, st.maxLatencyNs / 1e6);
+        ImGui::Text("Voices %u (peak %u)   peak queue %llu",
+                    st.voices, st.peakVoices, (unsigned long long)st.maxQueue);
+        if (g_EmulatedSink.IsBlocking()) {
+            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.3f, 0.2f, 1.0f));
+            ImGui::TextWrapped("SINK FULL - sender blocked");
+            ImGui::PopStyleColor();
+        }
+        if (ImGui::SmallButton("Reset stats")) g_EmulatedSink.ResetStats();
+    }
+
+    ImGui::Unindent(8.0f);
+}
+
+// ---------------------------------------------------------------
+// Burst Spread - paces same-tick chord walls across a short
+// window so the synth's input queue is not hit all at once.
+// Watch "peak queue" in the Emulated Sink panel to compare.
+// ---------------------------------------------------------------
+inline void DrawBurstSpreadPanel(MidiOutputEngine& engine)
+{
+    ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.22f, 0.12f, 0.32f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.32f, 0.18f, 0.46f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.42f, 0.22f, 0.58f, 1.00f));
+    bool open = ImGui::CollapsingHeader("Burst Spread");
+    ImGui::PopStyleColor(3);
+    if (!open) return;
+
+    ImGui::Indent(8.0f);
+    ImGui::Spacing();
+
+    static int s_lastWindowUs = 250;   // restored when re-enabled
+    int  windowUs = (int)engine.GetBurstSpreadMicros();
+    int  minEvents = (int)engine.GetBurstSpreadMinEvents();
+    bool enabled  = windowUs > 0;
+    if (enabled) s_lastWindowUs = windowUs;
+
+    if (ImGui::Checkbox("Spread same-tick bursts", &enabled))
+        engine.SetBurstSpread(enabled ? (uint32_t)s_lastWindowUs : 0, (uint32_t)minEvents);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Sends a dense chord over a short window instead of all at once.\n"
+                          "Note-offs still go first and every key keeps its order.");
+
+    if (enabled) {
+        bool changed = false;
+        ImGui::PushItemWidth(160.0f);
+        changed |= ImGui::SliderInt("Window (us)", &windowUs, 10, (int)BurstSpreader::kMaxWindowMicros);
+        changed |= ImGui::InputInt("Min events", &minEvents, 16, 256);
+        ImGui::PopItemWidth();
+        if (changed) {
+            windowUs = std::clamp(windowUs, 10, (int)BurstSpreader::kMaxWindowMicros);
+            minEvents = std::clamp(minEvents, 1, 1 << 20);
+            engine.SetBurstSpread((uint32_t)windowUs, (uint32_t)minEvents);
+        }
+    } else {
+        ImGui::TextDisabled("(disabled - bursts go out back to back)");
+    }
+
+    ImGui::Unindent(8.0f);
+}
@@ -0,0 +1,211 @@
+// =============================================================
+// LibraryPanel.hpp
+// =============================================================
+#pragma once
+#include "imgui.h"
+#include "midi_library.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Folder browser over g_MidiLibrary. Sorting and the name filter work on a row
+// → entry index list that is rebuilt only when the library changes (at most
+// every kLibraryViewMs while a scan is streaming in) or the sort / filter
+// does; the table itself is virtual-scrolled with ImGuiListClipper, so 50k
+// files draw as cheaply as 50.
+static constexpr int kLibraryViewMs = 250;
+static bool          s_LibraryOpen  = false;
+
+inline std::string LibrarySizeText(uint64_t bytes) {
+    char buf[32];
+    if (bytes >= (1ull << 30)) snprintf(buf, sizeof(buf), "%.2f GB", bytes / 1073741824.0);
+    else if (bytes >= (1ull << 20)) snprintf(buf, sizeof(buf), "%.1f MB", bytes / 1048576.0);
+    else snprintf(buf, sizeof(buf), "%.1f KB", bytes / 1024.0);
+    return buf;
+}
+
+// Returns true when a file was chosen to play (double-click or Enter); its
+// path is written to `chosen` and the scan is cancelled so it does not compete
+// with the load for the disk. `startFolder` seeds the folder box when the
+// cache remembers no folder.
+inline bool DrawLibraryPanel(std::string& chosen, const std::string& startFolder)
+{
+    static bool s_wasOpen = false;
+    if (!s_LibraryOpen) { s_wasOpen = false; return false; }
+
+    static char s_folder[1024] = "";
+    static char s_filter[128]  = "";
+    static bool s_recursive    = true;
+    if (!s_wasOpen) {
+        // Just opened: rescan to pick up changes on disk — unchanged files come from the cache
+        s_wasOpen = true;
+        if (!s_folder[0]) {
+            std::string f = g_MidiLibrary.Folder();
+            if (f.empty()) f = startFolder;
+            snprintf(s_folder, sizeof(s_folder), "%s", f.c_str());
+        }
+        if (s_folder[0] && !g_MidiLibrary.Scanning()) g_MidiLibrary.Scan(s_folder, s_recursive);
+    }
+
+    bool picked = false;
+    ImGui::SetNextWindowSize(ImVec2(880.0f, 520.0f), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("MIDI Library##LB", &s_LibraryOpen, ImGuiWindowFlags_NoCollapse)) {
+        ImGui::End();
+        return false;
+    }
+
+    // ── Folder / scan ─────────────────────────────────────────
+    ImGui::SetNextItemWidth(-260.0f);
+    const bool enter = ImGui::InputText("##lbfolder", s_folder, sizeof(s_folder), ImGuiInputTextFlags_EnterReturnsTrue);
+    ImGui::SameLine();
+    ImGui::Checkbox("Subfolders", &s_recursive);
+    ImGui::SameLine();
+    if (g_MidiLibrary.Scanning()) {
+        if (ImGui::Button("Cancel")) g_MidiLibrary.Cancel();
+    } else if ((ImGui::Button("Scan") || enter) && s_folder[0]) {
+        g_MidiLibrary.Scan(s_folder, s_recursive);
+    }
+    static int s_selected = -1;   // entry index; entries restart with every scan
+    if (g_MidiLibrary.Found() == 0) s_selected = -1;
+    ImGui::SetNextItemWidth(240.0f);
+    const bool filterChanged = ImGui::InputText("Filter##lbfilter", s_filter, sizeof(s_filter));
+    ImGui::SameLine();
+    if (g_MidiLibrary.Scanning())
+        ImGui::TextDisabled("Scanning: %zu found, %zu probed", g_MidiLibrary.Found(), g_MidiLibrary.Probed());
+    else
+        ImGui::TextDisabled("%zu files", g_MidiLibrary.Found());
+
+    // ── View: row → entry index ───────────────────────────────
+    static std::vector<uint32_t> s_rows;
+    static uint64_t s_rowsRev = 0;
+    static int      s_sortCol = 0;
+    static bool     s_sortAsc = true;
+    static auto     s_rowsAt  = std::chrono::steady_clock::time_point{};
+
+    enum { ColName, ColTracks, ColPpq, ColSize, ColNotes, ColLength };
+    const ImGuiTableFlags flags = ImGuiTableFlags_Sortable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_RowBg |
+                                  ImGuiTableFlags_Resizable | ImGuiTableFlags_BordersOuter | ImGuiTableFlags_BordersV;
+    if (ImGui::BeginTable("##lbtable", 6, flags, ImVec2(0.0f, 0.0f))) {
+        ImGui::TableSetupScrollFreeze(0, 1);
+        ImGui::TableSetupColumn("Name",   ImGuiTableColumnFlags_WidthStretch | ImGuiTableColumnFlags_DefaultSort, 0.0f, ColName);
+        ImGui::TableSetupColumn("Tracks", ImGuiTableColumnFlags_WidthFixed, 60.0f,  ColTracks);
+        ImGui::TableSetupColumn("PPQ",    ImGuiTableColumnFlags_WidthFixed, 50.0f,  ColPpq);
+        ImGui::TableSetupColumn("Size",   ImGuiTableColumnFlags_WidthFixed, 80.0f,  ColSize);
+        ImGui::TableSetupColumn("Notes",  ImGuiTableColumnFlags_WidthFixed, 110.0f, ColNotes);
+        ImGui::TableSetupColumn("Length", ImGuiTableColumnFlags_WidthFixed, 70.0f,  ColLength);
+        ImGui::TableHeadersRow();
+
+        bool sortChanged = false;
+        if (ImGuiTableSortSpecs* specs = ImGui::TableGetSortSpecs(); specs && specs->SpecsDirty) {
+            if (specs->SpecsCount > 0) {
+                s_sortCol = (int)specs->Specs[0].ColumnUserID;
+                s_sortAsc = specs->Specs[0].SortDirection == ImGuiSortDirection_Ascending;
+            }
+            specs->SpecsDirty = false;
+            sortChanged = true;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const bool stale = g_MidiLibrary.Revision() != s_rowsRev &&
+            (!g_MidiLibrary.Scanning() || now - s_rowsAt >= std::chrono::milliseconds(kLibraryViewMs));
+        if (stale || sortChanged || filterChanged) {
+            s_rowsRev = g_MidiLibrary.Revision();
+            s_rowsAt  = now;
+            std::string needle = s_filter;
+            std::transform(needle.begin(), needle.end(), needle.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+            g_MidiLibrary.Read([&](const std::deque<LibraryEntry>& es) {
+                s_rows.clear();
+                s_rows.reserve(es.size());
+                std::string lower;
+                for (size_t i = 0; i < es.size(); ++i) {
+                    if (!needle.empty()) {
+                        lower = es[i].name;
+                        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+                        if (lower.find(needle) == std::string::npos) continue;
+                    }
+                    s_rows.push_back((uint32_t)i);
+                }
+                auto key = [&](const LibraryEntry& e) -> double {
+                    switch (s_sortCol) {
+                        case ColTracks: return e.tracks;
+                        case ColPpq:    return e.ppq;
+                        case ColSize:   return (double)e.bytes;
+                        case ColNotes:  return (double)e.notes;
+                        case ColLength: return e.seconds;
+                        default:        return 0.0;
+                    }
+                };
+                std::stable_sort(s_rows.begin(), s_rows.end(), [&](uint32_t a, uint32_t b) {
+                    const LibraryEntry& ea = es[a];
+                    const LibraryEntry& eb = es[b];
+                    if (s_sortCol == ColName) return s_sortAsc ? ea.name < eb.name : eb.name < ea.name;
+                    return s_sortAsc ? key(ea) < key(eb) : key(eb) < key(ea);
+                });
+            });
+        }
+
+        // ── Virtual-scrolled rows ─────────────────────────────
+        g_MidiLibrary.Read([&](const std::deque<LibraryEntry>& es) {
+            ImGuiListClipper clipper;
+            clipper.Begin((int)s_rows.size());
+            while (clipper.Step()) {
+                for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+                    const uint32_t idx = s_rows[(size_t)r];
+                    if (idx >= es.size()) continue;   // view predates a rescan
+                    const LibraryEntry& e = es[idx];
+                    ImGui::TableNextRow();
+                    ImGui::TableSetColumnIndex(ColName);
+                    ImGui::PushID((int)idx);
+                    if (ImGui::Selectable(e.name.c_str(), s_selected == (int)idx,
+                                          ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowDoubleClick)) {
+                        s_selected = (int)idx;
+                        if (ImGui::IsMouseDoubleClicked(0) && e.state != LibraryEntry::State::Invalid) { chosen = e.path; picked = true; }
+                    }
+                    if (ImGui::IsItemHovered()) ImGui::SetTooltip("%s", e.path.c_str());
+                    ImGui::PopID();
+
+                    ImGui::TableSetColumnIndex(ColSize);
+                    ImGui::TextUnformatted(LibrarySizeText(e.bytes).c_str());
+                    if (e.state == LibraryEntry::State::Pending) {
+                        ImGui::TableSetColumnIndex(ColNotes);
+                        ImGui::TextDisabled("probing...");
+                        continue;
+                    }
+                    if (e.state == LibraryEntry::State::Invalid) {
+                        ImGui::TableSetColumnIndex(ColNotes);
+                        ImGui::TextDisabled("not a MIDI file");
+                        continue;
+                    }
+                    ImGui::TableSetColumnIndex(ColTracks);
+                    ImGui::Text("%u", (unsigned)e.tracks);
+                    ImGui::TableSetColumnIndex(ColPpq);
+                    if (e.ppq) ImGui::Text("%u", (unsigned)e.ppq); else ImGui::TextDisabled("SMPTE");
+                    ImGui::TableSetColumnIndex(ColNotes);
+                    ImGui::Text("%s%llu", e.estimated ? "~" : "", (unsigned long long)e.notes);
+                    ImGui::TableSetColumnIndex(ColLength);
+                    const int sec = (int)(e.seconds + 0.5);
+                    ImGui::Text("%s%d:%02d", e.estimated ? "~" : "", sec / 60, sec % 60);
+                }
+            }
+            clipper.End();
+
+            if (s_selected >= 0 && (size_t)s_selected < es.size() && ImGui::IsWindowFocused(ImGuiFocusedFlags_ChildWindows) &&
+                !ImGui::IsAnyItemActive() && ImGui::IsKeyPressed(ImGuiKey_Enter) && es[(size_t)s_selected].state != LibraryEntry::State::Invalid) {
+                chosen = es[(size_t)s_selected].path;
+                picked = true;
+            }
+        });
+        ImGui::EndTable();
+    }
+    ImGui::End();
+    if (picked) {
+        s_LibraryOpen = false;
+        g_MidiLibrary.Cancel();
+    }
+    return picked;
+}
@@ -0,0 +1,106 @@
+// =============================================================
+// TrackListPanel.hpp
+// =============================================================
+#pragma once
+#include "imgui.h"
+#include "raylib.h"
+#include "track_masks.hpp"
+#include "visualizer.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Show / mute / solo per track plus channel masks. The list is virtual-
+// scrolled with ImGuiListClipper, so only the visible rows are submitted —
+// a 65k-track file costs the same per frame as a 16-track one.
+inline void DrawTrackListPanel(const std::vector<OptimizedTrackData>& tracks,
+                               Color (*trackColor)(int track, int channel))
+{
+    ImGui::PushStyleColor(ImGuiCol_Header,        ImVec4(0.30f, 0.22f, 0.10f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderHovered, ImVec4(0.42f, 0.30f, 0.14f, 1.00f));
+    ImGui::PushStyleColor(ImGuiCol_HeaderActive,  ImVec4(0.54f, 0.38f, 0.18f, 1.00f));
+    bool open = ImGui::CollapsingHeader("Tracks");
+    ImGui::PopStyleColor(3);
+    if (!open) return;
+
+    ImGui::Indent(8.0f);
+    ImGui::Spacing();
+
+    static bool s_hideEmpty = true;
+
+    // ── Channel masks ─────────────────────────────────────────
+    ImGui::TextDisabled("Channels  (top: show, bottom: mute)");
+    for (int row = 0; row < 2; ++row) {
+        for (int ch = 0; ch < 16; ++ch) {
+            char label[8];
+            snprintf(label, sizeof(label), "%d", ch + 1);
+            ImGui::PushID(row * 16 + ch);
+            if (row == 0) {
+                bool shown = g_TrackMasks.ChannelVisible((uint8_t)ch);
+                if (ImGui::Checkbox(label, &shown)) g_TrackMasks.SetChannelVisible((uint8_t)ch, shown);
+            } else {
+                bool muted = g_TrackMasks.ChannelMuted((uint8_t)ch);
+                if (ImGui::Checkbox(label, &muted)) g_TrackMasks.SetChannelMuted((uint8_t)ch, muted);
+            }
+            ImGui::PopID();
+            if (ch != 15) ImGui::SameLine();
+        }
+    }
+
+    // ── Bulk actions ──────────────────────────────────────────
+    if (ImGui::SmallButton("Show all")) g_TrackMasks.ShowAllTracks();
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Unmute all")) g_TrackMasks.UnmuteAllTracks();
+    ImGui::SameLine();
+    ImGui::Checkbox("Hide empty tracks", &s_hideEmpty);
+
+    // Row index → track index. Rebuilt only when a new file is loaded
+    // (masks reset) or the empty-track filter is toggled.
+    static uint64_t              s_rowsEpoch     = UINT64_MAX;
+    static bool                  s_rowsHideEmpty = true;
+    static std::vector<uint32_t> s_rows;
+    if (s_rowsEpoch != g_TrackMasks.ResetEpoch() || s_rowsHideEmpty != s_hideEmpty) {
+        s_rowsEpoch = g_TrackMasks.ResetEpoch(); s_rowsHideEmpty = s_hideEmpty;
+        s_rows.clear();
+        size_t n = std::min(tracks.size(), TrackMasks::kMaxTracks);
+        for (size_t t = 0; t < n; ++t)
+            if (!s_hideEmpty || !tracks[t].notes.empty()) s_rows.push_back((uint32_t)t);
+    }
+
+    ImGui::TextDisabled("%zu tracks listed", s_rows.size());
+
+    // ── Virtual-scrolled track list ───────────────────────────
+    const float rowH = ImGui::GetFrameHeightWithSpacing();
+    ImGui::BeginChild("##tracklist", ImVec2(0.0f, rowH * 12.0f), true);   // bordered
+    ImGuiListClipper clipper;
+    clipper.Begin((int)s_rows.size(), rowH);
+    while (clipper.Step()) {
+        for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; ++r) {
+            const uint32_t t = s_rows[r];
+            const auto&    notes = tracks[t].notes;
+            const int      ch0   = notes.empty() ? 0 : notes.front().channel;
+            const Color    c     = trackColor((int)t, ch0);
+
+            ImGui::PushID((int)t);
+            ImGui::ColorButton("##col", ImVec4(c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, 1.0f),
+                               ImGuiColorEditFlags_NoTooltip, ImVec2(rowH - 4.0f, rowH - 4.0f));
+            ImGui::SameLine();
+            ImGui::Text("%5u  %10zu notes", t, notes.size());
+            ImGui::SameLine();
+
+            bool shown = g_TrackMasks.TrackVisible(t);
+            if (ImGui::Checkbox("Show", &shown)) g_TrackMasks.SetTrackVisible(t, shown);
+            ImGui::SameLine();
+            bool muted = g_TrackMasks.TrackMuted(t);
+            if (ImGui::Checkbox("Mute", &muted)) g_TrackMasks.SetTrackMuted(t, muted);
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Solo")) g_TrackMasks.SoloTrack(t, tracks.size());
+            ImGui::PopID();
+        }
+    }
+    clipper.End();
+    ImGui::EndChild();
+
+    ImGui::Unindent(8.0f);
+}
@@ -0,0 +1,66 @@
+// active_notes.hpp — Incremental "which keys are sounding" tracker for the keyboard overlay
+#pragma once
+
+#include "visualizer.hpp"
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+// Keeps per (key, track, channel) reference counts for the notes that
+// contain the playhead tick.
+//
+//   Forward play: per-track cursors ordered by a next-start min-heap, plus a
+//   min-heap of note ends. A frame costs O(notes crossed · log) — tracks that
+//   have nothing to start are never touched.
+//   Seek / loop back / long jump: Rebuild() from a per-track block index
+//   (max end tick per 64 notes), which skips whole blocks of finished notes.
+class ActiveNoteTracker {
+public:
+    // One sounding (track, channel) on a key. `ident` = track << 4 | channel,
+    // so the holder with the largest ident is the top-most painted track.
+    struct Holder {
+        uint32_t ident;
+        uint32_t count;
+    };
+
+    void Bind(const std::vector<OptimizedTrackData>* tracks);
+    void Unbind();
+    // The notes of `changed` were replaced in the bound tracks (watch mode):
+    // re-index those and rebuild on the next Update().
+    void Refresh(const std::vector<uint16_t>& changed);
+    bool IsBound() const { return tracks != nullptr; }
+
+    // Advance to `tick`. Going backwards or jumping more than `maxStepTicks`
+    // forward rebuilds from the block index instead of replaying every note.
+    void Update(uint32_t tick, uint32_t maxStepTicks);
+    void Rebuild(uint32_t tick);
+
+    const std::vector<Holder>& Holders(uint8_t key) const { return keys[key & 127]; }
+    size_t ActiveCount() const { return active; }
+
+private:
+    static constexpr uint32_t kBlock = 64;
+
+    struct Start { uint32_t tick; uint32_t track; };
+    struct End   { uint32_t tick; uint32_t ident; uint8_t key; };
+    struct StartLater { bool operator()(const Start& a, const Start& b) const { return a.tick > b.tick; } };
+    struct EndLater   { bool operator()(const End& a, const End& b) const { return a.tick > b.tick; } };
+
+    void Add(uint8_t key, uint32_t ident, uint32_t endTick);
+    void Release(uint8_t key, uint32_t ident);
+    void ClearState();
+    void IndexTrack(size_t t);   // blockMaxEnd[t] from the bound notes
+
+    const std::vector<OptimizedTrackData>* tracks = nullptr;
+    std::vector<std::vector<uint32_t>>     blockMaxEnd;   // [track][block]
+    std::vector<uint32_t>                  cursor;        // next note to start, per track
+
+    std::priority_queue<Start, std::vector<Start>, StartLater> starts;
+    std::priority_queue<End,   std::vector<End>,   EndLater>   ends;
+
+    std::vector<Holder> keys[128];
+    size_t   active   = 0;
+    uint32_t lastTick = 0;
+    bool     primed   = false;
+};
@@ -1,6 +1,5 @@
 // bass_backend.hpp — BassMIDI pre-render / real-time audio backend
 #pragma once
-#ifdef _WIN32
 
 #include <string>
 #include <vector>
@@ -10,6 +9,10 @@
 #include <mutex>
 #include <functional>
 
+#include "emulated_sink.hpp"
+#include "event_filter.hpp"
+#include "synth_shard.hpp"
+
 // ── Audio backend mode ────────────────────────────────────────────────────────
 enum class AudioMode : uint8_t {
     KDMAPI           = 0,  // Original path — SendDirectData (KDMAPI / OmniMIDI)
@@ -17,6 +20,12 @@ enum class AudioMode : uint8_t {
     BassMIDI_PreRender,    // BassMIDI pre-rendered live PCM stream
 };
 
+// ── Synth used by each real-time shard ────────────────────────────────────────
+enum class RtSynth : uint8_t {
+    BassMIDI = 0,          // BASS_MIDI decode stream per shard (uses the soundfont list)
+    BuiltIn,               // SoftSynth — no soundfont needed
+};
+
 // ── Soundfont list entry ──────────────────────────────────────────────────────
 struct SoundFontEntry {
     std::string path;
@@ -45,10 +54,16 @@ struct BassConfig {
     // down to lowBufferMinVoices (at 0s health) so decode catches up faster.
     int      lowBufferMinVoices = 16;
 
-    // Low-buffer velocity ignore scaling (RT mode only).
-    // At health < lowVelScaleMaxSec, GetDynamicVelIgnore scales up toward 127.
-    // Set to 0 to disable.
-    float    lowVelScaleMaxSec  = 0.5f;
+    // Real-time sharding (BassMIDI_RT mode). With rtShards == 1 and the BassMIDI
+    // synth the original single-stream path is used; anything else routes RT
+    // sends through a ShardedSynth mixed into one output stream.
+    int      rtShards           = 1;
+    ShardKey rtShardKey         = ShardKey::Channel;
+    RtSynth  rtSynth            = RtSynth::BassMIDI;
+
+    // Pre-render decoder. BuiltIn renders through SoftPreRenderDecoder, whose
+    // seeks restore a synth snapshot instead of rescanning the whole song.
+    RtSynth  preRenderSynth     = RtSynth::BassMIDI;
 };
 
 // ── Pre-render progress ───────────────────────────────────────────────────────
@@ -79,6 +94,9 @@ public:
     void    SetLowBufferMode(bool on);
     void    SetSfxEnabled(bool on);
     void    SetPlaybackSpeed(float speed);
+    void    SetRtSharding(int shards, ShardKey key, RtSynth synth);
+    void    SetPreRenderSynth(RtSynth synth);
+    std::vector<ShardStats> GetShardStats() const;
 
     AudioMode GetActiveMode() const;
 
@@ -90,14 +108,14 @@ public:
     const   std::vector<SoundFontEntry>& GetSoundFonts() const;
     void    ReloadAllSoundFonts();
 
-    void    StartPreRender(const void* rawEvents, size_t eventCount,
-                           int ppq, uint32_t initialTempoBPM,
-                           uint64_t totalMicros);
+    void    StartPreRender(std::shared_ptr<const FilteredStream> stream, uint64_t totalMicros);
+    void    SetPreRenderStream(std::shared_ptr<const FilteredStream> stream);
     void    CancelPreRender();
     PreRenderStatus GetPreRenderStatus() const;
     double  GetBufferHealthSeconds() const;
 
-    void    SendMidiData(uint32_t msg);
+    void    SendMidiData(uint32_t msg, uint16_t track = 0);
+    void    SendMidiLongData(const uint8_t* data, uint32_t len);   // complete SysEx (F0 … F7)
 
     void    Play();
     void    Pause();
@@ -121,22 +139,73 @@ extern BassPreRenderEngine g_BassEngine;
 #ifndef BASS_DISPATCH_DEFINED
 #define BASS_DISPATCH_DEFINED
 extern "C" void SendDirectData(unsigned long data);
+// KDMAPI long-message path (Prepare / SendDirectLongData / Unprepare)
+void SendKdmapiLongData(const uint8_t* data, uint32_t len);
+
+// Where DispatchMidiOut sends right now, in priority order. The playback loop
+// resolves this once per batch and calls the DispatchMidiOutTo<> it needs.
+enum class DispatchSink : uint8_t {
+    Null = 0,       // --null-audio / benchmark: count and discard
+    Emulated,       // overload testing: modelled sink replaces the device
+    BassRT,         // BassMIDI real-time send
+    Direct,         // KDMAPI / OmniMIDI
+    PreRender,      // audio is already stored in the buffer: send nothing
+    Count
+};
 
-// Route MIDI correctly preventing double playback
-inline void DispatchMidiOut(uint32_t msg) {
+inline DispatchSink CurrentDispatchSink() {
+    if (g_NullSink.IsEnabled())     return DispatchSink::Null;
+    if (g_EmulatedSink.IsEnabled()) return DispatchSink::Emulated;
     if (g_BassEngine.IsInitialized()) {
-        AudioMode mode = g_BassEngine.GetActiveMode();
-        if (mode == AudioMode::BassMIDI_RT) {
-            g_BassEngine.SendMidiData(msg); // Only send live to Bass if in Real-Time mode
-        } else if (mode == AudioMode::KDMAPI) {
-            SendDirectData((unsigned long)msg);
-        }
-        // If BassMIDI_PreRender is active, audio is already stored in the buffer. 
-        // We do absolutely nothing here so we don't trigger phantom/duplicate notes!
-    } else {
-        SendDirectData((unsigned long)msg);
+        const AudioMode mode = g_BassEngine.GetActiveMode();
+        if (mode == AudioMode::BassMIDI_RT) return DispatchSink::BassRT;
+        if (mode == AudioMode::KDMAPI)      return DispatchSink::Direct;
+        return DispatchSink::PreRender;
     }
+    return DispatchSink::Direct;
+}
+
+// `track` is the source visual track; only the track-sharded RT path uses it.
+template <DispatchSink S>
+inline void DispatchMidiOutTo(uint32_t msg, uint16_t track) {
+    if constexpr (S == DispatchSink::Null)          g_NullSink.Send(msg);
+    else if constexpr (S == DispatchSink::Emulated) g_EmulatedSink.Send(msg);
+    else if constexpr (S == DispatchSink::BassRT)   g_BassEngine.SendMidiData(msg, track);
+    else if constexpr (S == DispatchSink::Direct)   SendDirectData((unsigned long)msg);
+    // Pre-render: do absolutely nothing so we don't trigger phantom/duplicate notes!
+    (void)msg; (void)track;
 }
-#endif // BASS_DISPATCH_DEFINED
 
-#endif // _WIN32
\ No newline at end of file
+// Same routing for variable-length messages (SysEx from the SysExArena).
+// SysEx is global state, so it is never split by track.
+template <DispatchSink S>
+inline void DispatchMidiLongOutTo(const uint8_t* data, uint32_t len) {
+    if (!data || len == 0) return;
+    if constexpr (S == DispatchSink::Null)          g_NullSink.SendLong(data, len);
+    else if constexpr (S == DispatchSink::Emulated) g_EmulatedSink.SendLong(data, len);
+    else if constexpr (S == DispatchSink::BassRT)   g_BassEngine.SendMidiLongData(data, len);
+    else if constexpr (S == DispatchSink::Direct)   SendKdmapiLongData(data, len);
+    // Pre-render: the SysEx is already in the encoded SMF
+}
+
+// Route MIDI correctly preventing double playback.
+inline void DispatchMidiOut(uint32_t msg, uint16_t track = 0) {
+    switch (CurrentDispatchSink()) {
+        case DispatchSink::Null:     DispatchMidiOutTo<DispatchSink::Null>(msg, track);     break;
+        case DispatchSink::Emulated: DispatchMidiOutTo<DispatchSink::Emulated>(msg, track); break;
+        case DispatchSink::BassRT:   DispatchMidiOutTo<DispatchSink::BassRT>(msg, track);   break;
+        case DispatchSink::Direct:   DispatchMidiOutTo<DispatchSink::Direct>(msg, track);   break;
+        default: break;
+    }
+}
+
+inline void DispatchMidiLongOut(const uint8_t* data, uint32_t len) {
+    switch (CurrentDispatchSink()) {
+        case DispatchSink::Null:     DispatchMidiLongOutTo<DispatchSink::Null>(data, len);     break;
+        case DispatchSink::Emulated: DispatchMidiLongOutTo<DispatchSink::Emulated>(data, len); break;
+        case DispatchSink::BassRT:   DispatchMidiLongOutTo<DispatchSink::BassRT>(data, len);   break;
+        case DispatchSink::Direct:   DispatchMidiLongOutTo<DispatchSink::Direct>(data, len);   break;
+        default: break;
+    }
+}
+#endif // BASS_DISPATCH_DEFINED
@@ -0,0 +1,108 @@
+// benchmark.hpp — Unattended benchmark: scripted playback, JSON report, exit
+#pragma once
+
+#include "frame_stats.hpp"   // HdrHistogram
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// jidi-player --benchmark song.mid [--speed X] [--duration S] [--report out.json]
+//
+// Skips the menu, loads the song, then plays it through a fixed script of
+// seeks, speed changes and viewer toggles. When the duration is up (or the
+// song ends) it writes a JSON report — load stages, frame-time percentiles,
+// painter latency, dispatch lateness, buffer-health minima and the worst
+// frame after each scripted step — and exits, with status 1 if the song did
+// not load or the report could not be written. MIDI goes to the null sink, so
+// the numbers are the player's own and no synth is needed; on Linux it runs
+// headless under a virtual framebuffer:
+//
+//   xvfb-run -s "-screen 0 1280x720x24" jidi-player --benchmark song.mid
+//
+// Steps sit at fractions of the run, so a short and a long run exercise the
+// same things, and two reports of the same song and options compare directly.
+
+enum class BenchAction : uint8_t {
+    Play,           // leave the first pause
+    SeekBy,         // value: seconds (negative = back)
+    SeekTo,         // value: fraction of the song
+    Speed,          // value: multiple of --speed
+    CycleViewer,    // same as the T key
+    TimeDomain,     // same as the D key
+};
+
+struct BenchStep {
+    double      at;        // fraction of the run
+    BenchAction action;
+    double      value;
+    const char* label;
+};
+
+class BenchmarkRun {
+public:
+    static constexpr double kDefaultDurationSec = 60.0;
+    static constexpr double kStepWindowSec      = 1.0;   // "worst frame after a step" window
+
+    // Consumes the option at argv[i] (and its value); false if it is not a benchmark option.
+    bool ParseArg(int& i, int argc, char* argv[]);
+
+    bool               Enabled() const   { return enabled; }
+    const std::string& File() const      { return file; }
+    float              BaseSpeed() const { return speed; }
+
+    // Song loaded and paused: the script clock starts now.
+    void Begin(double songSec, uint64_t notes, size_t tracks);
+    bool Running() const { return running.load(std::memory_order_acquire); }
+
+    // Once per playing frame, with the frame time FrameStats just recorded.
+    void OnFrame(double frameMs);
+    // The next step that is due, if any; call until it returns false.
+    bool NextStep(BenchStep& out);
+    bool Expired(bool songFinished) const;
+
+    // Painter thread: enqueue → exact chunk published. Cheap no-op unless running.
+    void RecordPaintLatency(double ms);
+
+    // Writes the report to --report and ends the run; the main loop exits on Done().
+    bool Finish(bool songFinished);
+    void Abort(const char* why);   // no report (the song never loaded)
+    bool Done() const { return done; }
+    // Process exit status: non-zero if the run was aborted, its report could
+    // not be written, or the window closed before it finished.
+    int  ExitCode() const { return (enabled && (!done || failed)) ? 1 : 0; }
+
+private:
+    struct StepResult {
+        const char* label;
+        double      atSec;
+        double      worstFrameMs;
+    };
+    using Clock = std::chrono::steady_clock;
+
+    double Elapsed() const { return std::chrono::duration<double>(Clock::now() - start).count(); }
+
+    bool              enabled     = false;
+    bool              done        = false;
+    bool              failed      = false;
+    std::string       file;
+    std::string       reportPath  = "benchmark.json";
+    float             speed       = 1.0f;
+    double            durationSec = kDefaultDurationSec;
+
+    double            songSec     = 0.0;
+    uint64_t          noteCount   = 0;
+    size_t            trackCount  = 0;
+    Clock::time_point start;
+    size_t            nextStep    = 0;
+    std::vector<StepResult> steps;
+
+    std::atomic<bool> running{ false };
+    std::mutex        paintMtx;
+    HdrHistogram      paintLatency;   // µs
+};
+
+extern BenchmarkRun g_Benchmark;
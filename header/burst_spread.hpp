@@ -0,0 +1,60 @@
+// burst_spread.hpp — Spreads same-tick event bursts over a short window
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Black MIDIs stack thousands of note-ons (and the previous chord's note-offs)
+// on one tick. Sent back to back they arrive at the synth as one wall and
+// overrun its input queue (KDMAPI / OmniMIDI drop or stall), while the
+// following milliseconds carry nothing. BurstSpreader gives the k-th of the n
+// events in such a run the offset k · window / n, so the wall is paced across
+// `window` instead.
+//
+// Events are still dispatched in list order — they are only held back, by a
+// non-decreasing amount — so the loader's same-tick order (TEMPO < SYSEX <
+// NOTE_OFF < NOTE_ON < other: offs before ons) and the order on every key stay
+// exactly as in the file.
+//
+// The offset depends only on the event's position inside its run, so seeks
+// and loop-backs into the middle of a run need no extra state. Runs shorter
+// than `minEvents` are not spread.
+class BurstSpreader {
+public:
+    static constexpr uint32_t kMaxWindowMicros  = 1000;   // sub-millisecond by design
+    static constexpr uint32_t kDefaultMinEvents = 128;
+
+    // Forget the cached run (the event list was replaced).
+    void Invalidate() { list = nullptr; begin = end = 0; }
+
+    // Offset for events[pos], in the unit of `window`. `tickOf(e)` gives the
+    // event's tick (or any same-instant key). A run is scanned once, when the
+    // first of its events is asked about.
+    template <class Events, class TickOf>
+    double Offset(const Events& events, size_t pos, double window, uint32_t minEvents, TickOf tickOf) {
+        if (window <= 0.0 || pos >= events.size()) return 0.0;
+        if (list != (const void*)&events || pos < begin || pos >= end) Scan(events, pos, tickOf);
+
+        const size_t n = end - begin;
+        if (n < (size_t)(minEvents ? minEvents : 1)) return 0.0;
+        return window * (double)(pos - begin) / (double)n;
+    }
+
+    size_t RunBegin() const { return begin; }
+    size_t RunEnd() const   { return end; }
+
+private:
+    template <class Events, class TickOf>
+    void Scan(const Events& events, size_t pos, TickOf tickOf) {
+        list = (const void*)&events;
+        const auto tick = tickOf(events[pos]);
+        begin = pos;
+        while (begin > 0 && tickOf(events[begin - 1]) == tick) --begin;
+        end = pos + 1;
+        while (end < events.size() && tickOf(events[end]) == tick) ++end;
+    }
+
+    const void* list  = nullptr;
+    size_t      begin = 0;
+    size_t      end   = 0;
+};
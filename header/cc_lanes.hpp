@@ -0,0 +1,72 @@
+// cc_lanes.hpp — Per-(channel, controller) step-function index for the CC lanes
+#pragma once
+
+#include "visualizer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Lanes drawn under the roll, top to bottom
+enum class CCLane : uint8_t { Sustain, Volume, Expression, Pan, PitchBend, Count };
+
+constexpr int CC_LANE_COUNT = (int)CCLane::Count;
+
+// Built once at load from the sorted CCEvent list; the raw list can be freed
+// afterwards. Each (lane, channel) is a step function stored as parallel
+// tick / value arrays, so any tick window resolves with two binary searches.
+// A step is kept for every tick that has an event, repeats included, so a
+// step depends only on its own tick: a watch edit replaces the steps of the
+// ticks it touched and nothing else. Several changes on one tick collapse to
+// the highest value; the merged event list plays them in no fixed order.
+//
+// ChunkPolyline() returns the step function over one fixed-width tick chunk
+// as (tick, value) corners and caches it, like the note texture chunks — a
+// frame only rebuilds a polyline when a new chunk scrolls into view.
+class CCLaneIndex {
+public:
+    struct Point {
+        uint32_t tick;
+        uint8_t  value;
+    };
+
+    void Build(const std::vector<CCEvent>& events);
+    // Replaces every step in ticks [lo, hi] with those of `events`: all CC
+    // records of those ticks, sorted by tick.
+    void Splice(uint32_t lo, uint32_t hi, const std::vector<CCEvent>& events);
+    void Clear();
+
+    bool    Empty() const { return eventCount == 0; }
+    size_t  EventCount() const { return eventCount; }
+    bool    HasData(CCLane lane, uint8_t ch) const { return !Series(lane, ch).ticks.empty(); }
+    bool    LaneHasData(CCLane lane) const;
+    uint8_t ValueAt(CCLane lane, uint8_t ch, uint32_t tick) const;
+
+    const std::vector<Point>& ChunkPolyline(CCLane lane, uint8_t ch, uint64_t chunkIdx, uint32_t chunkTicks);
+
+    static const char* LaneName(CCLane lane);
+    static uint8_t     DefaultValue(CCLane lane);   // value before the first event
+
+private:
+    static constexpr int kCacheSlots = 4;   // chunks kept per series (1 current + 3 ahead)
+
+    struct CacheSlot {
+        uint64_t           chunk  = UINT64_MAX;
+        uint32_t           ticks  = 0;
+        uint64_t           stamp  = 0;
+        std::vector<Point> points;
+    };
+    struct SeriesData {
+        std::vector<uint32_t> ticks;
+        std::vector<uint8_t>  values;
+        CacheSlot             cache[kCacheSlots];
+    };
+
+    static void AddStep(SeriesData& s, uint32_t tick, uint8_t value);
+
+    const SeriesData& Series(CCLane lane, uint8_t ch) const { return series[(int)lane][ch & 15]; }
+    SeriesData&       Series(CCLane lane, uint8_t ch)       { return series[(int)lane][ch & 15]; }
+
+    SeriesData series[CC_LANE_COUNT][16];
+    size_t     eventCount = 0;
+    uint64_t   stampClock = 0;
+};
@@ -0,0 +1,70 @@
+// chunk_painter.hpp — Rasterizes one chunk of the scrolling note texture
+#pragma once
+
+#include "raylib.h"
+#include "visualizer.hpp"
+#include "note_time_columns.hpp"
+#include "track_masks.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The texture viewers (ChannelTrackLayer, TickLayer) scroll a texture of
+// kChunkRows rows, one per key, cut into chunk-wide column ranges. A chunk is
+// always painted from scratch by PaintChunkRange: cleared, then every note
+// overlapping its range is drawn as a run of pixels. A pixel that is already
+// non-zero is never overwritten, so the note drawn first wins:
+//
+//   ChannelTrackLayer: tracks from last to first, notes of a track from last
+//                      to first → track 0, earliest note on top.
+//   TickLayer:         all notes of the chunk sorted by (start tick, track)
+//                      and drawn in reverse → earliest start on top, ties to
+//                      the lower track (PFA layering).
+//
+// Everything the painter reads comes in through ChunkPaintContext, so it
+// runs headless; painter-test checks its output against stored hashes.
+inline constexpr int kChunkRows = 128;
+
+inline uint32_t ToRGBA8(Color c) {
+    return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | (0xFFu << 24);
+}
+
+// A note's extent on the painter's axis: ticks, or NoteTimeColumns units in
+// time-domain mode. Both are sorted by start, so the searches are shared.
+struct NoteAxis {
+    const NoteEvent* base;
+    const uint32_t*  starts;   // null → tick axis
+    const uint32_t*  ends;
+    uint32_t Start(const NoteEvent& n) const { return starts ? starts[&n - base] : n.startTick; }
+    uint32_t End(const NoteEvent& n) const {
+        if (ends) return ends[&n - base];
+        return (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
+    }
+
+    static NoteAxis For(const std::vector<OptimizedTrackData>& tracks, const NoteTimeColumns* times, size_t t) {
+        const NoteEvent* base = tracks[t].notes.data();
+        if (!times) return { base, nullptr, nullptr };
+        return { base, times->Starts(t), times->Ends(t) };
+    }
+};
+
+struct ChunkPaintContext {
+    const std::vector<OptimizedTrackData>* tracks = nullptr;
+    const NoteTimeColumns*   times       = nullptr;   // non-null: the axis is time units
+    ViewerType               viewer      = ViewerType::ChannelTrackLayer;
+    int                      width       = 0;         // chunk width in pixels
+    double                   pixPerTick  = 0.0;       // pixels per axis unit
+    const Color*             palette     = nullptr;   // colour of (track, channel) = palette[(track * 16 + channel) % paletteSize]
+    int                      paletteSize = 0;
+    const TrackMasks*        masks       = nullptr;   // required: hidden tracks / channels are skipped
+    const std::atomic<bool>* cancel      = nullptr;   // optional; polled per track and per note
+};
+
+// Paints the axis range [tickStart, tickEnd) into `out` (kChunkRows rows,
+// `outStride` pixels apart, ctx.width pixels each). stride > 1 keeps only
+// every stride-th note of each track (coarse pass). Returns the number of
+// notes drawn; 0 when cancelled (the chunk is then partial).
+uint64_t PaintChunkRange(const ChunkPaintContext& ctx, uint32_t tickStart, uint32_t tickEnd,
+                         uint32_t* out, size_t outStride, uint32_t stride = 1);
@@ -0,0 +1,149 @@
+// emulated_sink.hpp — Modelled MIDI sink for back-pressure and overload testing
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+// The Lag Simulator only throttles inside the playback engine. A real synth
+// pushes back instead: its input queue fills, the sender blocks, and each
+// event costs more the more voices are sounding. SinkModel reproduces that
+// as a single-server queue in virtual nanoseconds, so the same input always
+// gives the same stats (sink-bench runs it with no audio hardware), and
+// EmulatedSink drives it from the real clock as a playback output.
+//
+//   service(event) = eventCostNs + voiceCostNs * voices   (+ byteCostNs per SysEx byte)
+//
+// Voices are counted at submit time from note-on / note-off / CC 120, 123,
+// capped at maxVoices (stealing keeps the count at the cap). Release tails
+// are not modelled.
+
+enum class SinkOverflow : uint8_t {
+    Block = 0,      // sender waits for queue space (a full KDMAPI / driver buffer)
+    DropNewest,     // event is discarded
+    DropNoteOns,    // note-ons are discarded, everything else waits
+};
+
+struct SinkModelConfig {
+    uint32_t     queueDepth  = 4096;
+    double       eventCostNs = 250.0;
+    double       voiceCostNs = 2.0;
+    double       byteCostNs  = 40.0;
+    uint32_t     maxVoices   = 1024;
+    SinkOverflow overflow    = SinkOverflow::Block;
+
+    bool operator==(const SinkModelConfig&) const = default;
+};
+
+struct SinkStats {
+    uint64_t submitted    = 0;
+    uint64_t accepted     = 0;
+    uint64_t dropped      = 0;
+    uint64_t blocked      = 0;     // submits that had to wait
+    uint64_t blockedNs    = 0;     // total sender wait
+    uint64_t maxQueue     = 0;
+    uint32_t voices       = 0;
+    uint32_t peakVoices   = 0;
+    double   meanLatencyNs = 0.0;  // submit → serviced, including the wait
+    uint64_t p50LatencyNs = 0;
+    uint64_t p99LatencyNs = 0;
+    uint64_t maxLatencyNs = 0;
+
+    bool operator==(const SinkStats&) const = default;
+};
+
+class SinkModel {
+public:
+    struct Result {
+        bool     accepted  = false;
+        uint64_t blockedNs = 0;    // how long the sender must wait before returning
+        uint64_t latencyNs = 0;    // until the sink has serviced the event
+    };
+
+    explicit SinkModel(const SinkModelConfig& cfg = {});
+
+    // nowNs must not go backwards between calls.
+    Result Submit(uint32_t msg, uint64_t nowNs);
+    Result SubmitLong(uint32_t len, uint64_t nowNs);
+
+    void                   Reset();
+    SinkStats              Stats() const;
+    const SinkModelConfig& Config() const { return cfg; }
+
+private:
+    Result Enqueue(double serviceNs, uint64_t nowNs, bool noteOn);
+    void   TrackVoices(uint32_t msg);
+    void   RecordLatency(uint64_t ns);
+
+    // Log-scale histogram, 8 buckets per octave (~9 % resolution)
+    static constexpr int kLatencyBuckets = 64 * 8;
+
+    SinkModelConfig      cfg;
+    std::deque<uint64_t> completions;        // queued events' service end times
+    uint64_t             lastCompletion = 0;
+    uint16_t             held[16][128]  = {};
+    SinkStats            stats;
+    double               latencySumNs   = 0.0;
+    std::array<uint64_t, kLatencyBuckets> latency{};
+};
+
+// Real-time front end. When enabled, DispatchMidiOut sends here instead of to
+// a device; Send() sleeps for the modelled back-pressure, so the playback
+// thread stalls the way it would on a synth whose queue is full.
+class EmulatedSink {
+public:
+    void            SetEnabled(bool on);
+    bool            IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    void            Configure(const SinkModelConfig& cfg);   // also resets the stats
+    SinkModelConfig GetConfig() const;
+
+    void            Send(uint32_t msg);
+    void            SendLong(const uint8_t* data, uint32_t len);
+
+    SinkStats       GetStats() const;
+    bool            IsBlocking() const { return blocking.load(std::memory_order_relaxed); }
+    void            ResetStats();
+
+private:
+    void            Wait(uint64_t ns);
+    uint64_t        NowNs() const;
+
+    mutable std::mutex                    mtx;
+    SinkModel                             model;
+    std::atomic<bool>                     enabled{ false };
+    std::atomic<bool>                     blocking{ false };
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+extern EmulatedSink g_EmulatedSink;
+
+// Discards everything and only counts it. Used by --null-audio and the
+// benchmark, so playback runs the full dispatch path with no device (and no
+// KDMAPI / BASS) behind it. Checked before the emulated sink.
+class NullSink {
+public:
+    void     SetEnabled(bool on) { enabled.store(on, std::memory_order_relaxed); }
+    bool     IsEnabled() const   { return enabled.load(std::memory_order_relaxed); }
+
+    void     Send(uint32_t)                  { events.fetch_add(1, std::memory_order_relaxed); }
+    void     SendLong(const uint8_t*, uint32_t len) {
+        longEvents.fetch_add(1, std::memory_order_relaxed);
+        longBytes.fetch_add(len, std::memory_order_relaxed);
+    }
+
+    uint64_t Events() const     { return events.load(std::memory_order_relaxed); }
+    uint64_t LongEvents() const { return longEvents.load(std::memory_order_relaxed); }
+    uint64_t LongBytes() const  { return longBytes.load(std::memory_order_relaxed); }
+    void     ResetStats()       { events = longEvents = longBytes = 0; }
+
+private:
+    std::atomic<bool>     enabled{ false };
+    std::atomic<uint64_t> events{ 0 };
+    std::atomic<uint64_t> longEvents{ 0 };
+    std::atomic<uint64_t> longBytes{ 0 };
+};
+
+extern NullSink g_NullSink;
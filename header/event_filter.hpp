@@ -0,0 +1,108 @@
+// event_filter.hpp — Declarative event filter, compiled once per configuration change
+#pragma once
+
+#include "midi_event.hpp"
+#include "sysex_arena.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ── Filter settings ───────────────────────────────────────────────────────────
+// Every rule drops matching events from the stream handed to playback and to
+// the pre-render encoder. Dropping a note-on always drops its paired note-off
+// too, so KDMAPI reference counting stays balanced. Tempo and SysEx are never
+// filtered. Mutes are not a filter rule: they live in TrackMasks and only
+// reach the compile through the pipeline's mute overlay.
+struct EventFilterConfig {
+    uint8_t  velocityIgnore = 0;      // note-ons with 0 < vel <= this are dropped
+    uint8_t  keyLow         = 0;      // inclusive key range
+    uint8_t  keyHigh        = 127;
+    bool     stripCC        = false;
+    bool     stripPitchBend = false;
+    bool     stripProgram   = false;
+    bool     stripPressure  = false;
+    uint32_t minNoteTicks   = 0;      // notes shorter than this (in ticks) are removed
+
+    bool operator==(const EventFilterConfig&) const = default;
+
+    bool IsPassThrough() const;
+};
+
+// ── Compiled stream ───────────────────────────────────────────────────────────
+// Immutable result of one compile. Consumers hold it by shared_ptr, so a
+// settings change never pulls events out from under a running thread.
+class FilteredStream {
+public:
+    const std::vector<MidiEvent>& Events() const { return view ? *view : owned; }
+
+    uint64_t generation    = 0;
+    int      ppq           = 480;
+    uint32_t initialTempo  = 500000;
+    uint32_t lastTempo     = 500000;  // last tempo in the stream (pre-render tail length)
+    size_t   droppedNotes  = 0;       // note-ons removed (offs not counted)
+    size_t   droppedOther  = 0;       // CC / bend / program / pressure removed
+    const SysExArena* sysex = nullptr; // payloads of SYSEX events (loader-owned)
+    double   compileMs     = 0.0;
+
+    // Complete single-track SMF image for BASS_MIDI_StreamCreateFile, with
+    // tempos scaled by 1/speed and the keep-alive tail appended. Encoded on
+    // first use and reused until a different speed is requested.
+    std::shared_ptr<const std::vector<uint8_t>> EncodedSmf(float speed) const;
+
+private:
+    friend class EventFilterPipeline;
+
+    const std::vector<MidiEvent>* view = nullptr;  // pass-through: the loader's list
+    std::vector<MidiEvent>        owned;
+
+    mutable std::mutex                                  smfMutex;
+    mutable float                                       smfSpeed = 0.0f;
+    mutable std::shared_ptr<const std::vector<uint8_t>> smf;
+};
+
+// ── Pipeline ──────────────────────────────────────────────────────────────────
+// SetSource / SetConfig bump the generation; Get() compiles lazily and returns
+// the cached stream until the next bump. UI thread only, except Generation().
+class EventFilterPipeline {
+public:
+    void     SetSource(const std::vector<MidiEvent>* events, int ppq, uint32_t initialTempo,
+                       const SysExArena* sysex = nullptr);
+    void     SetConfig(const EventFilterConfig& cfg);   // no-op when unchanged
+    EventFilterConfig GetConfig() const;
+    // Live mutes from TrackMasks, applied at compile time. Only set while the
+    // pre-render is active (it has no dispatch loop). Like the dispatcher, a
+    // mute drops notes only; CC / program / bend of the channel still play.
+    void     SetMuteOverlay(std::vector<uint64_t> trackWords, uint16_t channels);
+    // Watch mode: the source was edited in place. `was` / `now` hold the
+    // rebuilt tracks' channel events before and after (sorted), [lo, hi] the
+    // ticks where the source changed (none when lo > hi). No rule looks across
+    // tracks, so only those tracks are filtered again, and the cached stream
+    // is rewritten over the ticks where the result differs. Like the source,
+    // it is edited in place: the caller parks its readers first
+    // (MidiOutputEngine::Hold).
+    void     SpliceTracks(const std::vector<MidiEvent>& was, const std::vector<MidiEvent>& now,
+                          uint32_t lo, uint32_t hi);
+    uint64_t Generation() const { return generation.load(std::memory_order_acquire); }
+
+    std::shared_ptr<const FilteredStream> Get();
+
+private:
+    std::shared_ptr<FilteredStream> Compile() const;
+    void Filter(const std::vector<MidiEvent>& src, FilteredStream& out) const;   // fills owned + counters
+
+    mutable std::mutex             mtx;
+    const std::vector<MidiEvent>*  source       = nullptr;
+    const SysExArena*              sysex        = nullptr;
+    int                            ppq          = 480;
+    uint32_t                       initialTempo = 500000;
+    EventFilterConfig              cfg;
+    std::vector<uint64_t>          overlayTracks;
+    uint16_t                       overlayChannels = 0;
+    std::atomic<uint64_t>          generation{1};
+    std::shared_ptr<FilteredStream> cached;
+};
+
+extern EventFilterPipeline g_EventFilter;
@@ -0,0 +1,74 @@
+// event_splice.hpp — Tick-window diff and in-place range replace for watch-mode splices
+#pragma once
+
+#include "midi_event.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A watch-mode edit replaces the events of a few tracks. Both versions are
+// sorted by tick, so everything before the first differing tick and after the
+// last one is shared: only that window of the merged list, the filtered
+// stream and the CC lanes has to be rebuilt.
+//
+// Same-tick order is not fixed (the loader's sort is not stable), so runs of
+// one tick are compared as multisets.
+inline bool SameTickRun(const MidiEvent* a, const MidiEvent* b, size_t n) {
+    std::vector<uint32_t> x(n), y(n);
+    for (size_t i = 0; i < n; ++i) { x[i] = a[i].word; y[i] = b[i].word; }
+    std::sort(x.begin(), x.end());
+    std::sort(y.begin(), y.end());
+    return x == y;
+}
+
+// [lo, hi]: the ticks outside which `was` and `now` hold the same events.
+// False when they hold the same events everywhere.
+inline bool ChangedTicks(const std::vector<MidiEvent>& was, const std::vector<MidiEvent>& now,
+                         uint32_t& lo, uint32_t& hi) {
+    // Head: skip equal runs from the front
+    size_t i = 0, j = 0;
+    while (i < was.size() && j < now.size() && was[i].tick == now[j].tick) {
+        size_t ie = i, je = j;
+        while (ie < was.size() && was[ie].tick == was[i].tick) ++ie;
+        while (je < now.size() && now[je].tick == now[j].tick) ++je;
+        if (ie - i != je - j || !SameTickRun(&was[i], &now[j], ie - i)) break;
+        i = ie; j = je;
+    }
+    if (i == was.size() && j == now.size()) return false;
+    lo = std::min(i < was.size() ? was[i].tick : UINT32_MAX, j < now.size() ? now[j].tick : UINT32_MAX);
+
+    // Tail: the same from the back, never past the head
+    size_t ie = was.size(), je = now.size();
+    while (ie > i && je > j && was[ie - 1].tick == now[je - 1].tick) {
+        size_t ib = ie, jb = je;
+        while (ib > i && was[ib - 1].tick == was[ie - 1].tick) --ib;
+        while (jb > j && now[jb - 1].tick == now[je - 1].tick) --jb;
+        if (ie - ib != je - jb || !SameTickRun(&was[ib], &now[jb], ie - ib)) break;
+        ie = ib; je = jb;
+    }
+    hi = std::max(ie > i ? was[ie - 1].tick : 0u, je > j ? now[je - 1].tick : 0u);
+    hi = std::max(hi, lo);
+    return true;
+}
+
+// First event at or after `tick` / after `tick` (events sorted by tick)
+inline size_t TickLowerBound(const std::vector<MidiEvent>& events, uint32_t tick) {
+    return (size_t)(std::partition_point(events.begin(), events.end(),
+                                         [tick](const MidiEvent& e) { return e.tick < tick; }) - events.begin());
+}
+inline size_t TickUpperBound(const std::vector<MidiEvent>& events, uint32_t tick) {
+    return (size_t)(std::partition_point(events.begin(), events.end(),
+                                         [tick](const MidiEvent& e) { return e.tick <= tick; }) - events.begin());
+}
+
+// v[first, last) = with. Only the tail behind `last` moves, and only when the
+// length changes: one memmove, no per-element work outside the range.
+template <class T>
+void ReplaceRange(std::vector<T>& v, size_t first, size_t last, const std::vector<T>& with) {
+    const size_t n = last - first;
+    if (with.size() > n) v.insert(v.begin() + (ptrdiff_t)last, with.size() - n, T{});
+    else if (with.size() < n) v.erase(v.begin() + (ptrdiff_t)(first + with.size()), v.begin() + (ptrdiff_t)last);
+    std::copy(with.begin(), with.end(), v.begin() + (ptrdiff_t)first);
+}
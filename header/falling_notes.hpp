@@ -0,0 +1,55 @@
+// falling_notes.hpp — GPU-instanced vertical (PFA-style) falling-notes renderer
+#pragma once
+
+#include "raylib.h"
+#include "note_window_index.hpp"
+#include "visualizer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// ViewerType::FallingNotes. Keys run left → right, time falls towards the
+// playhead line at the bottom of the roll area.
+//
+// Each frame the visible notes (culled per track through NoteWindowIndex, plus
+// the track / channel masks) are packed as one instance each:
+//     { start - now, end - now, key, colour index }   (4 floats)
+// and drawn with ONE instanced draw call of a unit quad. Colours come from a
+// small palette texture, so a palette change is one texture upload.
+//
+// Needs instancing: desktop GL 3.3+ or GLES 3.0. Mesa llvmpipe exposes GL 4.5
+// core, so this runs on GPU-less machines. Available() reports false otherwise
+// and the caller falls back to a texture viewer.
+class FallingNotesRenderer {
+public:
+    ~FallingNotesRenderer() = default;   // GL objects are freed by Unload()
+
+    bool Available();   // lazily compiles the shader / creates buffers
+    void Unload();      // call while the GL context is alive
+
+    // RGBA8 entries; instance colour index = (track * 16 + channel) % size
+    void SetPalette(const std::vector<uint32_t>& rgba);
+
+    // area = roll rectangle; viewTicks = ticks between the top edge and the playhead
+    void Draw(const std::vector<OptimizedTrackData>& tracks, const NoteWindowIndex& index,
+              uint64_t currentTick, uint32_t viewTicks, Rectangle area);
+
+    size_t LastInstanceCount() const { return lastInstances; }
+    size_t LastTruncated() const { return lastTruncated; }
+
+private:
+    static constexpr size_t kMaxInstances = 4u << 20;   // 64 MB of instance data
+
+    bool EnsureCapacity(size_t instances);
+    void BindInstanceAttributes();
+
+    bool         tried = false, ok = false;
+    unsigned int shader = 0, vao = 0, quadVbo = 0, instVbo = 0, paletteTex = 0;
+    size_t       instCapacity = 0;
+    int          paletteWidth = 0, paletteSize = 0;
+    int          locScreen = -1, locArea = -1, locPxPerTick = -1, locPalette = -1, locPaletteWidth = -1;
+    int          locPos = 0, locNote = 1;
+
+    std::vector<float> instances;   // 4 floats per note, rebuilt each frame
+    size_t lastInstances = 0, lastTruncated = 0;
+};
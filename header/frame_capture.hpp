@@ -0,0 +1,120 @@
+// frame_capture.hpp — Asynchronous screenshot / image-sequence capture
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class CaptureFormat : uint8_t { PNG, QOI };
+
+// Replaces the synchronous TakeScreenshot() path:
+//
+//   Readback: OnFrameEnd() runs right before EndDrawing(). When pixel-buffer
+//             objects are available (GL 2.1+, resolved through GLFW), the
+//             framebuffer is read into a ring of PBOs and mapped a couple of
+//             frames later, so the GPU copy never stalls the render thread.
+//             Otherwise glReadPixels goes straight into a pooled buffer.
+//   Encode:   flip + PNG/QOI encode + file write run on one worker thread.
+//   Burst:    every Nth frame goes to an image sequence. Pooled buffers are
+//             never dropped; if the encoder falls behind the render thread
+//             waits for a free buffer (counted in Stats::stalls) instead.
+class FrameCapture {
+public:
+    struct Stats {
+        uint64_t queued  = 0;   // frames handed to the worker
+        uint64_t written = 0;   // files written
+        uint64_t failed  = 0;
+        uint64_t stalls  = 0;   // render thread waited for a free buffer
+        size_t   pending = 0;   // frames waiting for encode
+        bool     usingPbo = false;
+    };
+    // Outcome of one RequestScreenshot() (burst frames only count in Stats)
+    struct ShotResult {
+        std::string path;
+        bool        ok = false;
+    };
+
+    ~FrameCapture() { Shutdown(); }
+
+    void RequestScreenshot(CaptureFormat format = CaptureFormat::PNG);
+    void StartBurst(int everyNthFrame, CaptureFormat format = CaptureFormat::QOI);
+    void StopBurst();
+    bool IsBursting() const { return burstActive; }
+    const std::string& BurstFolder() const { return burstDir; }
+
+    // Render thread, once per frame, after everything (including ImGui) is drawn
+    void OnFrameEnd();
+    // Drain the queue, join the worker, free GL objects (call before CloseWindow)
+    void Shutdown();
+
+    Stats GetStats() const;
+    std::string LastWrittenPath() const;
+    // Render thread: one finished screenshot per call, false when none is left
+    bool PollShotResult(ShotResult& out);
+
+private:
+    struct Frame {
+        std::unique_ptr<uint8_t[]> pixels;
+        size_t                     capacity = 0;
+        int                        width = 0, height = 0;
+        std::string                path;
+        CaptureFormat              format = CaptureFormat::PNG;
+        bool                       shot   = false;   // RequestScreenshot, not burst
+    };
+    struct Pending {   // a PBO read that has been issued but not yet mapped
+        int           slot = -1;
+        int           width = 0, height = 0;
+        std::string   path;
+        CaptureFormat format = CaptureFormat::PNG;
+        bool          shot   = false;
+    };
+
+    static constexpr int kPboCount  = 3;
+    static constexpr int kPoolLimit = 12;
+
+    bool InitGl();
+    void ReleaseGl();
+    void Issue(const std::string& path, CaptureFormat format, bool shot);
+    void ReportShot(const std::string& path, bool ok);
+    void Resolve(Pending& p);
+    std::unique_ptr<Frame> Acquire(size_t bytes);
+    void Submit(std::unique_ptr<Frame> f);
+    void WorkerLoop();
+    void EnsureWorker();
+
+    // ── Render-thread state ──
+    bool        glTried = false, pboOk = false;
+    unsigned    pbo[kPboCount] = {};
+    size_t      pboSize[kPboCount] = {};
+    int         pboNext = 0;
+    std::deque<Pending> inFlight;
+
+    bool          shotRequested = false;
+    CaptureFormat shotFormat    = CaptureFormat::PNG;
+    bool          burstActive   = false;
+    int           burstEvery    = 1;
+    uint64_t      burstCounter  = 0;
+    uint64_t      burstIndex    = 0;
+    CaptureFormat burstFormat   = CaptureFormat::QOI;
+    std::string   burstDir;
+
+    // ── Shared with the worker ──
+    mutable std::mutex                  mtx;
+    std::condition_variable             cvWork, cvFree;
+    std::deque<std::unique_ptr<Frame>>  queue;
+    std::vector<std::unique_ptr<Frame>> freeList;
+    int                                 allocated = 0;
+    bool                                stopping  = false;
+    std::thread                         worker;
+    Stats                               stats;
+    std::string                         lastPath;
+    std::deque<ShotResult>              shotResults;
+};
+
+extern FrameCapture g_FrameCapture;
@@ -0,0 +1,135 @@
+// frame_stats.hpp — Percentile frame-time / dispatch-lateness / buffer statistics and stutter log
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// HDR-histogram style recorder: values are bucketed log-linearly, 2^kSubBits
+// buckets per power of two, so any value is reported within 1/2^kSubBits
+// (~3 %) of what was recorded. Record() is a bit_width and an increment;
+// ValueAt() walks the buckets and is meant for the panel, not the hot path.
+class HdrHistogram {
+public:
+    static constexpr int      kSubBits = 5;
+    static constexpr int      kSub     = 1 << kSubBits;
+    static constexpr int      kMaxBits = 32;                              // values up to 2^32-1
+    static constexpr int      kBuckets = (kMaxBits - kSubBits + 1) * kSub;
+    static constexpr uint64_t kMaxValue = (1ull << kMaxBits) - 1;
+
+    void Record(uint64_t v);
+    void Reset();
+
+    uint64_t Count() const { return total; }
+    uint64_t Max()   const { return maxSeen; }
+    // Smallest recorded bucket covering quantile q (0..1), reported as the
+    // bucket's highest value. `also` is merged in without a copy.
+    uint64_t ValueAt(double q, const HdrHistogram* also = nullptr) const;
+
+    static int      Index(uint64_t v);
+    static uint64_t HighestInBucket(int idx);
+
+private:
+    std::array<uint32_t, kBuckets> counts{};
+    uint64_t total   = 0;
+    uint64_t maxSeen = 0;
+};
+
+// Things a frame can spend its time on besides drawing notes. Subsystems mark
+// them as they happen; the mask is attached to the frame when it is recorded.
+enum class FrameEvent : uint32_t {
+    Seek          = 1u << 0,
+    Repaint       = 1u << 1,   // painter drained and the note buffer invalidated
+    WindowRestart = 1u << 2,   // chunk window re-anchored, coarse pass on the main thread
+    ChunkSlide    = 1u << 3,   // chunk window slid by one chunk
+    TextureUpload = 1u << 4,   // note chunks uploaded to the GPU
+    MinimapUpload = 1u << 5,
+    StreamRebind  = 1u << 6,   // event filter / mute overlay swapped the playback stream
+    PaletteUpload = 1u << 7,
+    Capture       = 1u << 8,
+    Resize        = 1u << 9,
+    WatchReload   = 1u << 10,  // watch mode spliced re-parsed tracks into the song
+};
+
+// One per process, fed once per frame from the playing state.
+//
+//   frame time        µs, every frame
+//   dispatch lateness µs of real time the latest MIDI event of the frame went
+//                     out after its scheduled moment (only while playing)
+//   buffer health     ms of pre-rendered audio ahead (only in pre-render);
+//                     the low tail is what matters, so it reports p1 / p0.1
+//
+// Percentiles cover the last kWindowSec..2*kWindowSec seconds (two
+// histograms, the older one dropped as the newer one fills); the session
+// histograms feed the summary printed when a song ends.
+//
+// A frame at or above the stutter threshold is logged with the events marked
+// during it. raylib's GetFrameTime() is the *previous* frame's duration, so
+// EndFrame() must run before anything in the new frame marks an event.
+class FrameStats {
+public:
+    static constexpr double kWindowSec      = 10.0;
+    static constexpr size_t kStutterLog     = 64;
+    static constexpr double kDefaultStutter = 50.0;   // ms
+
+    struct Percentiles {
+        double   p50 = 0.0, p99 = 0.0, p999 = 0.0, max = 0.0;   // ms
+        uint64_t count = 0;
+    };
+    struct Stutter {
+        uint64_t frame  = 0;
+        double   atSec  = 0.0;    // since Reset()
+        double   ms     = 0.0;
+        uint32_t events = 0;      // FrameEvent mask
+    };
+
+    void Reset();                 // new song: the next frame carries the load and is skipped
+    void Mark(FrameEvent e) { pending.fetch_or((uint32_t)e, std::memory_order_relaxed); }
+    // dispatchLateMs / bufferSec < 0: not applicable this frame
+    void EndFrame(double frameMs, double dispatchLateMs, double bufferSec);
+
+    Percentiles FrameTime() const        { return Window(frameCur, &framePrev); }
+    Percentiles DispatchLateness() const { return Window(lateCur, &latePrev); }
+    Percentiles BufferHealthLow() const  { return Low(bufCur, &bufPrev); }   // p50 / p1 / p0.1 / min, in ms
+
+    // The same over the whole session since Reset() (summary, benchmark report)
+    Percentiles SessionFrameTime() const        { return Window(frameAll, nullptr); }
+    Percentiles SessionDispatchLateness() const { return Window(lateAll, nullptr); }
+    Percentiles SessionBufferHealthLow() const  { return Low(bufAll, nullptr); }
+    uint64_t    Frames() const                  { return frames; }
+    double      SessionSeconds() const          { return clockSec; }
+
+    void   SetStutterThresholdMs(double ms) { stutterMs = ms; }
+    double StutterThresholdMs() const       { return stutterMs; }
+    uint64_t StutterCount() const           { return stutterCount; }
+    std::vector<Stutter> RecentStutters() const;   // oldest first
+    const Stutter* LastStutter() const;
+
+    void PrintSummary() const;
+    static std::string EventNames(uint32_t mask);
+
+private:
+    static Percentiles Window(const HdrHistogram& cur, const HdrHistogram* prev);
+    static Percentiles Low(const HdrHistogram& cur, const HdrHistogram* prev);
+    void Rotate();
+
+    HdrHistogram frameCur, framePrev, frameAll;
+    HdrHistogram lateCur,  latePrev,  lateAll;
+    HdrHistogram bufCur,   bufPrev,   bufAll;     // µs of buffer, low tail reported
+
+    std::atomic<uint32_t> pending{ 0 };
+    double   stutterMs     = kDefaultStutter;
+    double   clockSec      = 0.0;    // sum of recorded frame times
+    double   windowStart   = 0.0;
+    double   lastWarnSec   = -1.0;
+    uint64_t frames        = 0;
+    uint64_t stutterCount  = 0;
+    uint64_t unprinted     = 0;      // stutters since the last console line
+    bool     skipNext      = true;
+    std::array<Stutter, kStutterLog> stutters{};
+    size_t   stutterHead   = 0;      // next slot
+};
+
+extern FrameStats g_FrameStats;
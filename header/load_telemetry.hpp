@@ -0,0 +1,94 @@
+// load_telemetry.hpp — Per-stage timings and memory high-water marks for the load pipeline
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The loader and the post-load index builds in main() call Stage() as they
+// move on; each stage records wall time, process CPU time (all threads, so a
+// parallel build shows cpu > wall), the bytes / notes it worked on and the
+// resident-set high-water mark seen while it ran. RSS is sampled every
+// kSampleMs by a helper thread between Begin() and Finish(), so a peak that
+// lives shorter than that can be missed.
+//
+// Finish() prints the table; AppendLog() adds one JSON object per load to a
+// .jsonl file so loader changes can be compared across a corpus. The same
+// file seeds the ETA: the post-parse cost per note of the last logged load
+// predicts the stages that come after the parse.
+class LoadTelemetry {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int         kSampleMs   = 5;
+    static constexpr const char* kParseStage = "Parse + pair";   // the ETA is anchored on this one
+
+    struct StageStats {
+        std::string name;
+        double      startMs   = 0.0;   // since Begin()
+        double      wallMs    = 0.0;
+        double      cpuMs     = 0.0;
+        uint64_t    bytes     = 0;     // work size, for MB/s
+        uint64_t    notes     = 0;     // work size, for notes/s
+        uint64_t    rssEndMB  = 0;
+        uint64_t    rssPeakMB = 0;
+        bool        running   = false;
+    };
+
+    ~LoadTelemetry() { StopSampler(); }
+
+    void Begin(const std::string& file);
+    // Closes the running stage (if any) and opens `name`.
+    void Stage(const char* name, uint64_t bytes = 0, uint64_t notes = 0);
+    // Work size of the running stage, once it is known.
+    void SetWork(uint64_t bytes, uint64_t notes);
+    void Finish(uint64_t totalNotes, size_t tracks);
+
+    bool   Active() const { return active.load(std::memory_order_acquire); }
+    double ElapsedMs() const;
+    std::vector<StageStats> Stages() const;   // the running stage reports its time so far
+    std::string             Running() const;  // name of the running stage, "" when idle
+
+    // Seconds left, or < 0 while there is nothing to go on yet.
+    double EtaSeconds(uint64_t bytesRead, uint64_t totalBytes, uint64_t notesSoFar) const;
+
+    void PrintTable() const;
+    bool AppendLog(const std::string& path) const;
+    void LoadHistory(const std::string& path);   // reads the last entry's post-parse cost
+
+private:
+    void CloseRunning(double nowMs, double cpuMs);   // caller holds mtx
+    const StageStats* Parse() const;                 // caller holds mtx
+    void StartSampler();
+    void StopSampler();
+    double NowMs() const { return std::chrono::duration<double, std::milli>(Clock::now() - origin).count(); }
+
+    mutable std::mutex      mtx;
+    std::vector<StageStats> stages;
+    std::string             file;
+    uint64_t                noteTotal   = 0;
+    size_t                  trackCount  = 0;
+    double                  totalMs     = 0.0;
+    double                  totalCpuMs  = 0.0;
+    double                  stageCpu0   = 0.0;   // process CPU at the running stage's start
+    double                  cpu0        = 0.0;   // ... at Begin()
+    double                  postParseMsPerNote = 0.0;   // from the last finished or logged load
+    Clock::time_point       origin      = Clock::now();
+
+    std::atomic<bool>       active{ false };
+    std::atomic<bool>       sampling{ false };
+    std::atomic<uint64_t>   peakRss{ 0 };         // bytes, reset at each stage boundary
+    std::thread             sampler;
+};
+
+extern LoadTelemetry g_LoadTelemetry;
+
+// Process counters (Psapi / procfs), usable without <windows.h> in the caller
+uint64_t ProcessResidentBytes();
+double   ProcessCpuMs();
+
+// Body of a JSON string literal (quotes, backslashes and control characters escaped)
+std::string JsonEscape(const std::string& s);
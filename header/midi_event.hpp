@@ -0,0 +1,59 @@
+// midi_event.hpp — Compact MIDI event record shared by loader, playback and audio backends
+#pragma once
+
+#include <cstdint>
+
+// New types are appended so existing values (and saved filters) keep their meaning.
+enum class EventType : uint8_t { NOTE_ON, NOTE_OFF, CC, TEMPO, PITCH_BEND, PROGRAM_CHANGE, CHANNEL_PRESSURE,
+                                 POLY_PRESSURE, SYSEX };
+
+// Channel-message status nibble → type; 0xF is SysEx (TEMPO is status 0xFF).
+inline constexpr EventType kEventTypeOfStatus[16] = {
+    EventType::NOTE_OFF, EventType::NOTE_OFF, EventType::NOTE_OFF, EventType::NOTE_OFF,   // 0x0-0x7 unused
+    EventType::NOTE_OFF, EventType::NOTE_OFF, EventType::NOTE_OFF, EventType::NOTE_OFF,
+    EventType::NOTE_OFF, EventType::NOTE_ON, EventType::POLY_PRESSURE, EventType::CC,
+    EventType::PROGRAM_CHANGE, EventType::CHANNEL_PRESSURE, EventType::PITCH_BEND, EventType::SYSEX,
+};
+
+// MidiEvent: 8 bytes — tick(4) + word(4).
+//
+//   channel message:  word = status | d1 << 8 | d2 << 16 | track << 24
+//   TEMPO:            word = 0xFF   | µs-per-beat << 8        (24 bits, as stored in the SMF)
+//   SYSEX:            word = 0xF0   | arena entry << 8        (index into the SysExArena)
+//
+// The low three bytes of a channel message are the short message a MIDI
+// device takes, so dispatch sends ShortMsg() without re-packing. A tempo fits
+// in place; the only side table is the arena's entry → offset list. `track`
+// is the loader's 8-bit visual track and is meaningful for channel messages
+// only. Note-offs carry status 0x8n (a note-on with velocity 0 is stored as one).
+struct MidiEvent {
+    uint32_t tick;
+    uint32_t word;
+
+    static constexpr MidiEvent MakeShort(uint32_t tick, uint8_t status, uint8_t d1, uint8_t d2, uint8_t track = 0) {
+        return { tick, (uint32_t)status | ((uint32_t)(d1 & 0x7F) << 8) | ((uint32_t)(d2 & 0x7F) << 16) | ((uint32_t)track << 24) };
+    }
+    static constexpr MidiEvent MakeTempo(uint32_t tick, uint32_t microsPerBeat) {
+        return { tick, 0xFFu | ((microsPerBeat & 0xFFFFFFu) << 8) };
+    }
+    static constexpr MidiEvent MakeSysEx(uint32_t tick, uint32_t entry) {
+        return { tick, 0xF0u | ((entry & 0xFFFFFFu) << 8) };
+    }
+
+    uint8_t   Status() const   { return (uint8_t)word; }
+    EventType Type() const     { return Status() == 0xFF ? EventType::TEMPO : kEventTypeOfStatus[Status() >> 4]; }
+    uint8_t   Channel() const  { return (uint8_t)(word & 0x0F); }
+    uint8_t   D1() const       { return (uint8_t)(word >> 8); }    // key / controller / program / bend LSB
+    uint8_t   D2() const       { return (uint8_t)(word >> 16); }   // velocity / value / bend MSB
+    uint8_t   Track() const    { return (uint8_t)(word >> 24); }   // channel messages only
+    uint32_t  ShortMsg() const { return word & 0xFFFFFFu; }
+    uint32_t  Tempo() const    { return word >> 8; }                // TEMPO only
+    uint32_t  SysExEntry() const { return word >> 8; }              // SYSEX only
+
+    bool operator<(const MidiEvent& other) const {
+        if (tick != other.tick) return tick < other.tick;
+        return Type() < other.Type();
+    }
+};
+
+static_assert(sizeof(MidiEvent) == 8, "MidiEvent must stay 8 bytes");
@@ -0,0 +1,94 @@
+// midi_library.hpp — Background folder scan with a cheap per-file probe, cached on disk
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// What the library browser shows for one file. Everything except path /
+// name / bytes / mtime comes from ProbeMidiFile().
+struct LibraryEntry {
+    enum class State : uint8_t { Pending, Done, Invalid };
+
+    std::string path;
+    std::string name;             // file name, shown and sorted on
+    uint64_t    bytes     = 0;
+    int64_t     mtime     = 0;    // last write time; with `bytes` the cache key
+    uint16_t    format    = 0;
+    uint16_t    tracks    = 0;    // MTrk chunks present (not the header's count)
+    uint16_t    ppq       = 0;    // 0 for SMTPE time division
+    uint64_t    notes     = 0;    // note-ons
+    double      seconds   = 0.0;
+    bool        estimated = false;   // notes / seconds extrapolated from the probed prefix
+    State       state     = State::Pending;
+};
+
+// Reads MThd and walks the chunk headers, seeking over everything it does not
+// count. Of each MTrk only the first kProbeBytes are parsed (running status,
+// note-ons, tempo, end tick); longer chunks are extrapolated by size, so a
+// 4 GB black MIDI costs about as much as a 4 MB one. Duration applies the
+// tempo events found in the parsed parts.
+static constexpr uint64_t kProbeBytes = 1ull << 20;
+bool ProbeMidiFile(const std::string& path, LibraryEntry& out);
+
+// One walker thread lists the folder; a few probe threads fill in the
+// entries. Files whose path, size and write time match the cache are not
+// opened at all. Entries are append-only while a scan runs (a deque, so
+// references stay valid) and every change bumps Revision(), which the
+// browser uses to rebuild its sorted view.
+class MidiLibrary {
+public:
+    ~MidiLibrary() { Cancel(); }
+
+    void Open(const std::string& cachePath);   // loads the cache and the last folder
+    void Scan(const std::string& folder, bool recursive);
+    void Cancel();                             // joins; saves what was probed so far
+
+    bool     Scanning() const { return running.load(std::memory_order_acquire); }
+    uint64_t Revision() const { return revision.load(std::memory_order_acquire); }
+    size_t   Found()    const { return found.load(std::memory_order_relaxed); }
+    size_t   Probed()   const { return probed.load(std::memory_order_relaxed); }
+    std::string Folder() const;
+
+    // fn(const std::deque<LibraryEntry>&) under the lock — keep it short
+    template <class Fn> void Read(Fn&& fn) const {
+        std::lock_guard<std::mutex> lk(mtx);
+        fn(static_cast<const std::deque<LibraryEntry>&>(entries));
+    }
+
+private:
+    void Walk(std::string folder, bool recursive);
+    void ProbeWorker();
+    void Finish();                 // last worker out
+    bool SaveCache();              // caller holds mtx
+
+    mutable std::mutex      mtx;
+    std::condition_variable workCv;
+    std::deque<LibraryEntry> entries;
+    std::deque<size_t>      work;            // indices into entries
+    std::unordered_map<std::string, LibraryEntry> cache;   // by path
+    std::unordered_set<std::string> seen;    // paths found by this scan
+    std::string             cachePath;
+    std::string             folder;
+    bool                    walking   = false;
+    bool                    recursiveScan = false;
+    bool                    cacheDirty = false;
+    int                     workersLeft = 0;
+
+    std::thread              walker;
+    std::vector<std::thread> probers;
+    std::atomic<bool>        running{ false };
+    std::atomic<bool>        cancel{ false };
+    std::atomic<uint64_t>    revision{ 1 };
+    std::atomic<size_t>      found{ 0 };
+    std::atomic<size_t>      probed{ 0 };
+};
+
+extern MidiLibrary g_MidiLibrary;
@@ -0,0 +1,142 @@
+// midi_watch.hpp — Watch mode: reparse only the MTrk chunks an edit touched
+#pragma once
+
+#include "midi_event.hpp"
+#include "visualizer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Composers iterating on a black MIDI save the same file again and again.
+// With watch mode on, the player polls the file's size and write time; once a
+// change has settled it re-reads the file on a worker thread, hashes every
+// MTrk chunk and compares the hashes with the ones recorded by the last load.
+// Only the changed chunks are parsed again:
+//
+//   - their channel events leave the merged event list and the new ones are
+//     merged in (both sides are already sorted, so no global sort),
+//   - the note lists of their visual tracks are replaced,
+//   - everything else stays: other tracks, the tempo map, the SysEx arena,
+//     the playback position and the painted chunks outside the edit.
+//
+// The worker also collects the changed tracks' current events from the
+// merged list (one scan, off the main thread) and diffs them with the new
+// ones: outside the ticks [editLo, editHi] nothing changed. The apply runs on
+// the main thread with playback held and rebuilds only that window of the
+// merged list, the filtered stream and the CC lanes; the sorted tick arrays
+// are spliced over the range of the changed notes, the NPS grid is updated
+// per cell, and the player keeps its tempo index. What is left grows with
+// the edit: the window's events, the changed tracks' notes and events (the
+// filter recompiles just those), plus one memmove of each list's tail when
+// the event count changes. The watch status line reports the apply time.
+//
+// A visual track is the loader's 8-bit track index, so chunks t and t + 256
+// share one; every chunk of an affected visual track is parsed again.
+// Anything that moves song-wide state is a full reload instead: a different
+// header or chunk layout, format 0, or a changed chunk that holds (or held)
+// tempo, time-signature or SysEx events.
+
+// One chunk of the file, as recorded by the last load
+struct SmfChunk {
+    enum : uint8_t {
+        kTrack  = 1,   // MTrk (other chunk types are skipped by the loader)
+        kGlobal = 2,   // tempo / time signature / SysEx: not track-local
+        kCC     = 4,   // CC or pitch bend: feeds the CC lanes
+    };
+    uint64_t hash  = 0;
+    uint8_t  flags = 0;
+};
+
+struct SmfIndex {
+    uint32_t headerLen  = 0;
+    uint16_t format     = 0;
+    uint16_t trackCount = 0;        // header's ntrks: the number of visual tracks
+    uint16_t division   = 0;
+    std::vector<SmfChunk> chunks;   // one per chunk read, in file order
+
+    bool SameLayout(const SmfIndex& o) const {
+        return headerLen == o.headerLen && format == o.format && trackCount == o.trackCount &&
+               division == o.division && chunks.size() == o.chunks.size();
+    }
+};
+
+struct TrackReload {
+    enum class Result : uint8_t { Unchanged, Tracks, Full, Failed };
+
+    Result      result = Result::Unchanged;
+    std::string why;                                 // Full / Failed: for the log
+    std::vector<uint16_t>               chunks;      // chunks whose bytes changed
+    std::vector<uint16_t>               tracks;      // visual tracks rebuilt, ascending
+    std::vector<std::vector<NoteEvent>> notes;       // per entry of `tracks`, sorted; the OLD notes after Apply
+    std::vector<MidiEvent>              events;      // channel events of those tracks, sorted (old order outside the edit)
+    std::vector<MidiEvent>              oldEvents;   // their events before the edit, in list order
+    uint32_t    editLo      = 1;                     // ticks whose events differ;
+    uint32_t    editHi      = 0;                     //   none when editLo > editHi
+    bool        ccTouched   = false;                 // CC lanes need a splice
+    uint64_t    bytesParsed = 0;
+    double      prepareMs   = 0.0;
+    SmfIndex    index;                               // committed by Apply
+};
+
+// load.cpp. Worker thread: reads `filename` and diffs it against the index of
+// the last load; parses the changed tracks into `out` and finds the edit
+// window. Reads the merged list (nothing writes it while a prepare runs) and
+// writes no shared state.
+void PrepareTrackReload(const std::string& filename, TrackReload& out);
+
+// load.cpp. Main thread, with playback parked and nothing reading `tracks`:
+// splices a Result::Tracks reload into the event list (its edit window only)
+// and `tracks`. The old notes of r.tracks are swapped into r.notes (callers
+// diff them against the new ones); r.events / r.oldEvents stay for the event
+// filter. When r.ccTouched, `cc` receives the CC records of the edit window
+// for CCLaneIndex::Splice(); otherwise it is left empty.
+void ApplyTrackReload(TrackReload& r, std::vector<OptimizedTrackData>& tracks,
+                      uint64_t& totalNoteCount, std::vector<CCEvent>& cc);
+
+// ── Watcher ───────────────────────────────────────────────────────────────────
+// Poll() is cheap: one stat every kPollSec. A change is acted on only once two
+// polls in a row see the same size and write time, so a save in progress is
+// not read half-written.
+class MidiFileWatch {
+public:
+    static constexpr double kPollSec = 0.5;
+
+    void SetEnabled(bool on) { enabled = on; }
+    bool Enabled() const     { return enabled; }
+
+    void Arm(const std::string& path);   // after a load: the file as it is now is the baseline
+    void Disarm();                       // joins a prepare still running
+
+    // Main thread, once per frame (`now` in seconds). True when a prepared
+    // reload waits in Pending(); call Done() once it is applied or dropped.
+    bool         Poll(double now);
+    TrackReload& Pending() { return pending; }
+    void         Done();
+
+    const std::string& LastResult() const          { return lastResult; }
+    void               SetLastResult(std::string s) { lastResult = std::move(s); }
+
+private:
+    struct Stamp {
+        uint64_t size  = 0;
+        int64_t  mtime = 0;
+        bool     ok    = false;
+        bool operator==(const Stamp&) const = default;
+    };
+    static Stamp StatFile(const std::string& path);
+
+    bool              enabled   = false;
+    std::string       file;
+    Stamp             base, seen;
+    double            nextPoll  = 0.0;
+    bool              preparing = false;
+    std::atomic<bool> ready{ false };
+    std::thread       worker;
+    TrackReload       pending;
+    std::string       lastResult;
+};
+
+extern MidiFileWatch g_MidiWatch;
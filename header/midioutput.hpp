@@ -1,17 +1,32 @@
 #pragma once
 #include "visualizer.hpp"
 #include "midi_timing_alt.hpp"
+#include "event_filter.hpp"
+#include "burst_spread.hpp"
+#include "bass_backend.hpp"   // DispatchSink
+#include <array>
+#include <utility>
 #include <vector>
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <memory>
 
 class MidiOutputEngine {
 public:
     MidiOutputEngine();
     ~MidiOutputEngine();
-    void Start(const std::vector<MidiEvent>& events, int ppq, uint32_t initialTempo);
+    void Start(std::shared_ptr<const FilteredStream> stream);
     void Stop();
+    // Swap in a recompiled stream (event filter change) keeping the position.
+    void Rebind(std::shared_ptr<const FilteredStream> stream);
+    // Park the worker (and a running pre-render decode) so the loader's event
+    // list can be edited in place (watch mode). The edit must leave the tempo
+    // events alone: the next Rebind() relocates the tempo index instead of
+    // rebuilding it, and restarts the worker at the held position, even with
+    // the same stream.
+    void Hold();
+    uint64_t GetStreamGeneration() const;
     void Pause();
     void Resume();
     void Seek(int64_t microsecondOffset);
@@ -30,6 +45,16 @@ public:
 	uint64_t GetLoopEndTick()   const;
     void ToggleAntiSlowdown(bool enabled);
     bool IsAntiSlowdownEnabled() const;
+    // Largest lateness (real-time µs an event went out after its scheduled
+    // moment) since the previous call; the frame stats take it once a frame.
+    uint32_t TakeDispatchLatenessMicros();
+
+    // Same-tick burst spreading (burst_spread.hpp): a run of at least
+    // `minEvents` events on one tick is paced across `windowMicros` of real
+    // time instead of being sent in one go. 0 µs = off (the default).
+    void     SetBurstSpread(uint32_t windowMicros, uint32_t minEvents);
+    uint32_t GetBurstSpreadMicros() const;
+    uint32_t GetBurstSpreadMinEvents() const;
 
     // ---------------------------------------------------------------
     // Lag Simulator — limits MIDI sends to N events/sec (0 = off).
@@ -45,9 +70,52 @@ public:
 
 private:
     void PlaybackThread();
+
+    // ---- Specialised dispatch loops ---------------------------------------
+    // The settings below change only on user action. They are snapshotted
+    // once per batch when configEpoch (bumped by the loop / lag-simulator
+    // setters), the mute epoch, the sink or the BASS mode changed. A
+    // DispatchBatch instantiation is chosen for them, so the per-event loop
+    // does no atomic loads; Pause / Stop are polled only every
+    // kPublishStride events. With mutes active, note-ons still test one
+    // relaxed bit word each.
+    //
+    // A note-on dropped by a mute is counted per (track, channel, key) and
+    // its note-off is dropped too, also when the mute was lifted in between:
+    // the synth never saw the note, so the off would be unmatched. The check
+    // runs in every instantiation while mutedOnsHeld is non-zero.
+    struct DispatchConfig {
+        uint32_t     epoch        = 0;
+        uint64_t     audibleEpoch = 0;
+        DispatchSink sink         = DispatchSink::Direct;
+        bool         bassActive   = false;   // BASS RT / pre-render: lag simulator off
+        bool         loopGate     = false;   // A/B loop points set and looping
+        uint64_t     loopEnd      = UINT64_MAX;
+        bool         lagSim       = false;
+        bool         mutes        = false;   // any track / channel muted
+    };
+    struct BatchState {
+        uint64_t nowVirtual  = 0;     // virtual µs the batch dispatches up to
+        double   burstWindow = 0.0;   // virtual µs, 0 = no burst spreading
+        uint32_t burstMin    = 0;
+        double   waitMicros  = 0.0;   // out: virtual µs until the next event is due
+        double   lateMicros  = 0.0;   // out: worst lateness in the batch
+    };
+    using BatchFn = void (MidiOutputEngine::*)(BatchState&);
+    static constexpr uint32_t kPublishStride = 64;   // events between state publishes
+
+    template <bool LoopGate, bool LagSim, bool Mutes, DispatchSink Sink>
+    void DispatchBatch(BatchState& b);
+    template <size_t... I>
+    static constexpr std::array<BatchFn, sizeof...(I)> MakeBatchTable(std::index_sequence<I...>);
+    void RefreshDispatchConfig();
+    bool EnterDispatch();
+
     void SilenceAllChannels();
     void SilenceAllChannelsWithoutCC();
     void BuildTempoIndex();
+    void RelocateTempoIndex();   // same tempo map, events moved (after Hold)
+    uint64_t SongMicros() const;   // length of *eventList at speed 1 (pre-render)
 
     // Built once in Start(). Each entry marks a tempo change point.
     struct TempoSegment {
@@ -63,6 +131,10 @@ private:
     std::atomic<bool> isPaused;
     std::atomic<bool> isFinished;
     std::atomic<bool> isLooping;
+    std::atomic<bool> dispatching{false};   // worker inside a batch / loop-back; Pause() waits it out
+    bool held       = false;   // Hold(): worker parked until Rebind()
+    bool heldPaused = false;
+    std::shared_ptr<const FilteredStream> stream;   // keeps *eventList alive
     const std::vector<MidiEvent>* eventList;
     int currentPpq;
     std::atomic<uint64_t> currentVisualizerTick;
@@ -82,6 +154,32 @@ private:
     std::atomic<bool> antiSlowdownEnabled{false};
 	bool activeNotes[16][128] = {};
 
+    // Muted note-ons awaiting their off, index (track << 11) | (ch << 7) | key.
+    // PlaybackThread-exclusive: a new worker and the loop-backs clear it
+    // directly, Seek() asks for it through mutedOnsReset.
+    static constexpr size_t kMutedOnSlots = 256 * 16 * 128;
+    std::vector<uint16_t> mutedOns;
+    uint32_t              mutedOnsHeld = 0;
+    std::atomic<bool>     mutedOnsReset{false};
+    static size_t MutedOnSlot(const MidiEvent& e) {
+        return ((size_t)e.Track() << 11) | ((size_t)e.Channel() << 7) | (e.D1() & 0x7F);
+    }
+    void HoldMutedOn(const MidiEvent& e) {
+        if (mutedOns.empty()) mutedOns.assign(kMutedOnSlots, 0);
+        uint16_t& n = mutedOns[MutedOnSlot(e)];
+        if (n == UINT16_MAX) return;
+        ++n;
+        ++mutedOnsHeld;
+    }
+    bool TakeMutedOn(const MidiEvent& e) {
+        uint16_t& n = mutedOns[MutedOnSlot(e)];
+        if (!n) return false;
+        --n;
+        --mutedOnsHeld;
+        return true;
+    }
+    void ClearMutedOns();
+
     // ---- Lag simulator state ------------------------------------------------
     // simulateEventsPerSecond: int64_t so it can hold up to 134 217 728 (2^27)
     // without overflow.  0 = disabled.  UI writes, PlaybackThread reads.
@@ -91,6 +189,18 @@ private:
     double   simTokens{0.0};
     std::chrono::steady_clock::time_point simLastRefill;
 	std::atomic<bool> simLagSmooth{false};
+
+    std::atomic<uint32_t> dispatchLateMaxUs{0};
+
+    // Burst spreading — UI writes the settings, the spreader's run cache is
+    // PlaybackThread-exclusive
+    std::atomic<uint32_t> burstWindowUs{0};
+    std::atomic<uint32_t> burstMinEvents{BurstSpreader::kDefaultMinEvents};
+    BurstSpreader         burstSpread;
+
+    std::atomic<uint32_t> configEpoch{0};
+    DispatchConfig        dispatchCfg;        // PlaybackThread-exclusive
+    BatchFn               batchFn = nullptr;
 };
 
 // ---------------------------------------------------------------
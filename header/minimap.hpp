@@ -0,0 +1,68 @@
+// minimap.hpp — Whole-song overview strip, rasterized in parallel off the render thread
+#pragma once
+
+#include "raylib.h"
+#include "visualizer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A downsampled piano roll of the entire song (time on x, key on y) coloured
+// by track, drawn as a single texture.
+//
+//   Build:   BuildAsync() snapshots the palette, then a builder thread fans the
+//            tracks out over hardware_concurrency() workers. Each worker owns
+//            a private ident plane (track << 4 | channel, + 1), so there is no
+//            sharing; planes are merged with max(), which gives the same "top
+//            track wins" layering as the roll. Cost O(notes / cores + W·H·cores).
+//   Upload:  Poll() on the render thread moves a finished image into the
+//            texture. Nothing else runs per frame besides Draw().
+//   Rebuild: call BuildAsync() again (e.g. palette change); a build that is
+//            still running is cancelled and its result discarded.
+class SongMinimap {
+public:
+    static constexpr int kWidth  = 1024;
+    static constexpr int kHeight = 128;   // one row per key
+
+    using TickToSeconds = double (*)(uint64_t tick);
+    using TrackColorFn  = Color (*)(int track, int channel);
+
+    ~SongMinimap() { Reset(); }
+
+    // `tracks` must stay alive and unchanged until Reset() or the next build.
+    void BuildAsync(const std::vector<OptimizedTrackData>& tracks, TrackColorFn color,
+                    TickToSeconds toSeconds, double durationSec);
+    void Reset();          // cancel, join, free the texture
+    void Cancel();         // cancel and join a running build; the texture stays
+    void Poll();           // render thread: upload a finished build
+
+    bool IsReady() const { return tex.id != 0; }
+    bool IsBuilding() const { return building.load(std::memory_order_acquire); }
+    double LastBuildMs() const { return buildMs; }
+
+    // Strip plus a playhead at `fraction` (0..1 of the song duration)
+    void Draw(Rectangle dst, float fraction) const;
+    // Fraction of the song under `point`, or -1 when outside `dst`
+    static float HitTest(Rectangle dst, Vector2 point);
+
+private:
+    void BuildWorker(uint64_t gen, const std::vector<OptimizedTrackData>* tracks,
+                     std::vector<uint32_t> palette, TickToSeconds toSeconds, double durationSec);
+    void Join();
+
+    std::thread           builder;
+    std::atomic<bool>     cancel{ false };
+    std::atomic<bool>     building{ false };
+    std::atomic<uint64_t> generation{ 0 };
+
+    std::mutex            resultMutex;
+    std::vector<uint32_t> result;          // RGBA8, kWidth * kHeight
+    uint64_t              resultGen = 0;   // 0 = nothing pending
+    double                resultMs  = 0.0;
+
+    Texture2D tex = { 0 };
+    double    buildMs = 0.0;
+};
@@ -0,0 +1,51 @@
+// note_time_columns.hpp — Per-note start / end times for time-domain scrolling
+#pragma once
+
+#include "visualizer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// One row of the tempo map: from `tick` on, each tick lasts `usPerTick`.
+// accumSec = song time at `tick`.
+struct TempoSeg {
+    uint32_t tick;
+    double   accumSec;
+    double   usPerTick;
+};
+
+// Time-domain scroll mode works in "time units" (fixed point, kUnitsPerSecond
+// per second) instead of ticks, so a note's on-screen width follows real time
+// whatever the tempo does. The columns are parallel to tracks[t].notes, and
+// the tick → time map is monotone, so they stay sorted by start like the
+// notes themselves: the painter's lower_bound / window walks work unchanged.
+//
+// uint32 at 0.1 ms resolution covers ~119 hours of song.
+class NoteTimeColumns {
+public:
+    static constexpr double kUnitsPerSecond = 10000.0;
+
+    // Parallel over tracks. Starts are sorted, so each worker walks the tempo
+    // map with a cursor that only moves forward; ends search from there.
+    void Build(const std::vector<OptimizedTrackData>& tracks, const std::vector<TempoSeg>& tempo);
+    // Same tracks and tempo map, only the notes of `changed` were replaced (watch mode)
+    void Rebuild(const std::vector<OptimizedTrackData>& tracks, const std::vector<uint16_t>& changed);
+    void Clear();
+    bool IsBuiltFor(const std::vector<OptimizedTrackData>& tracks) const {
+        return source == &tracks && starts.size() == tracks.size();
+    }
+
+    const uint32_t* Starts(size_t track) const { return starts[track].data(); }
+    const uint32_t* Ends(size_t track)   const { return ends[track].data(); }
+
+    // Whole-song mapping (binary search over the tempo map)
+    uint64_t TickToUnits(uint64_t tick) const;
+    uint64_t UnitsToTick(uint64_t units) const;
+
+private:
+    void FillTrack(const NoteList& notes, size_t t);
+
+    const std::vector<OptimizedTrackData>* source = nullptr;
+    std::vector<TempoSeg>                  segs;
+    std::vector<std::vector<uint32_t>>     starts, ends;
+};
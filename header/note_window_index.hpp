@@ -0,0 +1,65 @@
+// note_window_index.hpp — Per-track index for "which notes overlap [L, R)"
+#pragma once
+
+#include "visualizer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Notes are sorted by startTick, but a long note can start far before the
+// window and still overlap it, so a lower_bound on startTick alone misses it.
+// Per track we keep, for every block of kBlock notes:
+//   blockMaxEnd  — max endTick inside the block (skip blocks that ended before L)
+//   prefixMaxEnd — max endTick over blocks 0..b; non-decreasing, so the first
+//                  block that can overlap L is one binary search away.
+// A window query is two binary searches plus a walk over the candidate blocks.
+class NoteWindowIndex {
+public:
+    static constexpr uint32_t kBlock = 64;
+
+    void Build(const std::vector<OptimizedTrackData>& tracks);
+    // Same tracks, only the notes of `changed` were replaced (watch mode)
+    void Rebuild(const std::vector<OptimizedTrackData>& tracks, const std::vector<uint16_t>& changed);
+    void Clear();
+    bool IsBuiltFor(const std::vector<OptimizedTrackData>& tracks) const {
+        return source == &tracks && perTrack.size() == tracks.size();
+    }
+
+    // f(const NoteEvent&) for every note of track t with start < R && end > L,
+    // in startTick order.
+    template <class F>
+    void ForEachInWindow(const std::vector<OptimizedTrackData>& tracks, size_t t,
+                         uint32_t L, uint32_t R, F&& f) const
+    {
+        const auto& notes = tracks[t].notes;
+        const auto& ix    = perTrack[t];
+        if (notes.empty() || R <= L) return;
+
+        // First block whose prefix max end reaches past L
+        const size_t b0 = (size_t)(std::upper_bound(ix.prefixMaxEnd.begin(), ix.prefixMaxEnd.end(), L)
+                                   - ix.prefixMaxEnd.begin());
+        // One past the last note that starts before R
+        const size_t iEnd = (size_t)(std::lower_bound(notes.begin(), notes.end(), R,
+            [](const NoteEvent& n, uint32_t v) { return n.startTick < v; }) - notes.begin());
+
+        for (size_t b = b0; b * kBlock < iEnd; ++b) {
+            if (ix.blockMaxEnd[b] <= L) continue;
+            const size_t e = std::min(iEnd, (b + 1) * (size_t)kBlock);
+            for (size_t i = b * kBlock; i < e; ++i) {
+                const NoteEvent& n = notes[i];
+                const uint32_t end = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
+                if (end > L) f(n);
+            }
+        }
+    }
+
+private:
+    struct TrackIndex {
+        std::vector<uint32_t> blockMaxEnd;
+        std::vector<uint32_t> prefixMaxEnd;
+    };
+    static void BuildTrack(const NoteList& notes, TrackIndex& ix);
+    const std::vector<OptimizedTrackData>* source = nullptr;
+    std::vector<TrackIndex>                perTrack;
+};
@@ -0,0 +1,50 @@
+// particles.hpp — SoA background particle pool, SIMD update, one instanced draw
+#pragma once
+
+#include "raylib.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Background particles drift right → left and respawn past the right edge.
+// Positions live in separate x / y / speed / size arrays so the per-frame
+// update is a straight 4-wide SSE pass (x -= step * speed, plus the off-screen
+// test as a mask); only lanes that left the screen take the scalar respawn.
+// Random numbers come from a xorshift32, not rand().
+//
+// Drawing uploads the x, y and size arrays as-is as three instance streams
+// and issues ONE instanced draw of a quad, with the circle cut out in the
+// fragment shader, so the count is bounded by kMaxParticles rather than by
+// per-call overhead.
+// Without GL 3.3 / GLES 3.0 instancing it falls back to DrawCircleV for the
+// first kFallbackMax particles, which was the old cap.
+class BgParticleField {
+public:
+    static constexpr int kMaxParticles = 1 << 18;
+    static constexpr int kFallbackMax  = 512;
+
+    bool Available();   // lazily compiles the shader / creates buffers
+    void Unload();      // call while the GL context is alive
+
+    // Grows / shrinks the pool to `count` (new particles anywhere on screen)
+    // and moves every particle left by `step * its speed factor` pixels.
+    void Update(int count, float step, float radius, int screenW, int screenH);
+    void Draw(float radius, Color color);
+
+    size_t Count() const { return x.size(); }
+
+private:
+    void     Spawn(size_t i, bool randomX, int screenW, int screenH);
+    float    NextUnit();    // [0, 1)
+    bool     EnsureCapacity(size_t count);
+
+    std::vector<float> x, y, speed, size;   // speed / size: factors in [0.5, 1.5)
+    uint32_t rng = 0x9E3779B9u;
+
+    bool         tried = false, ok = false;
+    unsigned int shader = 0, vao = 0, quadVbo = 0, xVbo = 0, yVbo = 0, sizeVbo = 0;
+    size_t       capacity = 0;
+    int          locPos = 0, locX = 1, locY = 2, locSize = 3;
+    int          locScreen = -1, locScale = -1, locRadius = -1, locColor = -1;
+};
@@ -0,0 +1,44 @@
+// shared_mapping.hpp — Named shared-memory region (Win32 file mapping / POSIX shm)
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Kept free of raylib and <windows.h> so either side can include it.
+//
+// Names are plain identifiers ("jidi.main"); the platform prefix is added
+// here ("Local\" on Windows, "/" for shm_open). Create() fails if the name
+// already exists, so a stale region is never silently reused with the wrong
+// size. CreateOrOpen() is for fixed-layout blocks that any process may create
+// first. A creator's Unlink() removes the name; processes that still have it
+// mapped keep their view until Close().
+class SharedMapping {
+public:
+    SharedMapping() = default;
+    ~SharedMapping() { Close(); }
+    SharedMapping(const SharedMapping&)            = delete;
+    SharedMapping& operator=(const SharedMapping&) = delete;
+
+    bool Create(const std::string& name, size_t bytes);
+    bool CreateOrOpen(const std::string& name, size_t bytes, bool* created = nullptr);
+    bool Open(const std::string& name, bool readOnly);
+    void Unlink();     // no-op on Windows: the object dies with its last handle
+    void Close();
+
+    void*       Data()       { return ptr; }
+    const void* Data() const { return ptr; }
+    size_t      Size() const { return bytes; }
+    bool        IsOpen() const { return ptr != nullptr; }
+
+private:
+    bool Map(bool readOnly);
+
+    std::string name;
+    void*       ptr    = nullptr;
+    size_t      bytes  = 0;
+#ifdef _WIN32
+    void*       handle = nullptr;
+#else
+    int         fd     = -1;
+#endif
+};
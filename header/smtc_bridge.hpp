@@ -1,5 +1,4 @@
 #pragma once
-#ifdef _WIN32
 
 #include <string>
 #include <cstdint>
@@ -13,6 +12,7 @@ struct SmtcCallbacks {
     std::function<void(int64_t)>  onSeek;  // absolute microseconds
 };
 
+#ifdef _WIN32
 class SmtcBridge {
 public:
     SmtcBridge();
@@ -34,6 +34,16 @@ private:
     Impl* impl = nullptr;
 };
 
-extern SmtcBridge g_Smtc;
+#else
+// No system media transport controls here: the calls are no-ops
+class SmtcBridge {
+public:
+    bool Init(SmtcCallbacks) { return false; }
+    void UpdatePlaybackState(bool, bool, bool) {}
+    void UpdatePosition(uint64_t, uint64_t) {}
+    void UpdateMetadata(const std::string&, const std::string&) {}
+    void Shutdown() {}
+};
+#endif // _WIN32
 
-#endif // _WIN32
\ No newline at end of file
+extern SmtcBridge g_Smtc;
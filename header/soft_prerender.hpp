@@ -0,0 +1,87 @@
+// soft_prerender.hpp — Built-in synth decoder for the pre-render path, with seek snapshots
+#pragma once
+
+#include "event_filter.hpp"
+#include "soft_synth.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Renders a FilteredStream through SoftSynth into interleaved stereo float PCM,
+// the same way the BASS_MIDI file decode stream does for soundfonts.
+//
+// Seeking a decode stream normally means replaying the song from the start.
+// This decoder instead snapshots the complete synth state (plus its event and
+// tempo cursor) every kSnapshotSec of rendered audio. A seek restores the
+// nearest snapshot at or before the target and renders only the remaining
+// delta:
+//
+//   target inside the rendered range → restore + render < kSnapshotSec (exact,
+//                                      cost independent of song position)
+//   target past it                   → restore the last snapshot, replay the
+//                                      controller / program / SysEx events up
+//                                      to target - kPreRollSec without audio,
+//                                      then render the pre-roll (notes older
+//                                      than the pre-roll are not re-struck)
+//
+// The second case renders no more audio than the first, but its event replay
+// grows with the distance from the last snapshot. Its output is approximate,
+// so no snapshots are taken after it until a seek restores an exact one;
+// every stored snapshot is bit-identical to contiguous rendering from frame 0.
+// Snapshots only extend the rendered frontier, so the list stays sorted.
+// Not thread-safe: owned by the pre-render decode thread.
+class SoftPreRenderDecoder {
+public:
+    static constexpr double kSnapshotSec = 2.0;
+    static constexpr double kPreRollSec  = 1.0;
+    static constexpr double kTailSec     = 3.0;   // release tails after the last event
+
+    SoftPreRenderDecoder(std::shared_ptr<const FilteredStream> stream, float speed,
+                         uint32_t sampleRate, int maxVoices);
+
+    // Returns the number of frames written; 0 once the song and its tail are done.
+    uint32_t Read(float* stereo, uint32_t frames);
+    // Returns the frame actually reached (clamped to the length).
+    uint64_t Seek(uint64_t frame);
+
+    uint64_t Position() const { return pos; }
+    uint64_t Length()   const { return length; }
+    size_t   SnapshotCount() const { return snapshots.size(); }
+    size_t   SnapshotBytes() const { return snapshotBytes; }
+
+private:
+    // Where event playback stands: the next event to apply and the tempo
+    // segment used to place it in frames.
+    struct Cursor {
+        size_t   event         = 0;
+        uint32_t tempoTick     = 0;
+        double   tempoFrame    = 0.0;
+        double   framesPerTick = 0.0;
+    };
+    struct Snapshot {
+        uint64_t         frame = 0;
+        Cursor           cursor;
+        SoftSynth::State synth;
+    };
+
+    uint64_t FrameOf(uint32_t tick) const;
+    void     Apply(const MidiEvent& ev, bool notes);
+    void     ApplyDue(bool notes);
+    void     Restore(const Snapshot& s);
+    void     RenderDiscard(uint64_t toFrame);
+
+    std::shared_ptr<const FilteredStream> stream;
+    const std::vector<MidiEvent>&         events;
+    SoftSynth                             synth;
+    uint32_t                              sampleRate;
+    float                                 speed;
+    Cursor                                cur;
+    uint64_t                              pos    = 0;
+    uint64_t                              length = 0;
+    uint64_t                              snapshotFrames;
+    bool                                  exact  = true;   // false after an approximate seek
+    std::vector<Snapshot>                 snapshots;
+    size_t                                snapshotBytes = 0;
+    std::vector<float>                    scratch;
+};
@@ -0,0 +1,88 @@
+// soft_synth.hpp — Built-in software synthesizer (no BASS / soundfont required)
+#pragma once
+
+#include "synth_backend.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Simple polyphonic oscillator synth. It exists so the RT sharding layer and
+// the tooling under src/Test can be exercised without BASS or a soundfont, and
+// as a fallback backend when no soundfont is loaded.
+//
+//   Program  0-31  → triangle     Program 64-95  → square
+//   Program 32-63  → saw          Program 96-127 → sine
+//   Channel 10 (index 9) → short noise burst per hit
+//
+// Honoured controllers: 7 volume, 10 pan, 11 expression, 64 sustain,
+// 120/123 all sound / notes off, 121 reset. Pitch bend range is ±2 semitones.
+// SysEx: GM System On, GS Reset and XG System On reset every channel.
+//
+// The whole state is plain data, so it can be captured and restored exactly
+// (seek snapshots in the pre-render decoder, soft_prerender.hpp).
+class SoftSynth final : public SynthBackend {
+public:
+    struct State;
+
+    explicit SoftSynth(uint32_t sampleRate = 48000, int maxVoices = 256);
+
+    void        SendShort(uint32_t msg) override;
+    void        SendLong(const uint8_t* data, uint32_t len) override;
+    void        Render(float* stereo, uint32_t frames) override;
+    void        Reset() override;
+    int         ActiveVoices() const override { return activeCount; }
+    const char* Name() const override { return "Built-in"; }
+
+    // Only sounding voices are copied, so a snapshot of a quiet passage is small.
+    // Restoring then rendering gives bit-identical output to the captured run.
+    void        Capture(State& out) const;
+    void        Restore(const State& in);
+
+private:
+    struct Voice {
+        float    phase    = 0.0f;
+        float    inc      = 0.0f;   // phase increment per sample (cycles)
+        float    env      = 0.0f;
+        float    gain     = 0.0f;   // velocity gain, channel gain applied at render
+        uint32_t age      = 0;
+        uint32_t noise    = 0;      // LCG state for the drum channel
+        uint8_t  channel  = 0;
+        uint8_t  key      = 0;
+        bool     active   = false;
+        bool     held     = false;  // key still down
+        bool     releasing= false;
+    };
+
+    struct Channel {
+        float   volume     = 100.0f / 127.0f;
+        float   expression = 1.0f;
+        float   pan        = 0.5f;
+        float   bend       = 0.0f;  // semitones
+        bool    sustain    = false;
+        uint8_t program    = 0;
+    };
+
+    void  NoteOn(uint8_t ch, uint8_t key, uint8_t vel);
+    void  NoteOff(uint8_t ch, uint8_t key);
+    void  ReleaseSustained(uint8_t ch);
+    void  RetuneChannel(uint8_t ch);
+    float KeyIncrement(uint8_t ch, uint8_t key) const;
+
+    std::vector<Voice> voices;
+    Channel            channels[16];
+    uint32_t           sampleRate;
+    uint32_t           ageCounter  = 0;
+    int                activeCount = 0;
+    float              decayMul;    // per-sample sustain-phase decay
+    float              releaseMul;  // per-sample release decay
+};
+
+struct SoftSynth::State {
+    std::vector<Voice>    voices;   // active voices only
+    std::vector<uint32_t> slots;    // their slot indices (allocation and mix order)
+    Channel            channels[16];
+    uint32_t           ageCounter = 0;
+
+    size_t Bytes() const { return sizeof(State) + voices.size() * (sizeof(Voice) + sizeof(uint32_t)); }
+};
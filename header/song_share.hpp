@@ -0,0 +1,115 @@
+// song_share.hpp — Publish a loaded song and its transport to other windows via shared memory
+#pragma once
+
+#include "shared_mapping.hpp"
+#include "visualizer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One window parses the MIDI (the primary, `--share <name>`); any number of
+// secondaries (`--attach <name>`) map the result read-only and render their
+// own views — other monitors, other viewer types, other zoom levels — from
+// the same copy of the notes.
+//
+//   "<name>"           control block, read/write for everyone: the song
+//                      generation, the transport (seqlock) and a small request
+//                      ring secondaries use to pause / seek the primary
+//   "<name>.song.<g>"  one immutable region per published song:
+//                      header | track index | notes | tempo | CC
+//
+// The control block is never unlinked, so attached windows keep waiting
+// across a primary restart.
+//
+// After Publish() the primary's own NoteLists view the region too and its
+// parsed vectors are freed, so N windows hold one copy of the notes (12 B per
+// note). The indexes derived from them are still built per window: the
+// sorted start / end ticks and the time columns come to 16 B per note, the
+// window index to 8 B per 64 notes. A secondary therefore costs about 16 B
+// per note instead of 28, plus the sorts at attach. Tempo and CC events are
+// small and each window copies them as well.
+//
+// Sync: the primary writes {tick, tempo, speed, flags} with the steady-clock
+// time it read them at; secondaries extrapolate to their own present. The
+// steady clock is system-wide on both platforms (QPC / CLOCK_MONOTONIC), so
+// every window shows the tick for the moment it presents, not the moment the
+// primary last sampled.
+
+struct SharedSongInfo {
+    std::string file;
+    uint64_t    noteTotal          = 0;
+    int         ppq                = 480;
+    int         initialTempo       = 500000;
+    uint16_t    timeSigNumerator   = 4;
+    uint16_t    timeSigDenominator = 4;
+    uint32_t    lastEventTick      = 0;
+};
+
+struct SharedTransport {
+    uint64_t tick     = 0;
+    uint32_t tempo    = 500000;
+    float    speed    = 1.0f;
+    bool     paused   = true;
+    bool     finished = false;
+    bool     waiting  = true;    // primary has not started playback yet
+};
+
+enum class ShareRequest : uint32_t { None = 0, TogglePause, Seek, SeekAbsolute };
+
+struct ShareCommand {
+    ShareRequest type   = ShareRequest::None;
+    int64_t      micros = 0;     // Seek: offset; SeekAbsolute: target
+};
+
+class SongShare {
+public:
+    ~SongShare() { Shutdown(); }
+
+    bool StartPrimary(const std::string& name);
+    bool StartSecondary(const std::string& name);
+    void Shutdown();
+
+    bool IsPrimary()   const { return role == Role::Primary; }
+    bool IsSecondary() const { return role == Role::Secondary; }
+    const std::string& Name() const { return name; }
+    size_t MappedBytes() const { return song.Size(); }
+
+    // ── Primary ──
+    // Copies the song into a new region and points `tracks` at it.
+    bool Publish(std::vector<OptimizedTrackData>& tracks, const std::vector<TempoEvent>& tempo,
+                 const std::vector<CCEvent>& cc, const SharedSongInfo& info);
+    // Call once nothing reads the tracks any more (they view the region).
+    void Unpublish();
+    void WriteTransport(const SharedTransport& t);
+    bool PollCommand(ShareCommand& out);
+
+    // ── Secondary ──
+    bool SongWaiting() const;    // a song is up that this window has not attached, left or failed to attach
+    bool Attach(std::vector<OptimizedTrackData>& tracks, std::vector<TempoEvent>& tempo,
+                std::vector<CCEvent>& cc, SharedSongInfo& info);
+    bool IsAttached() const { return attachedGen != 0; }
+    bool SongGone() const;       // the attached song was unpublished or replaced
+    void Detach();               // after the tracks have been cleared
+    SharedTransport ReadTransport() const;   // extrapolated to now
+    void SendCommand(const ShareCommand& cmd);
+
+private:
+    enum class Role : uint8_t { None, Primary, Secondary };
+    struct Control;
+
+    bool     OpenControl(const std::string& name);
+    Control* Ctl() const { return (Control*)control.Data(); }
+
+    Role          role        = Role::None;
+    std::string   name;
+    SharedMapping control;
+    SharedMapping song;
+    uint64_t      publishedGen = 0;
+    uint64_t      attachedGen  = 0;
+    uint64_t      leftGen      = 0;
+    uint64_t      requestTail  = 0;
+};
+
+extern SongShare g_SongShare;
@@ -0,0 +1,83 @@
+// startup_tasks.hpp — Deferred startup work with a status line and a timeline report
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Everything that used to block the first frame (KDMAPI, BASS init, soundfont
+// loading, background-image decode, PFA palette parse) is registered here and
+// runs on its own thread once its dependencies have finished. Work that needs
+// the GL context is split off into an `onMain` continuation, which the render
+// thread runs from PumpMain().
+//
+// Phases measured on the main thread (window open, first frame) are recorded
+// with Mark() so PrintTimeline() shows the whole startup on one clock.
+class StartupTasks {
+public:
+    using Fn = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    StartupTasks() : origin(Clock::now()) {}
+    // Static destruction may run after CloseWindow(), so no continuation runs
+    // here: queued tasks are cancelled and the threads are joined.
+    ~StartupTasks() { Cancel(); }
+
+    // Register before Start(). `deps` are ids returned by earlier Add() calls.
+    size_t Add(const char* name, Fn work, Fn onMain = {}, std::vector<size_t> deps = {});
+    void   Start();
+
+    // Render thread, once per frame: run continuations of finished tasks.
+    // Prints the timeline once everything is done.
+    void PumpMain();
+    // Block until every task (and its continuation) is done. Main thread only.
+    void Wait();
+    // Drop pending continuations, skip tasks that have not started, wait for
+    // running work to return and join every thread.
+    void Cancel();
+
+    bool IsDone(size_t id) const;
+    bool AllDone() const { return remaining.load(std::memory_order_acquire) == 0; }
+    // Running tasks' names, or "" once everything is done
+    std::string StatusLine() const;
+    // Worker-side progress detail, e.g. "2/5 fonts" (shown in the status line)
+    void SetDetail(size_t id, std::string detail);
+
+    void Mark(const char* phase);   // main-thread phase reached "now"
+    void PrintTimeline() const;
+
+private:
+    enum class State : uint8_t { Pending, Running, WaitingMain, Done };
+    struct Task {
+        std::string         name;
+        Fn                  work, onMain;
+        std::vector<size_t> deps;
+        State               state = State::Pending;
+        std::string         detail;
+        double              startMs = 0, workEndMs = 0, endMs = 0;
+        std::thread         thread;
+    };
+    struct Phase { std::string name; double ms; };
+
+    double NowMs() const {
+        return std::chrono::duration<double, std::milli>(Clock::now() - origin).count();
+    }
+    void Run(size_t id);
+    void Finish(size_t id);   // caller holds mtx
+
+    Clock::time_point          origin;
+    mutable std::mutex         mtx;
+    std::condition_variable    cv;
+    std::vector<Task>          tasks;
+    std::vector<Phase>         phases;
+    std::atomic<size_t>        remaining{ 0 };
+    bool                       started = false, reported = false, cancelled = false;
+};
+
+extern StartupTasks g_Startup;
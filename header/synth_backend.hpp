@@ -0,0 +1,30 @@
+// synth_backend.hpp — Minimal synthesizer interface shared by every RT synth path
+#pragma once
+
+#include <cstdint>
+
+// A SynthBackend turns packed short MIDI messages into interleaved stereo float
+// PCM. It is deliberately tiny so the sharding layer (synth_shard.hpp) can host
+// BassMIDI decode streams and the built-in software synth interchangeably.
+//
+// Threading: one backend instance is only ever touched by one thread at a time
+// (the shard worker that owns it), so implementations need no locking.
+class SynthBackend {
+public:
+    virtual ~SynthBackend() = default;
+
+    // msg = status | data1 << 8 | data2 << 16 (same packing as SendDirectData)
+    virtual void        SendShort(uint32_t msg) = 0;
+
+    // Complete variable-length message (SysEx, F0 … F7). Backends that have
+    // no use for it may ignore it.
+    virtual void        SendLong(const uint8_t* data, uint32_t len) { (void)data; (void)len; }
+
+    // Renders `frames` stereo frames into `stereo` (2 * frames floats).
+    // Overwrites the buffer; the caller does the mixing.
+    virtual void        Render(float* stereo, uint32_t frames) = 0;
+
+    virtual void        Reset() = 0;
+    virtual int         ActiveVoices() const { return 0; }
+    virtual const char* Name() const = 0;
+};
@@ -0,0 +1,117 @@
+// synth_shard.hpp — Multi-instance real-time synthesis with track/channel sharding
+#pragma once
+
+#include "synth_backend.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ── Routing key ───────────────────────────────────────────────────────────────
+// Channel: every message of a channel goes to the shard that owns the channel.
+//          Balancing moves whole channels and replays their controller state.
+// Track:   note messages are routed by source (visual) track bucket; channel
+//          state messages (CC / program / bend / pressure) are broadcast so every
+//          shard keeps an identical view of each channel.
+enum class ShardKey : uint8_t { Channel = 0, Track };
+
+struct ShardStats {
+    int      routeKeys   = 0;     // channels or track buckets currently owned
+    int      voices      = 0;
+    double   renderUs    = 0.0;   // EWMA of per-block render time
+    uint64_t events      = 0;     // total messages delivered
+};
+
+// Distributes one real-time MIDI stream over N SynthBackend instances, each
+// rendered on its own worker thread, and sums their output in a SIMD mix
+// stage. Send() is called from the playback thread; Render() from the audio
+// callback. Those are the only two threads that may call into the object.
+class ShardedSynth {
+public:
+    using Factory = std::function<std::unique_ptr<SynthBackend>()>;
+
+    static constexpr int      kMaxShards    = 16;
+    static constexpr int      kTrackBuckets = 256;      // visual tracks are uint8
+    // Rebalance at most every kBalanceMinUs, checked every kBalanceEvery sends
+    static constexpr uint32_t kBalanceEvery = 4096;
+    static constexpr int64_t  kBalanceMinUs = 500000;
+
+    ShardedSynth();
+    ~ShardedSynth();
+
+    bool     Start(int shardCount, ShardKey key, const Factory& factory);
+    void     Stop();
+    bool     IsRunning() const { return running.load(std::memory_order_acquire); }
+    int      ShardCount() const { return (int)shards.size(); }
+    ShardKey Key() const { return key; }
+
+    void     Send(uint32_t msg, uint16_t track = 0);
+    void     SendLong(const uint8_t* data, uint32_t len);   // broadcast: SysEx is global state
+    void     Render(float* stereo, uint32_t frames);
+
+    std::vector<ShardStats> GetStats() const;
+
+    // Playback thread (or before Start). Tests shorten it to force migrations.
+    void     SetBalanceInterval(uint32_t everySends, int64_t minUs) { balanceEvery = everySends; balanceMinUs = minUs; }
+
+private:
+    struct Shard;
+
+    void  WorkerLoop(Shard* s);
+    void  RenderShard(Shard& s, uint32_t frames);
+    void  Rebalance();
+    void  ReplayChannelState(uint8_t ch, int shard);
+    int   RouteFor(uint8_t ch, uint16_t track) const;
+    void  Push(int shard, uint32_t msg);
+    void  PushLong(int shard, const uint8_t* data, uint32_t len);
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    ShardKey key = ShardKey::Channel;
+
+    // Stop() may run on the UI thread while the playback thread is inside
+    // Send(); it clears `running` and waits for in-flight senders to leave.
+    std::atomic<bool> running{false};
+    std::atomic<int>  sendersInside{0};
+
+    // Routing table: index = channel (Channel mode) or track bucket (Track mode)
+    std::atomic<uint8_t>  route[kTrackBuckets];
+    std::atomic<uint32_t> keyEvents[kTrackBuckets];   // events since last rebalance
+
+    // Playback-thread-only state ------------------------------------------------
+    // Note-offs follow their note-on across a migration.
+    // Channel mode: held[shard][ch][key] counts note-ons delivered to a shard
+    // and not yet released there.
+    // Track mode: heldTrack[bucket][ch][key] = count << 8 | shard. Two tracks
+    // can hold the same (ch, key) on one shard, so the count has to be per
+    // track; while a track holds a key, its further note-ons for that key
+    // stay on the same shard.
+    std::vector<uint16_t> held;
+    std::vector<uint32_t> heldTrack;
+    uint8_t  ccState[16][128]  = {};
+    bool     ccSeen[16][128]   = {};
+    uint8_t  program[16]       = {};
+    bool     programSeen[16]   = {};
+    uint16_t bend[16]          = {};
+    bool     bendSeen[16]      = {};
+    uint32_t sendsSinceBalance = 0;
+    int64_t  lastBalanceUs     = 0;
+    uint32_t balanceEvery      = kBalanceEvery;
+    int64_t  balanceMinUs      = kBalanceMinUs;
+
+    // Fork/join for the render stage: Render() renders shard 0 itself and
+    // wakes the workers for the rest.
+    std::mutex              jobMutex;
+    std::condition_variable jobCV;
+    std::condition_variable doneCV;
+    uint32_t                jobFrames     = 0;
+    uint64_t                jobGeneration = 0;
+    int                     jobPending    = 0;
+    bool                    stopWorkers   = false;
+};
+
+// dst[i] += src[i] for `count` floats (SSE when available).
+void MixAddFloats(float* dst, const float* src, size_t count);
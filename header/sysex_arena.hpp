@@ -0,0 +1,65 @@
+// sysex_arena.hpp — Contiguous byte arena for variable-length (SysEx) messages
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// MidiEvent stays 8 bytes: an EventType::SYSEX event only carries the 24-bit
+// index of its message in this arena (MidiEvent::SysExEntry()), and the arena
+// maps it to a byte offset. Each entry is
+//     [uint32 length][length bytes]
+// and holds the complete message as sent to a device: F0 … F7 for a normal
+// SysEx, or the raw bytes of an F7 "escape" packet. Files without SysEx never
+// touch the arena, so it costs nothing for them.
+class SysExArena {
+public:
+    struct Message {
+        const uint8_t* data = nullptr;
+        uint32_t       size = 0;
+    };
+
+    static constexpr size_t kMaxEntries = 1u << 24;   // MidiEvent payload width
+
+    bool Full() const { return offsets.size() >= kMaxEntries; }
+
+    // `leadF0` prepends the F0 status byte the SMF encoding strips off.
+    // Returns the entry index; check Full() first.
+    uint32_t Add(const uint8_t* payload, uint32_t len, bool leadF0) {
+        const uint32_t offset = (uint32_t)bytes.size();
+        const uint32_t size   = len + (leadF0 ? 1u : 0u);
+        bytes.resize(bytes.size() + sizeof(uint32_t) + size);
+        uint8_t* p = bytes.data() + offset;
+        std::memcpy(p, &size, sizeof(uint32_t));
+        p += sizeof(uint32_t);
+        if (leadF0) *p++ = 0xF0;
+        if (len) std::memcpy(p, payload, len);
+        offsets.push_back(offset);
+        return (uint32_t)(offsets.size() - 1);
+    }
+
+    Message Get(uint32_t entry) const {
+        if (entry >= offsets.size()) return {};
+        const uint32_t offset = offsets[entry];
+        if ((size_t)offset + sizeof(uint32_t) > bytes.size()) return {};
+        uint32_t size;
+        std::memcpy(&size, bytes.data() + offset, sizeof(uint32_t));
+        if ((size_t)offset + sizeof(uint32_t) + size > bytes.size()) return {};
+        return { bytes.data() + offset + sizeof(uint32_t), size };
+    }
+
+    void Clear() {
+        bytes.clear();
+        bytes.shrink_to_fit();
+        offsets.clear();
+        offsets.shrink_to_fit();
+    }
+
+    bool   Empty() const { return offsets.empty(); }
+    size_t Count() const { return offsets.size(); }
+    size_t Bytes() const { return bytes.size(); }
+
+private:
+    std::vector<uint8_t>  bytes;
+    std::vector<uint32_t> offsets;   // entry → byte offset
+};
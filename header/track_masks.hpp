@@ -0,0 +1,77 @@
+// track_masks.hpp — Per-track / per-channel visibility and mute bitmasks
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Fixed-size bitsets, so the painter and playback threads can read them
+// while the UI edits them without any reallocation. Bit set = hidden / muted.
+//
+//   Visibility → PaintChunkRange skips hidden tracks and hidden channels.
+//   Audibility → PlaybackThread drops NOTE_ONs with one bit test on the
+//                combined (track << 4 | channel) table. Note-offs and channel
+//                state always pass so nothing hangs across a mute toggle.
+//                The pre-render has no dispatch loop; the main loop bakes the
+//                mutes into g_EventFilter when the audible epoch changes.
+class TrackMasks {
+public:
+    static constexpr size_t kMaxTracks = 65536;   // NoteTrack index; MidiEvent::Track() is 8-bit
+
+    void Reset();   // everything visible and audible
+
+    // ── Visibility ──
+    bool TrackVisible(size_t t) const {
+        return t >= kMaxTracks || !((hiddenTracks[t >> 6].load(std::memory_order_relaxed) >> (t & 63)) & 1u);
+    }
+    bool ChannelVisible(uint8_t ch) const {
+        return !((hiddenChannels.load(std::memory_order_relaxed) >> (ch & 15)) & 1u);
+    }
+    void SetTrackVisible(size_t t, bool visible);
+    void SetChannelVisible(uint8_t ch, bool visible);
+    void ShowAllTracks();
+
+    // ── Audibility ──
+    bool NoteAudible(uint16_t track, uint8_t ch) const {
+        const uint32_t i = ((uint32_t)track << 4) | (ch & 15u);
+        return !((mutedNotes[i >> 6].load(std::memory_order_relaxed) >> (i & 63)) & 1u);
+    }
+    bool TrackMuted(size_t t) const {
+        return t < kMaxTracks && ((mutedTracks[t >> 6].load(std::memory_order_relaxed) >> (t & 63)) & 1u);
+    }
+    bool ChannelMuted(uint8_t ch) const {
+        return (mutedChannels.load(std::memory_order_relaxed) >> (ch & 15)) & 1u;
+    }
+    void SetTrackMuted(size_t t, bool muted);
+    void SetChannelMuted(uint8_t ch, bool muted);
+    void SoloTrack(size_t t, size_t trackCount);   // mute every other track
+    void UnmuteAllTracks();
+    bool AnyMuted() const;   // scans the track words; call when AudibleEpoch moves
+
+    // Muted-track words with trailing zero words trimmed (g_EventFilter overlay)
+    std::vector<uint64_t> MutedTrackWords() const;
+    uint16_t              MutedChannels() const { return mutedChannels.load(std::memory_order_relaxed); }
+
+    uint64_t VisibleEpoch() const { return visibleEpoch.load(std::memory_order_acquire); }
+    uint64_t AudibleEpoch() const { return audibleEpoch.load(std::memory_order_acquire); }
+    uint64_t ResetEpoch()   const { return resetEpoch.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t kTrackWords = kMaxTracks / 64;
+    static constexpr size_t kNoteWords  = kMaxTracks * 16 / 64;
+
+    void RebuildNoteWord(size_t t);   // the 16 channel bits of one track
+    void RebuildAllNoteWords();
+
+    std::atomic<uint64_t> hiddenTracks[kTrackWords]  = {};
+    std::atomic<uint64_t> mutedTracks[kTrackWords]   = {};
+    std::atomic<uint64_t> mutedNotes[kNoteWords]     = {};   // bit (track << 4 | ch)
+    std::atomic<uint16_t> hiddenChannels{0};
+    std::atomic<uint16_t> mutedChannels{0};
+    std::atomic<uint64_t> visibleEpoch{0};
+    std::atomic<uint64_t> audibleEpoch{0};
+    std::atomic<uint64_t> resetEpoch{0};
+};
+
+extern TrackMasks g_TrackMasks;
@@ -13,6 +13,8 @@
 #include <string>
 #include <cstring>
 #include "raylib.h"
+#include "midi_event.hpp"
+#include "sysex_arena.hpp"
 
 struct LoadProgress {
     std::atomic<bool> isFinished{false};
@@ -135,12 +137,58 @@ struct NoteEvent {
 struct CCEvent {
     uint32_t tick;
     uint8_t  channel;
-    uint8_t  controller;
+    uint8_t  controller;   // 0..127, or CC_PITCH_BEND
     uint8_t  value;
 };
 
+// Pseudo-controller for pitch bend in the CC lane data (value = 14-bit MSB)
+constexpr uint8_t CC_PITCH_BEND = 128;
+
+// A track's notes, sorted by startTick. The loader fills the owned vector; a
+// song shared between windows (song_share.hpp) points the list at the mapped
+// array instead, so every window reads the same copy. Readers get the const
+// contiguous-range interface either way.
+class NoteList {
+public:
+    NoteList() = default;
+    NoteList(const NoteList& o) : owned(o.owned), first(o.first), count(o.count), external(o.external) { Sync(); }
+    NoteList(NoteList&& o) noexcept : owned(std::move(o.owned)), first(o.first), count(o.count), external(o.external) { Sync(); o.Reset(); }
+    NoteList& operator=(const NoteList& o) { owned = o.owned; first = o.first; count = o.count; external = o.external; Sync(); return *this; }
+    NoteList& operator=(NoteList&& o) noexcept {
+        owned = std::move(o.owned); first = o.first; count = o.count; external = o.external;
+        Sync(); o.Reset(); return *this;
+    }
+
+    // Loader side
+    void reserve(size_t n)             { owned.reserve(n); Sync(); }
+    void push_back(const NoteEvent& n) { owned.push_back(n); Sync(); }
+    void shrink_to_fit()               { owned.shrink_to_fit(); Sync(); }
+    std::vector<NoteEvent>& Owned()    { return owned; }   // in-place sort, or a swap followed by Sync()
+
+    // Drops the owned copy and reads `n` notes at `p` until Reset()
+    void View(const NoteEvent* p, size_t n) { owned.clear(); owned.shrink_to_fit(); first = p; count = n; external = true; }
+    void Reset()                            { owned.clear(); owned.shrink_to_fit(); external = false; Sync(); }
+    void Sync()                             { if (!external) { first = owned.data(); count = owned.size(); } }
+    bool IsView() const                     { return external; }
+
+    const NoteEvent* data()  const { return first; }
+    size_t           size()  const { return count; }
+    bool             empty() const { return count == 0; }
+    const NoteEvent* begin() const { return first; }
+    const NoteEvent* end()   const { return first + count; }
+    const NoteEvent& operator[](size_t i) const { return first[i]; }
+    const NoteEvent& front() const { return first[0]; }
+    const NoteEvent& back()  const { return first[count - 1]; }
+
+private:
+    std::vector<NoteEvent> owned;
+    const NoteEvent*       first    = nullptr;
+    size_t                 count    = 0;
+    bool                   external = false;
+};
+
 struct OptimizedTrackData {
-    std::vector<NoteEvent> notes;
+    NoteList notes;
 };
 
 struct TempoEvent {
@@ -148,42 +196,12 @@ struct TempoEvent {
     uint32_t tempoMicroseconds;
 };
 
-// ===== UNIFIED MIDI EVENT STRUCTURE =====
-enum class EventType : uint8_t { NOTE_ON, NOTE_OFF, CC, TEMPO, PITCH_BEND, PROGRAM_CHANGE, CHANNEL_PRESSURE };
-enum class ViewerType : uint8_t { ChannelTrackLayer, TickLayer };
+// ===== VIEW / INPUT MODES (MidiEvent lives in midi_event.hpp) =====
+enum class ViewerType : uint8_t { ChannelTrackLayer, TickLayer, FallingNotes };
 enum class InputMode : uint8_t { Normal, Simulate };
 
-// MidiEvent: 12 bytes.
-// Layout: tick(4) + type(1) + channel(1) + _pad(2) + data(4) = 12B
-// Field order is IDENTICAL to the original — do NOT reorder.
-// midioutput.hpp and any other TU that uses MidiEvent by raw offset must
-// see exactly this layout. The _pad field just makes the compiler-inserted
-// padding explicit; it does not change sizeof or any field offset.
-struct MidiEvent {
-    uint32_t tick;      // offset 0 (4B)
-    uint8_t  type;      // offset 4 (1B)
-    uint8_t  channel;   // offset 5 (1B)
-    uint16_t _pad{0};   // offset 6 (2B) — explicit; was implicit compiler padding before
-    union {             // offset 8 (4B)
-        struct { uint8_t n; uint8_t v; } note;  // NOTE_ON / NOTE_OFF
-        struct { uint8_t c; uint8_t v; } cc;    // CC
-        struct { uint8_t l1; uint8_t m2; } raw; // PITCH_BEND (LSB, MSB)
-        uint8_t  val;                           // PROGRAM_CHANGE / CHANNEL_PRESSURE
-        uint32_t tempo;                         // TEMPO (24-bit value in low 3 bytes)
-    } data;
-
-    MidiEvent(uint32_t t, EventType et, uint8_t ch)
-        : tick(t), type((uint8_t)et), channel(ch), _pad(0) {
-        memset(&data, 0, sizeof(data));
-    }
-
-    bool operator<(const MidiEvent& other) const {
-        if (tick != other.tick) return tick < other.tick;
-        return type < other.type;
-    }
-};
-
 // ===== load.cpp — streaming MIDI parser (1:1 memory, uint24 tempo) =====
+class LoadTelemetry;   // load_telemetry.hpp
 std::vector<CCEvent> loadStreamingMidiData(
     const std::string&              filename,
     std::vector<OptimizedTrackData>& tracks,
@@ -192,7 +210,8 @@ std::vector<CCEvent> loadStreamingMidiData(
     uint64_t&                       totalNoteCount,
     uint16_t&                       outTimeSigNumerator,    // filled from meta 0x58; default 4
     uint16_t&                       outTimeSigDenominator,  // filled from meta 0x58; default 4
-    LoadProgress*                   progress = nullptr);
+    LoadProgress*                   progress  = nullptr,
+    LoadTelemetry*                  telemetry = nullptr);   // stages recorded when given
 
 std::vector<TempoEvent> collectGlobalTempoEvents(const std::string& filename);
 
@@ -200,6 +219,9 @@ std::vector<TempoEvent> collectGlobalTempoEvents(const std::string& filename);
 // Call after loading; pass directly to MidiOutputEngine::Start().
 const std::vector<MidiEvent>& GetGlobalMidiEvents();
 
+// SysEx payloads referenced by EventType::SYSEX events (empty for most files).
+const SysExArena& GetSysExArena();
+
 // ===================================================================
 // GLOBAL CONFIGURATION SETTINGS (Placed at bottom to resolve types)
 // ===================================================================
@@ -211,6 +233,7 @@ extern bool showDebug;
 extern bool showPerformance;
 extern bool showOptions;
 extern ViewerType g_viewerType;
+extern bool g_timeDomainScroll;
 
 extern float g_bgColorF[4];
 extern Color g_backgroundColor;
@@ -0,0 +1,120 @@
+#include "active_notes.hpp"
+
+#include <algorithm>
+
+void ActiveNoteTracker::Bind(const std::vector<OptimizedTrackData>* t) {
+    tracks = t;
+    blockMaxEnd.assign(t ? t->size() : 0, {});
+    cursor.assign(t ? t->size() : 0, 0);
+    if (t) {
+        for (size_t ti = 0; ti < t->size(); ++ti) IndexTrack(ti);
+    }
+    ClearState();
+}
+
+void ActiveNoteTracker::Refresh(const std::vector<uint16_t>& changed) {
+    if (!tracks) return;
+    for (uint16_t t : changed)
+        if (t < blockMaxEnd.size()) IndexTrack(t);
+    ClearState();
+}
+
+void ActiveNoteTracker::IndexTrack(size_t t) {
+    const auto& notes = (*tracks)[t].notes;
+    auto& blocks = blockMaxEnd[t];
+    blocks.assign((notes.size() + kBlock - 1) / kBlock, 0);
+    for (size_t i = 0; i < notes.size(); ++i)
+        blocks[i / kBlock] = std::max(blocks[i / kBlock], notes[i].endTick);
+}
+
+void ActiveNoteTracker::Unbind() {
+    tracks = nullptr;
+    blockMaxEnd.clear(); blockMaxEnd.shrink_to_fit();
+    cursor.clear();      cursor.shrink_to_fit();
+    ClearState();
+}
+
+void ActiveNoteTracker::ClearState() {
+    for (auto& k : keys) k.clear();
+    starts = {};
+    ends   = {};
+    active = 0;
+    primed = false;
+}
+
+// Holder lists are tiny (a few tracks per key even on black MIDIs) and kept
+// sorted by ident, so the top track is always back().
+void ActiveNoteTracker::Add(uint8_t key, uint32_t ident, uint32_t endTick) {
+    auto& list = keys[key & 127];
+    auto it = std::lower_bound(list.begin(), list.end(), ident,
+        [](const Holder& h, uint32_t v) { return h.ident < v; });
+    if (it != list.end() && it->ident == ident) it->count++;
+    else list.insert(it, Holder{ ident, 1 });
+    ends.push(End{ endTick, ident, (uint8_t)(key & 127) });
+    active++;
+}
+
+void ActiveNoteTracker::Release(uint8_t key, uint32_t ident) {
+    auto& list = keys[key];
+    auto it = std::lower_bound(list.begin(), list.end(), ident,
+        [](const Holder& h, uint32_t v) { return h.ident < v; });
+    if (it == list.end() || it->ident != ident) return;
+    if (--it->count == 0) list.erase(it);
+    active--;
+}
+
+void ActiveNoteTracker::Rebuild(uint32_t tick) {
+    ClearState();
+    if (!tracks) return;
+
+    for (size_t t = 0; t < tracks->size(); ++t) {
+        const auto& notes = (*tracks)[t].notes;
+        // First note that starts after the playhead — everything before it may be sounding
+        const size_t u = (size_t)(std::upper_bound(notes.begin(), notes.end(), tick,
+            [](uint32_t v, const NoteEvent& n) { return v < n.startTick; }) - notes.begin());
+
+        const auto& blocks = blockMaxEnd[t];
+        for (size_t b = 0; b * kBlock < u; ++b) {
+            if (blocks[b] <= tick) continue;   // whole block already finished
+            const size_t e = std::min(u, (b + 1) * kBlock);
+            for (size_t i = b * kBlock; i < e; ++i) {
+                const NoteEvent& n = notes[i];
+                if (n.endTick > tick) Add(n.note, ((uint32_t)t << 4) | (n.channel & 15u), n.endTick);
+            }
+        }
+
+        cursor[t] = (uint32_t)u;
+        if (u < notes.size()) starts.push(Start{ notes[u].startTick, (uint32_t)t });
+    }
+    lastTick = tick;
+    primed   = true;
+}
+
+void ActiveNoteTracker::Update(uint32_t tick, uint32_t maxStepTicks) {
+    if (!tracks) return;
+    if (!primed || tick < lastTick || tick - lastTick > maxStepTicks) {
+        Rebuild(tick);
+        return;
+    }
+
+    // Notes crossed by the playhead since the last frame
+    while (!starts.empty() && starts.top().tick <= tick) {
+        const uint32_t t = starts.top().track;
+        starts.pop();
+        const auto& notes = (*tracks)[t].notes;
+        uint32_t i = cursor[t];
+        for (; i < notes.size() && notes[i].startTick <= tick; ++i) {
+            const NoteEvent& n = notes[i];
+            if (n.endTick > tick) Add(n.note, (t << 4) | (n.channel & 15u), n.endTick);
+        }
+        cursor[t] = i;
+        if (i < notes.size()) starts.push(Start{ notes[i].startTick, t });
+    }
+
+    while (!ends.empty() && ends.top().tick <= tick) {
+        const End e = ends.top();
+        ends.pop();
+        Release(e.key, e.ident);
+    }
+    lastTick = tick;
+}
@@ -4,6 +4,7 @@
 #define NOMINMAX
 
 #include <windows.h>
+#include <mmsystem.h>
 #include <bass.h>
 #include <bassmidi.h>
 
@@ -20,24 +21,9 @@
 #include <condition_variable>
 
 #include "bass_backend.hpp"
-
-#ifndef MIDI_EVENT_TYPES_DEFINED
-#define MIDI_EVENT_TYPES_DEFINED
-enum class EventType : uint8_t { NOTE_ON, NOTE_OFF, CC, TEMPO, PITCH_BEND, PROGRAM_CHANGE, CHANNEL_PRESSURE };
-struct MidiEvent {
-    uint32_t tick;
-    uint8_t  type;
-    uint8_t  channel;
-    uint16_t _pad{0};
-    union {
-        struct { uint8_t n; uint8_t v; } note;
-        struct { uint8_t c; uint8_t v; } cc;
-        struct { uint8_t l1; uint8_t m2; } raw;
-        uint8_t  val;
-        uint32_t tempo;
-    } data;
-};
-#endif
+#include "midi_event.hpp"
+#include "soft_prerender.hpp"
+#include "soft_synth.hpp"
 
 #ifndef BASS_ATTRIB_MIDI_VOICES
 #  define BASS_ATTRIB_MIDI_VOICES    0x12000
@@ -51,6 +37,50 @@ struct MidiEvent {
 
 static constexpr DWORD kDecodeChunk = 1920u;
 
+// Byte length of a packed short message for BASS_MIDI_EVENTS_RAW. Program
+// change and channel pressure carry one data byte; sending 3 would make BASS
+// read the trailing zero as a running-status repeat.
+static inline DWORD ShortMsgLength(uint32_t msg) {
+    uint8_t type = msg & 0xF0;
+    return (type == 0xC0 || type == 0xD0) ? 2u : 3u;
+}
+
+// ── BassMIDI shard backend ────────────────────────────────────────────────────
+// One BASS_MIDI decode stream per shard; the sharded mixer pulls PCM from it.
+class BassMidiSynth final : public SynthBackend {
+public:
+    explicit BassMidiSynth(HSTREAM s) : stream(s) {}
+    ~BassMidiSynth() override { if (stream) BASS_StreamFree(stream); }
+
+    void SendShort(uint32_t msg) override {
+        BASS_MIDI_StreamEvents(stream, BASS_MIDI_EVENTS_RAW, &msg, ShortMsgLength(msg));
+    }
+    void SendLong(const uint8_t* data, uint32_t len) override {
+        BASS_MIDI_StreamEvents(stream, BASS_MIDI_EVENTS_RAW, data, len);
+    }
+    void Render(float* stereo, uint32_t frames) override {
+        DWORD want = frames * 2 * (DWORD)sizeof(float);
+        DWORD got  = BASS_ChannelGetData(stream, stereo, want | BASS_DATA_FLOAT);
+        if (got == (DWORD)-1) got = 0;
+        if (got < want) memset(reinterpret_cast<uint8_t*>(stereo) + got, 0, want - got);
+    }
+    void Reset() override {
+        for (uint32_t ch = 0; ch < 16; ++ch) {
+            SendShort((0xB0 | ch) | (123 << 8));
+            SendShort((0xB0 | ch) | (121 << 8));
+        }
+    }
+    int ActiveVoices() const override {
+        float v = 0.0f;
+        BASS_ChannelGetAttribute(stream, BASS_ATTRIB_MIDI_VOICES_ACTIVE, &v);
+        return (int)v;
+    }
+    const char* Name() const override { return "BassMIDI"; }
+
+private:
+    HSTREAM stream;
+};
+
 struct BassPreRenderEngine::Impl {
     bool        initialized  = false;
     BassConfig  cfg;
@@ -59,6 +89,13 @@ struct BassPreRenderEngine::Impl {
     HSTREAM     midiStream   = 0;
     HSTREAM     pushStream   = 0;
 
+    // Sharded RT path: shardStream pulls the mixed output of `shards`.
+    // shardMidiStreams mirrors the BassMIDI shard streams (guarded by fontMutex)
+    // so font and voice changes reach them.
+    ShardedSynth          shards;
+    HSTREAM               shardStream  = 0;
+    std::vector<HSTREAM>  shardMidiStreams;
+
     std::vector<SoundFontEntry> fonts;
     mutable std::mutex          fontMutex;
     float volume = 1.0f;
@@ -70,10 +107,11 @@ struct BassPreRenderEngine::Impl {
     std::atomic<bool>         prError{false};
     std::atomic<bool>         prSeekFlush{false};
     
-    // Dynamic Rebuild Cache
-    std::vector<MidiEvent>    cachedEvents;
-    int                       cachedPpq = 480;
-    uint32_t                  cachedInitialTempo = 500000;
+    // Dynamic Rebuild Cache — the compiled event stream being rendered.
+    // Swapped by SetPreRenderStream(); the decode thread copies the pointer
+    // under prStreamMutex at each (re)build.
+    std::shared_ptr<const FilteredStream> prStream;
+    std::mutex                prStreamMutex;
     uint64_t                  cachedTotalMicros = 0;
     float                     playbackSpeed = 1.0f;
     float                     lastRenderedSpeed = 1.0f;
@@ -92,6 +130,30 @@ struct BassPreRenderEngine::Impl {
     std::string               prErrorMsg;
     mutable std::mutex        prMsgMutex;
 
+    bool UseShards() const {
+        return cfg.rtShards > 1 || cfg.rtSynth != RtSynth::BassMIDI;
+    }
+
+    // The stream that plays in RT mode, whichever path built it
+    HSTREAM RtStream() const { return shardStream ? shardStream : midiStream; }
+
+    void StopShards() {
+        if (shardStream) { BASS_StreamFree(shardStream); shardStream = 0; }
+        shards.Stop();
+        std::lock_guard<std::mutex> lk(fontMutex);
+        shardMidiStreams.clear();
+    }
+
+    bool MakeShardedStream();
+
+    // (Re)creates the RT output, choosing the single-stream or sharded path
+    bool MakeRtStream() {
+        StopShards();
+        if (!UseShards()) return MakeStream(0);
+        if (midiStream) { BASS_StreamFree(midiStream); midiStream = 0; }
+        return MakeShardedStream();
+    }
+
     bool MakeStream(DWORD flags) {
         if (midiStream) { BASS_StreamFree(midiStream); midiStream = 0; }
         midiStream = BASS_MIDI_StreamCreate(16, flags | BASS_SAMPLE_FLOAT, cfg.sampleRate);
@@ -117,7 +179,10 @@ struct BassPreRenderEngine::Impl {
             bfont.bank   = (fe.bank < 0) ? 0 : fe.bank;
             active.push_back(bfont);
         }
-        BASS_MIDI_StreamSetFonts(midiStream, active.empty() ? nullptr : active.data(), (DWORD)active.size());
+        if (midiStream)
+            BASS_MIDI_StreamSetFonts(midiStream, active.empty() ? nullptr : active.data(), (DWORD)active.size());
+        for (HSTREAM s : shardMidiStreams)
+            BASS_MIDI_StreamSetFonts(s, active.empty() ? nullptr : active.data(), (DWORD)active.size());
     }
 
     bool LoadFont(SoundFontEntry& fe) {
@@ -131,22 +196,51 @@ struct BassPreRenderEngine::Impl {
     void UnloadFont(SoundFontEntry& fe) {
         if (fe.handle) { BASS_MIDI_FontFree((HSOUNDFONT)fe.handle); fe.handle = 0; }
     }
+};
+
+static DWORD CALLBACK ShardStreamProc(HSTREAM handle, void *buffer, DWORD length, void *user) {
+    auto* impl = static_cast<BassPreRenderEngine::Impl*>(user);
+    impl->shards.Render(static_cast<float*>(buffer), length / (2 * sizeof(float)));
+    return length;
+}
 
-    // Returns a velocity-ignore threshold that scales with buffer health.
-    //   bufHealthSec >= lowVelScaleMaxSec  → use cfg.velocityIgnore (normal, e.g. 2)
-    //   bufHealthSec == 0.0f              → return 127 (silence all new notes)
-    // The 10ms low end comes from cfg.latencyMs — below that we're basically empty.
-    uint8_t GetDynamicVelIgnore(double bufHealthSec) const {
-        const float scaleMax = cfg.lowVelScaleMaxSec;
-        if (scaleMax <= 0.0f) return cfg.velocityIgnore; // feature disabled
-        if (bufHealthSec <= 0.0) return 127; // buffer completely dry → silence
-        if (bufHealthSec >= (double)scaleMax) return cfg.velocityIgnore; // healthy → normal
-        // Linear interpolation: 0s → 127, scaleMax → cfg.velocityIgnore
-        float t = (float)(bufHealthSec / (double)scaleMax); // 0..1
-        float result = 127.0f + t * ((float)cfg.velocityIgnore - 127.0f);
-        return (uint8_t)std::clamp((int)result, (int)cfg.velocityIgnore, 127);
+bool BassPreRenderEngine::Impl::MakeShardedStream() {
+    const uint32_t sr    = cfg.sampleRate;
+    const int      voice = cfg.voices;
+    ShardedSynth::Factory factory;
+    if (cfg.rtSynth == RtSynth::BuiltIn) {
+        factory = [sr, voice]() -> std::unique_ptr<SynthBackend> {
+            return std::make_unique<SoftSynth>(sr, std::clamp(voice, 16, 4096));
+        };
+    } else {
+        factory = [this, sr, voice]() -> std::unique_ptr<SynthBackend> {
+            HSTREAM s = BASS_MIDI_StreamCreate(16, BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT, sr);
+            if (!s) {
+                std::cerr << "[BassEngine] shard BASS_MIDI_StreamCreate failed: " << BASS_ErrorGetCode() << "\n";
+                return nullptr;
+            }
+            BASS_ChannelSetAttribute(s, BASS_ATTRIB_MIDI_VOICES, (float)voice);
+            std::lock_guard<std::mutex> lk(fontMutex);
+            shardMidiStreams.push_back(s);
+            ApplyFontsLocked();
+            return std::make_unique<BassMidiSynth>(s);
+        };
     }
-};
+
+    if (!shards.Start(cfg.rtShards, cfg.rtShardKey, factory)) {
+        std::lock_guard<std::mutex> lk(fontMutex);
+        shardMidiStreams.clear();
+        return false;
+    }
+    shardStream = BASS_StreamCreate(sr, 2, BASS_SAMPLE_FLOAT, ShardStreamProc, this);
+    if (!shardStream) {
+        std::cerr << "[BassEngine] shard output BASS_StreamCreate failed: " << BASS_ErrorGetCode() << "\n";
+        StopShards();
+        return false;
+    }
+    BASS_ChannelSetAttribute(shardStream, BASS_ATTRIB_VOL, volume);
+    return true;
+}
 
 static DWORD CALLBACK PreRenderStreamProc(HSTREAM handle, void *buffer, DWORD length, void *user) {
     auto* impl = static_cast<BassPreRenderEngine::Impl*>(user);
@@ -200,10 +294,26 @@ BassPreRenderEngine::~BassPreRenderEngine() {
     impl = nullptr;
 }
 
+// Velocity ignore belongs to the BASS panel and is mirrored into the shared
+// event filter. The strip rules belong to the filter (Event Filter panel);
+// SFX writes all four only when it is switched, as a shortcut.
+static void SyncVelocityIgnore(uint8_t v) {
+    EventFilterConfig fc = g_EventFilter.GetConfig();
+    fc.velocityIgnore = v;
+    g_EventFilter.SetConfig(fc);
+}
+
+static void ApplySfxShortcut(bool on) {
+    EventFilterConfig fc = g_EventFilter.GetConfig();
+    fc.stripCC = fc.stripPitchBend = fc.stripProgram = fc.stripPressure = !on;
+    g_EventFilter.SetConfig(fc);
+}
+
 bool BassPreRenderEngine::Init(void* hwnd) {
     if (!impl) return false;
     if (impl->initialized) return true;
     impl->hwnd = hwnd;
+    SyncVelocityIgnore(impl->cfg.velocityIgnore);
 
     // Use latencyMs directly for both update period and buffer size.
     // Halving the update period caused a doubled device-poll interval mismatch
@@ -222,7 +332,7 @@ bool BassPreRenderEngine::Init(void* hwnd) {
     impl->initialized = true;
 
     if (impl->cfg.mode == AudioMode::BassMIDI_RT) {
-        impl->MakeStream(0);
+        impl->MakeRtStream();
     }
     return true;
 }
@@ -230,6 +340,7 @@ bool BassPreRenderEngine::Init(void* hwnd) {
 void BassPreRenderEngine::Shutdown() {
     if (!impl || !impl->initialized) return;
     CancelPreRender();
+    impl->StopShards();
     if (impl->pushStream) { BASS_StreamFree(impl->pushStream); impl->pushStream = 0; }
     if (impl->midiStream) { BASS_StreamFree(impl->midiStream); impl->midiStream = 0; }
     {
@@ -247,16 +358,22 @@ bool BassPreRenderEngine::IsInitialized() const {
 
 void BassPreRenderEngine::ApplyConfig(const BassConfig& cfg) {
     if (!impl) return;
+    bool velChanged    = (cfg.velocityIgnore != impl->cfg.velocityIgnore);
+    bool sfxChanged    = (cfg.sfxEnabled != impl->cfg.sfxEnabled);
     bool modeChanged   = (cfg.mode    != impl->cfg.mode);
     bool voiceChanged  = (cfg.voices  != impl->cfg.voices);
+    bool shardChanged  = (cfg.rtShards != impl->cfg.rtShards || cfg.rtShardKey != impl->cfg.rtShardKey ||
+                          cfg.rtSynth  != impl->cfg.rtSynth);
     impl->cfg = cfg;
+    if (velChanged) SyncVelocityIgnore(cfg.velocityIgnore);
+    if (sfxChanged) ApplySfxShortcut(cfg.sfxEnabled);
 
     if (impl->initialized) {
         if (impl->midiStream && voiceChanged) {
             BASS_ChannelSetAttribute(impl->midiStream, BASS_ATTRIB_MIDI_VOICES, (float)cfg.voices);
         }
-        if (modeChanged && cfg.mode == AudioMode::BassMIDI_RT) {
-            impl->MakeStream(0);
+        if (cfg.mode == AudioMode::BassMIDI_RT && (modeChanged || shardChanged)) {
+            impl->MakeRtStream();
         }
     }
 }
@@ -271,9 +388,12 @@ void BassPreRenderEngine::SetMode(AudioMode m) {
     impl->cfg.mode = m;
     if (impl->initialized) {
         if (m == AudioMode::BassMIDI_RT) {
-            if (!impl->midiStream) impl->MakeStream(0);
+            if (!impl->RtStream()) impl->MakeRtStream();
         } else if (m == AudioMode::BassMIDI_PreRender) {
             if (impl->midiStream) BASS_ChannelStop(impl->midiStream);
+            impl->StopShards();
+        } else {
+            impl->StopShards();
         }
     }
 }
@@ -284,26 +404,26 @@ void BassPreRenderEngine::SetVoices(int v) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
-        BASS_ChannelSetAttribute(impl->midiStream, BASS_ATTRIB_MIDI_VOICES, (float)impl->cfg.voices);
+    } else {
+        if (impl->midiStream)
+            BASS_ChannelSetAttribute(impl->midiStream, BASS_ATTRIB_MIDI_VOICES, (float)impl->cfg.voices);
+        std::lock_guard<std::mutex> lk(impl->fontMutex);
+        for (HSTREAM s : impl->shardMidiStreams)
+            BASS_ChannelSetAttribute(s, BASS_ATTRIB_MIDI_VOICES, (float)impl->cfg.voices);
     }
 }
 
+// Velocity ignore and SFX are rules of the shared event filter; the filtered
+// stream reaches the pre-render through MidiOutputEngine::Rebind().
 void BassPreRenderEngine::SetVelocityIgnore(uint8_t v) { 
     if (!impl) return;
     impl->cfg.velocityIgnore = v; 
-    if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
-        impl->prNeedsRebuild.store(true);
-        impl->pcmCV.notify_all();
-    }
+    SyncVelocityIgnore(v);
 }
 void BassPreRenderEngine::SetSfxEnabled(bool on) { 
     if (!impl) return;
     impl->cfg.sfxEnabled = on; 
-    if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
-        impl->prNeedsRebuild.store(true);
-        impl->pcmCV.notify_all();
-    }
+    ApplySfxShortcut(on);
 }
 void BassPreRenderEngine::SetPlaybackSpeed(float speed) {
     if (!impl) return;
@@ -326,6 +446,31 @@ void BassPreRenderEngine::SetPreRenderBufferSec(float sec) {
 }
 void BassPreRenderEngine::SetLowBufferMode(bool on) { if (impl) impl->cfg.lowBufferMode = on; }
 
+void BassPreRenderEngine::SetRtSharding(int shards, ShardKey key, RtSynth synth) {
+    if (!impl) return;
+    BassConfig cfg = impl->cfg;
+    cfg.rtShards   = std::clamp(shards, 1, ShardedSynth::kMaxShards);
+    cfg.rtShardKey = key;
+    cfg.rtSynth    = synth;
+    bool wasPlaying = IsPlaying();
+    ApplyConfig(cfg);
+    if (wasPlaying) Play();
+}
+
+void BassPreRenderEngine::SetPreRenderSynth(RtSynth synth) {
+    if (!impl || impl->cfg.preRenderSynth == synth) return;
+    impl->cfg.preRenderSynth = synth;
+    if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
+        impl->prNeedsRebuild.store(true);
+        impl->pcmCV.notify_all();
+    }
+}
+
+std::vector<ShardStats> BassPreRenderEngine::GetShardStats() const {
+    if (!impl || !impl->shardStream) return {};
+    return impl->shards.GetStats();
+}
+
 AudioMode BassPreRenderEngine::GetActiveMode() const { return impl ? impl->cfg.mode : AudioMode::KDMAPI; }
 
 bool BassPreRenderEngine::AddSoundFont(const std::string& path) {
@@ -342,7 +487,7 @@ bool BassPreRenderEngine::AddSoundFont(const std::string& path) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
     return true;
@@ -357,7 +502,7 @@ void BassPreRenderEngine::RemoveSoundFont(size_t index) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
 }
@@ -370,7 +515,7 @@ void BassPreRenderEngine::MoveSoundFontUp(size_t index) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
 }
@@ -383,7 +528,7 @@ void BassPreRenderEngine::MoveSoundFontDown(size_t index) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
 }
@@ -398,7 +543,7 @@ void BassPreRenderEngine::SetSoundFontEnabled(size_t index, bool on) {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
 }
@@ -415,19 +560,19 @@ void BassPreRenderEngine::ReloadAllSoundFonts() {
     if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
         impl->prNeedsRebuild.store(true);
         impl->pcmCV.notify_all();
-    } else if (impl->midiStream) {
+    } else if (impl->RtStream()) {
         impl->ApplyFontsLocked(); 
     }
 }
 
-void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCount, int ppq, uint32_t initialTempo, uint64_t totalMicros) {
-    if (!impl || impl->cfg.mode != AudioMode::BassMIDI_PreRender) return;
+void BassPreRenderEngine::StartPreRender(std::shared_ptr<const FilteredStream> stream, uint64_t totalMicros) {
+    if (!impl || impl->cfg.mode != AudioMode::BassMIDI_PreRender || !stream) return;
     CancelPreRender();
 
-    const MidiEvent* evPtr = static_cast<const MidiEvent*>(rawEvents);
-    impl->cachedEvents.assign(evPtr, evPtr + eventCount);
-    impl->cachedPpq = ppq;
-    impl->cachedInitialTempo = initialTempo;
+    {
+        std::lock_guard<std::mutex> lk(impl->prStreamMutex);
+        impl->prStream = std::move(stream);
+    }
     impl->cachedTotalMicros = totalMicros;
     impl->lastRenderedSpeed = impl->playbackSpeed;
 
@@ -465,128 +610,19 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
 
     impl->prThread = std::thread([this, device, sr]() mutable {
         BASS_SetDevice(device);
-        // Hysteresis counter: how many consecutive decode chunks have seen a different
-        // velIgnore from what is baked. Only rebuild after 8 stable chunks to prevent loops.
 
         auto buildStream = [&]() -> HSTREAM {
-            // Use cfg.velocityIgnore directly — buffer health is always 0 at build time
-            // (decode hasn't started yet), so GetDynamicVelIgnore would always return 127
-            // and bake silence into every stream. Vel ignore is a static config, not dynamic.
-            const uint8_t velIgnore  = impl->cfg.velocityIgnore;
-            const bool    sfxEnabled = impl->cfg.sfxEnabled;
-            const float   speed      = impl->playbackSpeed;
-
-            auto writeVlq = [](std::vector<uint8_t>& buf, uint32_t v) {
-                uint8_t tmp[4]; int n = 0;
-                do { tmp[n++] = static_cast<uint8_t>(v & 0x7F); v >>= 7; } while (v);
-                for (int i = n - 1; i >= 0; --i) buf.push_back(tmp[i] | (i ? 0x80u : 0u));
-            };
-
-            std::vector<uint8_t> trackData;
-            trackData.reserve(impl->cachedEvents.size() * 4);
-
-            writeVlq(trackData, 0);
-            trackData.push_back(0xFF); trackData.push_back(0x51); trackData.push_back(0x03);
-            uint32_t initialT = (uint32_t)(impl->cachedInitialTempo / speed);
-            trackData.push_back(static_cast<uint8_t>((initialT >> 16) & 0xFF));
-            trackData.push_back(static_cast<uint8_t>((initialT >>  8) & 0xFF));
-            trackData.push_back(static_cast<uint8_t>( initialT        & 0xFF));
-
-            uint32_t lastWrittenTick = 0;
-            for (const auto& ev : impl->cachedEvents) {
-                auto et = static_cast<EventType>(ev.type);
-                bool skip = false;
-                if (et == EventType::NOTE_ON) {
-                    uint8_t vel = ev.data.note.v;
-                    if (vel > 0 && vel <= velIgnore) skip = true;
-                } else if (!sfxEnabled) {
-                    if (et == EventType::CC || et == EventType::PITCH_BEND || et == EventType::PROGRAM_CHANGE || et == EventType::CHANNEL_PRESSURE) skip = true;
-                }
-
-                if (skip) continue;
-
-                uint32_t delta = ev.tick - lastWrittenTick;
-                lastWrittenTick = ev.tick;
-
-                if (et == EventType::TEMPO) {
-                    uint32_t t = (uint32_t)(ev.data.tempo / speed);
-                    writeVlq(trackData, delta);
-                    trackData.push_back(0xFF); trackData.push_back(0x51); trackData.push_back(0x03);
-                    trackData.push_back((uint8_t)((t >> 16) & 0xFF));
-                    trackData.push_back((uint8_t)((t >>  8) & 0xFF));
-                    trackData.push_back((uint8_t)( t        & 0xFF));
-                } else if (et == EventType::NOTE_ON) {
-                    writeVlq(trackData, delta);
-                    trackData.push_back(static_cast<uint8_t>(0x90 | ev.channel));
-                    trackData.push_back(ev.data.note.n);
-                    trackData.push_back(ev.data.note.v);
-                } else if (et == EventType::NOTE_OFF) {
-                    writeVlq(trackData, delta);
-                    trackData.push_back(static_cast<uint8_t>(0x80 | ev.channel));
-                    trackData.push_back(ev.data.note.n);
-                    trackData.push_back(ev.data.note.v);
-                } else if (et == EventType::CC) {
-                    writeVlq(trackData, delta);
-                    trackData.push_back(static_cast<uint8_t>(0xB0 | ev.channel));
-                    trackData.push_back(ev.data.cc.c);
-                    trackData.push_back(ev.data.cc.v);
-                } else if (et == EventType::PITCH_BEND) {
-                    writeVlq(trackData, delta);
-                    trackData.push_back(static_cast<uint8_t>(0xE0 | ev.channel));
-                    trackData.push_back(ev.data.raw.l1);
-                    trackData.push_back(ev.data.raw.m2);
-                } else if (et == EventType::PROGRAM_CHANGE) {
-                    writeVlq(trackData, delta);
-                    trackData.push_back(static_cast<uint8_t>(0xC0 | ev.channel));
-                    trackData.push_back(ev.data.val);
-                }
-            }
-
-            // Tail: BASS MIDI ends decode as soon as all voices are silent —
-            // CC events and bare delta ticks are ignored once voices stop.
-            // Solution: mute channel 15 with CC7=0, send a NOTE_ON to create
-            // a real voice, wait tailTicks, NOTE_OFF. The voice keeps BASS
-            // rendering audio (= release envelopes + reverb from real channels)
-            // while outputting silence itself (CC7=0).
+            // The event filter has already been applied; the SMF image is
+            // cached on the stream, so rebuilds for voices / fonts re-encode nothing.
+            std::shared_ptr<const FilteredStream> stream;
             {
-                uint32_t lastTempo = impl->cachedInitialTempo;
-                for (const auto& ev : impl->cachedEvents)
-                    if (static_cast<EventType>(ev.type) == EventType::TEMPO)
-                        lastTempo = ev.data.tempo;
-
-                double secsPerTick = (lastTempo / 1000000.0) / impl->cachedPpq;
-                uint32_t tailTicks = (secsPerTick > 0.0)
-                    ? (uint32_t)(3.0 / secsPerTick)
-                    : (impl->cachedPpq * 6);
-
-                // All notes off + sustain off on all channels
-                for (uint8_t ch = 0; ch < 16; ++ch) {
-                    writeVlq(trackData, 0); trackData.push_back(0xB0 | ch); trackData.push_back(123); trackData.push_back(0);
-                    writeVlq(trackData, 0); trackData.push_back(0xB0 | ch); trackData.push_back(64);  trackData.push_back(0);
-                }
-                // Mute ch15 with CC7=0 so the tail note is inaudible
-                writeVlq(trackData, 0); trackData.push_back(0xBF); trackData.push_back(7); trackData.push_back(0);
-                // NOTE_ON ch15 note=60 vel=1 — creates a real voice, keeps BASS alive
-                writeVlq(trackData, 0); trackData.push_back(0x9F); trackData.push_back(60); trackData.push_back(1);
-                // Wait tailTicks — BASS renders real release/reverb from other channels
-                writeVlq(trackData, tailTicks);
-                // NOTE_OFF ch15 note=60
-                trackData.push_back(0x8F); trackData.push_back(60); trackData.push_back(0);
-                writeVlq(trackData, 0);
-                trackData.push_back(0xFF); trackData.push_back(0x2F); trackData.push_back(0x00); // EOT
+                std::lock_guard<std::mutex> lk(impl->prStreamMutex);
+                stream = impl->prStream;
             }
+            if (!stream) return 0;
+            auto midiFile = stream->EncodedSmf(impl->playbackSpeed);
 
-            std::vector<uint8_t> midiFile;
-            midiFile.reserve(14 + 8 + trackData.size());
-            const uint8_t hdr[] = { 'M','T','h','d', 0,0,0,6, 0,0, 0,1, (uint8_t)((impl->cachedPpq >> 8) & 0xFF), (uint8_t)(impl->cachedPpq & 0xFF) };
-            midiFile.insert(midiFile.end(), std::begin(hdr), std::end(hdr));
-
-            uint32_t tlen = static_cast<uint32_t>(trackData.size());
-            const uint8_t tkhdr[] = { 'M','T','r','k', (uint8_t)((tlen >> 24) & 0xFF), (uint8_t)((tlen >> 16) & 0xFF), (uint8_t)((tlen >>  8) & 0xFF), (uint8_t)(tlen & 0xFF) };
-            midiFile.insert(midiFile.end(), std::begin(tkhdr), std::end(tkhdr));
-            midiFile.insert(midiFile.end(), trackData.begin(), trackData.end());
-
-            HSTREAM s = BASS_MIDI_StreamCreateFile(TRUE, midiFile.data(), 0, static_cast<QWORD>(midiFile.size()), BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT, sr);
+            HSTREAM s = BASS_MIDI_StreamCreateFile(TRUE, midiFile->data(), 0, static_cast<QWORD>(midiFile->size()), BASS_STREAM_DECODE | BASS_SAMPLE_FLOAT, sr);
             if (s) {
                 BASS_ChannelSetAttribute(s, BASS_ATTRIB_MIDI_VOICES, static_cast<float>(impl->cfg.voices));
                 std::lock_guard<std::mutex> lk(impl->fontMutex);
@@ -604,16 +640,55 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
             return s;
         };
 
-        HSTREAM decStream = buildStream();
-        if (!decStream) {
+        // The decoder is either a BASS_MIDI file stream (soundfonts) or the
+        // built-in synth decoder, which seeks from its state snapshots instead
+        // of rescanning the song. Positions are bytes of interleaved float stereo.
+        HSTREAM decStream = 0;
+        std::unique_ptr<SoftPreRenderDecoder> softDec;
+        const QWORD kFrameBytes = 2 * sizeof(float);
+
+        auto buildDecoder = [&]() -> bool {
+            if (decStream) { BASS_StreamFree(decStream); decStream = 0; }
+            softDec.reset();
+            if (impl->cfg.preRenderSynth == RtSynth::BuiltIn) {
+                std::shared_ptr<const FilteredStream> stream;
+                {
+                    std::lock_guard<std::mutex> lk(impl->prStreamMutex);
+                    stream = impl->prStream;
+                }
+                if (!stream) return false;
+                softDec = std::make_unique<SoftPreRenderDecoder>(stream, impl->playbackSpeed, sr,
+                                                                 std::clamp(impl->cfg.voices, 16, 4096));
+                return true;
+            }
+            decStream = buildStream();
+            return decStream != 0;
+        };
+        auto decLength = [&]() -> QWORD {
+            if (softDec) return softDec->Length() * kFrameBytes;
+            return BASS_ChannelGetLength(decStream, BASS_POS_BYTE);
+        };
+        auto decSeek = [&](QWORD bytePos) -> QWORD {
+            if (softDec) return softDec->Seek(bytePos / kFrameBytes) * kFrameBytes;
+            BASS_ChannelSetPosition(decStream, bytePos, BASS_POS_BYTE);
+            return BASS_ChannelGetPosition(decStream, BASS_POS_BYTE);
+        };
+        auto decRead = [&](float* dst, DWORD bytes) -> DWORD {
+            if (softDec) return softDec->Read(dst, (uint32_t)(bytes / kFrameBytes)) * (DWORD)kFrameBytes;
+            return BASS_ChannelGetData(decStream, dst, bytes | BASS_DATA_FLOAT);
+        };
+
+        if (!buildDecoder()) {
             std::lock_guard<std::mutex> lk(impl->prMsgMutex);
-            impl->prErrorMsg = "BASS_MIDI_StreamCreateFile failed: " + std::to_string(BASS_ErrorGetCode());
+            impl->prErrorMsg = impl->cfg.preRenderSynth == RtSynth::BuiltIn
+                ? std::string("Built-in synth pre-render: no event stream to render")
+                : "BASS_MIDI_StreamCreateFile failed: " + std::to_string(BASS_ErrorGetCode());
             impl->prError.store(true);
             impl->prRunning.store(false);
             return;
         }
 
-        QWORD totalBytes = BASS_ChannelGetLength(decStream, BASS_POS_BYTE);
+        QWORD totalBytes = decLength();
         if (totalBytes == (QWORD)-1) totalBytes = (QWORD)(((double)impl->cachedTotalMicros / 1000000.0 / impl->lastRenderedSpeed) * sr * 2 * sizeof(float));
 
         std::vector<float> chunk(kDecodeChunk / sizeof(float));
@@ -625,24 +700,21 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
             if (impl->prNeedsRebuild.exchange(false)) {
                 uint64_t currentVirtualMicros = this->GetPositionMicros(); 
                 
-                if (decStream) BASS_StreamFree(decStream);
-                decStream = buildStream();
+                const bool built = buildDecoder();
                 impl->lastRenderedSpeed = impl->playbackSpeed;
 
                 
-                if (!decStream) {
+                if (!built) {
                     impl->prError.store(true);
                     break;
                 }
                 
-                totalBytes = BASS_ChannelGetLength(decStream, BASS_POS_BYTE);
+                totalBytes = decLength();
                 if (totalBytes == (QWORD)-1) totalBytes = (QWORD)(((double)impl->cachedTotalMicros / 1000000.0 / impl->lastRenderedSpeed) * sr * 2 * sizeof(float));
 
                 uint64_t targetPhysicalMicros = (uint64_t)(currentVirtualMicros / impl->lastRenderedSpeed);
                 QWORD bytePos = (QWORD)((targetPhysicalMicros / 1000000.0) * sr * 2 * sizeof(float));
-                BASS_ChannelSetPosition(decStream, bytePos, BASS_POS_BYTE);
-                
-                QWORD actualBytePos = BASS_ChannelGetPosition(decStream, BASS_POS_BYTE);
+                QWORD actualBytePos = decSeek(bytePos);
                 
                 std::lock_guard<std::mutex> lk(impl->pcmMutex);
                 std::fill(impl->pcm.begin(), impl->pcm.end(), 0.0f);
@@ -684,9 +756,7 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
                 uint64_t targetVirtualMicros = impl->seekTargetMicros.load();
                 uint64_t targetPhysicalMicros = (uint64_t)(targetVirtualMicros / impl->lastRenderedSpeed);
                 QWORD bytePos = (QWORD)((targetPhysicalMicros / 1000000.0) * sr * 2 * sizeof(float));
-                BASS_ChannelSetPosition(decStream, bytePos, BASS_POS_BYTE);
-                
-                QWORD actualBytePos = BASS_ChannelGetPosition(decStream, BASS_POS_BYTE);
+                QWORD actualBytePos = decSeek(bytePos);
                 std::lock_guard<std::mutex> lk(impl->pcmMutex);
                 impl->pcmWritePos = actualBytePos / sizeof(float);
                 impl->pcmReadPos = impl->pcmWritePos;
@@ -711,7 +781,7 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
             if (space == 0) continue;
 
             uint64_t floatsToRead = std::min((uint64_t)(kDecodeChunk / sizeof(float)), space);
-            DWORD got = BASS_ChannelGetData(decStream, chunk.data(), (DWORD)(floatsToRead * sizeof(float)) | BASS_DATA_FLOAT);
+            DWORD got = decRead(chunk.data(), (DWORD)(floatsToRead * sizeof(float)));
             
             if (got == (DWORD)-1 || got == 0) {
                 impl->prDone.store(true);
@@ -775,13 +845,29 @@ void BassPreRenderEngine::StartPreRender(const void* rawEvents, size_t eventCoun
                 }
             }
         }
-        BASS_StreamFree(decStream);
+        if (decStream) BASS_StreamFree(decStream);
+        softDec.reset();
 
         if (!impl->prRunning.load()) return;
         impl->prRunning.store(false);
     });
 }
 
+// Swap in a recompiled event stream and rebuild the decoder at the current
+// position (same flush path as a voice-count or speed change).
+void BassPreRenderEngine::SetPreRenderStream(std::shared_ptr<const FilteredStream> stream) {
+    if (!impl || !stream) return;
+    {
+        std::lock_guard<std::mutex> lk(impl->prStreamMutex);
+        if (impl->prStream == stream) return;
+        impl->prStream = std::move(stream);
+    }
+    if (impl->cfg.mode == AudioMode::BassMIDI_PreRender && impl->prRunning.load()) {
+        impl->prNeedsRebuild.store(true);
+        impl->pcmCV.notify_all();
+    }
+}
+
 void BassPreRenderEngine::CancelPreRender() {
     if (!impl) return;
     impl->prRunning.store(false);
@@ -812,20 +898,37 @@ double BassPreRenderEngine::GetBufferHealthSeconds() const {
     return 0.0;
 }
 
-void BassPreRenderEngine::SendMidiData(uint32_t msg) {
-    if (!impl || !impl->midiStream) return;
-    const uint8_t status  = msg & 0xFF;
-    const uint8_t data1   = (msg >> 8) & 0xFF;
-    const uint8_t data2   = (msg >> 16) & 0xFF;
-    // Use dynamic velocity ignore (scales with buffer health in pre-render mode)
-    double bufHealth = GetBufferHealthSeconds();
-    uint8_t velIgnore = impl->GetDynamicVelIgnore(bufHealth);
-    if ((status & 0xF0) == 0x90 && data2 <= velIgnore && data2 > 0) return;
-    if (!impl->cfg.sfxEnabled) {
-        uint8_t type = status & 0xF0;
-        if (type == 0xB0 || type == 0xE0 || type == 0xC0 || type == 0xD0) return;
-    }
-    BASS_MIDI_StreamEvents(impl->midiStream, BASS_MIDI_EVENTS_RAW, &msg, 3);
+// Filtering (velocity ignore, SFX, mutes) happens once in the compiled event
+// stream, so messages arriving here go straight to the synth.
+void BassPreRenderEngine::SendMidiData(uint32_t msg, uint16_t track) {
+    if (!impl || !impl->RtStream()) return;
+    if (impl->shardStream) { impl->shards.Send(msg, track); return; }
+    BASS_MIDI_StreamEvents(impl->midiStream, BASS_MIDI_EVENTS_RAW, &msg, ShortMsgLength(msg));
+}
+
+void BassPreRenderEngine::SendMidiLongData(const uint8_t* data, uint32_t len) {
+    if (!impl || !impl->RtStream()) return;
+    if (impl->shardStream) { impl->shards.SendLong(data, len); return; }
+    BASS_MIDI_StreamEvents(impl->midiStream, BASS_MIDI_EVENTS_RAW, data, len);
+}
+
+// ── KDMAPI long messages ──────────────────────────────────────────────────────
+// OmniMIDI exports, as declared in external/OmniMIDI.h
+extern "C" {
+    UINT WINAPI PrepareLongData(MIDIHDR* hdr, UINT size);
+    UINT WINAPI UnprepareLongData(MIDIHDR* hdr, UINT size);
+    UINT WINAPI SendDirectLongData(MIDIHDR* hdr, UINT size);
+}
+
+void SendKdmapiLongData(const uint8_t* data, uint32_t len) {
+    // KDMAPI consumes the buffer synchronously, so a stack header is enough
+    MIDIHDR hdr{};
+    hdr.lpData          = (LPSTR)data;
+    hdr.dwBufferLength  = len;
+    hdr.dwBytesRecorded = len;
+    if (PrepareLongData(&hdr, sizeof(hdr)) != MMSYSERR_NOERROR) return;
+    SendDirectLongData(&hdr, sizeof(hdr));
+    UnprepareLongData(&hdr, sizeof(hdr));
 }
 
 void BassPreRenderEngine::Play() {
@@ -855,19 +958,19 @@ void BassPreRenderEngine::Play() {
         bool restart = impl->prSeekFlush.exchange(false);
         BASS_ChannelPlay(impl->pushStream, restart ? TRUE : FALSE);
     } else {
-        if (impl->midiStream) BASS_ChannelPlay(impl->midiStream, FALSE);
+        if (HSTREAM s = impl->RtStream()) BASS_ChannelPlay(s, FALSE);
     }
 }
 
 void BassPreRenderEngine::Pause() {
     if (!impl) return;
-    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->midiStream;
+    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->RtStream();
     if (s) BASS_ChannelPause(s);
 }
 
 void BassPreRenderEngine::Stop() {
     if (!impl) return;
-    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->midiStream;
+    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->RtStream();
     if (s) { 
         BASS_ChannelStop(s); 
         if (impl->cfg.mode == AudioMode::BassMIDI_PreRender) {
@@ -898,13 +1001,13 @@ void BassPreRenderEngine::SeekTo(uint64_t seekVirtualMicros) {
 
 bool BassPreRenderEngine::IsPlaying() const {
     if (!impl) return false;
-    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->midiStream;
+    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->RtStream();
     return s && (BASS_ChannelIsActive(s) == BASS_ACTIVE_PLAYING);
 }
 
 bool BassPreRenderEngine::IsPaused() const {
     if (!impl) return false;
-    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->midiStream;
+    HSTREAM s = (impl->cfg.mode == AudioMode::BassMIDI_PreRender) ? impl->pushStream : impl->RtStream();
     return s && (BASS_ChannelIsActive(s) == BASS_ACTIVE_PAUSED);
 }
 
@@ -920,9 +1023,9 @@ uint64_t BassPreRenderEngine::GetPositionMicros() const {
         if (floatPos < 0) floatPos = 0;
         uint64_t physicalMicros = (uint64_t)((double)floatPos / 2.0 / impl->cfg.sampleRate * 1'000'000.0);
         return (uint64_t)(physicalMicros * impl->lastRenderedSpeed);
-    } else if (impl->midiStream) {
-        QWORD pos = BASS_ChannelGetPosition(impl->midiStream, BASS_POS_BYTE);
-        return (uint64_t)(BASS_ChannelBytes2Seconds(impl->midiStream, pos) * 1'000'000.0);
+    } else if (HSTREAM s = impl->RtStream()) {
+        QWORD pos = BASS_ChannelGetPosition(s, BASS_POS_BYTE);
+        return (uint64_t)(BASS_ChannelBytes2Seconds(s, pos) * 1'000'000.0);
     }
     return 0;
 }
@@ -932,10 +1035,120 @@ void BassPreRenderEngine::SetVolume(float v) {
     impl->volume = std::clamp(v, 0.0f, 1.0f);
     if (impl->midiStream) BASS_ChannelSetAttribute(impl->midiStream, BASS_ATTRIB_VOL, impl->volume);
     if (impl->pushStream) BASS_ChannelSetAttribute(impl->pushStream, BASS_ATTRIB_VOL, impl->volume);
+    if (impl->shardStream) BASS_ChannelSetAttribute(impl->shardStream, BASS_ATTRIB_VOL, impl->volume);
 }
 
 float BassPreRenderEngine::GetVolume() const {
     return impl ? impl->volume : 1.0f;
 }
 
-#endif // _WIN32
\ No newline at end of file
+#else // !_WIN32
+
+// ── No audio backend ──────────────────────────────────────────────────────────
+// BASS / BassMIDI and OmniMIDI are Windows builds here, so elsewhere the
+// engine never initialises and KDMAPI sends are dropped; the player is meant
+// to run with --null-audio (the benchmark does). Settings are still kept so
+// the Audio Config panel and its save file round-trip.
+
+#include <algorithm>
+
+#include "bass_backend.hpp"
+
+struct BassPreRenderEngine::Impl {
+    BassConfig                  cfg;
+    std::vector<SoundFontEntry> fonts;
+    float                       volume = 1.0f;
+};
+
+BassPreRenderEngine g_BassEngine;
+
+BassPreRenderEngine::BassPreRenderEngine() { impl = new Impl(); }
+BassPreRenderEngine::~BassPreRenderEngine() { delete impl; impl = nullptr; }
+
+bool BassPreRenderEngine::Init(void*)        { return false; }
+void BassPreRenderEngine::Shutdown()         {}
+bool BassPreRenderEngine::IsInitialized() const { return false; }
+
+void BassPreRenderEngine::ApplyConfig(const BassConfig& cfg) {
+    // Velocity ignore / SFX still shape the compiled stream the null sink counts
+    EventFilterConfig fc = g_EventFilter.GetConfig();
+    fc.velocityIgnore = cfg.velocityIgnore;
+    if (cfg.sfxEnabled != impl->cfg.sfxEnabled)
+        fc.stripCC = fc.stripPitchBend = fc.stripProgram = fc.stripPressure = !cfg.sfxEnabled;
+    g_EventFilter.SetConfig(fc);
+    impl->cfg = cfg;
+}
+const BassConfig& BassPreRenderEngine::GetConfig() const { return impl->cfg; }
+
+void BassPreRenderEngine::SetMode(AudioMode m)              { impl->cfg.mode = m; }
+void BassPreRenderEngine::SetVoices(int v)                  { impl->cfg.voices = v; }
+void BassPreRenderEngine::SetVelocityIgnore(uint8_t v)      { BassConfig c = impl->cfg; c.velocityIgnore = v; ApplyConfig(c); }
+void BassPreRenderEngine::SetPreRenderBufferSec(float sec)  { impl->cfg.preRenderBufferSec = sec; }
+void BassPreRenderEngine::SetLowBufferMode(bool on)         { impl->cfg.lowBufferMode = on; }
+void BassPreRenderEngine::SetSfxEnabled(bool on) {
+    impl->cfg.sfxEnabled = on;
+    EventFilterConfig fc = g_EventFilter.GetConfig();
+    fc.stripCC = fc.stripPitchBend = fc.stripProgram = fc.stripPressure = !on;
+    g_EventFilter.SetConfig(fc);
+}
+void BassPreRenderEngine::SetPlaybackSpeed(float)           {}
+void BassPreRenderEngine::SetRtSharding(int shards, ShardKey key, RtSynth synth) {
+    impl->cfg.rtShards   = shards;
+    impl->cfg.rtShardKey = key;
+    impl->cfg.rtSynth    = synth;
+}
+void BassPreRenderEngine::SetPreRenderSynth(RtSynth synth)  { impl->cfg.preRenderSynth = synth; }
+std::vector<ShardStats> BassPreRenderEngine::GetShardStats() const { return {}; }
+
+AudioMode BassPreRenderEngine::GetActiveMode() const { return impl->cfg.mode; }
+
+bool BassPreRenderEngine::AddSoundFont(const std::string& path) {
+    SoundFontEntry fe;
+    fe.path = path;
+    impl->fonts.push_back(fe);
+    return true;
+}
+void BassPreRenderEngine::RemoveSoundFont(size_t index) {
+    if (index < impl->fonts.size()) impl->fonts.erase(impl->fonts.begin() + (ptrdiff_t)index);
+}
+void BassPreRenderEngine::MoveSoundFontUp(size_t index) {
+    if (index > 0 && index < impl->fonts.size()) std::swap(impl->fonts[index], impl->fonts[index - 1]);
+}
+void BassPreRenderEngine::MoveSoundFontDown(size_t index) {
+    if (index + 1 < impl->fonts.size()) std::swap(impl->fonts[index], impl->fonts[index + 1]);
+}
+void BassPreRenderEngine::SetSoundFontEnabled(size_t index, bool on) {
+    if (index < impl->fonts.size()) impl->fonts[index].enabled = on;
+}
+const std::vector<SoundFontEntry>& BassPreRenderEngine::GetSoundFonts() const { return impl->fonts; }
+void BassPreRenderEngine::ReloadAllSoundFonts() {}
+
+void BassPreRenderEngine::StartPreRender(std::shared_ptr<const FilteredStream>, uint64_t) {}
+void BassPreRenderEngine::SetPreRenderStream(std::shared_ptr<const FilteredStream>) {}
+void BassPreRenderEngine::CancelPreRender() {}
+PreRenderStatus BassPreRenderEngine::GetPreRenderStatus() const { return {}; }
+double BassPreRenderEngine::GetBufferHealthSeconds() const { return 0.0; }
+
+void BassPreRenderEngine::SendMidiData(uint32_t, uint16_t) {}
+void BassPreRenderEngine::SendMidiLongData(const uint8_t*, uint32_t) {}
+
+void     BassPreRenderEngine::Play()   {}
+void     BassPreRenderEngine::Pause()  {}
+void     BassPreRenderEngine::Stop()   {}
+void     BassPreRenderEngine::SeekTo(uint64_t) {}
+bool     BassPreRenderEngine::IsPlaying() const { return false; }
+bool     BassPreRenderEngine::IsPaused()  const { return false; }
+uint64_t BassPreRenderEngine::GetPositionMicros() const { return 0; }
+
+void  BassPreRenderEngine::SetVolume(float v) { impl->volume = std::clamp(v, 0.0f, 1.0f); }
+float BassPreRenderEngine::GetVolume() const  { return impl->volume; }
+
+// KDMAPI entry points the player links against on Windows (OmniMIDI)
+extern "C" {
+    bool InitializeKDMAPIStream() { return false; }
+    void TerminateKDMAPIStream() {}
+    void SendDirectData(unsigned long) {}
+}
+void SendKdmapiLongData(const uint8_t*, uint32_t) {}
+
+#endif // _WIN32
@@ -0,0 +1,206 @@
+#include "benchmark.hpp"
+#include "build_info.hpp"
+#include "emulated_sink.hpp"    // g_NullSink
+#include "load_telemetry.hpp"   // g_LoadTelemetry, JsonEscape
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+BenchmarkRun g_Benchmark;
+
+// Seeks land on both sides of the chunk window, the speed change doubles the
+// dispatch rate, and the viewer cycle ends where it started (three presses).
+static constexpr BenchStep kScript[] = {
+    { 0.00, BenchAction::Play,        0.0,  "play" },
+    { 0.15, BenchAction::SeekBy,      10.0, "seek +10 s" },
+    { 0.25, BenchAction::Speed,       2.0,  "speed x2" },
+    { 0.35, BenchAction::Speed,       1.0,  "speed x1" },
+    { 0.45, BenchAction::SeekBy,      -5.0, "seek -5 s" },
+    { 0.55, BenchAction::CycleViewer, 0.0,  "viewer cycle 1/3" },
+    { 0.62, BenchAction::CycleViewer, 0.0,  "viewer cycle 2/3" },
+    { 0.69, BenchAction::CycleViewer, 0.0,  "viewer cycle 3/3" },
+    { 0.76, BenchAction::TimeDomain,  0.0,  "time-domain scroll toggle" },
+    { 0.83, BenchAction::TimeDomain,  0.0,  "time-domain scroll toggle back" },
+    { 0.90, BenchAction::SeekTo,      0.5,  "seek to 50%" },
+};
+static constexpr size_t kScriptSteps = sizeof(kScript) / sizeof(kScript[0]);
+
+static std::string Num(double v) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.3f", v);
+    return buf;
+}
+
+bool BenchmarkRun::ParseArg(int& i, int argc, char* argv[]) {
+    const std::string arg = argv[i];
+    if (i + 1 >= argc) return false;
+    if (arg == "--benchmark") {
+        enabled = true;
+        file    = argv[++i];
+    } else if (arg == "--speed") {
+        speed = std::clamp((float)std::atof(argv[++i]), 0.01f, 100.0f);
+    } else if (arg == "--duration") {
+        const double sec = std::atof(argv[++i]);
+        durationSec = sec > 0.0 ? sec : kDefaultDurationSec;
+    } else if (arg == "--report") {
+        reportPath = argv[++i];
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void BenchmarkRun::Begin(double songSeconds, uint64_t notes, size_t tracks) {
+    songSec    = songSeconds;
+    noteCount  = notes;
+    trackCount = tracks;
+    nextStep   = 0;
+    steps.clear();
+    {
+        std::lock_guard<std::mutex> lk(paintMtx);
+        paintLatency.Reset();
+    }
+    g_NullSink.ResetStats();
+    start = Clock::now();
+    running.store(true, std::memory_order_release);
+    std::cout << "+ Benchmark: " << durationSec << " s at " << speed << "x, report to " << reportPath << std::endl;
+}
+
+void BenchmarkRun::OnFrame(double frameMs) {
+    if (!Running() || steps.empty()) return;
+    StepResult& s = steps.back();
+    if (Elapsed() - s.atSec <= kStepWindowSec) s.worstFrameMs = std::max(s.worstFrameMs, frameMs);
+}
+
+bool BenchmarkRun::NextStep(BenchStep& out) {
+    if (!Running() || nextStep >= kScriptSteps) return false;
+    const double now = Elapsed();
+    if (now < kScript[nextStep].at * durationSec) return false;
+    out = kScript[nextStep++];
+    steps.push_back({ out.label, now, 0.0 });
+    std::cout << "+ Benchmark step: " << out.label << std::endl;
+    return true;
+}
+
+bool BenchmarkRun::Expired(bool songFinished) const {
+    if (!Running()) return false;
+    return Elapsed() >= durationSec || (songFinished && nextStep > 0);
+}
+
+void BenchmarkRun::RecordPaintLatency(double ms) {
+    if (!Running()) return;
+    std::lock_guard<std::mutex> lk(paintMtx);
+    paintLatency.Record((uint64_t)(ms * 1000.0));
+}
+
+void BenchmarkRun::Abort(const char* why) {
+    running.store(false, std::memory_order_release);
+    done   = true;
+    failed = true;
+    std::cout << "[warn] Benchmark aborted: " << why << std::endl;
+}
+
+bool BenchmarkRun::Finish(bool songFinished) {
+    const double ranSec = Elapsed();
+    running.store(false, std::memory_order_release);
+    done   = true;
+    failed = true;   // until the report is on disk
+
+    std::ofstream out(reportPath, std::ios::trunc);
+    if (!out) {
+        std::cout << "[warn] Benchmark: cannot write " << reportPath << std::endl;
+        return false;
+    }
+
+    // Opens an object and leaves it open for extra fields. The buffer-health
+    // block reports its low tail, so `low` renames the keys to match.
+    auto percentiles = [&](const char* name, const FrameStats::Percentiles& p, bool low) {
+        out << "  \"" << name << "\": {\"samples\": " << p.count
+            << ", \"p50Ms\": " << Num(p.p50)
+            << (low ? ", \"p1Ms\": " : ", \"p99Ms\": ") << Num(p.p99)
+            << (low ? ", \"p01Ms\": " : ", \"p999Ms\": ") << Num(p.p999)
+            << (low ? ", \"minMs\": " : ", \"maxMs\": ") << Num(p.max);
+    };
+
+    out << "{\n";
+    out << "  \"build\": " << BUILD_NUMBER << ",\n";
+#ifdef _WIN32
+    out << "  \"platform\": \"windows\",\n";
+#else
+    out << "  \"platform\": \"linux\",\n";
+#endif
+    out << "  \"hardwareThreads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"file\": \"" << JsonEscape(file) << "\",\n";
+    out << "  \"notes\": " << noteCount << ",\n";
+    out << "  \"tracks\": " << trackCount << ",\n";
+    out << "  \"songSeconds\": " << Num(songSec) << ",\n";
+    out << "  \"speed\": " << Num(speed) << ",\n";
+    out << "  \"durationSec\": " << Num(durationSec) << ",\n";
+    out << "  \"ranSec\": " << Num(ranSec) << ",\n";
+    out << "  \"songFinished\": " << (songFinished ? "true" : "false") << ",\n";
+
+    // ── Load ──
+    out << "  \"load\": {\"totalMs\": " << Num(g_LoadTelemetry.ElapsedMs()) << ", \"stages\": [";
+    const auto stages = g_LoadTelemetry.Stages();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const auto& s = stages[i];
+        out << (i ? ", " : "") << "{\"name\": \"" << JsonEscape(s.name) << "\", \"wallMs\": " << Num(s.wallMs)
+            << ", \"cpuMs\": " << Num(s.cpuMs) << ", \"rssPeakMB\": " << s.rssPeakMB << "}";
+    }
+    out << "]},\n";
+
+    // ── Frames ──
+    const FrameStats::Percentiles frame = g_FrameStats.SessionFrameTime();
+    const double clock = g_FrameStats.SessionSeconds();
+    percentiles("frameTime", frame, false);
+    out << ", \"avgFps\": " << Num(clock > 0.0 ? (double)g_FrameStats.Frames() / clock : 0.0)
+        << ", \"stutters\": " << g_FrameStats.StutterCount()
+        << ", \"stutterThresholdMs\": " << Num(g_FrameStats.StutterThresholdMs()) << "},\n";
+
+    // ── Painter ──
+    FrameStats::Percentiles paint;
+    {
+        std::lock_guard<std::mutex> lk(paintMtx);
+        paint.count = paintLatency.Count();
+        paint.p50   = paintLatency.ValueAt(0.50)  / 1000.0;
+        paint.p99   = paintLatency.ValueAt(0.99)  / 1000.0;
+        paint.p999  = paintLatency.ValueAt(0.999) / 1000.0;
+        paint.max   = paintLatency.Max()          / 1000.0;
+    }
+    percentiles("painterLatency", paint, false);
+    out << "},\n";
+
+    // ── Dispatch ──
+    percentiles("dispatchLateness", g_FrameStats.SessionDispatchLateness(), false);
+    out << ", \"events\": " << g_NullSink.Events() << ", \"sysex\": " << g_NullSink.LongEvents() << "},\n";
+
+    // ── Buffer health (pre-render only; none under the null sink) ──
+    const FrameStats::Percentiles buf = g_FrameStats.SessionBufferHealthLow();
+    if (buf.count) {
+        percentiles("bufferHealth", buf, true);
+        out << "},\n";
+    } else {
+        out << "  \"bufferHealth\": null,\n";
+    }
+
+    // ── Script ──
+    out << "  \"steps\": [";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        out << (i ? "," : "") << "\n    {\"label\": \"" << JsonEscape(steps[i].label) << "\", \"atSec\": " << Num(steps[i].atSec)
+            << ", \"worstFrameMs\": " << Num(steps[i].worstFrameMs) << "}";
+    }
+    out << "\n  ]\n}\n";
+    out.close();
+
+    if (!out) {
+        std::cout << "[warn] Benchmark: writing " << reportPath << " failed" << std::endl;
+        return false;
+    }
+    std::cout << "+ Benchmark report written: " << reportPath << std::endl;
+    failed = false;
+    return true;
+}
@@ -0,0 +1,142 @@
+#include "cc_lanes.hpp"
+#include "event_splice.hpp"
+
+#include <algorithm>
+
+static int LaneOf(uint8_t controller) {
+    switch (controller) {
+        case 64:            return (int)CCLane::Sustain;
+        case 7:             return (int)CCLane::Volume;
+        case 11:            return (int)CCLane::Expression;
+        case 10:            return (int)CCLane::Pan;
+        case CC_PITCH_BEND: return (int)CCLane::PitchBend;
+        default:            return -1;
+    }
+}
+
+const char* CCLaneIndex::LaneName(CCLane lane) {
+    switch (lane) {
+        case CCLane::Sustain:    return "Sustain";
+        case CCLane::Volume:     return "Volume";
+        case CCLane::Expression: return "Expression";
+        case CCLane::Pan:        return "Pan";
+        case CCLane::PitchBend:  return "Pitch Bend";
+        default:                 return "?";
+    }
+}
+
+uint8_t CCLaneIndex::DefaultValue(CCLane lane) {
+    switch (lane) {
+        case CCLane::Volume:     return 100;
+        case CCLane::Expression: return 127;
+        case CCLane::Pan:        return 64;
+        case CCLane::PitchBend:  return 64;   // centre
+        default:                 return 0;
+    }
+}
+
+void CCLaneIndex::Clear() {
+    for (auto& lane : series)
+        for (auto& s : lane) s = SeriesData{};
+    eventCount = 0;
+}
+
+// Several changes on one tick: the highest, whatever order they came in
+void CCLaneIndex::AddStep(SeriesData& s, uint32_t tick, uint8_t value) {
+    if (!s.ticks.empty() && s.ticks.back() == tick) { s.values.back() = std::max(s.values.back(), value); return; }
+    s.ticks.push_back(tick);
+    s.values.push_back(value);
+}
+
+void CCLaneIndex::Build(const std::vector<CCEvent>& events) {
+    Clear();
+    // Two passes: count, then fill exactly-sized arrays
+    size_t counts[CC_LANE_COUNT][16] = {};
+    for (const auto& e : events) {
+        int l = LaneOf(e.controller);
+        if (l >= 0) counts[l][e.channel & 15]++;
+    }
+    for (int l = 0; l < CC_LANE_COUNT; ++l)
+        for (int ch = 0; ch < 16; ++ch) {
+            series[l][ch].ticks.reserve(counts[l][ch]);
+            series[l][ch].values.reserve(counts[l][ch]);
+        }
+
+    for (const auto& e : events) {
+        int l = LaneOf(e.controller);
+        if (l >= 0) AddStep(series[l][e.channel & 15], e.tick, e.value);
+    }
+    for (const auto& lane : series)
+        for (const auto& s : lane) eventCount += s.ticks.size();
+}
+
+void CCLaneIndex::Splice(uint32_t lo, uint32_t hi, const std::vector<CCEvent>& events) {
+    SeriesData fresh[CC_LANE_COUNT][16];
+    for (const auto& e : events) {
+        int l = LaneOf(e.controller);
+        if (l >= 0 && e.tick >= lo && e.tick <= hi) AddStep(fresh[l][e.channel & 15], e.tick, e.value);
+    }
+    for (int l = 0; l < CC_LANE_COUNT; ++l)
+        for (int ch = 0; ch < 16; ++ch) {
+            SeriesData& s = series[l][ch];
+            const SeriesData& f = fresh[l][ch];
+            const size_t a = (size_t)(std::lower_bound(s.ticks.begin(), s.ticks.end(), lo) - s.ticks.begin());
+            const size_t b = (size_t)(std::upper_bound(s.ticks.begin() + (ptrdiff_t)a, s.ticks.end(), hi) - s.ticks.begin());
+            if (a == b && f.ticks.empty()) continue;
+            eventCount = eventCount - (b - a) + f.ticks.size();
+            ReplaceRange(s.ticks, a, b, f.ticks);
+            ReplaceRange(s.values, a, b, f.values);
+            for (auto& c : s.cache) c.chunk = UINT64_MAX;
+        }
+}
+
+bool CCLaneIndex::LaneHasData(CCLane lane) const {
+    for (uint8_t ch = 0; ch < 16; ++ch)
+        if (HasData(lane, ch)) return true;
+    return false;
+}
+
+uint8_t CCLaneIndex::ValueAt(CCLane lane, uint8_t ch, uint32_t tick) const {
+    const SeriesData& s = Series(lane, ch);
+    auto it = std::upper_bound(s.ticks.begin(), s.ticks.end(), tick);
+    if (it == s.ticks.begin()) return DefaultValue(lane);
+    return s.values[(size_t)(it - s.ticks.begin()) - 1];
+}
+
+const std::vector<CCLaneIndex::Point>& CCLaneIndex::ChunkPolyline(CCLane lane, uint8_t ch,
+                                                                  uint64_t chunkIdx, uint32_t chunkTicks) {
+    SeriesData& s = Series(lane, ch);
+    const uint64_t stamp = ++stampClock;
+
+    CacheSlot* slot = nullptr;
+    for (auto& c : s.cache)
+        if (c.chunk == chunkIdx && c.ticks == chunkTicks) { c.stamp = stamp; return c.points; }
+    for (auto& c : s.cache)
+        if (!slot || c.stamp < slot->stamp) slot = &c;   // least recently used
+
+    slot->chunk = chunkIdx;
+    slot->ticks = chunkTicks;
+    slot->stamp = stamp;
+    slot->points.clear();
+
+    const uint64_t begin64 = chunkIdx * (uint64_t)chunkTicks;
+    const uint32_t begin = (uint32_t)std::min<uint64_t>(begin64, UINT32_MAX);
+    const uint32_t end   = (uint32_t)std::min<uint64_t>(begin64 + chunkTicks, UINT32_MAX);
+
+    // Window [begin, end): two binary searches, then a straight walk
+    auto lo = std::upper_bound(s.ticks.begin(), s.ticks.end(), begin);
+    auto hi = std::lower_bound(lo, s.ticks.end(), end);
+    uint8_t v = (lo == s.ticks.begin()) ? DefaultValue(lane) : s.values[(size_t)(lo - s.ticks.begin()) - 1];
+
+    slot->points.reserve((size_t)(hi - lo) * 2 + 2);
+    slot->points.push_back({ begin, v });
+    for (auto it = lo; it != hi; ++it) {
+        const uint8_t nv = s.values[(size_t)(it - s.ticks.begin())];
+        if (nv == v) continue;   // a repeat adds no corner
+        slot->points.push_back({ *it, v });
+        slot->points.push_back({ *it, nv });
+        v = nv;
+    }
+    slot->points.push_back({ end, v });
+    return slot->points;
+}
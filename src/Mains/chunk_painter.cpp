@@ -0,0 +1,163 @@
+#include "chunk_painter.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+uint64_t PaintChunkRange(const ChunkPaintContext& ctx, uint32_t tickStart, uint32_t tickEnd,
+                         uint32_t* out, size_t outStride, uint32_t stride)
+{
+    if (!ctx.tracks || ctx.width <= 0 || tickEnd <= tickStart) return 0;
+    const auto&  tracks = *ctx.tracks;
+    const auto&  masks  = *ctx.masks;
+    const int    W      = ctx.width;
+    const double ppt    = ctx.pixPerTick;
+    auto cancelled = [&ctx]() { return ctx.cancel && ctx.cancel->load(std::memory_order_relaxed); };
+    auto colorOf   = [&ctx](size_t t, uint8_t ch) { return ToRGBA8(ctx.palette[(t * 16 + ch) % (size_t)ctx.paletteSize]); };
+
+    // Clear chunk
+    for (int y = 0; y < kChunkRows; ++y)
+        std::memset(out + (size_t)y * outStride, 0, (size_t)W * sizeof(uint32_t));
+
+    uint64_t count = 0;
+
+    if (ctx.viewer == ViewerType::TickLayer) {
+        struct NoteRef {
+            const NoteEvent* note;
+            uint16_t trackIdx;
+        };
+
+        thread_local std::vector<NoteRef> chunkNotes;
+        chunkNotes.clear();
+
+        if (chunkNotes.capacity() < 2000000) chunkNotes.reserve(2000000);
+
+        for (size_t t = 0; t < tracks.size(); ++t) {
+            if (cancelled()) return 0;
+            const auto& track = tracks[t];
+            if (track.notes.empty() || !masks.TrackVisible(t)) continue;
+
+            const NoteAxis ax = NoteAxis::For(tracks, ctx.times, t);
+            auto it = std::lower_bound(track.notes.begin(), track.notes.end(), tickStart,
+                [&ax](const NoteEvent& n, uint32_t v){ return ax.Start(n) < v; });
+
+            auto ri = it;
+            while (ri != track.notes.begin()) {
+                --ri;
+                if (ax.End(*ri) <= tickStart) { ++ri; break; }
+            }
+
+            for (; ri != track.notes.end() && ax.Start(*ri) < tickEnd; ++ri) {
+                const NoteEvent& n = *ri;
+                if (stride > 1 && (size_t)(&n - ax.base) % stride) continue;
+                const uint32_t ns = ax.Start(n), rawEnd = ax.End(n);
+                uint32_t ds = (ns > tickStart) ? ns : tickStart;
+                uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
+                if (ds >= de) continue;
+
+                int px0 = (int)((double)(ds - tickStart) * ppt);
+                int px1 = (int)((double)(de - tickStart) * ppt) + 1;
+                if (px0 < 0)  px0 = 0;
+                if (px1 > W)  px1 = W;
+                if (px0 >= px1) continue;
+
+                int y = (kChunkRows - 1) - (int)n.note;
+                if ((unsigned)y >= (unsigned)kChunkRows) continue;
+                if (!masks.ChannelVisible(n.channel)) continue;
+
+                chunkNotes.push_back({&n, (uint16_t)t});
+            }
+        }
+
+        // Lux's fix: merge all tracks into one array, sort by startTick ascending,
+        // then draw in REVERSE (latest tick first = background, earliest tick last = foreground).
+        // "First note played = on top" — matches PFA layering behavior exactly.
+        // if (row[px] == 0) guard means first writer wins = earliest tick wins each pixel.
+        std::sort(chunkNotes.begin(), chunkNotes.end(), [](const NoteRef& a, const NoteRef& b){
+            if (a.note->startTick != b.note->startTick) return a.note->startTick < b.note->startTick;
+            return a.trackIdx < b.trackIdx; // same tick: track 0 drawn last = on top
+        });
+
+        for (int i = (int)chunkNotes.size() - 1; i >= 0; --i) {
+            if (cancelled()) return 0;
+            const auto& ref = chunkNotes[i];
+            const NoteEvent& n = *ref.note;
+            const NoteAxis ax = NoteAxis::For(tracks, ctx.times, ref.trackIdx);
+            const uint32_t ns = ax.Start(n), rawEnd = ax.End(n);
+            uint32_t ds = (ns > tickStart) ? ns : tickStart;
+            uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
+            if (ds >= de) continue;
+
+            int px0 = (int)((double)(ds - tickStart) * ppt);
+            int px1 = (int)((double)(de - tickStart) * ppt) + 1;
+            if (px0 < 0)  px0 = 0;
+            if (px1 > W)  px1 = W;
+            if (px0 >= px1) continue;
+
+            int y = (kChunkRows - 1) - (int)n.note;
+            if ((unsigned)y >= (unsigned)kChunkRows) continue;
+
+            uint32_t rgba = colorOf(ref.trackIdx, n.channel);
+            uint32_t* row = out + (size_t)y * outStride;
+
+            ++count;
+            for (int px = px0; px < px1; ++px) {
+                if (row[px] == 0) row[px] = rgba;
+            }
+        }
+    } else {
+        // Exact duplicate culling is safe here: ChannelTrackLayer draws directly
+        // in reverse order (track N-1 first), so the sort order is already correct.
+        for (int t = (int)tracks.size() - 1; t >= 0; --t) {
+            if (cancelled()) return 0;
+            const auto& track = tracks[t];
+            if (track.notes.empty() || !masks.TrackVisible((size_t)t)) continue;
+
+            const NoteAxis ax = NoteAxis::For(tracks, ctx.times, (size_t)t);
+            auto it = std::lower_bound(track.notes.begin(), track.notes.end(), tickStart,
+                [&ax](const NoteEvent& n, uint32_t v){ return ax.Start(n) < v; });
+
+            auto ri_start = it;
+            while (ri_start != track.notes.begin()) {
+                --ri_start;
+                if (ax.End(*ri_start) <= tickStart) { ++ri_start; break; }
+            }
+
+            auto ri_end = ri_start;
+            while (ri_end != track.notes.end() && ax.Start(*ri_end) < tickEnd) {
+                ++ri_end;
+            }
+
+            if (ri_start == ri_end) continue;
+
+            auto ri = ri_end;
+            do {
+                --ri;
+                const NoteEvent& n = *ri;
+                if (stride > 1 && (size_t)(&n - ax.base) % stride) continue;
+                const uint32_t ns = ax.Start(n), rawEnd = ax.End(n);
+                uint32_t ds = (ns > tickStart) ? ns : tickStart;
+                uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
+                if (ds >= de) continue;
+
+                int px0 = (int)((double)(ds - tickStart) * ppt);
+                int px1 = (int)((double)(de - tickStart) * ppt) + 1;
+                if (px0 < 0)  px0 = 0;
+                if (px1 > W)  px1 = W;
+                if (px0 >= px1) continue;
+
+                int y = (kChunkRows - 1) - (int)n.note;
+                if ((unsigned)y >= (unsigned)kChunkRows) continue;
+                if (!masks.ChannelVisible(n.channel)) continue;
+                uint32_t rgba = colorOf((size_t)t, n.channel);
+                uint32_t* row = out + (size_t)y * outStride;
+
+                ++count;
+				for (int px = px0; px < px1; ++px) {
+					if (row[px] == 0) row[px] = rgba; // already-painted pixel = skip, not black hole
+				}
+            } while (ri != ri_start);
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,178 @@
+#include "emulated_sink.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+EmulatedSink g_EmulatedSink;
+NullSink     g_NullSink;
+
+// ── SinkModel ─────────────────────────────────────────────────────────────────
+
+SinkModel::SinkModel(const SinkModelConfig& c) : cfg(c) {
+    cfg.queueDepth = std::max<uint32_t>(1, cfg.queueDepth);
+}
+
+void SinkModel::Reset() {
+    completions.clear();
+    lastCompletion = 0;
+    std::fill(&held[0][0], &held[0][0] + 16 * 128, (uint16_t)0);
+    stats        = {};
+    latencySumNs = 0.0;
+    latency.fill(0);
+}
+
+void SinkModel::TrackVoices(uint32_t msg) {
+    const uint8_t status = msg & 0xF0;
+    const uint8_t ch     = msg & 0x0F;
+    const uint8_t key    = (msg >> 8) & 0x7F;
+    const uint8_t vel    = (msg >> 16) & 0x7F;
+
+    if (status == 0x90 && vel > 0) {
+        held[ch][key]++;
+        if (stats.voices < cfg.maxVoices) stats.voices++;   // else a voice is stolen
+        stats.peakVoices = std::max(stats.peakVoices, stats.voices);
+    } else if (status == 0x80 || status == 0x90) {
+        if (held[ch][key] > 0) {
+            held[ch][key]--;
+            if (stats.voices > 0) stats.voices--;
+        }
+    } else if (status == 0xB0 && (key == 120 || key == 123)) {
+        uint32_t n = 0;
+        for (auto& h : held[ch]) { n += h; h = 0; }
+        stats.voices -= std::min(stats.voices, n);
+    }
+}
+
+void SinkModel::RecordLatency(uint64_t ns) {
+    const int b = (ns == 0) ? 0 : std::min(kLatencyBuckets - 1, 1 + (int)(std::log2((double)ns) * 8.0));
+    latency[b]++;
+    latencySumNs += (double)ns;
+    stats.maxLatencyNs = std::max(stats.maxLatencyNs, ns);
+}
+
+SinkModel::Result SinkModel::Enqueue(double serviceNs, uint64_t nowNs, bool noteOn) {
+    Result r;
+    stats.submitted++;
+    while (!completions.empty() && completions.front() <= nowNs) completions.pop_front();
+
+    uint64_t start = nowNs;
+    if (completions.size() >= cfg.queueDepth) {
+        const bool drop = cfg.overflow == SinkOverflow::DropNewest ||
+                          (cfg.overflow == SinkOverflow::DropNoteOns && noteOn);
+        if (drop) {
+            stats.dropped++;
+            return r;
+        }
+        // Block until the oldest queued event has been serviced
+        start = completions.front();
+        completions.pop_front();
+        r.blockedNs = start - nowNs;
+        stats.blocked++;
+        stats.blockedNs += r.blockedNs;
+    }
+
+    const uint64_t begin = std::max(start, lastCompletion);
+    lastCompletion = begin + (uint64_t)std::llround(std::max(0.0, serviceNs));
+    completions.push_back(lastCompletion);
+    stats.maxQueue = std::max<uint64_t>(stats.maxQueue, completions.size());
+    stats.accepted++;
+
+    r.accepted  = true;
+    r.latencyNs = lastCompletion - nowNs;
+    RecordLatency(r.latencyNs);
+    return r;
+}
+
+SinkModel::Result SinkModel::Submit(uint32_t msg, uint64_t nowNs) {
+    const bool noteOn = (msg & 0xF0) == 0x90 && ((msg >> 16) & 0x7F) > 0;
+    // Cost is taken at the current polyphony, before this event changes it
+    const double service = cfg.eventCostNs + cfg.voiceCostNs * (double)stats.voices;
+    Result r = Enqueue(service, nowNs, noteOn);
+    if (r.accepted) TrackVoices(msg);
+    return r;
+}
+
+SinkModel::Result SinkModel::SubmitLong(uint32_t len, uint64_t nowNs) {
+    return Enqueue(cfg.eventCostNs + cfg.byteCostNs * (double)len, nowNs, false);
+}
+
+SinkStats SinkModel::Stats() const {
+    SinkStats s = stats;
+    if (s.accepted == 0) return s;
+    s.meanLatencyNs = latencySumNs / (double)s.accepted;
+
+    auto percentile = [&](double q) -> uint64_t {
+        const uint64_t want = (uint64_t)std::ceil(q * (double)s.accepted);
+        uint64_t seen = 0;
+        for (int b = 0; b < kLatencyBuckets; ++b) {
+            seen += latency[b];
+            if (seen >= want) return b == 0 ? 0 : (uint64_t)std::exp2((double)(b - 1) / 8.0);
+        }
+        return s.maxLatencyNs;
+    };
+    s.p50LatencyNs = percentile(0.50);
+    s.p99LatencyNs = percentile(0.99);
+    return s;
+}
+
+// ── EmulatedSink ──────────────────────────────────────────────────────────────
+
+void EmulatedSink::SetEnabled(bool on) {
+    if (on && !enabled.load()) ResetStats();
+    enabled.store(on, std::memory_order_relaxed);
+    if (!on) blocking.store(false, std::memory_order_relaxed);
+}
+
+void EmulatedSink::Configure(const SinkModelConfig& cfg) {
+    std::lock_guard<std::mutex> lk(mtx);
+    model = SinkModel(cfg);
+}
+
+SinkModelConfig EmulatedSink::GetConfig() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return model.Config();
+}
+
+uint64_t EmulatedSink::NowNs() const {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count();
+}
+
+void EmulatedSink::Wait(uint64_t ns) {
+    blocking.store(ns > 0, std::memory_order_relaxed);
+    if (ns == 0) return;
+    // Sleep the bulk, spin the tail: waits are often shorter than a scheduler tick
+    const auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns);
+    if (ns > 2'000'000) std::this_thread::sleep_for(std::chrono::nanoseconds(ns - 1'000'000));
+    while (std::chrono::steady_clock::now() < until) std::this_thread::yield();
+}
+
+void EmulatedSink::Send(uint32_t msg) {
+    SinkModel::Result r;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        r = model.Submit(msg, NowNs());
+    }
+    Wait(r.blockedNs);
+}
+
+void EmulatedSink::SendLong(const uint8_t* data, uint32_t len) {
+    (void)data;
+    SinkModel::Result r;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        r = model.SubmitLong(len, NowNs());
+    }
+    Wait(r.blockedNs);
+}
+
+SinkStats EmulatedSink::GetStats() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return model.Stats();
+}
+
+void EmulatedSink::ResetStats() {
+    std::lock_guard<std::mutex> lk(mtx);
+    model.Reset();
+}
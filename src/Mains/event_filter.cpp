@@ -0,0 +1,337 @@
+#include "event_filter.hpp"
+#include "event_splice.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <unordered_map>
+
+EventFilterPipeline g_EventFilter;
+
+// ── EventFilterConfig ─────────────────────────────────────────────────────────
+bool EventFilterConfig::IsPassThrough() const {
+    if (velocityIgnore || minNoteTicks) return false;
+    if (keyLow > 0 || keyHigh < 127) return false;
+    if (stripCC || stripPitchBend || stripProgram || stripPressure) return false;
+    return true;
+}
+
+// ── SMF encoding (pre-render) ─────────────────────────────────────────────────
+static void WriteVlq(std::vector<uint8_t>& buf, uint32_t v) {
+    uint8_t tmp[4]; int n = 0;
+    do { tmp[n++] = static_cast<uint8_t>(v & 0x7F); v >>= 7; } while (v && n < 4);
+    for (int i = n - 1; i >= 0; --i) buf.push_back(tmp[i] | (i ? 0x80u : 0u));
+}
+
+static void WriteTempo(std::vector<uint8_t>& buf, uint32_t t) {
+    buf.push_back(0xFF); buf.push_back(0x51); buf.push_back(0x03);
+    buf.push_back(static_cast<uint8_t>((t >> 16) & 0xFF));
+    buf.push_back(static_cast<uint8_t>((t >>  8) & 0xFF));
+    buf.push_back(static_cast<uint8_t>( t        & 0xFF));
+}
+
+std::shared_ptr<const std::vector<uint8_t>> FilteredStream::EncodedSmf(float speed) const {
+    std::lock_guard<std::mutex> lk(smfMutex);
+    if (smf && smfSpeed == speed) return smf;
+
+    const auto& events = Events();
+    std::vector<uint8_t> trackData;
+    trackData.reserve(events.size() * 4 + 256);
+
+    WriteVlq(trackData, 0);
+    WriteTempo(trackData, (uint32_t)(initialTempo / speed));
+
+    uint32_t lastWrittenTick = 0;
+    for (const auto& ev : events) {
+        const auto et = ev.Type();
+        if (et == EventType::CHANNEL_PRESSURE) continue;  // not played back either
+
+        WriteVlq(trackData, ev.tick - lastWrittenTick);
+        lastWrittenTick = ev.tick;
+
+        switch (et) {
+            case EventType::TEMPO:
+                WriteTempo(trackData, (uint32_t)(ev.Tempo() / speed));
+                break;
+            case EventType::NOTE_ON:
+            case EventType::NOTE_OFF:
+            case EventType::CC:
+            case EventType::PITCH_BEND:
+            case EventType::POLY_PRESSURE:
+                // The event word already holds status, d1, d2 in wire order
+                trackData.push_back(ev.Status());
+                trackData.push_back(ev.D1());
+                trackData.push_back(ev.D2());
+                break;
+            case EventType::PROGRAM_CHANGE:
+                trackData.push_back(ev.Status());
+                trackData.push_back(ev.D1());
+                break;
+            case EventType::SYSEX: {
+                // F0 <len> <bytes after F0>, or F7 <len> <bytes> for an escape packet
+                const auto     msg  = sysex ? sysex->Get(ev.SysExEntry()) : SysExArena::Message{};
+                const bool     f0   = msg.size > 0 && msg.data[0] == 0xF0;
+                const uint32_t skip = f0 ? 1u : 0u;
+                trackData.push_back(f0 ? 0xF0 : 0xF7);
+                WriteVlq(trackData, msg.size - skip);
+                trackData.insert(trackData.end(), msg.data + skip, msg.data + msg.size);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Tail: BASS MIDI ends decode as soon as all voices are silent —
+    // CC events and bare delta ticks are ignored once voices stop.
+    // Solution: mute channel 15 with CC7=0, send a NOTE_ON to create
+    // a real voice, wait tailTicks, NOTE_OFF. The voice keeps BASS
+    // rendering audio (= release envelopes + reverb from real channels)
+    // while outputting silence itself (CC7=0).
+    {
+        double secsPerTick = (lastTempo / 1000000.0) / ppq;
+        uint32_t tailTicks = (secsPerTick > 0.0)
+            ? (uint32_t)(3.0 / secsPerTick)
+            : (uint32_t)(ppq * 6);
+
+        // All notes off + sustain off on all channels
+        for (uint8_t ch = 0; ch < 16; ++ch) {
+            WriteVlq(trackData, 0); trackData.push_back(0xB0 | ch); trackData.push_back(123); trackData.push_back(0);
+            WriteVlq(trackData, 0); trackData.push_back(0xB0 | ch); trackData.push_back(64);  trackData.push_back(0);
+        }
+        // Mute ch15 with CC7=0 so the tail note is inaudible
+        WriteVlq(trackData, 0); trackData.push_back(0xBF); trackData.push_back(7); trackData.push_back(0);
+        // NOTE_ON ch15 note=60 vel=1 — creates a real voice, keeps BASS alive
+        WriteVlq(trackData, 0); trackData.push_back(0x9F); trackData.push_back(60); trackData.push_back(1);
+        // Wait tailTicks — BASS renders real release/reverb from other channels
+        WriteVlq(trackData, tailTicks);
+        // NOTE_OFF ch15 note=60
+        trackData.push_back(0x8F); trackData.push_back(60); trackData.push_back(0);
+        WriteVlq(trackData, 0);
+        trackData.push_back(0xFF); trackData.push_back(0x2F); trackData.push_back(0x00); // EOT
+    }
+
+    auto file = std::make_shared<std::vector<uint8_t>>();
+    file->reserve(14 + 8 + trackData.size());
+    const uint8_t hdr[] = { 'M','T','h','d', 0,0,0,6, 0,0, 0,1, (uint8_t)((ppq >> 8) & 0xFF), (uint8_t)(ppq & 0xFF) };
+    file->insert(file->end(), std::begin(hdr), std::end(hdr));
+
+    uint32_t tlen = static_cast<uint32_t>(trackData.size());
+    const uint8_t tkhdr[] = { 'M','T','r','k', (uint8_t)((tlen >> 24) & 0xFF), (uint8_t)((tlen >> 16) & 0xFF), (uint8_t)((tlen >>  8) & 0xFF), (uint8_t)(tlen & 0xFF) };
+    file->insert(file->end(), std::begin(tkhdr), std::end(tkhdr));
+    file->insert(file->end(), trackData.begin(), trackData.end());
+
+    smf      = std::move(file);
+    smfSpeed = speed;
+    return smf;
+}
+
+// ── EventFilterPipeline ───────────────────────────────────────────────────────
+void EventFilterPipeline::SetSource(const std::vector<MidiEvent>* events, int newPpq, uint32_t tempo,
+                                    const SysExArena* newSysex) {
+    std::lock_guard<std::mutex> lk(mtx);
+    source       = events;
+    sysex        = newSysex;
+    ppq          = newPpq;
+    initialTempo = tempo;
+    cached.reset();
+    generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void EventFilterPipeline::SetConfig(const EventFilterConfig& next) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (next == cfg) return;
+    cfg = next;
+    cached.reset();
+    generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void EventFilterPipeline::SetMuteOverlay(std::vector<uint64_t> trackWords, uint16_t channels) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (trackWords == overlayTracks && channels == overlayChannels) return;
+    overlayTracks   = std::move(trackWords);
+    overlayChannels = channels;
+    cached.reset();
+    generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+EventFilterConfig EventFilterPipeline::GetConfig() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return cfg;
+}
+
+std::shared_ptr<const FilteredStream> EventFilterPipeline::Get() {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (!cached) cached = Compile();
+    return cached;
+}
+
+std::shared_ptr<FilteredStream> EventFilterPipeline::Compile() const {
+    auto t0  = std::chrono::steady_clock::now();
+    auto out = std::make_shared<FilteredStream>();
+    out->generation   = generation.load(std::memory_order_acquire);
+    out->ppq          = ppq;
+    out->initialTempo = initialTempo;
+    out->lastTempo    = initialTempo;
+    out->sysex        = sysex;
+
+    static const std::vector<MidiEvent> kEmpty;
+    const std::vector<MidiEvent>& src = source ? *source : kEmpty;
+    for (const auto& ev : src)
+        if (ev.Type() == EventType::TEMPO) out->lastTempo = ev.Tempo();
+
+    const EventFilterConfig& eff = cfg;
+    bool anyMute = overlayChannels != 0;
+    for (uint64_t w : overlayTracks) anyMute |= w != 0;
+
+    if (eff.IsPassThrough() && !anyMute) {
+        out->view = &src;
+        return out;
+    }
+    Filter(src, *out);
+
+    out->compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "+ Event filter: " << out->owned.size() << " / " << src.size() << " events kept ("
+              << out->droppedNotes << " notes dropped) in " << out->compileMs << " ms" << std::endl;
+    return out;
+}
+
+// Two passes: mark, then copy survivors. Channel, track and key rules depend
+// only on the event itself, so a note-off matches its note-on automatically.
+// Velocity and length rules need the pair, which is found the way the loader
+// pairs notes: FIFO per (track, channel, key).
+void EventFilterPipeline::Filter(const std::vector<MidiEvent>& src, FilteredStream& out) const {
+    const EventFilterConfig& eff = cfg;
+    bool anyMute = overlayChannels != 0;
+    for (uint64_t w : overlayTracks) anyMute |= w != 0;
+
+    auto muted = [&](const MidiEvent& ev) {
+        const size_t w = ev.Track() >> 6;
+        return ((overlayChannels >> ev.Channel()) & 1u) ||
+               (w < overlayTracks.size() && ((overlayTracks[w] >> (ev.Track() & 63)) & 1u));
+    };
+
+    auto dropsByItself = [&](const MidiEvent& ev) -> bool {
+        const auto et = ev.Type();
+        if (et == EventType::TEMPO || et == EventType::SYSEX) return false;   // not channel data
+        switch (et) {
+            case EventType::NOTE_ON:
+                if (ev.D2() > 0 && ev.D2() <= eff.velocityIgnore) return true;
+                [[fallthrough]];
+            case EventType::NOTE_OFF:
+                if (anyMute && muted(ev)) return true;
+                return ev.D1() < eff.keyLow || ev.D1() > eff.keyHigh;
+            case EventType::CC:               return eff.stripCC;
+            case EventType::PITCH_BEND:       return eff.stripPitchBend;
+            case EventType::PROGRAM_CHANGE:   return eff.stripProgram;
+            case EventType::CHANNEL_PRESSURE:
+            case EventType::POLY_PRESSURE:    return eff.stripPressure;
+            default:                          return false;
+        }
+    };
+
+    std::vector<uint8_t> drop(src.size(), 0);
+    const bool needPairs = eff.velocityIgnore > 0 || eff.minNoteTicks > 0;
+
+    struct Fifo { std::vector<size_t> q; size_t head = 0; };
+    std::unordered_map<uint32_t, Fifo> pending;
+
+    for (size_t i = 0; i < src.size(); ++i) {
+        const MidiEvent& ev = src[i];
+        drop[i] = dropsByItself(ev) ? 1 : 0;
+        if (!needPairs) continue;
+
+        const auto et = ev.Type();
+        if (et != EventType::NOTE_ON && et != EventType::NOTE_OFF) continue;
+        const uint32_t key = ((uint32_t)ev.Track() << 11) | ((uint32_t)ev.Channel() << 7) | (ev.D1() & 0x7F);
+
+        if (et == EventType::NOTE_ON) {
+            pending[key].q.push_back(i);
+            continue;
+        }
+        auto it = pending.find(key);
+        if (it == pending.end() || it->second.head == it->second.q.size()) continue;
+        Fifo& f = it->second;
+        const size_t on = f.q[f.head++];
+        if (f.head == f.q.size()) { f.q.clear(); f.head = 0; }
+
+        if (src[i].tick - src[on].tick < eff.minNoteTicks) drop[on] = 1;
+        if (drop[on]) drop[i] = 1;
+    }
+
+    size_t kept = 0;
+    for (uint8_t d : drop) kept += !d;
+    out.owned.reserve(out.owned.size() + kept);
+    for (size_t i = 0; i < src.size(); ++i) {
+        if (!drop[i]) { out.owned.push_back(src[i]); continue; }
+        const auto et = src[i].Type();
+        if      (et == EventType::NOTE_ON)  out.droppedNotes++;
+        else if (et != EventType::NOTE_OFF) out.droppedOther++;
+    }
+}
+
+void EventFilterPipeline::SpliceTracks(const std::vector<MidiEvent>& was, const std::vector<MidiEvent>& now,
+                                       uint32_t lo, uint32_t hi) {
+    std::lock_guard<std::mutex> lk(mtx);
+    const uint64_t gen = generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (!cached) return;   // compiled on the next Get()
+    FilteredStream& out = *cached;
+    out.generation = gen;
+    {
+        std::lock_guard<std::mutex> sk(out.smfMutex);
+        out.smf.reset();
+        out.smfSpeed = 0.0f;
+    }
+    if (out.view || !source) return;   // pass-through: the source is the stream
+
+    const auto t0 = std::chrono::steady_clock::now();
+    FilteredStream before, after;
+    Filter(was, before);
+    Filter(now, after);
+    out.droppedNotes = out.droppedNotes - before.droppedNotes + after.droppedNotes;
+    out.droppedOther = out.droppedOther - before.droppedOther + after.droppedOther;
+    // A note whose off moved can change its fate outside the source window
+    uint32_t flo = 0, fhi = 0;
+    if (ChangedTicks(before.owned, after.owned, flo, fhi)) {
+        lo = (lo <= hi) ? std::min(lo, flo) : flo;
+        hi = std::max(hi, fhi);
+    }
+    if (lo > hi) return;
+
+    // Over [lo, hi] a source event survives when the old stream kept it (other
+    // tracks, tempo, SysEx) or the new compile did (rebuilt tracks). Both are
+    // subsequences of the source in its order (the splice keeps the old order
+    // outside the edit), and their words differ in the track byte, so one walk
+    // interleaves them.
+    bool rebuilt[256] = {};
+    for (const auto* list : { &was, &now })
+        for (const MidiEvent& e : *list) rebuilt[e.Track()] = true;
+
+    const size_t first = TickLowerBound(out.owned, lo);
+    const size_t last  = TickUpperBound(out.owned, hi);
+    std::vector<MidiEvent> kept;
+    for (size_t i = first; i < last; ++i) {
+        const MidiEvent& e = out.owned[i];
+        if (e.Status() >= 0xF0 || !rebuilt[e.Track()]) kept.push_back(e);
+    }
+    const MidiEvent* add    = after.owned.data() + TickLowerBound(after.owned, lo);
+    const MidiEvent* addEnd = after.owned.data() + TickUpperBound(after.owned, hi);
+
+    std::vector<MidiEvent> window;
+    window.reserve(kept.size() + (size_t)(addEnd - add));
+    auto same = [](const MidiEvent& a, const MidiEvent& b) { return a.tick == b.tick && a.word == b.word; };
+    const std::vector<MidiEvent>& src = *source;
+    const size_t end = TickUpperBound(src, hi);
+    size_t k = 0;
+    for (size_t i = TickLowerBound(src, lo); i < end; ++i) {
+        if      (k < kept.size() && same(src[i], kept[k])) ++k;
+        else if (add < addEnd && same(src[i], *add))       ++add;
+        else continue;
+        window.push_back(src[i]);
+    }
+    ReplaceRange(out.owned, first, last, window);
+
+    out.compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "+ Event filter: " << was.size() << " -> " << now.size() << " events of the edited tracks, "
+              << window.size() << " kept over ticks " << lo << "-" << hi << " in " << out.compileMs << " ms" << std::endl;
+}
@@ -0,0 +1,210 @@
+#include "falling_notes.hpp"
+#include "track_masks.hpp"
+
+#include "rlgl.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+// ── Shaders ───────────────────────────────────────────────────────────────────
+// Same body for GLSL 330 and GLSL ES 300; only the header differs.
+static const char* kFallingVsBody = R"(
+in vec2 aPos;               // unit quad corner
+in vec4 aNote;              // start, end (ticks relative to now), key, colour index
+uniform vec2  uScreen;
+uniform vec4  uArea;        // x, y, w, h of the roll in pixels
+uniform float uPxPerTick;
+uniform sampler2D uPalette;
+uniform int   uPaletteWidth;
+flat out vec4 vColor;
+flat out vec2 vSize;
+out vec2 vLocal;
+void main() {
+    float kw     = uArea.z / 128.0;
+    float bottom = uArea.y + uArea.w;
+    float yTop   = max(uArea.y, bottom - aNote.y * uPxPerTick);
+    float yBot   = min(bottom,  bottom - aNote.x * uPxPerTick);
+    vec2  p      = vec2(uArea.x + (aNote.z + aPos.x) * kw, mix(yTop, yBot, aPos.y));
+    int   idx    = int(aNote.w);
+    vColor = texelFetch(uPalette, ivec2(idx % uPaletteWidth, idx / uPaletteWidth), 0);
+    vSize  = vec2(kw, yBot - yTop);
+    vLocal = aPos * vSize;
+    gl_Position = vec4(p.x / uScreen.x * 2.0 - 1.0, 1.0 - p.y / uScreen.y * 2.0, 0.0, 1.0);
+}
+)";
+
+static const char* kFallingFsBody = R"(
+flat in vec4 vColor;
+flat in vec2 vSize;
+in vec2 vLocal;
+out vec4 fragColor;
+void main() {
+    bool edge = vLocal.x < 1.0 || vLocal.x > vSize.x - 1.0 || vLocal.y < 1.0 || vLocal.y > vSize.y - 1.0;
+    fragColor = vec4(vColor.rgb * (edge ? 0.55 : 1.0), 1.0);
+}
+)";
+
+// Two triangles covering the unit square
+static const float kQuad[12] = { 0,0, 1,0, 1,1,  0,0, 1,1, 0,1 };
+
+bool FallingNotesRenderer::Available() {
+    if (tried) return ok;
+    tried = true;
+
+    const int ver = rlGetVersion();
+    std::string header;
+    if (ver == RL_OPENGL_33 || ver == RL_OPENGL_43) header = "#version 330\n";
+    else if (ver == RL_OPENGL_ES_30)                header = "#version 300 es\nprecision highp float;\nprecision highp int;\n";
+    else {
+        std::cout << "[warn] Falling notes need GL 3.3 / GLES 3.0 instancing - viewer unavailable" << std::endl;
+        return false;
+    }
+    const std::string vs = header + kFallingVsBody;
+    const std::string fs = header + kFallingFsBody;
+    shader = rlLoadShaderCode(vs.c_str(), fs.c_str());
+    if (shader == 0 || shader == rlGetShaderIdDefault()) {
+        std::cout << "[warn] Falling notes shader failed to compile" << std::endl;
+        shader = 0;
+        return false;
+    }
+    locPos          = rlGetLocationAttrib(shader, "aPos");
+    locNote         = rlGetLocationAttrib(shader, "aNote");
+    locScreen       = rlGetLocationUniform(shader, "uScreen");
+    locArea         = rlGetLocationUniform(shader, "uArea");
+    locPxPerTick    = rlGetLocationUniform(shader, "uPxPerTick");
+    locPalette      = rlGetLocationUniform(shader, "uPalette");
+    locPaletteWidth = rlGetLocationUniform(shader, "uPaletteWidth");
+    if (locPos < 0 || locNote < 0) {
+        std::cout << "[warn] Falling notes shader is missing its attributes" << std::endl;
+        rlUnloadShaderProgram(shader); shader = 0;
+        return false;
+    }
+
+    vao = rlLoadVertexArray();
+    rlEnableVertexArray(vao);
+    quadVbo = rlLoadVertexBuffer(kQuad, (int)sizeof(kQuad), false);
+    rlSetVertexAttribute((unsigned)locPos, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locPos);
+    rlDisableVertexArray();
+
+    ok = EnsureCapacity(1u << 16);
+    std::cout << (ok ? "+ Falling notes renderer ready (instanced)" : "[warn] Falling notes buffers failed") << std::endl;
+    return ok;
+}
+
+void FallingNotesRenderer::BindInstanceAttributes() {
+    rlEnableVertexArray(vao);
+    rlEnableVertexBuffer(instVbo);
+    rlSetVertexAttribute((unsigned)locNote, 4, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locNote);
+    rlSetVertexAttributeDivisor((unsigned)locNote, 1);
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+}
+
+bool FallingNotesRenderer::EnsureCapacity(size_t count) {
+    if (count <= instCapacity && instVbo != 0) return true;
+    size_t cap = std::max<size_t>(instCapacity ? instCapacity : 1, 1u << 16);
+    while (cap < count) cap *= 2;
+    cap = std::min(cap, kMaxInstances);
+
+    if (instVbo != 0) rlUnloadVertexBuffer(instVbo);
+    rlEnableVertexArray(vao);
+    instVbo = rlLoadVertexBuffer(nullptr, (int)(cap * 4 * sizeof(float)), true);
+    rlDisableVertexArray();
+    if (instVbo == 0) { instCapacity = 0; return false; }
+    instCapacity = cap;
+    BindInstanceAttributes();
+    return true;
+}
+
+void FallingNotesRenderer::SetPalette(const std::vector<uint32_t>& rgba) {
+    if (!Available() || rgba.empty()) return;
+    const int size   = (int)rgba.size();
+    const int width  = std::min(size, 1024);
+    const int height = (size + width - 1) / width;
+    std::vector<uint32_t> padded((size_t)width * height, 0xFFFFFFFFu);
+    std::copy(rgba.begin(), rgba.end(), padded.begin());
+
+    if (paletteTex != 0 && (width != paletteWidth || (size + width - 1) / width != (paletteSize + paletteWidth - 1) / paletteWidth)) {
+        rlUnloadTexture(paletteTex);
+        paletteTex = 0;
+    }
+    if (paletteTex == 0) paletteTex = rlLoadTexture(padded.data(), width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+    else                 rlUpdateTexture(paletteTex, 0, 0, width, height, RL_PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, padded.data());
+    paletteWidth = width;
+    paletteSize  = size;
+}
+
+void FallingNotesRenderer::Draw(const std::vector<OptimizedTrackData>& tracks, const NoteWindowIndex& index,
+                                uint64_t currentTick, uint32_t viewTicks, Rectangle area)
+{
+    lastInstances = 0;
+    lastTruncated = 0;
+    if (!Available() || paletteTex == 0 || !index.IsBuiltFor(tracks) || viewTicks == 0) return;
+
+    const uint32_t L = (uint32_t)std::min<uint64_t>(currentTick, UINT32_MAX);
+    const uint32_t R = (uint32_t)std::min<uint64_t>((uint64_t)L + viewTicks, UINT32_MAX);
+    const double   now = (double)L;
+
+    // ── Cull + pack (track N-1 last so it lands on top, like ChannelTrackLayer) ──
+    instances.clear();
+    size_t count = 0;
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        if (!g_TrackMasks.TrackVisible(t)) continue;
+        index.ForEachInWindow(tracks, t, L, R, [&](const NoteEvent& n) {
+            if (!g_TrackMasks.ChannelVisible(n.channel)) return;
+            if (count >= kMaxInstances) { lastTruncated++; return; }
+            const uint32_t end = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
+            instances.push_back((float)((double)n.startTick - now));
+            instances.push_back((float)((double)end - now));
+            instances.push_back((float)(n.note & 127));
+            instances.push_back((float)((t * 16 + n.channel) % (size_t)paletteSize));
+            count++;
+        });
+    }
+    lastInstances = count;
+    if (count == 0 || !EnsureCapacity(count)) return;
+
+    // ── Upload + one instanced draw ──
+    rlDrawRenderBatchActive();   // flush raylib's batch so layering stays correct
+    rlUpdateVertexBuffer(instVbo, instances.data(), (int)(count * 4 * sizeof(float)), 0);
+
+    const float screen[2] = { (float)GetRenderWidth(), (float)GetRenderHeight() };
+    // Area is given in screen coordinates; scale to the framebuffer for HiDPI
+    const float sx = screen[0] / (float)std::max(1, GetScreenWidth());
+    const float sy = screen[1] / (float)std::max(1, GetScreenHeight());
+    const float areaPx[4] = { area.x * sx, area.y * sy, area.width * sx, area.height * sy };
+    const float pxPerTick = areaPx[3] / (float)viewTicks;
+    const int   texUnit = 0;
+
+    rlEnableShader(shader);
+    rlSetUniform(locScreen,       screen,        RL_SHADER_UNIFORM_VEC2,  1);
+    rlSetUniform(locArea,         areaPx,        RL_SHADER_UNIFORM_VEC4,  1);
+    rlSetUniform(locPxPerTick,    &pxPerTick,    RL_SHADER_UNIFORM_FLOAT, 1);
+    rlSetUniform(locPaletteWidth, &paletteWidth, RL_SHADER_UNIFORM_INT,   1);
+    rlSetUniform(locPalette,      &texUnit,      RL_SHADER_UNIFORM_INT,   1);
+    rlActiveTextureSlot(0);
+    rlEnableTexture(paletteTex);
+
+    rlEnableVertexArray(vao);
+    rlDrawVertexArrayInstanced(0, 6, (int)count);
+    rlDisableVertexArray();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+void FallingNotesRenderer::Unload() {
+    if (instVbo)    { rlUnloadVertexBuffer(instVbo); instVbo = 0; }
+    if (quadVbo)    { rlUnloadVertexBuffer(quadVbo); quadVbo = 0; }
+    if (vao)        { rlUnloadVertexArray(vao); vao = 0; }
+    if (paletteTex) { rlUnloadTexture(paletteTex); paletteTex = 0; }
+    if (shader)     { rlUnloadShaderProgram(shader); shader = 0; }
+    instCapacity = 0;
+    paletteWidth = paletteSize = 0;
+    tried = ok = false;
+    instances.clear();
+    instances.shrink_to_fit();
+}
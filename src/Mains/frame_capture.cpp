@@ -0,0 +1,334 @@
+#include "frame_capture.hpp"
+#include "frame_stats.hpp"
+
+#include "raylib.h"
+#include "rlgl.h"
+
+#include <cstring>
+#include <ctime>
+#include <iostream>
+
+FrameCapture g_FrameCapture;
+
+// ── GL entry points ───────────────────────────────────────────────────────────
+// raylib does not expose a GL loader, but its desktop build links GLFW, so the
+// few functions needed for pixel-pack buffers are resolved through it.
+#if defined(_WIN32) && !defined(_WIN64)
+#  define CAPTURE_APIENTRY __stdcall
+#else
+#  define CAPTURE_APIENTRY
+#endif
+
+typedef void (*GLFWglproc)(void);
+extern "C" GLFWglproc glfwGetProcAddress(const char* procname);
+
+namespace {
+constexpr unsigned kGL_RGBA              = 0x1908;
+constexpr unsigned kGL_UNSIGNED_BYTE     = 0x1401;
+constexpr unsigned kGL_PACK_ALIGNMENT    = 0x0D05;
+constexpr unsigned kGL_PIXEL_PACK_BUFFER = 0x88EB;
+constexpr unsigned kGL_STREAM_READ       = 0x88E1;
+constexpr unsigned kGL_READ_ONLY         = 0x88B8;
+
+typedef void  (CAPTURE_APIENTRY* PFN_ReadPixels)(int, int, int, int, unsigned, unsigned, void*);
+typedef void  (CAPTURE_APIENTRY* PFN_PixelStorei)(unsigned, int);
+typedef void  (CAPTURE_APIENTRY* PFN_GenBuffers)(int, unsigned*);
+typedef void  (CAPTURE_APIENTRY* PFN_DeleteBuffers)(int, const unsigned*);
+typedef void  (CAPTURE_APIENTRY* PFN_BindBuffer)(unsigned, unsigned);
+typedef void  (CAPTURE_APIENTRY* PFN_BufferData)(unsigned, ptrdiff_t, const void*, unsigned);
+typedef void* (CAPTURE_APIENTRY* PFN_MapBuffer)(unsigned, unsigned);
+typedef unsigned char (CAPTURE_APIENTRY* PFN_UnmapBuffer)(unsigned);
+
+PFN_ReadPixels    glReadPixels_    = nullptr;
+PFN_PixelStorei   glPixelStorei_   = nullptr;
+PFN_GenBuffers    glGenBuffers_    = nullptr;
+PFN_DeleteBuffers glDeleteBuffers_ = nullptr;
+PFN_BindBuffer    glBindBuffer_    = nullptr;
+PFN_BufferData    glBufferData_    = nullptr;
+PFN_MapBuffer     glMapBuffer_     = nullptr;
+PFN_UnmapBuffer   glUnmapBuffer_   = nullptr;
+
+std::string TimestampName(const char* pattern) {
+    time_t now = time(0);
+    struct tm tstruct;
+#ifdef _WIN32
+    localtime_s(&tstruct, &now);
+#else
+    localtime_r(&now, &tstruct);
+#endif
+    char buf[96];
+    strftime(buf, sizeof(buf), pattern, &tstruct);
+    return buf;
+}
+
+const char* Extension(CaptureFormat f) { return f == CaptureFormat::QOI ? ".qoi" : ".png"; }
+} // namespace
+
+bool FrameCapture::InitGl() {
+    if (glTried) return glReadPixels_ != nullptr;
+    glTried = true;
+
+    glReadPixels_  = (PFN_ReadPixels)glfwGetProcAddress("glReadPixels");
+    glPixelStorei_ = (PFN_PixelStorei)glfwGetProcAddress("glPixelStorei");
+    if (!glReadPixels_ || !glPixelStorei_) {
+        std::cout << "- Capture: glReadPixels unavailable" << std::endl;
+        glReadPixels_ = nullptr;
+        return false;
+    }
+
+    // Pixel-pack buffers: desktop GL 2.1+
+    const int ver = rlGetVersion();
+    if (ver == RL_OPENGL_21 || ver == RL_OPENGL_33 || ver == RL_OPENGL_43) {
+        glGenBuffers_    = (PFN_GenBuffers)glfwGetProcAddress("glGenBuffers");
+        glDeleteBuffers_ = (PFN_DeleteBuffers)glfwGetProcAddress("glDeleteBuffers");
+        glBindBuffer_    = (PFN_BindBuffer)glfwGetProcAddress("glBindBuffer");
+        glBufferData_    = (PFN_BufferData)glfwGetProcAddress("glBufferData");
+        glMapBuffer_     = (PFN_MapBuffer)glfwGetProcAddress("glMapBuffer");
+        glUnmapBuffer_   = (PFN_UnmapBuffer)glfwGetProcAddress("glUnmapBuffer");
+        pboOk = glGenBuffers_ && glDeleteBuffers_ && glBindBuffer_ && glBufferData_ && glMapBuffer_ && glUnmapBuffer_;
+    }
+    if (pboOk) glGenBuffers_(kPboCount, pbo);
+    std::cout << "+ Capture readback: " << (pboOk ? "PBO ring" : "direct glReadPixels") << std::endl;
+    std::lock_guard<std::mutex> lk(mtx);
+    stats.usingPbo = pboOk;
+    return true;
+}
+
+void FrameCapture::ReleaseGl() {
+    if (pboOk && glDeleteBuffers_) glDeleteBuffers_(kPboCount, pbo);
+    for (int i = 0; i < kPboCount; ++i) { pbo[i] = 0; pboSize[i] = 0; }
+    pboOk = false;
+    glTried = false;
+    glReadPixels_ = nullptr;
+}
+
+// ── Requests ──────────────────────────────────────────────────────────────────
+void FrameCapture::RequestScreenshot(CaptureFormat format) {
+    shotRequested = true;
+    shotFormat    = format;
+}
+
+void FrameCapture::StartBurst(int everyNthFrame, CaptureFormat format) {
+    if (burstActive) StopBurst();
+    burstDir = TimestampName("Jidi-Capture_%Y-%m-%d_%H-%M-%S");
+    if (MakeDirectory(burstDir.c_str()) != 0) {
+        std::cout << "- Capture: cannot create folder " << burstDir << std::endl;
+        return;
+    }
+    burstEvery   = everyNthFrame < 1 ? 1 : everyNthFrame;
+    burstFormat  = format;
+    burstCounter = 0;
+    burstIndex   = 0;
+    burstActive  = true;
+    std::cout << "+ Burst capture started: every " << burstEvery << " frame(s) → " << burstDir << std::endl;
+}
+
+void FrameCapture::StopBurst() {
+    if (!burstActive) return;
+    burstActive = false;
+    std::cout << "- Burst capture stopped after " << burstIndex << " frame(s)" << std::endl;
+}
+
+// ── Render thread ─────────────────────────────────────────────────────────────
+void FrameCapture::OnFrameEnd() {
+    // Reads issued on earlier frames have finished their DMA by now
+    while (!inFlight.empty()) { Resolve(inFlight.front()); inFlight.pop_front(); }
+
+    const bool burstThisFrame = burstActive && (burstCounter++ % (uint64_t)burstEvery) == 0;
+    if (!shotRequested && !burstThisFrame) return;
+    g_FrameStats.Mark(FrameEvent::Capture);
+    if (!InitGl()) {
+        if (shotRequested) ReportShot("", false);
+        shotRequested = false;
+        return;
+    }
+
+    rlDrawRenderBatchActive();   // everything queued in rlgl must be in the framebuffer
+    if (shotRequested) {
+        shotRequested = false;
+        Issue(TimestampName("Jidi-Screenshot_%Y-%m-%d_%H-%M-%S") + Extension(shotFormat), shotFormat, true);
+    }
+    if (burstThisFrame) {
+        const std::string name = TextFormat("%s/frame_%06llu%s", burstDir.c_str(),
+                                            (unsigned long long)burstIndex++, Extension(burstFormat));
+        Issue(name, burstFormat, false);
+    }
+}
+
+void FrameCapture::Issue(const std::string& path, CaptureFormat format, bool shot) {
+    const int w = GetRenderWidth(), h = GetRenderHeight();
+    if (w <= 0 || h <= 0) {
+        if (shot) ReportShot(path, false);
+        return;
+    }
+    const size_t bytes = (size_t)w * h * 4;
+    glPixelStorei_(kGL_PACK_ALIGNMENT, 1);
+
+    if (pboOk) {
+        // Ring full → the oldest read must be consumed before its slot is reused
+        if ((int)inFlight.size() >= kPboCount) { Resolve(inFlight.front()); inFlight.pop_front(); }
+        const int slot = pboNext;
+        pboNext = (pboNext + 1) % kPboCount;
+        glBindBuffer_(kGL_PIXEL_PACK_BUFFER, pbo[slot]);
+        if (pboSize[slot] != bytes) {
+            glBufferData_(kGL_PIXEL_PACK_BUFFER, (ptrdiff_t)bytes, nullptr, kGL_STREAM_READ);
+            pboSize[slot] = bytes;
+        }
+        glReadPixels_(0, 0, w, h, kGL_RGBA, kGL_UNSIGNED_BYTE, nullptr);   // async into the PBO
+        glBindBuffer_(kGL_PIXEL_PACK_BUFFER, 0);
+        inFlight.push_back(Pending{ slot, w, h, path, format, shot });
+        return;
+    }
+
+    auto f = Acquire(bytes);
+    glReadPixels_(0, 0, w, h, kGL_RGBA, kGL_UNSIGNED_BYTE, f->pixels.get());
+    f->width = w; f->height = h; f->path = path; f->format = format; f->shot = shot;
+    Submit(std::move(f));
+}
+
+void FrameCapture::ReportShot(const std::string& path, bool ok) {
+    std::lock_guard<std::mutex> lk(mtx);
+    shotResults.push_back({ path, ok });
+}
+
+void FrameCapture::Resolve(Pending& p) {
+    const size_t bytes = (size_t)p.width * p.height * 4;
+    auto f = Acquire(bytes);
+    glBindBuffer_(kGL_PIXEL_PACK_BUFFER, pbo[p.slot]);
+    const void* src = glMapBuffer_(kGL_PIXEL_PACK_BUFFER, kGL_READ_ONLY);
+    bool ok = src != nullptr;
+    if (ok) {
+        std::memcpy(f->pixels.get(), src, bytes);
+        glUnmapBuffer_(kGL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer_(kGL_PIXEL_PACK_BUFFER, 0);
+    if (!ok) {
+        std::lock_guard<std::mutex> lk(mtx);
+        stats.failed++;
+        if (p.shot) shotResults.push_back({ p.path, false });
+        freeList.push_back(std::move(f));
+        return;
+    }
+    f->width = p.width; f->height = p.height; f->path = std::move(p.path); f->format = p.format; f->shot = p.shot;
+    Submit(std::move(f));
+}
+
+// ── Buffer pool ───────────────────────────────────────────────────────────────
+std::unique_ptr<FrameCapture::Frame> FrameCapture::Acquire(size_t bytes) {
+    std::unique_ptr<Frame> f;
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        if (freeList.empty() && allocated >= kPoolLimit) {
+            stats.stalls++;
+            cvFree.wait(lk, [&] { return !freeList.empty(); });
+        }
+        if (!freeList.empty()) { f = std::move(freeList.back()); freeList.pop_back(); }
+        else { f = std::make_unique<Frame>(); allocated++; }
+    }
+    if (f->capacity < bytes) {
+        f->pixels.reset(new uint8_t[bytes]);
+        f->capacity = bytes;
+    }
+    return f;
+}
+
+void FrameCapture::Submit(std::unique_ptr<Frame> f) {
+    EnsureWorker();
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        queue.push_back(std::move(f));
+        stats.queued++;
+    }
+    cvWork.notify_one();
+}
+
+void FrameCapture::EnsureWorker() {
+    if (worker.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = false;
+    }
+    worker = std::thread(&FrameCapture::WorkerLoop, this);
+}
+
+// ── Worker: flip, encode, write ───────────────────────────────────────────────
+void FrameCapture::WorkerLoop() {
+    std::vector<uint8_t> rowTmp;
+    for (;;) {
+        std::unique_ptr<Frame> f;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            cvWork.wait(lk, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;   // stopping and drained
+            f = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        // GL rows are bottom-up
+        const size_t stride = (size_t)f->width * 4;
+        rowTmp.resize(stride);
+        uint8_t* px = f->pixels.get();
+        for (int y = 0; y < f->height / 2; ++y) {
+            uint8_t* a = px + (size_t)y * stride;
+            uint8_t* b = px + (size_t)(f->height - 1 - y) * stride;
+            std::memcpy(rowTmp.data(), a, stride);
+            std::memcpy(a, b, stride);
+            std::memcpy(b, rowTmp.data(), stride);
+        }
+        // Opaque output, like TakeScreenshot
+        for (size_t i = 3; i < stride * f->height; i += 4) px[i] = 255;
+
+        Image img = {};
+        img.data    = px;
+        img.width   = f->width;
+        img.height  = f->height;
+        img.mipmaps = 1;
+        img.format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        const bool ok = ExportImage(img, f->path.c_str());
+
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (ok) { stats.written++; lastPath = f->path; }
+            else    stats.failed++;
+            if (f->shot) shotResults.push_back({ f->path, ok });
+            f->path.clear();
+            freeList.push_back(std::move(f));
+        }
+        cvFree.notify_one();
+    }
+}
+
+void FrameCapture::Shutdown() {
+    StopBurst();
+    if (pboOk) {
+        while (!inFlight.empty()) { Resolve(inFlight.front()); inFlight.pop_front(); }
+    }
+    inFlight.clear();
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stopping = true;
+    }
+    cvWork.notify_all();
+    if (worker.joinable()) worker.join();
+    if (glTried) ReleaseGl();
+}
+
+FrameCapture::Stats FrameCapture::GetStats() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    Stats s = stats;
+    s.pending = queue.size();
+    return s;
+}
+
+std::string FrameCapture::LastWrittenPath() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return lastPath;
+}
+
+bool FrameCapture::PollShotResult(ShotResult& out) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (shotResults.empty()) return false;
+    out = std::move(shotResults.front());
+    shotResults.pop_front();
+    return true;
+}
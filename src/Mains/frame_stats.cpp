@@ -0,0 +1,196 @@
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+FrameStats g_FrameStats;
+
+// ── HdrHistogram ──────────────────────────────────────────────────────────────
+
+int HdrHistogram::Index(uint64_t v) {
+    if (v > kMaxValue) v = kMaxValue;
+    if (v < (uint64_t)kSub) return (int)v;                       // exact below kSub
+    const int exp   = (int)std::bit_width(v) - 1;                // >= kSubBits
+    const int shift = exp - kSubBits;
+    const int sub   = (int)((v >> shift) & (uint64_t)(kSub - 1));
+    return (shift + 1) * kSub + sub;
+}
+
+uint64_t HdrHistogram::HighestInBucket(int idx) {
+    if (idx < kSub) return (uint64_t)idx;
+    const int shift = idx / kSub - 1;
+    const uint64_t lo = (uint64_t)(kSub + idx % kSub) << shift;
+    return lo + ((1ull << shift) - 1);
+}
+
+void HdrHistogram::Record(uint64_t v) {
+    ++counts[(size_t)Index(v)];
+    ++total;
+    if (v > maxSeen) maxSeen = v;
+}
+
+void HdrHistogram::Reset() {
+    counts.fill(0);
+    total = maxSeen = 0;
+}
+
+uint64_t HdrHistogram::ValueAt(double q, const HdrHistogram* also) const {
+    const uint64_t n = total + (also ? also->total : 0);
+    if (n == 0) return 0;
+    const uint64_t rank = std::max<uint64_t>(1, (uint64_t)std::ceil(std::clamp(q, 0.0, 1.0) * (double)n));
+    const uint64_t top  = std::max(maxSeen, also ? also->maxSeen : 0);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; ++i) {
+        seen += counts[(size_t)i] + (also ? also->counts[(size_t)i] : 0);
+        if (seen >= rank) return std::min(HighestInBucket(i), top);
+    }
+    return top;
+}
+
+// ── FrameStats ────────────────────────────────────────────────────────────────
+
+void FrameStats::Reset() {
+    for (HdrHistogram* h : { &frameCur, &framePrev, &frameAll, &lateCur, &latePrev, &lateAll, &bufCur, &bufPrev, &bufAll })
+        h->Reset();
+    pending.store(0, std::memory_order_relaxed);
+    clockSec = windowStart = 0.0;
+    lastWarnSec  = -1.0;
+    frames = stutterCount = unprinted = 0;
+    stutterHead = 0;
+    skipNext = true;
+}
+
+void FrameStats::Rotate() {
+    framePrev = frameCur; frameCur.Reset();
+    latePrev  = lateCur;  lateCur.Reset();
+    bufPrev   = bufCur;   bufCur.Reset();
+    windowStart = clockSec;
+}
+
+void FrameStats::EndFrame(double frameMs, double dispatchLateMs, double bufferSec) {
+    const uint32_t events = pending.exchange(0, std::memory_order_relaxed);
+    if (skipNext) { skipNext = false; return; }
+    if (frameMs < 0.0) return;
+
+    ++frames;
+    clockSec += frameMs / 1000.0;
+    if (clockSec - windowStart >= kWindowSec) Rotate();
+
+    const uint64_t ft = (uint64_t)(frameMs * 1000.0);
+    frameCur.Record(ft);
+    frameAll.Record(ft);
+    if (dispatchLateMs >= 0.0) {
+        const uint64_t late = (uint64_t)(dispatchLateMs * 1000.0);
+        lateCur.Record(late);
+        lateAll.Record(late);
+    }
+    if (bufferSec >= 0.0) {
+        const uint64_t buf = (uint64_t)(bufferSec * 1e6);
+        bufCur.Record(buf);
+        bufAll.Record(buf);
+    }
+
+    if (frameMs < stutterMs) return;
+    Stutter& s = stutters[stutterHead];
+    s.frame  = frames;
+    s.atSec  = clockSec;
+    s.ms     = frameMs;
+    s.events = events;
+    stutterHead = (stutterHead + 1) % kStutterLog;
+    ++stutterCount;
+    ++unprinted;
+
+    // A heavy passage stutters every frame; one console line a second is plenty
+    if (lastWarnSec >= 0.0 && clockSec - lastWarnSec < 1.0) return;
+    lastWarnSec = clockSec;
+    char line[200];
+    std::snprintf(line, sizeof(line), "[warn] Stutter: %.1f ms frame at %.1f s (%s)", frameMs, clockSec,
+                  EventNames(events).c_str());
+    std::cout << line;
+    if (unprinted > 1) std::cout << " +" << (unprinted - 1) << " more since the last report";
+    std::cout << std::endl;
+    unprinted = 0;
+}
+
+FrameStats::Percentiles FrameStats::Window(const HdrHistogram& cur, const HdrHistogram* prev) {
+    Percentiles p;
+    p.count = cur.Count() + (prev ? prev->Count() : 0);
+    p.p50   = (double)cur.ValueAt(0.50,  prev) / 1000.0;
+    p.p99   = (double)cur.ValueAt(0.99,  prev) / 1000.0;
+    p.p999  = (double)cur.ValueAt(0.999, prev) / 1000.0;
+    p.max   = (double)std::max(cur.Max(), prev ? prev->Max() : 0) / 1000.0;
+    return p;
+}
+
+FrameStats::Percentiles FrameStats::Low(const HdrHistogram& cur, const HdrHistogram* prev) {
+    Percentiles p;
+    p.count = cur.Count() + (prev ? prev->Count() : 0);
+    p.p50   = (double)cur.ValueAt(0.50,  prev) / 1000.0;
+    p.p99   = (double)cur.ValueAt(0.01,  prev) / 1000.0;
+    p.p999  = (double)cur.ValueAt(0.001, prev) / 1000.0;
+    p.max   = (double)cur.ValueAt(0.0,   prev) / 1000.0;
+    return p;
+}
+
+std::vector<FrameStats::Stutter> FrameStats::RecentStutters() const {
+    const size_t n = (size_t)std::min<uint64_t>(stutterCount, kStutterLog);
+    std::vector<Stutter> out;
+    out.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        out.push_back(stutters[(stutterHead + kStutterLog - n + i) % kStutterLog]);
+    return out;
+}
+
+const FrameStats::Stutter* FrameStats::LastStutter() const {
+    return stutterCount ? &stutters[(stutterHead + kStutterLog - 1) % kStutterLog] : nullptr;
+}
+
+std::string FrameStats::EventNames(uint32_t mask) {
+    static constexpr struct { FrameEvent e; const char* name; } kNames[] = {
+        { FrameEvent::Seek,          "seek" },
+        { FrameEvent::Repaint,       "repaint" },
+        { FrameEvent::WindowRestart, "window restart" },
+        { FrameEvent::ChunkSlide,    "chunk slide" },
+        { FrameEvent::TextureUpload, "texture upload" },
+        { FrameEvent::MinimapUpload, "minimap upload" },
+        { FrameEvent::StreamRebind,  "stream rebind" },
+        { FrameEvent::PaletteUpload, "palette upload" },
+        { FrameEvent::Capture,       "capture" },
+        { FrameEvent::Resize,        "resize" },
+        { FrameEvent::WatchReload,   "watch reload" },
+    };
+    std::string out;
+    for (const auto& n : kNames) {
+        if (!(mask & (uint32_t)n.e)) continue;
+        if (!out.empty()) out += ", ";
+        out += n.name;
+    }
+    return out.empty() ? "no marked events" : out;
+}
+
+void FrameStats::PrintSummary() const {
+    if (frameAll.Count() == 0) return;
+    char line[200];
+    auto ms = [](uint64_t us) { return (double)us / 1000.0; };
+    std::cout << "+-[ Frame statistics ]-+" << std::endl;
+    std::snprintf(line, sizeof(line), "  %-18s %8s %9s %9s %9s %9s", "", "samples", "p50 ms", "p99 ms", "p99.9 ms", "max ms");
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "  %-18s %8llu %9.2f %9.2f %9.2f %9.2f", "frame time", (unsigned long long)frameAll.Count(),
+                  ms(frameAll.ValueAt(0.5)), ms(frameAll.ValueAt(0.99)), ms(frameAll.ValueAt(0.999)), ms(frameAll.Max()));
+    std::cout << line << std::endl;
+    if (lateAll.Count()) {
+        std::snprintf(line, sizeof(line), "  %-18s %8llu %9.2f %9.2f %9.2f %9.2f", "dispatch lateness", (unsigned long long)lateAll.Count(),
+                      ms(lateAll.ValueAt(0.5)), ms(lateAll.ValueAt(0.99)), ms(lateAll.ValueAt(0.999)), ms(lateAll.Max()));
+        std::cout << line << std::endl;
+    }
+    if (bufAll.Count()) {
+        std::snprintf(line, sizeof(line), "  %-18s %8llu %9.2f %9.2f %9.2f %9.2f  (p50 / p1 / p0.1 / min)", "buffer health", (unsigned long long)bufAll.Count(),
+                      ms(bufAll.ValueAt(0.5)), ms(bufAll.ValueAt(0.01)), ms(bufAll.ValueAt(0.001)), ms(bufAll.ValueAt(0.0)));
+        std::cout << line << std::endl;
+    }
+    std::snprintf(line, sizeof(line), "  %llu stutters >= %.0f ms over %.1f s", (unsigned long long)stutterCount, stutterMs, clockSec);
+    std::cout << line << std::endl;
+}
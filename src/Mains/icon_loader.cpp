@@ -1,9 +1,12 @@
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include "resource.h"
+#endif
 #include "icon_loader.hpp"
 
 IconBytes GetIconPNGBytes() {
+#ifdef _WIN32
     HMODULE hMod     = GetModuleHandle(NULL);
     HRSRC   hResInfo = FindResource(hMod, MAKEINTRESOURCE(IDI_PNG1), RT_RCDATA);
     if (!hResInfo) return { nullptr, 0 };
@@ -11,4 +14,7 @@ IconBytes GetIconPNGBytes() {
     DWORD   size  = SizeofResource(hMod, hResInfo);
     void*   pData = LockResource(hRes);
     return { (const unsigned char*)pData, (int)size };
+#else
+    return { nullptr, 0 };   // the icon is a Windows resource (resources/icon.rc)
+#endif
 }
\ No newline at end of file
@@ -3,16 +3,23 @@
 // Tempo stored/read as 3-byte (uint24) exactly as the MIDI spec mandates.
 // Populates:
 //   std::vector<MidiEvent>          → MidiOutputEngine
+//   SysExArena                      → SysEx payloads referenced by SYSEX events
 //   std::vector<OptimizedTrackData> → visualizer (NoteEvent note-on/off pairing)
-//   std::vector<CCEvent>            → CC lane data
+//   std::vector<CCEvent>            → CC lane data (pitch bend as CC_PITCH_BEND)
 //   std::vector<TempoEvent>         → global tempo map
+//   SmfIndex                        → per-chunk hashes; watch mode re-parses changed chunks only
 // ──────────────────────────────────────────────────────────────────────────────
 
 #include "visualizer.hpp"
 #include "midi_timing_alt.hpp"
+#include "load_telemetry.hpp"
+#include "midi_watch.hpp"
+#include "event_splice.hpp"
 
 #include <cstdio>
 #include <algorithm>
+#include <bit>
+#include <chrono>
 #include <unordered_map>
 #include <cstring>
 #include <stdexcept>
@@ -115,136 +122,94 @@ inline NoteKey makeNoteKey(uint8_t ch, uint8_t note) {
     return ((uint32_t)ch << 7) | note;
 }
 
-} // namespace
-
-static std::vector<MidiEvent> s_globalEvents;
-
-std::vector<TempoEvent> collectGlobalTempoEvents(const std::string& filename) {
-    std::vector<TempoEvent> tempos;
-    MidiReader r(filename);
-
-    uint32_t hdrId  = r.readU32();  
-    uint32_t hdrLen = r.readU32();  
-    uint16_t format = r.readU16();
-    uint16_t nTracks= r.readU16();
-    uint16_t ppq    = r.readU16();
-    (void)format; (void)ppq;
-    if (hdrLen > 6) r.skip(hdrLen - 6);
-
-    for (uint16_t t = 0; t < nTracks && !r.eof(); ++t) {
-        uint32_t chunkId  = r.readU32(); 
-        uint32_t chunkLen = r.readU32();
-        if (chunkId != 0x4D54726B) { r.skip(chunkLen); continue; }
-
-        uint32_t absTick   = 0;
-        uint8_t  runStatus = 0;
-        size_t   bytesLeft = chunkLen;
-        auto consume = [&](size_t n) { if (n <= bytesLeft) bytesLeft -= n; };
-
-        while (bytesLeft > 0 && !r.eof()) {
-            uint32_t delta = r.readVLQ(); consume(0); 
-            absTick += delta;
-
-            uint8_t statusByte = r.readU8(); consume(1);
-
-            // RUNNING STATUS FIX: Channel msgs (< 0xF0) update running status
-            if (statusByte & 0x80) {
-                if (statusByte < 0xF0) runStatus = statusByte;
-            }
-
-            uint8_t status = (statusByte & 0x80) ? statusByte : runStatus;
-            uint8_t firstData = (statusByte & 0x80) ? 0xFF : statusByte; 
-
-            if (status == 0xFF) {
-                uint8_t  metaType = r.readU8(); consume(1);
-                uint32_t metaLen  = r.readVLQ(); consume(0);
-                if (metaType == 0x51 && metaLen == 3) {
-                    uint32_t tempo = r.readU24(); consume(3);
-                    tempos.push_back({ absTick, tempo });
-                } else {
-                    r.skip(metaLen); consume(metaLen);
-                }
-            } else if (status == 0xF0 || status == 0xF7) {
-                uint32_t sysLen = r.readVLQ(); consume(0);
-                r.skip(sysLen); consume(sysLen);
-            } else {
-                uint8_t type = status & 0xF0;
-                if (type == 0xC0 || type == 0xD0) {
-                    if (firstData == 0xFF) { r.readU8(); consume(1); }
-                } else {
-                    if (firstData == 0xFF) { r.readU8(); consume(1); }
-                    r.readU8(); consume(1);
-                }
-            }
-        }
-        if (bytesLeft > 0) r.skip((uint32_t)bytesLeft);
+// Same-tick order of the merged list; the watch-mode splice merges with it too
+struct EventOrder {
+    bool operator()(const MidiEvent& a, const MidiEvent& b) const {
+        if (a.tick != b.tick) return a.tick < b.tick;
+        const EventType at = a.Type(), bt = b.Type();
+        bool aTempo = (at == EventType::TEMPO);
+        bool bTempo = (bt == EventType::TEMPO);
+        if (aTempo != bTempo) return aTempo > bTempo; 
+        
+        auto pri = [](EventType t) -> int {
+            if (t == EventType::TEMPO)    return 0;
+            // SysEx (GM/GS/XG resets, part setup) must land before the
+            // channel messages of the same tick that rely on it
+            if (t == EventType::SYSEX)    return 1;
+            // FIX: Must process NOTE_OFF BEFORE NOTE_ON for back-to-back notes!
+            // If a note ends and another begins on the exact same tick, the OFF must happen 
+            // first, otherwise it will instantly assassinate the newly started note!
+            if (t == EventType::NOTE_OFF) return 2;
+            if (t == EventType::NOTE_ON)  return 3;
+            return 4;
+        };
+        if (pri(at) != pri(bt)) return pri(at) < pri(bt);
+        // Arena entries grow in file order, so same-tick SysEx keep theirs
+        if (at == EventType::SYSEX) return a.SysExEntry() < b.SysExEntry();
+        return false;
     }
+};
 
-    std::stable_sort(tempos.begin(), tempos.end(),
-        [](const TempoEvent& a, const TempoEvent& b){ return a.tick < b.tick; });
-    return tempos;
+inline void SortNotes(std::vector<NoteEvent>& notes) {
+    std::sort(notes.begin(), notes.end(),
+        [](const NoteEvent& a, const NoteEvent& b){
+            return a.startTick < b.startTick;
+        });
 }
 
-std::vector<CCEvent> loadStreamingMidiData(
-    const std::string& filename, std::vector<OptimizedTrackData>& tracks,
-    int& ppq, int& initialTempo, uint64_t& totalNoteCount,
-    uint16_t& outTimeSigNumerator, uint16_t& outTimeSigDenominator,
-    LoadProgress* progress)
-{
-    if (progress) progress->loadPhase = 1;
-    MidiReader r(filename, progress ? &progress->bytesRead : nullptr);
-    if (progress) progress->totalBytes = r.totalSize;
-    tracks.clear();
-    totalNoteCount = 0;
-    outTimeSigNumerator   = 4;
-    outTimeSigDenominator = 4;
-    std::vector<CCEvent> ccEvents;
-
-    s_globalEvents.clear();
-
-    if (r.totalSize > 0) {
-        size_t estimatedEvents = r.totalSize / 10; 
-        s_globalEvents.reserve(estimatedEvents);
-        ccEvents.reserve(estimatedEvents / 8);     
-    }
-
-    if (r.readU32() != 0x4D546864) throw std::runtime_error("Not a MIDI file");
-    uint32_t hdrLen = r.readU32();
-    uint16_t format  = r.readU16();
-    uint16_t nTracks = r.readU16();
-    if (progress) progress->totalTracks = nTracks;
-    uint16_t ppqRaw  = r.readU16();
-    ppq = (int)(ppqRaw & 0x7FFF); 
-    initialTempo = (int)MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
-    if (hdrLen > 6) r.skip(hdrLen - 6);
-
-    int visualTrackCount = (format == 0) ? 16 : (int)nTracks;
-    tracks.resize(visualTrackCount);
-
-    if (r.totalSize > 0 && visualTrackCount > 0) {
-        size_t notesPerTrack = (r.totalSize / 16) / (size_t)visualTrackCount;
-        for (auto& td : tracks)
-            td.notes.reserve(std::max<size_t>(notesPerTrack, 1024));
+// Change detection for watch mode, not integrity: FNV-1a steps over 8-byte
+// words in four independent lanes, so hashing a whole file runs at about
+// memory speed instead of one multiply per byte.
+uint64_t HashChunk(const uint8_t* p, size_t n) {
+    constexpr uint64_t kPrime = 1099511628211ull;
+    uint64_t lane[4] = { 1469598103934665603ull, 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull };
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t w;
+            std::memcpy(&w, p + i + 8 * l, sizeof(w));
+            lane[l] = (lane[l] ^ w) * kPrime;
+        }
     }
+    uint64_t h = lane[0] ^ std::rotl(lane[1], 16) ^ std::rotl(lane[2], 32) ^ std::rotl(lane[3], 48);
+    for (; i < n; ++i) h = (h ^ p[i]) * kPrime;
+    return (h ^ (uint64_t)n) * kPrime;
+}
 
-    std::vector<std::unordered_map<NoteKey, std::vector<PendingNote>>> pendingNotes(visualTrackCount);
-
-    for (uint16_t trackIdx = 0; trackIdx < nTracks && !r.eof(); ++trackIdx) {
-        uint32_t chunkId  = r.readU32();
-        uint32_t chunkLen = r.readU32();
-		if (progress) progress->currentTrack = trackIdx + 1;
-
-        if (chunkId != 0x4D54726B) {  
-            r.skip(chunkLen);
-            continue;
-        }
+// One MTrk chunk → event list, note tracks and CC list. The full load runs it
+// over every chunk and watch mode over the chunks of the tracks that changed,
+// so both produce the same records. Chunks share no state: notes still
+// pending are closed at the end of each one.
+struct TrackParser {
+    std::vector<MidiEvent>&          events;
+    SysExArena&                      sysex;
+    std::vector<OptimizedTrackData>& tracks;
+    std::vector<CCEvent>&            ccEvents;
+    uint64_t&                        totalNoteCount;
+    int&                             initialTempo;
+    uint16_t&                        outTimeSigNumerator;
+    uint16_t&                        outTimeSigDenominator;
+    bool                             isFormat0;
+    LoadProgress*                    progress;
+
+    std::vector<std::unordered_map<NoteKey, std::vector<PendingNote>>> pendingNotes;
+
+    TrackParser(std::vector<MidiEvent>& ev, SysExArena& sx, std::vector<OptimizedTrackData>& tr,
+                std::vector<CCEvent>& cc, uint64_t& notes, int& tempo, uint16_t& tsNum, uint16_t& tsDen,
+                bool format0, LoadProgress* prog)
+        : events(ev), sysex(sx), tracks(tr), ccEvents(cc), totalNoteCount(notes), initialTempo(tempo),
+          outTimeSigNumerator(tsNum), outTimeSigDenominator(tsDen), isFormat0(format0), progress(prog),
+          pendingNotes(tr.size()) {}
+
+    // Parses the `chunkLen` bytes at r.pos; returns the SmfChunk kGlobal / kCC flags seen
+    uint8_t Chunk(MidiReader& r, uint32_t chunkLen, uint16_t trackIdx) {
+        const int visualTrackCount = (int)tracks.size();
+        uint8_t   flags = 0;
 
         uint32_t absTick   = 0;
         uint8_t  runStatus = 0;
         size_t   bytesLeft = chunkLen;
 
-        bool isFormat0 = (format == 0);
-
         while (bytesLeft > 0 && !r.eof()) {
             uint32_t delta = 0;
             for (int i = 0; i < 4; ++i) {
@@ -283,14 +248,14 @@ std::vector<CCEvent> loadStreamingMidiData(
 
                 if (metaType == 0x51 && metaLen == 3 && bytesLeft >= 3) {
                     uint32_t tempoVal = r.readU24(); bytesLeft -= 3;
-                    if (absTick == 0 && s_globalEvents.empty() &&
+                    if (absTick == 0 && events.empty() &&
                         initialTempo == (int)MidiTiming::DEFAULT_TEMPO_MICROSECONDS) {
                         initialTempo = (int)tempoVal;
                     }
-                    MidiEvent ev(absTick, EventType::TEMPO, 0);
-                    ev.data.tempo = tempoVal;   
-                    s_globalEvents.push_back(ev);
+                    events.push_back(MidiEvent::MakeTempo(absTick, tempoVal));
+                    flags |= SmfChunk::kGlobal;
                 } else if (metaType == 0x58 && metaLen == 4 && bytesLeft >= 4) {
+                    flags |= SmfChunk::kGlobal;
                     uint8_t nn = r.readU8(); bytesLeft--;
                     uint8_t dd = r.readU8(); bytesLeft--;
                     r.readU8(); bytesLeft--; 
@@ -324,6 +289,10 @@ std::vector<CCEvent> loadStreamingMidiData(
                     if (!(b & 0x80)) break;
                 }
                 if (sysLen > 0 && bytesLeft >= sysLen) {
+                    flags |= SmfChunk::kGlobal;
+                    // Payload goes to the arena; the event only keeps its entry index
+                    if (!sysex.Full())
+                        events.push_back(MidiEvent::MakeSysEx(absTick, sysex.Add(r.buf.data() + r.pos, sysLen, statusByte == 0xF0)));
                     r.skip(sysLen); bytesLeft -= sysLen;
                 }
                 continue;
@@ -341,10 +310,8 @@ std::vector<CCEvent> loadStreamingMidiData(
             };
 
             auto doNoteOff = [&](uint8_t note) {
-                MidiEvent ev(absTick, EventType::NOTE_OFF, channel);
-                ev.data.note.n = note;
-                ev.data.note.v = 0;
-                s_globalEvents.push_back(ev); // Pure unfiltered Note-Off for OmniMIDI Reference Counter
+                // Pure unfiltered Note-Off for OmniMIDI Reference Counter
+                events.push_back(MidiEvent::MakeShort(absTick, 0x80 | channel, note, 0, vtrack));
 
                 NoteKey key = makeNoteKey(channel, note);
                 auto& pm    = pendingNotes[vtrack];
@@ -384,10 +351,7 @@ std::vector<CCEvent> loadStreamingMidiData(
 					if (vel == 0) {
 						doNoteOff(note); 
 					} else {
-						MidiEvent ev(absTick, EventType::NOTE_ON, channel);
-						ev.data.note.n = note;
-						ev.data.note.v = vel;
-						s_globalEvents.push_back(ev);
+						events.push_back(MidiEvent::MakeShort(absTick, 0x90 | channel, note, vel, vtrack));
 						
 						NoteKey key = makeNoteKey(channel, note);
 						auto& pm    = pendingNotes[vtrack];
@@ -405,10 +369,8 @@ std::vector<CCEvent> loadStreamingMidiData(
                 }
                 
                 {
-                    MidiEvent ev(absTick, EventType::CC, channel);
-                    ev.data.cc.c = ctrl;
-                    ev.data.cc.v = val;
-                    s_globalEvents.push_back(ev);
+                    events.push_back(MidiEvent::MakeShort(absTick, 0xB0 | channel, ctrl, val, vtrack));
+                    flags |= SmfChunk::kCC;
 
                     CCEvent cc{};
                     cc.tick       = absTick;
@@ -422,28 +384,31 @@ std::vector<CCEvent> loadStreamingMidiData(
             case 0xE0: {   
                 uint8_t lsb = readData();
                 uint8_t msb = readData();
-                MidiEvent ev(absTick, EventType::PITCH_BEND, channel);
-                ev.data.raw.l1 = lsb;
-                ev.data.raw.m2 = msb;
-                s_globalEvents.push_back(ev);
+                events.push_back(MidiEvent::MakeShort(absTick, 0xE0 | channel, lsb, msb, vtrack));
+                flags |= SmfChunk::kCC;
+
+                CCEvent cc{};
+                cc.tick       = absTick;
+                cc.channel    = channel;
+                cc.controller = CC_PITCH_BEND;
+                cc.value      = msb;
+                ccEvents.push_back(cc);
                 break;
             }
             case 0xC0: {   
                 uint8_t prog = readData();
-                MidiEvent ev(absTick, EventType::PROGRAM_CHANGE, channel);
-                ev.data.val = prog;
-                s_globalEvents.push_back(ev);
+                events.push_back(MidiEvent::MakeShort(absTick, 0xC0 | channel, prog, 0, vtrack));
                 break;
             }
             case 0xD0: {   
                 uint8_t pressure = readData();
-                MidiEvent ev(absTick, EventType::CHANNEL_PRESSURE, channel);
-                ev.data.val = pressure;
-                s_globalEvents.push_back(ev);
+                events.push_back(MidiEvent::MakeShort(absTick, 0xD0 | channel, pressure, 0, vtrack));
                 break;
             }
             case 0xA0: {   
-                readData(); readData();
+                uint8_t note     = readData();
+                uint8_t pressure = readData();
+                events.push_back(MidiEvent::MakeShort(absTick, 0xA0 | channel, note, pressure, vtrack));
                 break;
             }
             default:
@@ -477,44 +442,178 @@ std::vector<CCEvent> loadStreamingMidiData(
         }
 
         if (bytesLeft > 0) r.skip((uint32_t)bytesLeft);
+        return flags;
+    }
+};
+
+} // namespace
+
+static std::vector<MidiEvent> s_globalEvents;
+static SysExArena             s_sysex;
+static SmfIndex               s_smfIndex;   // the file as last loaded (watch mode)
+
+std::vector<TempoEvent> collectGlobalTempoEvents(const std::string& filename) {
+    std::vector<TempoEvent> tempos;
+    MidiReader r(filename);
+
+    uint32_t hdrId  = r.readU32();  
+    uint32_t hdrLen = r.readU32();  
+    uint16_t format = r.readU16();
+    uint16_t nTracks= r.readU16();
+    uint16_t ppq    = r.readU16();
+    (void)format; (void)ppq;
+    if (hdrLen > 6) r.skip(hdrLen - 6);
+
+    for (uint16_t t = 0; t < nTracks && !r.eof(); ++t) {
+        uint32_t chunkId  = r.readU32(); 
+        uint32_t chunkLen = r.readU32();
+        if (chunkId != 0x4D54726B) { r.skip(chunkLen); continue; }
+
+        uint32_t absTick   = 0;
+        uint8_t  runStatus = 0;
+        size_t   bytesLeft = chunkLen;
+        auto consume = [&](size_t n) { if (n <= bytesLeft) bytesLeft -= n; };
+
+        while (bytesLeft > 0 && !r.eof()) {
+            uint32_t delta = r.readVLQ(); consume(0); 
+            absTick += delta;
+
+            uint8_t statusByte = r.readU8(); consume(1);
+
+            // RUNNING STATUS FIX: Channel msgs (< 0xF0) update running status
+            if (statusByte & 0x80) {
+                if (statusByte < 0xF0) runStatus = statusByte;
+            }
+
+            uint8_t status = (statusByte & 0x80) ? statusByte : runStatus;
+            uint8_t firstData = (statusByte & 0x80) ? 0xFF : statusByte; 
+
+            if (status == 0xFF) {
+                uint8_t  metaType = r.readU8(); consume(1);
+                uint32_t metaLen  = r.readVLQ(); consume(0);
+                if (metaType == 0x51 && metaLen == 3) {
+                    uint32_t tempo = r.readU24(); consume(3);
+                    tempos.push_back({ absTick, tempo });
+                } else {
+                    r.skip(metaLen); consume(metaLen);
+                }
+            } else if (status == 0xF0 || status == 0xF7) {
+                uint32_t sysLen = r.readVLQ(); consume(0);
+                r.skip(sysLen); consume(sysLen);
+            } else {
+                uint8_t type = status & 0xF0;
+                if (type == 0xC0 || type == 0xD0) {
+                    if (firstData == 0xFF) { r.readU8(); consume(1); }
+                } else {
+                    if (firstData == 0xFF) { r.readU8(); consume(1); }
+                    r.readU8(); consume(1);
+                }
+            }
+        }
+        if (bytesLeft > 0) r.skip((uint32_t)bytesLeft);
+    }
+
+    std::stable_sort(tempos.begin(), tempos.end(),
+        [](const TempoEvent& a, const TempoEvent& b){ return a.tick < b.tick; });
+    return tempos;
+}
+
+std::vector<CCEvent> loadStreamingMidiData(
+    const std::string& filename, std::vector<OptimizedTrackData>& tracks,
+    int& ppq, int& initialTempo, uint64_t& totalNoteCount,
+    uint16_t& outTimeSigNumerator, uint16_t& outTimeSigDenominator,
+    LoadProgress* progress, LoadTelemetry* telemetry)
+{
+    if (progress) progress->loadPhase = 1;
+    if (telemetry) telemetry->Stage("Read file");
+    MidiReader r(filename, progress ? &progress->bytesRead : nullptr);
+    if (progress) progress->totalBytes = r.totalSize;
+    if (telemetry) {
+        telemetry->SetWork(r.totalSize, 0);
+        telemetry->Stage("Parse + pair", r.totalSize);
+    }
+    tracks.clear();
+    totalNoteCount = 0;
+    outTimeSigNumerator   = 4;
+    outTimeSigDenominator = 4;
+    std::vector<CCEvent> ccEvents;
+
+    s_globalEvents.clear();
+    s_sysex.Clear();
+
+    if (r.totalSize > 0) {
+        size_t estimatedEvents = r.totalSize / 10; 
+        s_globalEvents.reserve(estimatedEvents);
+        ccEvents.reserve(estimatedEvents / 8);     
+    }
+
+    if (r.readU32() != 0x4D546864) throw std::runtime_error("Not a MIDI file");
+    uint32_t hdrLen = r.readU32();
+    uint16_t format  = r.readU16();
+    uint16_t nTracks = r.readU16();
+    if (progress) progress->totalTracks = nTracks;
+    uint16_t ppqRaw  = r.readU16();
+    ppq = (int)(ppqRaw & 0x7FFF); 
+    initialTempo = (int)MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
+    if (hdrLen > 6) r.skip(hdrLen - 6);
+
+    int visualTrackCount = (format == 0) ? 16 : (int)nTracks;
+    tracks.resize(visualTrackCount);
+
+    if (r.totalSize > 0 && visualTrackCount > 0) {
+        size_t notesPerTrack = (r.totalSize / 16) / (size_t)visualTrackCount;
+        for (auto& td : tracks)
+            td.notes.reserve(std::max<size_t>(notesPerTrack, 1024));
+    }
+
+    TrackParser parser(s_globalEvents, s_sysex, tracks, ccEvents, totalNoteCount, initialTempo,
+                       outTimeSigNumerator, outTimeSigDenominator, format == 0, progress);
+    s_smfIndex = SmfIndex{};
+    s_smfIndex.headerLen  = hdrLen;
+    s_smfIndex.format     = format;
+    s_smfIndex.trackCount = nTracks;
+    s_smfIndex.division   = ppqRaw;
+    s_smfIndex.chunks.reserve(nTracks);
+
+    for (uint16_t trackIdx = 0; trackIdx < nTracks && !r.eof(); ++trackIdx) {
+        uint32_t chunkId  = r.readU32();
+        uint32_t chunkLen = r.readU32();
+		if (progress) progress->currentTrack = trackIdx + 1;
+
+        // Watch mode compares these with the file's next version
+        SmfChunk info;
+        info.hash = HashChunk(r.buf.data() + r.pos, std::min<size_t>(chunkLen, r.totalSize - r.pos));
+
+        if (chunkId != 0x4D54726B) {  
+            s_smfIndex.chunks.push_back(info);
+            r.skip(chunkLen);
+            continue;
+        }
+        info.flags = SmfChunk::kTrack | parser.Chunk(r, chunkLen, trackIdx);
+        s_smfIndex.chunks.push_back(info);
     }
 	
 	if (progress) {
         progress->currentNotes = totalNoteCount;
         progress->loadPhase = 2; 
     }
+    if (telemetry) {
+        telemetry->SetWork(r.totalSize, totalNoteCount);
+        telemetry->Stage("Sort events", s_globalEvents.size() * sizeof(MidiEvent));
+    }
 
-    std::sort(s_globalEvents.begin(), s_globalEvents.end(),
-        [](const MidiEvent& a, const MidiEvent& b) {
-            if (a.tick != b.tick) return a.tick < b.tick;
-            bool aTempo = (a.type == (uint8_t)EventType::TEMPO);
-            bool bTempo = (b.type == (uint8_t)EventType::TEMPO);
-            if (aTempo != bTempo) return aTempo > bTempo; 
-            
-            auto pri = [](uint8_t t) -> int {
-				if (t == (uint8_t)EventType::TEMPO)    return 0;
-                // FIX: Must process NOTE_OFF BEFORE NOTE_ON for back-to-back notes!
-                // If a note ends and another begins on the exact same tick, the OFF must happen 
-                // first, otherwise it will instantly assassinate the newly started note!
-				if (t == (uint8_t)EventType::NOTE_OFF) return 1;
-				if (t == (uint8_t)EventType::NOTE_ON)  return 2;
-				return 3;
-			};
-			if (pri(a.type) != pri(b.type)) return pri(a.type) < pri(b.type);
-			return false;
-        });
+    std::sort(s_globalEvents.begin(), s_globalEvents.end(), EventOrder{});
 
+    if (telemetry) telemetry->Stage("Shrink events", s_globalEvents.size() * sizeof(MidiEvent));
     s_globalEvents.shrink_to_fit(); 
 
-    for (auto& td : tracks) {
-        std::sort(td.notes.begin(), td.notes.end(),
-            [](const NoteEvent& a, const NoteEvent& b){
-                return a.startTick < b.startTick;
-            });
-        td.notes.shrink_to_fit(); 
-    }
+    if (telemetry) telemetry->Stage("Sort tracks", totalNoteCount * sizeof(NoteEvent), totalNoteCount);
+    for (auto& td : tracks) SortNotes(td.notes.Owned());
+    if (telemetry) telemetry->Stage("Shrink tracks", totalNoteCount * sizeof(NoteEvent), totalNoteCount);
+    for (auto& td : tracks) td.notes.shrink_to_fit(); 
 
-    std::sort(ccEvents.begin(), ccEvents.end(),
+    if (telemetry) telemetry->Stage("Sort CC", ccEvents.size() * sizeof(CCEvent));
+    std::stable_sort(ccEvents.begin(), ccEvents.end(),
         [](const CCEvent& a, const CCEvent& b){
             return a.tick < b.tick;
         });
@@ -525,4 +624,168 @@ std::vector<CCEvent> loadStreamingMidiData(
 
 const std::vector<MidiEvent>& GetGlobalMidiEvents() {
     return s_globalEvents;
-}
\ No newline at end of file
+}
+
+const SysExArena& GetSysExArena() {
+    return s_sysex;
+}
+// ── Watch mode: track-level reparse ──────────────────────────────────────────
+
+void PrepareTrackReload(const std::string& filename, TrackReload& out) {
+    const auto t0 = std::chrono::steady_clock::now();
+    using Result = TrackReload::Result;
+    auto finish = [&](Result result, const char* why) {
+        out.result    = result;
+        out.why       = why;
+        out.prepareMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    };
+
+    MidiReader r(filename);
+    if (r.totalSize < 14 || r.readU32() != 0x4D546864) return finish(Result::Failed, "not a MIDI file");
+    SmfIndex& ix = out.index;
+    ix.headerLen  = r.readU32();
+    ix.format     = r.readU16();
+    ix.trackCount = r.readU16();
+    ix.division   = r.readU16();
+    if (ix.headerLen > 6) r.skip(ix.headerLen - 6);
+
+    // Hash every chunk; remember where the MTrk ones start
+    std::vector<size_t> offsets;
+    std::vector<uint32_t> lengths;
+    for (uint16_t t = 0; t < ix.trackCount && !r.eof(); ++t) {
+        const uint32_t chunkId  = r.readU32();
+        const uint32_t chunkLen = r.readU32();
+        if (chunkLen > r.totalSize - r.pos) return finish(Result::Full, "last chunk is truncated");
+        SmfChunk info;
+        info.hash  = HashChunk(r.buf.data() + r.pos, chunkLen);
+        info.flags = (chunkId == 0x4D54726B) ? SmfChunk::kTrack : 0;
+        ix.chunks.push_back(info);
+        offsets.push_back(r.pos);
+        lengths.push_back(chunkLen);
+        r.skip(chunkLen);
+    }
+
+    const SmfIndex& old = s_smfIndex;
+    if (old.chunks.empty())       return finish(Result::Full, "no chunk index from the last load");
+    if (!ix.SameLayout(old))      return finish(Result::Full, "header or chunk layout changed");
+
+    for (size_t i = 0; i < ix.chunks.size(); ++i) {
+        if (ix.chunks[i].hash == old.chunks[i].hash) continue;
+        if ((ix.chunks[i].flags ^ old.chunks[i].flags) & SmfChunk::kTrack)
+            return finish(Result::Full, "a chunk changed type");
+        if (ix.chunks[i].flags & SmfChunk::kTrack) out.chunks.push_back((uint16_t)i);
+    }
+    if (out.chunks.empty()) {
+        ix.chunks = old.chunks;   // only skipped chunks (or nothing) changed
+        return finish(Result::Unchanged, "");
+    }
+    if (ix.format == 0) return finish(Result::Full, "format 0 has a single track");
+
+    // Every chunk feeding an affected visual track is parsed again
+    bool affected[256] = {};
+    for (uint16_t c : out.chunks) affected[(uint8_t)c] = true;
+    std::vector<uint16_t> group;
+    for (size_t i = 0; i < ix.chunks.size(); ++i) {
+        if (!(ix.chunks[i].flags & SmfChunk::kTrack)) continue;
+        if (!affected[(uint8_t)i]) { ix.chunks[i].flags = old.chunks[i].flags; continue; }
+        if (old.chunks[i].flags & SmfChunk::kGlobal)
+            return finish(Result::Full, "a changed track held tempo / time signature / SysEx");
+        group.push_back((uint16_t)i);
+    }
+
+    std::vector<OptimizedTrackData> scratch(ix.trackCount);
+    std::vector<CCEvent> cc;
+    SysExArena sysex;
+    uint64_t   notes = 0;
+    int        tempo = (int)MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
+    uint16_t   tsNum = 4, tsDen = 4;
+    TrackParser parser(out.events, sysex, scratch, cc, notes, tempo, tsNum, tsDen, false, nullptr);
+    for (uint16_t i : group) {
+        r.pos = offsets[i];
+        const uint8_t flags = parser.Chunk(r, lengths[i], i);
+        if (flags & SmfChunk::kGlobal)
+            return finish(Result::Full, "a changed track now holds tempo / time signature / SysEx");
+        out.ccTouched |= ((flags | old.chunks[i].flags) & SmfChunk::kCC) != 0;
+        ix.chunks[i].flags = SmfChunk::kTrack | flags;
+        out.bytesParsed += lengths[i];
+    }
+
+    std::sort(out.events.begin(), out.events.end(), EventOrder{});
+    // The same tracks' events in the merged list, and the ticks where they
+    // differ. Apply rebuilds only that window; the scan stays on this thread.
+    for (const MidiEvent& e : s_globalEvents)
+        if (e.Status() < 0xF0 && affected[e.Track()]) out.oldEvents.push_back(e);
+    // Outside the window each tick holds the same events, but maybe in another
+    // order. Keep the old one: the event filter pairs notes in list order, so
+    // the rebuilt tracks must read exactly as they will in the merged list.
+    if (ChangedTicks(out.oldEvents, out.events, out.editLo, out.editHi)) {
+        std::vector<MidiEvent> events(out.oldEvents.begin(),
+                                      out.oldEvents.begin() + (ptrdiff_t)TickLowerBound(out.oldEvents, out.editLo));
+        events.insert(events.end(), out.events.begin() + (ptrdiff_t)TickLowerBound(out.events, out.editLo),
+                      out.events.begin() + (ptrdiff_t)TickUpperBound(out.events, out.editHi));
+        events.insert(events.end(), out.oldEvents.begin() + (ptrdiff_t)TickUpperBound(out.oldEvents, out.editHi),
+                      out.oldEvents.end());
+        out.events.swap(events);
+    } else {
+        out.events = out.oldEvents;
+    }
+    for (size_t a = 0; a < 256 && a < scratch.size(); ++a) {
+        if (!affected[a]) continue;
+        out.tracks.push_back((uint16_t)a);
+        out.notes.push_back(std::move(scratch[a].notes.Owned()));
+        SortNotes(out.notes.back());
+        out.notes.back().shrink_to_fit();
+    }
+    finish(Result::Tracks, "");
+}
+
+void ApplyTrackReload(TrackReload& r, std::vector<OptimizedTrackData>& tracks,
+                      uint64_t& totalNoteCount, std::vector<CCEvent>& cc)
+{
+    if (r.result != TrackReload::Result::Tracks) return;
+
+    // Channel events carry their visual track; tempo / SysEx never come from
+    // a rebuilt track (PrepareTrackReload checked), so they all stay. Outside
+    // [editLo, editHi] the rebuilt tracks' events did not change, so only
+    // that window is rebuilt: the other tracks' events in it, merged with the
+    // new ones.
+    bool affected[256] = {};
+    for (uint16_t t : r.tracks) affected[t & 0xFF] = true;
+    const bool edited = r.editLo <= r.editHi;
+    if (edited) {
+        const size_t first = TickLowerBound(s_globalEvents, r.editLo);
+        const size_t last  = TickUpperBound(s_globalEvents, r.editHi);
+        std::vector<MidiEvent> kept;
+        for (size_t i = first; i < last; ++i) {
+            const MidiEvent& e = s_globalEvents[i];
+            if (e.Status() >= 0xF0 || !affected[e.Track()]) kept.push_back(e);
+        }
+        const auto added = r.events.begin() + (ptrdiff_t)TickLowerBound(r.events, r.editLo);
+        const auto end   = r.events.begin() + (ptrdiff_t)TickUpperBound(r.events, r.editHi);
+        std::vector<MidiEvent> window;
+        window.reserve(kept.size() + (size_t)(end - added));
+        std::merge(kept.begin(), kept.end(), added, end, std::back_inserter(window), EventOrder{});
+        ReplaceRange(s_globalEvents, first, last, window);
+    }
+
+    for (size_t k = 0; k < r.tracks.size(); ++k) {
+        NoteList& notes = tracks[r.tracks[k]].notes;
+        totalNoteCount = totalNoteCount - notes.size() + r.notes[k].size();
+        notes.Owned().swap(r.notes[k]);
+        notes.Sync();
+    }
+    s_smfIndex = std::move(r.index);
+
+    cc.clear();
+    if (!r.ccTouched || !edited) return;
+    // Same records the loader makes, read back from the window of the merged
+    // list. Their order within a tick is lost there, which the lanes don't
+    // need (CCLaneIndex takes a tick's highest value).
+    const size_t last = TickUpperBound(s_globalEvents, r.editHi);
+    for (size_t i = TickLowerBound(s_globalEvents, r.editLo); i < last; ++i) {
+        const MidiEvent& e = s_globalEvents[i];
+        const uint8_t kind = e.Status() >> 4;
+        if (kind == 0xB)      cc.push_back({ e.tick, e.Channel(), e.D1(), e.D2() });
+        else if (kind == 0xE) cc.push_back({ e.tick, e.Channel(), CC_PITCH_BEND, e.D2() });
+    }
+}
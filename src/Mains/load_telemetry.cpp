@@ -0,0 +1,271 @@
+#include "load_telemetry.hpp"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+LoadTelemetry g_LoadTelemetry;
+
+// ── Process counters ──────────────────────────────────────────────────────────
+
+uint64_t ProcessResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return (uint64_t)pmc.WorkingSetSize;
+    return 0;
+#else
+    unsigned long long pages = 0, resident = 0;
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%llu %llu", &pages, &resident) != 2) resident = 0;
+        std::fclose(f);
+    }
+    return (uint64_t)resident * (uint64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+double ProcessCpuMs() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0.0;
+    auto ticks = [](const FILETIME& f) { return ((uint64_t)f.dwHighDateTime << 32) | f.dwLowDateTime; };
+    return (double)(ticks(kernel) + ticks(user)) / 10000.0;   // 100 ns units
+#else
+    timespec ts{};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+static std::string TextLine(const char* fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    std::vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+std::string JsonEscape(const std::string& s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') { out += '\\'; out += (char)c; }
+        else if (c < 0x20)         out += TextLine("\\u%04x", c);
+        else                       out += (char)c;
+    }
+    return out;
+}
+
+// ── Sampler ───────────────────────────────────────────────────────────────────
+
+void LoadTelemetry::StartSampler() {
+    StopSampler();
+    sampling.store(true, std::memory_order_release);
+    sampler = std::thread([this] {
+        while (sampling.load(std::memory_order_acquire)) {
+            const uint64_t rss = ProcessResidentBytes();
+            uint64_t seen = peakRss.load(std::memory_order_relaxed);
+            while (rss > seen && !peakRss.compare_exchange_weak(seen, rss, std::memory_order_relaxed)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(kSampleMs));
+        }
+    });
+}
+
+void LoadTelemetry::StopSampler() {
+    sampling.store(false, std::memory_order_release);
+    if (sampler.joinable()) sampler.join();
+}
+
+// ── Stages ────────────────────────────────────────────────────────────────────
+
+void LoadTelemetry::Begin(const std::string& f) {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        stages.clear();
+        file       = f;
+        noteTotal  = 0;
+        trackCount = 0;
+        totalMs    = totalCpuMs = 0.0;
+        origin     = Clock::now();
+        cpu0       = stageCpu0 = ProcessCpuMs();
+        peakRss.store(ProcessResidentBytes(), std::memory_order_relaxed);
+    }
+    active.store(true, std::memory_order_release);
+    StartSampler();
+}
+
+void LoadTelemetry::CloseRunning(double nowMs, double cpuMs) {
+    if (stages.empty() || !stages.back().running) return;
+    StageStats& s = stages.back();
+    const uint64_t rss = ProcessResidentBytes();
+    s.wallMs    = nowMs - s.startMs;
+    s.cpuMs     = cpuMs - stageCpu0;
+    s.rssEndMB  = rss >> 20;
+    s.rssPeakMB = std::max(peakRss.load(std::memory_order_relaxed), rss) >> 20;
+    s.running   = false;
+}
+
+void LoadTelemetry::Stage(const char* name, uint64_t bytes, uint64_t notes) {
+    if (!Active()) return;
+    std::lock_guard<std::mutex> lk(mtx);
+    const double now = NowMs(), cpu = ProcessCpuMs();
+    CloseRunning(now, cpu);
+    StageStats s;
+    s.name    = name;
+    s.startMs = now;
+    s.bytes   = bytes;
+    s.notes   = notes;
+    s.running = true;
+    stages.push_back(std::move(s));
+    stageCpu0 = cpu;
+    peakRss.store(ProcessResidentBytes(), std::memory_order_relaxed);
+}
+
+void LoadTelemetry::SetWork(uint64_t bytes, uint64_t notes) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (stages.empty() || !stages.back().running) return;
+    stages.back().bytes = bytes;
+    stages.back().notes = notes;
+}
+
+void LoadTelemetry::Finish(uint64_t totalNotes, size_t tracks) {
+    if (!Active()) return;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        const double now = NowMs(), cpu = ProcessCpuMs();
+        CloseRunning(now, cpu);
+        totalMs    = now;
+        totalCpuMs = cpu - cpu0;
+        noteTotal  = totalNotes;
+        trackCount = tracks;
+        // Everything after the parse scales with the note count
+        if (const StageStats* parse = Parse(); parse && totalNotes > 0)
+            postParseMsPerNote = (totalMs - parse->startMs - parse->wallMs) / (double)totalNotes;
+    }
+    StopSampler();
+    active.store(false, std::memory_order_release);
+    PrintTable();
+}
+
+const LoadTelemetry::StageStats* LoadTelemetry::Parse() const {
+    for (const auto& s : stages)
+        if (s.name == kParseStage) return &s;
+    return nullptr;
+}
+
+std::string LoadTelemetry::Running() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return (!stages.empty() && stages.back().running) ? stages.back().name : std::string();
+}
+
+double LoadTelemetry::ElapsedMs() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return Active() ? NowMs() : totalMs;
+}
+
+std::vector<LoadTelemetry::StageStats> LoadTelemetry::Stages() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    std::vector<StageStats> out = stages;
+    if (!out.empty() && out.back().running) {
+        StageStats& s = out.back();
+        s.wallMs    = NowMs() - s.startMs;
+        s.cpuMs     = ProcessCpuMs() - stageCpu0;
+        s.rssPeakMB = peakRss.load(std::memory_order_relaxed) >> 20;
+    }
+    return out;
+}
+
+double LoadTelemetry::EtaSeconds(uint64_t bytesRead, uint64_t totalBytes, uint64_t notesSoFar) const {
+    std::lock_guard<std::mutex> lk(mtx);
+    const StageStats* p = Parse();
+    if (!p || !Active()) return -1.0;
+    const StageStats& parse = *p;
+    const double now = NowMs();
+
+    if (parse.running) {
+        if (bytesRead == 0 || totalBytes == 0) return -1.0;
+        const double frac      = std::min(1.0, (double)bytesRead / (double)totalBytes);
+        const double parseLeft = (now - parse.startMs) * (1.0 - frac) / frac;
+        const double notesEst  = (double)notesSoFar / frac;
+        return (parseLeft + notesEst * postParseMsPerNote) / 1000.0;
+    }
+    if (postParseMsPerNote <= 0.0) return -1.0;
+    const double since = now - (parse.startMs + parse.wallMs);
+    return std::max(0.0, (double)parse.notes * postParseMsPerNote - since) / 1000.0;
+}
+
+// ── Reports ───────────────────────────────────────────────────────────────────
+
+void LoadTelemetry::PrintTable() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    std::cout << "+-[ Load timeline ]-+" << std::endl;
+    std::cout << TextLine("  %-22s %9s %9s %9s %11s %8s %8s", "stage", "wall ms", "cpu ms", "MB/s", "notes/s", "RSS MB", "peak MB") << std::endl;
+    for (const auto& s : stages) {
+        const double sec = s.wallMs / 1000.0;
+        const std::string mbps  = (s.bytes && sec > 0) ? TextLine("%9.1f",  (double)s.bytes / 1048576.0 / sec) : "        -";
+        const std::string notes = (s.notes && sec > 0) ? TextLine("%11.0f", (double)s.notes / sec)              : "          -";
+        std::cout << TextLine("  %-22s %9.1f %9.1f %s %s %8llu %8llu", s.name.c_str(), s.wallMs, s.cpuMs,
+                              mbps.c_str(), notes.c_str(), (unsigned long long)s.rssEndMB, (unsigned long long)s.rssPeakMB) << std::endl;
+    }
+    std::cout << TextLine("  %-22s %9.1f %9.1f", "total", totalMs, totalCpuMs) << std::endl;
+}
+
+bool LoadTelemetry::AppendLog(const std::string& path) const {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (stages.empty()) return false;
+    std::ofstream out(path, std::ios::app);
+    if (!out.is_open()) return false;
+
+    char when[32] = "";
+    const std::time_t t = std::time(nullptr);
+    if (const std::tm* g = std::gmtime(&t)) std::strftime(when, sizeof(when), "%Y-%m-%dT%H:%M:%SZ", g);
+
+    uint64_t peak = 0;
+    for (const auto& s : stages) peak = std::max(peak, s.rssPeakMB);
+    const StageStats* parse = Parse();
+
+    out << "{\"time\":\"" << when << "\",\"file\":\"" << JsonEscape(file) << "\""
+        << ",\"bytes\":" << (parse ? parse->bytes : 0) << ",\"notes\":" << noteTotal << ",\"tracks\":" << trackCount
+        << ",\"totalMs\":" << TextLine("%.3f", totalMs) << ",\"cpuMs\":" << TextLine("%.3f", totalCpuMs)
+        << ",\"peakRssMB\":" << peak
+        << ",\"postParseMsPerNote\":" << TextLine("%.9g", postParseMsPerNote)
+        << ",\"stages\":[";
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const auto& s = stages[i];
+        const double sec = s.wallMs / 1000.0;
+        out << (i ? "," : "") << "{\"name\":\"" << JsonEscape(s.name) << "\""
+            << ",\"wallMs\":" << TextLine("%.3f", s.wallMs) << ",\"cpuMs\":" << TextLine("%.3f", s.cpuMs)
+            << ",\"bytes\":" << s.bytes << ",\"notes\":" << s.notes
+            << ",\"mbPerSec\":"    << TextLine("%.3f", (s.bytes && sec > 0) ? (double)s.bytes / 1048576.0 / sec : 0.0)
+            << ",\"notesPerSec\":" << TextLine("%.1f", (s.notes && sec > 0) ? (double)s.notes / sec : 0.0)
+            << ",\"rssEndMB\":" << s.rssEndMB << ",\"rssPeakMB\":" << s.rssPeakMB << "}";
+    }
+    out << "]}\n";
+    return true;
+}
+
+void LoadTelemetry::LoadHistory(const std::string& path) {
+    std::ifstream in(path);
+    std::string line, last;
+    while (std::getline(in, line)) if (!line.empty()) last = line;
+    const char* key = "\"postParseMsPerNote\":";
+    const size_t at = last.find(key);
+    if (at == std::string::npos) return;
+    const double v = std::strtod(last.c_str() + at + std::char_traits<char>::length(key), nullptr);
+    std::lock_guard<std::mutex> lk(mtx);
+    if (v > 0.0) postParseMsPerNote = v;
+}
@@ -0,0 +1,350 @@
+#include "midi_library.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+MidiLibrary g_MidiLibrary;
+
+namespace fs = std::filesystem;
+
+// ── Probe ─────────────────────────────────────────────────────────────────────
+
+namespace {
+
+struct TempoAt { uint64_t tick; uint32_t tempo; };
+
+uint32_t ReadBE(const uint8_t* p, int n) {
+    uint32_t v = 0;
+    for (int i = 0; i < n; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+struct TrackCount {
+    uint64_t notes    = 0;
+    uint64_t endTick  = 0;
+    size_t   consumed = 0;   // bytes up to the last complete event
+};
+
+// Parses as much of an MTrk body as `n` holds; stops at the first event the
+// buffer cuts off (or at End of Track).
+TrackCount CountTrack(const uint8_t* p, size_t n, std::vector<TempoAt>& tempo) {
+    TrackCount out;
+    size_t   i = 0;
+    uint64_t tick = 0;
+    uint8_t  status = 0;
+    auto vlq = [&](uint64_t& v) {
+        v = 0;
+        for (int k = 0; k < 4; ++k) {
+            if (i >= n) return false;
+            const uint8_t b = p[i++];
+            v = (v << 7) | (b & 0x7F);
+            if (!(b & 0x80)) return true;
+        }
+        return true;   // over-long VLQ: take what we have, like the loader
+    };
+    while (i < n) {
+        uint64_t delta;
+        if (!vlq(delta)) break;
+        tick += delta;
+        if (i >= n) break;
+        uint8_t b = p[i];
+        if (b & 0x80) { status = b; ++i; }
+        else if (status == 0 || status >= 0xF0) break;   // running status without a status: corrupt
+        const uint8_t hi = status & 0xF0;
+        if (hi == 0x80 || hi == 0x90 || hi == 0xA0 || hi == 0xB0 || hi == 0xE0) {
+            if (i + 2 > n) break;
+            if (hi == 0x90 && p[i + 1] != 0) ++out.notes;
+            i += 2;
+        } else if (hi == 0xC0 || hi == 0xD0) {
+            if (i + 1 > n) break;
+            i += 1;
+        } else if (status == 0xFF) {
+            if (i >= n) break;
+            const uint8_t type = p[i++];
+            uint64_t len;
+            if (!vlq(len) || i + len > n) break;
+            if (type == 0x51 && len == 3) tempo.push_back({ tick, ReadBE(p + i, 3) });
+            i += (size_t)len;
+            if (type == 0x2F) { out.consumed = i; out.endTick = tick; return out; }
+        } else if (status == 0xF0 || status == 0xF7) {
+            uint64_t len;
+            if (!vlq(len) || i + len > n) break;
+            i += (size_t)len;
+        } else {
+            break;
+        }
+        out.consumed = i;
+        out.endTick  = tick;
+    }
+    return out;
+}
+
+} // namespace
+
+bool ProbeMidiFile(const std::string& path, LibraryEntry& e) {
+    e.state = LibraryEntry::State::Invalid;
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+
+    uint8_t hdr[14];
+    if (!in.read((char*)hdr, sizeof(hdr)) || std::memcmp(hdr, "MThd", 4) != 0) return false;
+    const uint32_t hdrLen   = ReadBE(hdr + 4, 4);
+    const uint16_t division = (uint16_t)ReadBE(hdr + 12, 2);
+    if (hdrLen < 6) return false;
+    in.seekg(hdrLen - 6, std::ios::cur);
+    e.format = (uint16_t)ReadBE(hdr + 8, 2);
+    e.ppq    = (division & 0x8000) ? 0 : division;
+
+    std::vector<uint8_t> buf;
+    std::vector<TempoAt> tempo;
+    uint64_t notes = 0, endTick = 0;
+    uint16_t tracks = 0;
+    bool     estimated = false;
+    uint8_t  chunk[8];
+    while (in.read((char*)chunk, sizeof(chunk))) {
+        const uint64_t len = ReadBE(chunk + 4, 4);
+        if (std::memcmp(chunk, "MTrk", 4) != 0) { in.seekg((std::streamoff)len, std::ios::cur); continue; }
+        ++tracks;
+        const size_t take = (size_t)std::min(len, kProbeBytes);
+        buf.resize(take);
+        in.read((char*)buf.data(), (std::streamsize)take);
+        const size_t got = (size_t)in.gcount();
+        const TrackCount c = CountTrack(buf.data(), got, tempo);
+        if (got < len && c.consumed > 0) {
+            // Event density in the prefix stands in for the rest of the chunk
+            const double scale = (double)len / (double)c.consumed;
+            notes   += (uint64_t)((double)c.notes * scale);
+            endTick  = std::max(endTick, (uint64_t)((double)c.endTick * scale));
+            estimated = true;
+        } else {
+            notes  += c.notes;
+            endTick = std::max(endTick, c.endTick);
+        }
+        if (got < take) break;   // truncated file: keep what was counted
+        if (len > take) in.seekg((std::streamoff)(len - take), std::ios::cur);
+        if (!in) break;
+    }
+    if (tracks == 0) return false;
+
+    double seconds = 0.0;
+    if (e.ppq > 0) {
+        std::stable_sort(tempo.begin(), tempo.end(), [](const TempoAt& a, const TempoAt& b) { return a.tick < b.tick; });
+        uint64_t at = 0;
+        uint32_t us = 500000;
+        for (const TempoAt& t : tempo) {
+            if (t.tick >= endTick) break;
+            seconds += (double)(t.tick - at) * us / e.ppq / 1e6;
+            at = t.tick; us = t.tempo;
+        }
+        seconds += (double)(endTick - at) * us / e.ppq / 1e6;
+    } else {
+        // SMPTE: -fps in the high byte, ticks per frame in the low byte
+        const int fps = -(int8_t)(division >> 8), tpf = division & 0xFF;
+        if (fps > 0 && tpf > 0) seconds = (double)endTick / (fps * (fps == 29 ? 29.97 / 29.0 : 1.0) * tpf);
+    }
+
+    e.tracks    = tracks;
+    e.notes     = notes;
+    e.seconds   = seconds;
+    e.estimated = estimated;
+    e.state     = LibraryEntry::State::Done;
+    return true;
+}
+
+// ── Cache ─────────────────────────────────────────────────────────────────────
+// One tab-separated line per file, path last so it may contain anything but a
+// newline. "# folder <tab> path" remembers the last scanned folder.
+
+static constexpr const char* kCacheHeader = "# jidi library cache v1";
+
+void MidiLibrary::Open(const std::string& path) {
+    std::lock_guard<std::mutex> lk(mtx);
+    cachePath = path;
+    cache.clear();
+    std::ifstream in(path);
+    std::string line;
+    if (!std::getline(in, line) || line != kCacheHeader) return;
+    while (std::getline(in, line)) {
+        if (line.rfind("# folder\t", 0) == 0) { folder = line.substr(9); continue; }
+        LibraryEntry e;
+        unsigned long long bytes, notes;
+        long long mtime;
+        unsigned fmt, tracks, ppq, est;
+        double seconds;
+        int used = 0;
+        if (std::sscanf(line.c_str(), "%lld\t%llu\t%u\t%u\t%u\t%llu\t%lf\t%u%n",
+                        &mtime, &bytes, &fmt, &tracks, &ppq, &notes, &seconds, &est, &used) != 8 ||
+            used <= 0 || (size_t)used + 1 >= line.size() || line[(size_t)used] != '\t')
+            continue;
+        e.path      = line.substr((size_t)used + 1);
+        e.name      = fs::path(e.path).filename().string();
+        e.mtime     = mtime;
+        e.bytes     = bytes;
+        e.format    = (uint16_t)fmt;
+        e.tracks    = (uint16_t)tracks;
+        e.ppq       = (uint16_t)ppq;
+        e.notes     = notes;
+        e.seconds   = seconds;
+        e.estimated = est != 0;
+        e.state     = LibraryEntry::State::Done;
+        cache[e.path] = std::move(e);
+    }
+    std::cout << "+ Library cache: " << cache.size() << " files" << std::endl;
+}
+
+bool MidiLibrary::SaveCache() {
+    if (cachePath.empty()) return false;
+    std::ofstream out(cachePath, std::ios::trunc);
+    if (!out.is_open()) return false;
+    out << kCacheHeader << "\n";
+    if (!folder.empty()) out << "# folder\t" << folder << "\n";
+    char line[160];
+    for (const auto& [path, e] : cache) {
+        std::snprintf(line, sizeof(line), "%lld\t%llu\t%u\t%u\t%u\t%llu\t%.3f\t%u\t",
+                      (long long)e.mtime, (unsigned long long)e.bytes, (unsigned)e.format, (unsigned)e.tracks,
+                      (unsigned)e.ppq, (unsigned long long)e.notes, e.seconds, e.estimated ? 1u : 0u);
+        out << line << path << "\n";
+    }
+    cacheDirty = false;
+    return true;
+}
+
+std::string MidiLibrary::Folder() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return folder;
+}
+
+// ── Scan ──────────────────────────────────────────────────────────────────────
+
+void MidiLibrary::Scan(const std::string& dir, bool recursive) {
+    Cancel();
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        entries.clear();
+        work.clear();
+        seen.clear();
+        folder  = dir;
+        walking = true;
+        recursiveScan = recursive;
+        workersLeft = (int)std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+    }
+    found.store(0); probed.store(0);
+    cancel.store(false);
+    running.store(true, std::memory_order_release);
+    revision.fetch_add(1, std::memory_order_acq_rel);
+    walker = std::thread(&MidiLibrary::Walk, this, dir, recursive);
+    for (int i = 0; i < workersLeft; ++i) probers.emplace_back(&MidiLibrary::ProbeWorker, this);
+}
+
+void MidiLibrary::Cancel() {
+    cancel.store(true);
+    workCv.notify_all();
+    if (walker.joinable()) walker.join();
+    for (auto& t : probers) if (t.joinable()) t.join();
+    probers.clear();
+}
+
+static bool IsMidiExtension(const fs::path& p) {
+    std::string ext = p.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return ext == ".mid" || ext == ".midi";
+}
+
+void MidiLibrary::Walk(std::string dir, bool recursive) {
+    std::error_code ec;
+    const auto opts = fs::directory_options::skip_permission_denied;
+    auto visit = [&](const fs::directory_entry& de) {
+        std::error_code fec;
+        if (!de.is_regular_file(fec) || !IsMidiExtension(de.path())) return;
+        LibraryEntry e;
+        try {
+            e.path = de.path().string();
+            e.name = de.path().filename().string();
+        } catch (const std::exception&) {
+            return;   // not representable in the narrow encoding the loader opens files with
+        }
+        e.bytes = (uint64_t)de.file_size(fec);
+        e.mtime = (int64_t)de.last_write_time(fec).time_since_epoch().count();
+
+        std::lock_guard<std::mutex> lk(mtx);
+        seen.insert(e.path);
+        auto hit = cache.find(e.path);
+        if (hit != cache.end() && hit->second.bytes == e.bytes && hit->second.mtime == e.mtime) {
+            entries.push_back(hit->second);
+            probed.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            entries.push_back(std::move(e));
+            work.push_back(entries.size() - 1);
+            workCv.notify_one();
+        }
+        found.fetch_add(1, std::memory_order_relaxed);
+        revision.fetch_add(1, std::memory_order_release);
+    };
+    if (recursive) {
+        for (fs::recursive_directory_iterator it(fs::path(dir), opts, ec), end; !ec && it != end && !cancel.load(); it.increment(ec))
+            visit(*it);
+    } else {
+        for (fs::directory_iterator it(fs::path(dir), opts, ec), end; !ec && it != end && !cancel.load(); it.increment(ec))
+            visit(*it);
+    }
+    if (ec) std::cout << "[warn] Library scan of " << dir << ": " << ec.message() << std::endl;
+
+    std::lock_guard<std::mutex> lk(mtx);
+    walking = false;
+    workCv.notify_all();
+}
+
+void MidiLibrary::ProbeWorker() {
+    LibraryEntry probe;
+    for (;;) {
+        size_t idx;
+        {
+            std::unique_lock<std::mutex> lk(mtx);
+            workCv.wait(lk, [&] { return cancel.load() || !work.empty() || !walking; });
+            if (cancel.load() || work.empty()) break;
+            idx = work.front();
+            work.pop_front();
+            probe = entries[idx];
+        }
+        ProbeMidiFile(probe.path, probe);
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            entries[idx] = probe;
+            if (probe.state == LibraryEntry::State::Done) { cache[probe.path] = probe; cacheDirty = true; }
+        }
+        probed.fetch_add(1, std::memory_order_relaxed);
+        revision.fetch_add(1, std::memory_order_release);
+    }
+    Finish();
+}
+
+// True when `path` lies inside `dir`, compared on whole components: a scan of
+// "/music" must not claim "/music2/a.mid".
+static bool IsInsideFolder(const std::string& path, const std::string& dir) {
+    if (dir.empty() || path.size() <= dir.size() || path.compare(0, dir.size(), dir) != 0) return false;
+    auto isSep = [](char c) { return c == '/' || c == (char)fs::path::preferred_separator; };
+    return isSep(dir.back()) || isSep(path[dir.size()]);
+}
+
+void MidiLibrary::Finish() {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (--workersLeft > 0) return;
+    // A complete recursive walk knows every file under the folder: forget the ones gone
+    if (!cancel.load() && recursiveScan && !folder.empty()) {
+        const std::string prefix = fs::path(folder).string();
+        for (auto it = cache.begin(); it != cache.end();) {
+            if (IsInsideFolder(it->first, prefix) && !seen.count(it->first)) { it = cache.erase(it); cacheDirty = true; }
+            else ++it;
+        }
+    }
+    if (cacheDirty || !cancel.load()) SaveCache();   // also records the folder
+    running.store(false, std::memory_order_release);
+    revision.fetch_add(1, std::memory_order_release);
+    std::cout << "+ Library: " << entries.size() << " files in " << folder << std::endl;
+}
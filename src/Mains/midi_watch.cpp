@@ -0,0 +1,66 @@
+#include "midi_watch.hpp"
+
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+MidiFileWatch g_MidiWatch;
+
+MidiFileWatch::Stamp MidiFileWatch::StatFile(const std::string& path) {
+    Stamp s;
+    std::error_code ec;
+    s.size = (uint64_t)fs::file_size(path, ec);
+    if (ec) return {};
+    s.mtime = (int64_t)fs::last_write_time(path, ec).time_since_epoch().count();
+    if (ec) return {};
+    s.ok = true;
+    return s;
+}
+
+void MidiFileWatch::Arm(const std::string& path) {
+    Disarm();
+    file     = path;
+    base     = StatFile(path);
+    seen     = base;
+    nextPoll = 0.0;
+}
+
+void MidiFileWatch::Disarm() {
+    if (worker.joinable()) worker.join();
+    preparing = false;
+    ready.store(false, std::memory_order_relaxed);
+    pending = TrackReload{};
+    file.clear();
+}
+
+bool MidiFileWatch::Poll(double now) {
+    if (preparing) {
+        if (!ready.load(std::memory_order_acquire)) return false;
+        worker.join();
+        preparing = false;
+        return true;
+    }
+    if (!enabled || file.empty() || now < nextPoll) return false;
+    nextPoll = now + kPollSec;
+
+    const Stamp s = StatFile(file);
+    const bool settled = (s == seen);
+    seen = s;
+    // Gone (mid-save rename) or unchanged: nothing to do. Changed: wait for a
+    // second poll with the same stamp before reading it.
+    if (!s.ok || s == base || !settled) return false;
+
+    base = s;
+    pending = TrackReload{};
+    ready.store(false, std::memory_order_relaxed);
+    preparing = true;
+    worker = std::thread([this, path = file]() {
+        PrepareTrackReload(path, pending);
+        ready.store(true, std::memory_order_release);
+    });
+    return false;
+}
+
+void MidiFileWatch::Done() {
+    pending = TrackReload{};
+}
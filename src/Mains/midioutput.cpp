@@ -1,8 +1,12 @@
 #include "midioutput.hpp"
 #include "bass_backend.hpp"   
+#include "track_masks.hpp"
+#include "frame_stats.hpp"
+#include "event_splice.hpp"
 
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // ── KDMAPI prototype ──────────────────────────────────────────────────────────
 extern "C" {
@@ -29,17 +33,52 @@ void MidiOutputEngine::BuildTempoIndex() {
 
     for (size_t i = 0; i < eventList->size(); ++i) {
         const auto& ev = (*eventList)[i];
-        if (ev.type != (uint8_t)EventType::TEMPO) continue;
+        if (ev.Type() != EventType::TEMPO) continue;
 
         accumMicros  += (ev.tick - tick) * microsPerTick;
         tick          = ev.tick;
-        rawTempo      = ev.data.tempo;
+        rawTempo      = ev.Tempo();
         microsPerTick = MidiTiming::CalculateMicrosecondsPerTick(rawTempo, currentPpq);
 
         tempoIndex.push_back({ i, tick, accumMicros, rawTempo });
     }
 }
 
+// A watch edit keeps the tempo events; only their indices moved. Each one is
+// found again by a binary search on its tick (tempo sorts first within a
+// tick). Falls back to the scan if the list does not match.
+void MidiOutputEngine::RelocateTempoIndex() {
+    if (!eventList || tempoIndex.empty()) { BuildTempoIndex(); return; }
+    const auto& events = *eventList;
+    for (size_t i = 1; i < tempoIndex.size(); ++i) {
+        TempoSegment& seg = tempoIndex[i];
+        const size_t at = (i > 1 && tempoIndex[i - 1].tick == seg.tick)
+            ? tempoIndex[i - 1].eventIdx + 1
+            : TickLowerBound(events, seg.tick);
+        if (at >= events.size() || events[at].Status() != 0xFF || events[at].tick != seg.tick ||
+            events[at].Tempo() != seg.rawTempo) {
+            BuildTempoIndex();
+            return;
+        }
+        seg.eventIdx = at;
+    }
+}
+
+uint64_t MidiOutputEngine::SongMicros() const {
+    if (!eventList || eventList->empty()) return 0;
+    uint64_t totalMicros = 0;
+    uint32_t lastTick    = 0;
+    double   usPerTick   = MidiTiming::CalculateMicrosecondsPerTick(stream->initialTempo, currentPpq);
+    for (const auto& ev : *eventList) {
+        if (ev.Type() == EventType::TEMPO) {
+            totalMicros += (uint64_t)((ev.tick - lastTick) * usPerTick);
+            lastTick     = ev.tick;
+            usPerTick    = MidiTiming::CalculateMicrosecondsPerTick(ev.Tempo(), currentPpq);
+        }
+    }
+    return totalMicros + (uint64_t)((eventList->back().tick - lastTick) * usPerTick);
+}
+
 void MidiOutputEngine::ToggleAntiSlowdown(bool enabled) {
     antiSlowdownEnabled = enabled;
 }
@@ -52,6 +91,7 @@ bool MidiOutputEngine::IsAntiSlowdownEnabled() const {
 void MidiOutputEngine::SetSimulateEventsPerSecond(int64_t eps) {
     simulateEventsPerSecond.store(eps > 0 ? eps : 0);
     if (eps <= 0) simLagActive.store(false);
+    configEpoch.fetch_add(1, std::memory_order_release);
 }
 
 int64_t MidiOutputEngine::GetSimulateEventsPerSecond() const {
@@ -70,13 +110,35 @@ bool MidiOutputEngine::GetLagSmoothRender() const {
     return simLagSmooth.load();
 }
 
+uint32_t MidiOutputEngine::TakeDispatchLatenessMicros() {
+    return dispatchLateMaxUs.exchange(0, std::memory_order_relaxed);
+}
+
+// ── Burst spreading API ───────────────────────────────────────────────────────
+void MidiOutputEngine::SetBurstSpread(uint32_t windowMicros, uint32_t minEvents) {
+    burstWindowUs.store(std::min(windowMicros, BurstSpreader::kMaxWindowMicros));
+    burstMinEvents.store(std::max(minEvents, 1u));
+}
+
+uint32_t MidiOutputEngine::GetBurstSpreadMicros() const {
+    return burstWindowUs.load();
+}
+
+uint32_t MidiOutputEngine::GetBurstSpreadMinEvents() const {
+    return burstMinEvents.load();
+}
+
 MidiOutputEngine::~MidiOutputEngine() {
     Stop();
 }
 
-void MidiOutputEngine::Start(const std::vector<MidiEvent>& events, int ppq, uint32_t initialTempo) {
+void MidiOutputEngine::Start(std::shared_ptr<const FilteredStream> compiled) {
     Stop();
-    eventList = &events;
+    stream    = std::move(compiled);
+    eventList = &stream->Events();
+    const auto&    events       = *eventList;
+    const int      ppq          = stream->ppq;
+    const uint32_t initialTempo = stream->initialTempo;
     currentPpq = ppq;
     currentTempo = initialTempo;
     microsecondsPerTick = MidiTiming::CalculateMicrosecondsPerTick(currentTempo, ppq);
@@ -95,27 +157,10 @@ void MidiOutputEngine::Start(const std::vector<MidiEvent>& events, int ppq, uint
 
     BuildTempoIndex();
 
-    // Compute total song duration from the tempo index + remaining ticks.
     if (g_BassEngine.IsInitialized() &&
         g_BassEngine.GetActiveMode() == AudioMode::BassMIDI_PreRender &&
         !events.empty())
-    {
-        uint64_t totalMicros = 0;
-        {
-            uint32_t lastTick = 0;
-            double   usPerTick = MidiTiming::CalculateMicrosecondsPerTick(initialTempo, ppq);
-            for (const auto& ev : events) {
-                if (ev.type == (uint8_t)EventType::TEMPO) {
-                    totalMicros += (uint64_t)((ev.tick - lastTick) * usPerTick);
-                    lastTick     = ev.tick;
-                    usPerTick    = MidiTiming::CalculateMicrosecondsPerTick(ev.data.tempo, ppq);
-                }
-            }
-            totalMicros += (uint64_t)((events.back().tick - lastTick) * usPerTick);
-        }
-        g_BassEngine.StartPreRender(events.data(), events.size(),
-                                    ppq, initialTempo, totalMicros);
-    }
+        g_BassEngine.StartPreRender(stream, SongMicros());
 
     isPlaying = true;
     threadRunning = true;
@@ -123,6 +168,61 @@ void MidiOutputEngine::Start(const std::vector<MidiEvent>& events, int ppq, uint
     workerThread = std::thread(&MidiOutputEngine::PlaybackThread, this);
 }
 
+// The worker is parked for the swap so it never reads from a list that is
+// being released; Seek(0) then re-locates eventPos in the new list at the
+// paused position.
+void MidiOutputEngine::Rebind(std::shared_ptr<const FilteredStream> compiled) {
+    if (!compiled || (compiled == stream && !held)) return;
+    if (!isPlaying) { stream = std::move(compiled); eventList = &stream->Events(); return; }
+
+    const bool wasPaused = held ? heldPaused : isPaused.load();
+    if (!held) {
+        Pause();
+        threadRunning = false;
+        if (workerThread.joinable()) workerThread.join();
+    }
+
+    // Notes whose note-off was just filtered out must not hang
+    SilenceAllChannelsWithoutCC();
+    stream    = std::move(compiled);
+    eventList = &stream->Events();
+    if (held) RelocateTempoIndex();
+    else      BuildTempoIndex();
+
+    if (g_BassEngine.IsInitialized() &&
+        g_BassEngine.GetActiveMode() == AudioMode::BassMIDI_PreRender) {
+        // A held decode was cancelled: start over (Seek(0) below moves it to
+        // the position); otherwise the running one rebuilds at the position
+        if (held) g_BassEngine.StartPreRender(stream, SongMicros());
+        else      g_BassEngine.SetPreRenderStream(stream);
+    }
+    held = false;
+
+    Seek(0);
+
+    threadRunning = true;
+    workerThread = std::thread(&MidiOutputEngine::PlaybackThread, this);
+    if (!wasPaused) Resume();
+}
+
+// Unlike Rebind()'s own park, the pre-render decoder is stopped too: with a
+// pass-through stream it reads the very list the caller is about to edit.
+void MidiOutputEngine::Hold() {
+    if (!isPlaying || held) return;
+    heldPaused = isPaused.load();
+    Pause();
+    threadRunning = false;
+    if (workerThread.joinable()) workerThread.join();
+    if (g_BassEngine.IsInitialized() &&
+        g_BassEngine.GetActiveMode() == AudioMode::BassMIDI_PreRender)
+        g_BassEngine.CancelPreRender();
+    held = true;
+}
+
+uint64_t MidiOutputEngine::GetStreamGeneration() const {
+    return stream ? stream->generation : 0;
+}
+
 void MidiOutputEngine::Stop() {
     if (threadRunning) {
         threadRunning = false;
@@ -132,6 +232,7 @@ void MidiOutputEngine::Stop() {
     }
     SilenceAllChannels();
     isPlaying = false;
+    held      = false;
 
     // Mirror stop to BassMIDI if active
     if (g_BassEngine.IsInitialized() &&
@@ -139,12 +240,17 @@ void MidiOutputEngine::Stop() {
         g_BassEngine.Stop();
 }
 
+// Returns once the worker is out of its dispatch step, so callers (Seek in
+// particular) own the clock state and eventPos afterwards. Never called from
+// PlaybackThread.
 void MidiOutputEngine::Pause() {
     if (!isPaused && isPlaying) {
         auto now = std::chrono::steady_clock::now();
         uint64_t elapsedRealMicros = std::chrono::duration_cast<std::chrono::microseconds>(now - playbackStartTime).count();
         pauseVirtualMicros = (uint64_t)(elapsedRealMicros * playbackSpeed.load());
         isPaused = true;
+        // Pairs with EnterDispatch(): the batch sees isPaused within kPublishStride events
+        while (dispatching.load()) std::this_thread::yield();
         SilenceAllChannelsWithoutCC();
 
         if (g_BassEngine.IsInitialized() &&
@@ -200,6 +306,7 @@ void MidiOutputEngine::SetSpeed(float newSpeed) {
 
 void MidiOutputEngine::SetLooping(bool loop) {
     isLooping = loop;
+    configEpoch.fetch_add(1, std::memory_order_release);
 }
 
 // ── Loop A/B Points ───────────────────────────────────────────────────────────
@@ -207,12 +314,14 @@ void MidiOutputEngine::SetLoopPoints(uint64_t startTick, uint64_t endTick) {
     loopStartTick.store(startTick);
     loopEndTick.store(endTick);
     hasLoopPoints.store(true);
+    configEpoch.fetch_add(1, std::memory_order_release);
 }
 
 void MidiOutputEngine::ClearLoopPoints() {
     hasLoopPoints.store(false);
     loopStartTick.store(0);
     loopEndTick.store(UINT64_MAX);
+    configEpoch.fetch_add(1, std::memory_order_release);
 }
 
 bool     MidiOutputEngine::HasLoopPoints()    const { return hasLoopPoints.load(); }
@@ -238,6 +347,7 @@ uint64_t MidiOutputEngine::TickToMicros(uint64_t targetTick) const {
 // Called from PlaybackThread only — do NOT call from outside the worker thread.
 void MidiOutputEngine::LoopBackToTick(uint64_t loopStart) {
     SilenceAllChannels();
+    ClearMutedOns();
 
     // Binary-search tempoIndex for the segment that contains loopStart
     size_t segIdx = 0;
@@ -264,8 +374,8 @@ void MidiOutputEngine::LoopBackToTick(uint64_t loopStart) {
         if ((uint64_t)ev.tick >= loopStart) break;
         scanAccum = (uint64_t)(seg.accumMicros + (double)(ev.tick - seg.tick) * tempMPT);
         newLTick  = ev.tick;
-        if (ev.type == (uint8_t)EventType::TEMPO) {
-            tempTempo = ev.data.tempo;
+        if (ev.Type() == EventType::TEMPO) {
+            tempTempo = ev.Tempo();
             tempMPT   = MidiTiming::CalculateMicrosecondsPerTick(tempTempo, currentPpq);
         }
         newEP++;
@@ -315,9 +425,11 @@ bool MidiOutputEngine::IsPaused() const {
 }
 
 void MidiOutputEngine::Seek(int64_t microsecondOffset) {
+    g_FrameStats.Mark(FrameEvent::Seek);
     bool wasPlaying = !isPaused.load();
     Pause(); 
     SilenceAllChannelsWithoutCC();
+    mutedOnsReset.store(true, std::memory_order_release);   // their offs may never come now
     
     int64_t targetMicros = (int64_t)pauseVirtualMicros + microsecondOffset;
     if (targetMicros < 0) targetMicros = 0;
@@ -339,22 +451,22 @@ void MidiOutputEngine::Seek(int64_t microsecondOffset) {
     uint64_t scanAccumulatedMicros = (uint64_t)seg.accumMicros;
     uint32_t tempTempo             = seg.rawTempo;
     double   tempMicrosPerTick     = MidiTiming::CalculateMicrosecondsPerTick(tempTempo, currentPpq);
-    eventPos          = seg.eventIdx;
-    lastProcessedTick = seg.tick;
-
-    while (eventPos < eventList->size()) {
-        const auto& event = (*eventList)[eventPos];
-        uint64_t eventScheduledTime = scanAccumulatedMicros +
-            (uint64_t)((event.tick - lastProcessedTick) * tempMicrosPerTick);
-        if (eventScheduledTime > (uint64_t)targetMicros) break;
-        scanAccumulatedMicros = eventScheduledTime;
-        lastProcessedTick     = event.tick;
-        if (event.type == (uint8_t)EventType::TEMPO) {
-            tempTempo         = event.data.tempo;
-            tempMicrosPerTick = MidiTiming::CalculateMicrosecondsPerTick(tempTempo, currentPpq);
-        }
-        eventPos++;
+    // One tempo up to the next segment, so an event's time follows from its
+    // tick: binary search there instead of walking. eventPos is published once.
+    const std::vector<MidiEvent>& events = *eventList;
+    const size_t segEnd = (segIdx + 1 < tempoIndex.size()) ? tempoIndex[segIdx + 1].eventIdx : events.size();
+    auto timeOf = [&](const MidiEvent& e) {
+        return (uint64_t)seg.accumMicros + (uint64_t)((e.tick - seg.tick) * tempMicrosPerTick);
+    };
+    const size_t pos = (size_t)(std::partition_point(events.begin() + (ptrdiff_t)seg.eventIdx, events.begin() + (ptrdiff_t)segEnd,
+        [&](const MidiEvent& e) { return timeOf(e) <= (uint64_t)targetMicros; }) - events.begin());
+    uint32_t lastTick = seg.tick;
+    if (pos > seg.eventIdx) {
+        lastTick              = events[pos - 1].tick;
+        scanAccumulatedMicros = timeOf(events[pos - 1]);
     }
+    eventPos          = pos;
+    lastProcessedTick = lastTick;
     
     currentTempo        = tempTempo;
     microsecondsPerTick = tempMicrosPerTick;
@@ -388,12 +500,185 @@ void MidiOutputEngine::SeekAbsolute(uint64_t targetMicros) {
     if (wasPlaying) Resume();
 }
 
+// ── Specialised dispatch loops ────────────────────────────────────────────────
+// One DispatchBatch instantiation per (loop gate, lag simulator, mutes, sink)
+// combination; the table index packs the three flags in bits 0-2 and the sink
+// above them. PlaybackThread picks an entry once per batch.
+template <size_t... I>
+constexpr std::array<MidiOutputEngine::BatchFn, sizeof...(I)> MidiOutputEngine::MakeBatchTable(std::index_sequence<I...>) {
+    return { &MidiOutputEngine::DispatchBatch<(I & 1) != 0, (I & 2) != 0, (I & 4) != 0, (DispatchSink)(I >> 3)>... };
+}
+
+// Re-reads the user-controlled settings the per-event loop used to load on
+// every event. Cheap checks run each batch; the snapshot is rebuilt only when
+// the engine epoch, the mute epoch, the sink or the BASS mode moved.
+void MidiOutputEngine::RefreshDispatchConfig() {
+    static constexpr auto kBatchTable = MakeBatchTable(std::make_index_sequence<(size_t)DispatchSink::Count << 3>{});
+
+    const uint32_t     epoch   = configEpoch.load(std::memory_order_acquire);
+    const uint64_t     audible = g_TrackMasks.AudibleEpoch();
+    const DispatchSink sink    = CurrentDispatchSink();
+    const bool bassActive = g_BassEngine.IsInitialized() && g_BassEngine.GetActiveMode() != AudioMode::KDMAPI;
+    if (batchFn && epoch == dispatchCfg.epoch && audible == dispatchCfg.audibleEpoch &&
+        sink == dispatchCfg.sink && bassActive == dispatchCfg.bassActive)
+        return;
+
+    DispatchConfig c;
+    c.epoch        = epoch;
+    c.audibleEpoch = audible;
+    c.sink         = sink;
+    c.bassActive   = bassActive;
+    c.loopGate     = hasLoopPoints.load() && isLooping.load();
+    c.loopEnd      = loopEndTick.load();
+    c.lagSim       = simulateEventsPerSecond.load() > 0 && !bassActive;
+    c.mutes        = g_TrackMasks.AnyMuted();
+    dispatchCfg = c;
+    batchFn = kBatchTable[(c.loopGate ? 1u : 0u) | (c.lagSim ? 2u : 0u) | (c.mutes ? 4u : 0u) | ((size_t)sink << 3)];
+}
+
+// Dispatches every event that is due. The clock state lives in locals and is
+// published, together with eventPos, every kPublishStride events and at the
+// end. Pause / Stop are checked by EnterDispatch() before the batch and then
+// only at each publish, so Pause() waits at most kPublishStride events. The
+// batch never races a Seek: Seek pauses first, and Pause() waits for the
+// batch to return.
+template <bool LoopGate, bool LagSim, bool Mutes, DispatchSink Sink>
+void MidiOutputEngine::DispatchBatch(BatchState& b) {
+    const std::vector<MidiEvent>& events = *eventList;
+    const size_t   count   = events.size();
+    const uint64_t loopEnd = dispatchCfg.loopEnd;
+    const double   now     = (double)b.nowVirtual;
+
+    size_t   pos       = eventPos.load(std::memory_order_relaxed);
+    size_t   published = pos;
+    double   accum     = accumulatedMicroseconds;
+    uint32_t lastTick  = lastProcessedTick;
+    double   mpt       = microsecondsPerTick;
+    uint32_t tempo     = currentTempo.load(std::memory_order_relaxed);
+    uint32_t processed = 0;
+    bool     lagged    = false;
+
+    auto publish = [&]() {
+        if (pos == published) return;
+        published               = pos;
+        accumulatedMicroseconds = accum;
+        lastProcessedTick       = lastTick;
+        microsecondsPerTick     = mpt;
+        currentTempo.store(tempo, std::memory_order_relaxed);
+        eventPos.store(pos, std::memory_order_release);
+    };
+
+    while (pos < count) {
+        const MidiEvent& event = events[pos];
+
+        // ── A/B loop end gate: stop processing events at or past loopEndTick ──
+        if constexpr (LoopGate) {
+            if ((uint64_t)event.tick >= loopEnd) break;
+        }
+
+        const double scheduledTime = accum + (event.tick - lastTick) * mpt;
+        // A dense same-tick run is held back slot by slot; the song clock
+        // below still advances to the unshifted time
+        double gateTime = scheduledTime;
+        if (b.burstWindow > 0.0)
+            gateTime += burstSpread.Offset(events, pos, b.burstWindow, b.burstMin, [](const MidiEvent& e) { return e.tick; });
+        if (gateTime > now) {
+            b.waitMicros = gateTime - now;
+            break;
+        }
+
+        // ── Lag Simulator gate ────────────────────────────────────────────
+        if constexpr (LagSim) {
+            if (simTokens < 1.0) { lagged = true; break; }
+            simTokens -= 1.0;
+        }
+
+        b.lateMicros = std::max(b.lateMicros, now - gateTime);
+        accum    = scheduledTime;
+        lastTick = event.tick;
+
+        // The status nibble is the type for channel messages, and the low
+        // three bytes of the word are already the wire message
+        switch (event.Status() >> 4) {
+            case 0x9:
+                if (event.D2() > 0) {
+                    // Muted track / channel: one bit test; the off follows the on
+                    if constexpr (Mutes) {
+                        if (!g_TrackMasks.NoteAudible(event.Track(), event.Channel())) {
+                            HoldMutedOn(event);
+                            break;
+                        }
+                    }
+                    DispatchMidiOutTo<Sink>(event.ShortMsg(), event.Track());
+                    activeNotes[event.Channel()][event.D1()] = true;
+                    break;
+                }
+                [[fallthrough]];   // velocity 0 is a note-off
+            case 0x8:
+                // Every off whose on was sent goes out unaltered, for OmniMIDI reference counting
+                if (mutedOnsHeld && TakeMutedOn(event)) break;
+                DispatchMidiOutTo<Sink>(event.ShortMsg(), event.Track());
+                activeNotes[event.Channel()][event.D1()] = false;
+                break;
+            case 0xA:   // poly pressure
+            case 0xB:   // CC
+            case 0xC:   // program change
+            case 0xE:   // pitch bend
+                DispatchMidiOutTo<Sink>(event.ShortMsg(), event.Track());
+                break;
+            case 0xF:
+                if (event.Status() == 0xFF) {
+                    tempo = event.Tempo();
+                    mpt   = MidiTiming::CalculateMicrosecondsPerTick(tempo, currentPpq);
+                } else {
+                    const auto msg = GetSysExArena().Get(event.SysExEntry());
+                    DispatchMidiLongOutTo<Sink>(msg.data, msg.size);
+                }
+                break;
+            default:
+                break;   // channel pressure is not played back
+        }
+        ++pos;
+
+        if ((++processed & (kPublishStride - 1)) == 0) {
+            publish();
+            if ((processed & 4095) == 0) currentVisualizerTick = lastTick;
+            if (isPaused.load(std::memory_order_relaxed) || !threadRunning.load(std::memory_order_relaxed)) break;
+        }
+    }
+
+    publish();
+    if constexpr (LagSim) simLagActive.store(lagged, std::memory_order_relaxed);
+}
+
+void MidiOutputEngine::ClearMutedOns() {
+    mutedOnsReset.store(false, std::memory_order_relaxed);
+    if (!mutedOnsHeld) return;
+    std::fill(mutedOns.begin(), mutedOns.end(), (uint16_t)0);
+    mutedOnsHeld = 0;
+}
+
+// Marks the worker busy with playback state, unless a Pause / Stop already
+// landed. Pause() sets isPaused then waits for `dispatching` to clear; here
+// the order is reversed, so one of the two always sees the other.
+bool MidiOutputEngine::EnterDispatch() {
+    dispatching.store(true);
+    if (isPaused.load() || !threadRunning.load()) { dispatching.store(false); return false; }
+    return true;
+}
+
 void MidiOutputEngine::PlaybackThread() {
+    burstSpread.Invalidate();   // Start / Rebind hand the thread a new list
+    batchFn = nullptr;
+    ClearMutedOns();
     while (threadRunning) {
         if (isPaused || isFinished) {
             std::this_thread::sleep_for(std::chrono::milliseconds(10));
             continue;
         }
+        if (mutedOnsReset.load(std::memory_order_acquire)) ClearMutedOns();
+        RefreshDispatchConfig();
+        const DispatchConfig& cfg = dispatchCfg;
 
         auto now = std::chrono::steady_clock::now();
         uint64_t elapsedRealMicros = std::chrono::duration_cast<std::chrono::microseconds>(now - playbackStartTime).count();
@@ -401,18 +686,17 @@ void MidiOutputEngine::PlaybackThread() {
         
 		double microsSinceLastEvent = ((double)elapsedVirtualMicros > accumulatedMicroseconds)
 			? (double)elapsedVirtualMicros - accumulatedMicroseconds : 0.0;
-		double effectiveMicrosPerTick = microsecondsPerTick;
 		const int64_t eps = simulateEventsPerSecond.load();
 		if (eps > 0 && simLagActive.load() && !simLagSmooth.load()) {
 			microsSinceLastEvent = 0.0; 
 		}
 		
-        if (effectiveMicrosPerTick > 0.0) {
-            uint64_t rawVizTick = lastProcessedTick + (uint64_t)(microsSinceLastEvent / effectiveMicrosPerTick);
+        if (microsecondsPerTick > 0.0) {
+            uint64_t rawVizTick = lastProcessedTick + (uint64_t)(microsSinceLastEvent / microsecondsPerTick);
             // Cap at B so the visualiser never shows ticks past the loop-end point
             // and so the realtime-tick check below cannot falsely trigger early loop-back.
-            if (hasLoopPoints.load() && isLooping.load())
-                currentVisualizerTick = std::min(rawVizTick, loopEndTick.load());
+            if (cfg.loopGate)
+                currentVisualizerTick = std::min(rawVizTick, cfg.loopEnd);
             else
                 currentVisualizerTick = rawVizTick;
         }
@@ -426,71 +710,29 @@ void MidiOutputEngine::PlaybackThread() {
             simTokens = std::min(simTokens + dt * (double)eps, burstCap);
         }
 
-        int processedInBatch = 0;
-
-        while (eventPos < eventList->size() && threadRunning && !isPaused) {
-            const auto& event = (*eventList)[eventPos];
-
-            // ── A/B loop end gate: stop processing events at or past loopEndTick ──
-            if (hasLoopPoints.load() && isLooping.load()) {
-                if ((uint64_t)event.tick >= loopEndTick.load()) break;
-            }
-
-            double scheduledTime = accumulatedMicroseconds + (event.tick - lastProcessedTick) * effectiveMicrosPerTick;    
-            if (scheduledTime > (double)elapsedVirtualMicros) {
-                double waitTimeMicros = scheduledTime - (double)elapsedVirtualMicros;
-                if (waitTimeMicros > 2000.0) {
-                    uint64_t sleepTime = (uint64_t)(waitTimeMicros - 1500.0);
-                    if (sleepTime > 2000) sleepTime = 2000; 
-                    std::this_thread::sleep_for(std::chrono::microseconds(sleepTime));
-                }
-                break; 
-            }
+        // Burst window in virtual µs, so it stays the same length in real time at any speed
+        BatchState batch;
+        batch.nowVirtual  = elapsedVirtualMicros;
+        batch.burstWindow = (double)burstWindowUs.load(std::memory_order_relaxed) * (double)playbackSpeed.load();
+        batch.burstMin    = burstMinEvents.load(std::memory_order_relaxed);
+        if (!EnterDispatch()) continue;
+        (this->*batchFn)(batch);
+        dispatching.store(false);
+
+        if (batch.waitMicros > 2000.0) {
+            uint64_t sleepTime = (uint64_t)(batch.waitMicros - 1500.0);
+            if (sleepTime > 2000) sleepTime = 2000; 
+            std::this_thread::sleep_for(std::chrono::microseconds(sleepTime));
+        }
 
-            // ── Lag Simulator gate ────────────────────────────────────────────
-            const bool bassActive = g_BassEngine.IsInitialized() &&
-                                    g_BassEngine.GetActiveMode() != AudioMode::KDMAPI;
-            if (eps > 0 && !bassActive) {
-                if (simTokens < 1.0) {
-                    simLagActive.store(true);
-                    break;
-                }
-                simTokens -= 1.0;
-                simLagActive.store(false);
-            }
-			
-            accumulatedMicroseconds = scheduledTime;
-            lastProcessedTick = event.tick;
-            processedInBatch++;
-            
-            if (processedInBatch % 4096 == 0) {
-                currentVisualizerTick = event.tick;
-            }
-            
-            if (event.type == (uint8_t)EventType::TEMPO) {
-                currentTempo = event.data.tempo;
-                microsecondsPerTick = MidiTiming::CalculateMicrosecondsPerTick(currentTempo, currentPpq);
-                effectiveMicrosPerTick = microsecondsPerTick;
-            } else if (event.type == (uint8_t)EventType::NOTE_OFF) {
-                // Completely pure, unaltered Note-Off stream for OmniMIDI reference counting!
-				DispatchMidiOut((0x80 | event.channel) | (event.data.note.n << 8) | (event.data.note.v << 16));
-				activeNotes[event.channel][event.data.note.n] = false;
-			} else if (event.type == (uint8_t)EventType::NOTE_ON) {
-				uint8_t ch = event.channel, n = event.data.note.n, v = event.data.note.v;
-                // Completely pure, unaltered Note-On stream!
-                DispatchMidiOut((0x90 | ch) | (n << 8) | (v << 16));
-                activeNotes[ch][n] = (v > 0);
-			} else if (event.type == (uint8_t)EventType::CC) {
-                DispatchMidiOut((0xB0 | event.channel) | (event.data.cc.c << 8) | (event.data.cc.v << 16));
-            } else if (event.type == (uint8_t)EventType::PITCH_BEND) {
-                DispatchMidiOut((0xE0 | event.channel) | (event.data.raw.l1 << 8) | (event.data.raw.m2 << 16));
-            } else if (event.type == (uint8_t)EventType::PROGRAM_CHANGE) {
-                DispatchMidiOut((0xC0 | event.channel) | (event.data.val << 8));
-            }
-            eventPos++;
+        if (batch.lateMicros > 0.0) {
+            const float speed = std::max(playbackSpeed.load(), 0.01f);
+            const uint32_t late = (uint32_t)std::min(batch.lateMicros / (double)speed, 4.0e9);
+            uint32_t seen = dispatchLateMaxUs.load(std::memory_order_relaxed);
+            while (late > seen && !dispatchLateMaxUs.compare_exchange_weak(seen, late, std::memory_order_relaxed)) {}
         }
 
-        if (eps > 0 && simLagActive.load()) {
+        if (cfg.lagSim && simLagActive.load()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
 
@@ -500,8 +742,8 @@ void MidiOutputEngine::PlaybackThread() {
         //   (b) the virtual clock has actually reached B's scheduled microsecond position.
         // Without (b), the last events near B would already be sent but the loop-back
         // would happen before their scheduled time, causing audible gaps or jumps.
-        if (hasLoopPoints.load() && isLooping.load() && threadRunning && !isPaused) {
-            uint64_t loopEnd = loopEndTick.load();
+        if (cfg.loopGate && threadRunning && !isPaused) {
+            uint64_t loopEnd = cfg.loopEnd;
 
             // Condition (a): the next event to process is at or past B (or song ended)
             bool nextPastB = (eventPos >= eventList->size()) ||
@@ -511,11 +753,14 @@ void MidiOutputEngine::PlaybackThread() {
                 // Condition (b): compute virtual micros at exactly tick B
                 // accumulatedMicroseconds + delta_ticks * mpt  (using current tempo)
                 double loopEndMicros = accumulatedMicroseconds +
-                    (double)((int64_t)loopEnd - (int64_t)lastProcessedTick) * effectiveMicrosPerTick;
+                    (double)((int64_t)loopEnd - (int64_t)lastProcessedTick) * microsecondsPerTick;
 
                 if ((double)elapsedVirtualMicros >= loopEndMicros) {
                     // Virtual clock has reached B — loop back to A now
-                    LoopBackToTick(loopStartTick.load());
+                    if (EnterDispatch()) {
+                        LoopBackToTick(loopStartTick.load());
+                        dispatching.store(false);
+                    }
                     continue;
                 }
 
@@ -530,8 +775,7 @@ void MidiOutputEngine::PlaybackThread() {
                 }
             }
         }
-
-        if (eventPos >= eventList->size()) {
+        if (eventPos >= eventList->size() && EnterDispatch()) {
             if (isLooping.load()) {
                 if (hasLoopPoints.load()) {
                     // A/B loop: seek back to A point
@@ -540,14 +784,15 @@ void MidiOutputEngine::PlaybackThread() {
                 } else {
                     // Full-song loop (original behaviour: restart from tick 0)
                     SilenceAllChannels();
+                    ClearMutedOns();
                     accumulatedMicroseconds = 0.0;
                     lastProcessedTick = 0;
                     currentVisualizerTick = 0;
                     eventPos = 0;
 
                     uint32_t tempTempo = MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
-                    if (!eventList->empty() && (*eventList)[0].type == (uint8_t)EventType::TEMPO)
-                        tempTempo = (*eventList)[0].data.tempo;
+                    if (!eventList->empty() && (*eventList)[0].Type() == EventType::TEMPO)
+                        tempTempo = (*eventList)[0].Tempo();
                     currentTempo = tempTempo;
                     microsecondsPerTick = MidiTiming::CalculateMicrosecondsPerTick(currentTempo, currentPpq);
 
@@ -565,6 +810,7 @@ void MidiOutputEngine::PlaybackThread() {
             } else {
                 isFinished = true;
             }
+            dispatching.store(false);
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "minimap.hpp"
+#include "frame_stats.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+static constexpr uint32_t kMinimapBackground = 0xC8141414u;   // RGBA8 {20,20,20,200}
+
+static inline uint32_t PackRGBA8(Color c) {
+    return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | (0xFFu << 24);
+}
+
+void SongMinimap::BuildAsync(const std::vector<OptimizedTrackData>& tracks, TrackColorFn color,
+                             TickToSeconds toSeconds, double durationSec)
+{
+    Join();
+    if (tracks.empty() || durationSec <= 0.0) return;
+
+    // Snapshot the palette on the calling thread — the colour table may be
+    // edited again while the workers run.
+    const size_t trackCount = std::min(tracks.size(), (size_t)65536);
+    std::vector<uint32_t> palette(trackCount * 16);
+    for (size_t t = 0; t < trackCount; ++t)
+        for (int ch = 0; ch < 16; ++ch)
+            palette[t * 16 + ch] = PackRGBA8(color((int)t, ch));
+
+    const uint64_t gen = generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    cancel.store(false, std::memory_order_release);
+    building.store(true, std::memory_order_release);
+    builder = std::thread(&SongMinimap::BuildWorker, this, gen, &tracks,
+                          std::move(palette), toSeconds, durationSec);
+}
+
+void SongMinimap::Join() {
+    cancel.store(true, std::memory_order_release);
+    if (builder.joinable()) builder.join();
+    building.store(false, std::memory_order_release);
+}
+
+void SongMinimap::Cancel() {
+    Join();
+}
+
+void SongMinimap::Reset() {
+    Join();
+    {
+        std::lock_guard<std::mutex> lk(resultMutex);
+        result.clear(); result.shrink_to_fit();
+        resultGen = 0;
+    }
+    if (tex.id != 0) { UnloadTexture(tex); tex = { 0 }; }
+}
+
+void SongMinimap::BuildWorker(uint64_t gen, const std::vector<OptimizedTrackData>* tracks,
+                              std::vector<uint32_t> palette, TickToSeconds toSeconds, double durationSec)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    const size_t trackCount = palette.size() / 16;
+    const size_t planeSize  = (size_t)kWidth * kHeight;
+    const double xPerSec    = (double)kWidth / durationSec;
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned workers = (unsigned)std::min<size_t>(hw, std::max<size_t>(1, trackCount));
+
+    // Private ident plane per worker: 0 = empty, else (track << 4 | channel) + 1
+    std::vector<std::vector<uint32_t>> planes(workers, std::vector<uint32_t>(planeSize, 0u));
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w]() {
+            uint32_t* plane = planes[w].data();
+            // Strided track assignment keeps the busy low-numbered tracks spread out
+            for (size_t t = w; t < trackCount; t += workers) {
+                if (cancel.load(std::memory_order_relaxed)) return;
+                for (const NoteEvent& n : (*tracks)[t].notes) {
+                    const int x0 = std::clamp((int)(toSeconds(n.startTick) * xPerSec), 0, kWidth - 1);
+                    const int x1 = std::clamp((int)(toSeconds(n.endTick)   * xPerSec), x0, kWidth - 1);
+                    const uint32_t ident = (((uint32_t)t << 4) | (n.channel & 15u)) + 1u;
+                    uint32_t* row = plane + (size_t)(kHeight - 1 - (n.note & 127)) * kWidth;
+                    for (int x = x0; x <= x1; ++x)
+                        if (row[x] < ident) row[x] = ident;
+                }
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    if (cancel.load(std::memory_order_acquire)) { building.store(false, std::memory_order_release); return; }
+
+    // Merge (top track wins) and resolve colours
+    std::vector<uint32_t> image(planeSize);
+    for (size_t i = 0; i < planeSize; ++i) {
+        uint32_t ident = 0;
+        for (unsigned w = 0; w < workers; ++w) ident = std::max(ident, planes[w][i]);
+        image[i] = ident ? palette[ident - 1] : kMinimapBackground;
+    }
+
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    {
+        std::lock_guard<std::mutex> lk(resultMutex);
+        if (gen == generation.load(std::memory_order_acquire)) {
+            result    = std::move(image);
+            resultGen = gen;
+            resultMs  = ms;
+        }
+    }
+    building.store(false, std::memory_order_release);
+}
+
+void SongMinimap::Poll() {
+    std::vector<uint32_t> pixels;
+    {
+        std::lock_guard<std::mutex> lk(resultMutex);
+        if (resultGen == 0) return;
+        pixels.swap(result);
+        resultGen = 0;
+        buildMs   = resultMs;
+    }
+    if (builder.joinable() && !IsBuilding()) builder.join();
+
+    if (tex.id == 0) {
+        Image img = {};
+        img.data    = pixels.data();
+        img.width   = kWidth;
+        img.height  = kHeight;
+        img.mipmaps = 1;
+        img.format  = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+        tex = LoadTextureFromImage(img);
+        SetTextureFilter(tex, TEXTURE_FILTER_BILINEAR);
+    } else {
+        UpdateTexture(tex, pixels.data());
+    }
+    g_FrameStats.Mark(FrameEvent::MinimapUpload);
+    std::cout << "+ Minimap built in " << buildMs << " ms" << std::endl;
+}
+
+void SongMinimap::Draw(Rectangle dst, float fraction) const {
+    if (tex.id == 0) return;
+    DrawTexturePro(tex, { 0.f, 0.f, (float)kWidth, (float)kHeight }, dst, { 0.f, 0.f }, 0.f, WHITE);
+    DrawRectangleLinesEx(dst, 1.f, Color{ 128,128,128,160 });
+    const float px = dst.x + dst.width * std::clamp(fraction, 0.f, 1.f);
+    DrawLineEx({ px, dst.y }, { px, dst.y + dst.height }, 2.f, RED);
+}
+
+float SongMinimap::HitTest(Rectangle dst, Vector2 point) {
+    if (!CheckCollisionPointRec(point, dst) || dst.width <= 0.f) return -1.f;
+    return std::clamp((point.x - dst.x) / dst.width, 0.f, 1.f);
+}
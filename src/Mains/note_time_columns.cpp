@@ -0,0 +1,103 @@
+#include "note_time_columns.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+static inline uint64_t UnitsInSeg(const TempoSeg& s, uint64_t tick) {
+    const double sec = s.accumSec + (double)(tick - s.tick) * s.usPerTick / 1000000.0;
+    return (uint64_t)std::llround(sec * NoteTimeColumns::kUnitsPerSecond);
+}
+
+static inline uint32_t ClampUnits(uint64_t u) {
+    return (uint32_t)std::min<uint64_t>(u, UINT32_MAX);
+}
+
+void NoteTimeColumns::Build(const std::vector<OptimizedTrackData>& tracks, const std::vector<TempoSeg>& tempo) {
+    const auto t0 = std::chrono::steady_clock::now();
+    Clear();
+    if (tempo.empty() || tempo.front().tick != 0) return;   // BuildTempoSegs always starts at tick 0
+    source = &tracks;
+    segs   = tempo;
+    starts.assign(tracks.size(), {});
+    ends.assign(tracks.size(), {});
+
+    const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned workers = (unsigned)std::min<size_t>(hw, std::max<size_t>(1, tracks.size()));
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (unsigned w = 0; w < workers; ++w) {
+        pool.emplace_back([&, w]() {
+            for (size_t t = w; t < tracks.size(); t += workers) FillTrack(tracks[t].notes, t);
+        });
+    }
+    for (auto& th : pool) th.join();
+
+    size_t total = 0;
+    for (const auto& s : starts) total += s.size();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "+ Note time columns: " << total << " notes, " << segs.size() << " tempo segs, "
+              << workers << " workers, " << ms << " ms" << std::endl;
+}
+
+void NoteTimeColumns::FillTrack(const NoteList& notes, size_t t) {
+    auto& s = starts[t];
+    auto& e = ends[t];
+    s.resize(notes.size());
+    e.resize(notes.size());
+    size_t cur = 0;   // tempo cursor: starts are sorted, so it only moves forward
+    for (size_t i = 0; i < notes.size(); ++i) {
+        const NoteEvent& n = notes[i];
+        while (cur + 1 < segs.size() && segs[cur + 1].tick <= n.startTick) ++cur;
+        const uint32_t endTick = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
+        // The end is at or after the start's segment; search only from there
+        const size_t eseg = (size_t)(std::upper_bound(segs.begin() + (ptrdiff_t)cur, segs.end(), endTick,
+            [](uint32_t v, const TempoSeg& sg) { return v < sg.tick; }) - segs.begin()) - 1;
+        const uint32_t su = ClampUnits(UnitsInSeg(segs[cur], n.startTick));
+        const uint32_t eu = ClampUnits(UnitsInSeg(segs[eseg], endTick));
+        s[i] = su;
+        e[i] = (eu > su) ? eu : su + 1;   // keep every note at least one unit wide
+    }
+    s.shrink_to_fit();
+    e.shrink_to_fit();
+}
+
+void NoteTimeColumns::Rebuild(const std::vector<OptimizedTrackData>& tracks, const std::vector<uint16_t>& changed) {
+    if (!IsBuiltFor(tracks)) return;   // not built (or for another song): nothing to keep in step
+    for (uint16_t t : changed)
+        if (t < tracks.size()) FillTrack(tracks[t].notes, t);
+}
+
+void NoteTimeColumns::Clear() {
+    source = nullptr;
+    segs.clear();
+    starts.clear(); starts.shrink_to_fit();
+    ends.clear();   ends.shrink_to_fit();
+}
+
+uint64_t NoteTimeColumns::TickToUnits(uint64_t tick) const {
+    if (segs.empty()) return 0;
+    size_t lo = 0, hi = segs.size();
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (segs[mid].tick <= tick) lo = mid;
+        else hi = mid;
+    }
+    return UnitsInSeg(segs[lo], tick);
+}
+
+uint64_t NoteTimeColumns::UnitsToTick(uint64_t units) const {
+    if (segs.empty()) return 0;
+    const double sec = (double)units / kUnitsPerSecond;
+    size_t lo = 0, hi = segs.size();
+    while (hi - lo > 1) {
+        const size_t mid = (lo + hi) / 2;
+        if (segs[mid].accumSec <= sec) lo = mid;
+        else hi = mid;
+    }
+    const auto& s = segs[lo];
+    if (s.usPerTick <= 0.0) return s.tick;
+    return s.tick + (uint64_t)std::max(0.0, (sec - s.accumSec) * 1000000.0 / s.usPerTick);
+}
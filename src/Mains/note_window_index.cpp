@@ -0,0 +1,37 @@
+#include "note_window_index.hpp"
+
+void NoteWindowIndex::BuildTrack(const NoteList& notes, TrackIndex& ix) {
+    const size_t blocks = (notes.size() + kBlock - 1) / kBlock;
+    ix.blockMaxEnd.assign(blocks, 0);
+    ix.prefixMaxEnd.assign(blocks, 0);
+    uint32_t running = 0;
+    for (size_t b = 0; b < blocks; ++b) {
+        const size_t e = std::min(notes.size(), (b + 1) * (size_t)kBlock);
+        uint32_t m = 0;
+        for (size_t i = b * kBlock; i < e; ++i) {
+            const uint32_t end = (notes[i].endTick > notes[i].startTick) ? notes[i].endTick : notes[i].startTick + 1;
+            m = std::max(m, end);
+        }
+        running = std::max(running, m);
+        ix.blockMaxEnd[b]  = m;
+        ix.prefixMaxEnd[b] = running;
+    }
+}
+
+void NoteWindowIndex::Build(const std::vector<OptimizedTrackData>& tracks) {
+    source = &tracks;
+    perTrack.assign(tracks.size(), {});
+    for (size_t t = 0; t < tracks.size(); ++t) BuildTrack(tracks[t].notes, perTrack[t]);
+}
+
+void NoteWindowIndex::Rebuild(const std::vector<OptimizedTrackData>& tracks, const std::vector<uint16_t>& changed) {
+    if (!IsBuiltFor(tracks)) { Build(tracks); return; }
+    for (uint16_t t : changed)
+        if (t < tracks.size()) BuildTrack(tracks[t].notes, perTrack[t]);
+}
+
+void NoteWindowIndex::Clear() {
+    source = nullptr;
+    perTrack.clear();
+    perTrack.shrink_to_fit();
+}
@@ -0,0 +1,207 @@
+#include "particles.hpp"
+
+#include "rlgl.h"
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <string>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define PARTICLE_SSE 1
+#include <xmmintrin.h>
+#endif
+
+// ── Shaders ───────────────────────────────────────────────────────────────────
+// Same body for GLSL 330 and GLSL ES 300; only the header differs.
+static const char* kParticleVsBody = R"(
+in vec2  aPos;              // quad corner in [-1, 1]
+in float aX;
+in float aY;
+in float aSize;             // radius factor
+uniform vec2  uScreen;      // framebuffer pixels
+uniform vec2  uScale;       // framebuffer pixels per screen pixel (HiDPI)
+uniform float uRadius;      // screen pixels at factor 1
+out vec2 vLocal;
+flat out float vRadius;
+void main() {
+    float r    = uRadius * aSize;
+    float ext  = r + 1.0;   // one pixel more for the soft rim
+    vec2  p    = (vec2(aX, aY) + aPos * ext) * uScale;
+    vLocal  = aPos * ext;
+    vRadius = r;
+    gl_Position = vec4(p.x / uScreen.x * 2.0 - 1.0, 1.0 - p.y / uScreen.y * 2.0, 0.0, 1.0);
+}
+)";
+
+static const char* kParticleFsBody = R"(
+in vec2 vLocal;
+flat in float vRadius;
+uniform vec4 uColor;
+out vec4 fragColor;
+void main() {
+    float a = clamp(vRadius - length(vLocal) + 0.5, 0.0, 1.0);
+    if (a <= 0.0) discard;
+    fragColor = vec4(uColor.rgb, uColor.a * a);
+}
+)";
+
+// Two triangles covering [-1, 1]²
+static const float kQuad[12] = { -1,-1, 1,-1, 1,1,  -1,-1, 1,1, -1,1 };
+
+bool BgParticleField::Available() {
+    if (tried) return ok;
+    tried = true;
+
+    const int ver = rlGetVersion();
+    std::string header;
+    if (ver == RL_OPENGL_33 || ver == RL_OPENGL_43) header = "#version 330\n";
+    else if (ver == RL_OPENGL_ES_30)                header = "#version 300 es\nprecision highp float;\nprecision highp int;\n";
+    else {
+        std::cout << "[warn] Particles need GL 3.3 / GLES 3.0 instancing - drawing at most " << kFallbackMax << std::endl;
+        return false;
+    }
+    const std::string vs = header + kParticleVsBody;
+    const std::string fs = header + kParticleFsBody;
+    shader = rlLoadShaderCode(vs.c_str(), fs.c_str());
+    if (shader == 0 || shader == rlGetShaderIdDefault()) {
+        std::cout << "[warn] Particle shader failed to compile" << std::endl;
+        shader = 0;
+        return false;
+    }
+    locPos    = rlGetLocationAttrib(shader, "aPos");
+    locX      = rlGetLocationAttrib(shader, "aX");
+    locY      = rlGetLocationAttrib(shader, "aY");
+    locSize   = rlGetLocationAttrib(shader, "aSize");
+    locScreen = rlGetLocationUniform(shader, "uScreen");
+    locScale  = rlGetLocationUniform(shader, "uScale");
+    locRadius = rlGetLocationUniform(shader, "uRadius");
+    locColor  = rlGetLocationUniform(shader, "uColor");
+    if (locPos < 0 || locX < 0 || locY < 0 || locSize < 0) {
+        std::cout << "[warn] Particle shader is missing its attributes" << std::endl;
+        rlUnloadShaderProgram(shader); shader = 0;
+        return false;
+    }
+
+    vao = rlLoadVertexArray();
+    rlEnableVertexArray(vao);
+    quadVbo = rlLoadVertexBuffer(kQuad, (int)sizeof(kQuad), false);
+    rlSetVertexAttribute((unsigned)locPos, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute((unsigned)locPos);
+    rlDisableVertexArray();
+
+    ok = EnsureCapacity(1u << 12);
+    std::cout << (ok ? "+ Particle renderer ready (instanced)" : "[warn] Particle buffers failed") << std::endl;
+    return ok;
+}
+
+bool BgParticleField::EnsureCapacity(size_t count) {
+    if (count <= capacity && xVbo != 0) return true;
+    size_t cap = std::max<size_t>(capacity ? capacity : 1, 1u << 12);
+    while (cap < count) cap *= 2;
+    cap = std::min(cap, (size_t)kMaxParticles);
+
+    rlEnableVertexArray(vao);
+    auto stream = [&](unsigned int& vbo, int loc) {
+        if (vbo != 0) rlUnloadVertexBuffer(vbo);
+        vbo = rlLoadVertexBuffer(nullptr, (int)(cap * sizeof(float)), true);
+        if (vbo == 0) return false;
+        rlSetVertexAttribute((unsigned)loc, 1, RL_FLOAT, false, 0, 0);   // reads the buffer just bound
+        rlEnableVertexAttribute((unsigned)loc);
+        rlSetVertexAttributeDivisor((unsigned)loc, 1);
+        return true;
+    };
+    const bool made = stream(xVbo, locX) && stream(yVbo, locY) && stream(sizeVbo, locSize);
+    rlDisableVertexArray();
+    rlDisableVertexBuffer();
+    capacity = made ? cap : 0;
+    return made;
+}
+
+float BgParticleField::NextUnit() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return (float)(rng >> 8) * (1.0f / 16777216.0f);
+}
+
+void BgParticleField::Spawn(size_t i, bool randomX, int screenW, int screenH) {
+    x[i]     = randomX ? NextUnit() * (float)screenW : (float)screenW + NextUnit() * 300.0f;
+    y[i]     = NextUnit() * (float)screenH;
+    speed[i] = 0.5f + NextUnit();   // [0.50 – 1.50]
+    size[i]  = 0.5f + NextUnit();
+}
+
+void BgParticleField::Update(int count, float step, float radius, int screenW, int screenH) {
+    screenW = std::max(screenW, 1);
+    screenH = std::max(screenH, 1);
+    const size_t n   = (size_t)std::clamp(count, 1, kMaxParticles);
+    const size_t old = x.size();
+    if (n != old) {
+        x.resize(n); y.resize(n); speed.resize(n); size.resize(n);
+        for (size_t i = old; i < n; ++i) Spawn(i, /*randomX=*/true, screenW, screenH);
+    }
+    if (step == 0.0f) return;   // paused: frozen in place
+
+    // A particle is gone once it is fully past the left edge: x < -4 r * size
+    const float edge = -radius * 4.0f;
+    size_t i = 0;
+#ifdef PARTICLE_SSE
+    const __m128 vStep = _mm_set1_ps(step);
+    const __m128 vEdge = _mm_set1_ps(edge);
+    for (; i + 4 <= n; i += 4) {
+        const __m128 px = _mm_sub_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(vStep, _mm_loadu_ps(&speed[i])));
+        _mm_storeu_ps(&x[i], px);
+        unsigned gone = (unsigned)_mm_movemask_ps(_mm_cmplt_ps(px, _mm_mul_ps(vEdge, _mm_loadu_ps(&size[i]))));
+        while (gone) {
+            Spawn(i + (size_t)std::countr_zero(gone), /*randomX=*/false, screenW, screenH);
+            gone &= gone - 1;
+        }
+    }
+#endif
+    for (; i < n; ++i) {
+        x[i] -= step * speed[i];
+        if (x[i] < edge * size[i]) Spawn(i, /*randomX=*/false, screenW, screenH);
+    }
+}
+
+void BgParticleField::Draw(float radius, Color color) {
+    const size_t n = x.size();
+    if (n == 0) return;
+    if (!Available() || !EnsureCapacity(n)) {
+        const size_t m = std::min(n, (size_t)kFallbackMax);
+        for (size_t i = 0; i < m; ++i) DrawCircleV({ x[i], y[i] }, radius * size[i], color);
+        return;
+    }
+
+    // ── Upload the three streams + one instanced draw ──
+    rlDrawRenderBatchActive();   // flush raylib's batch so the background stays underneath
+    const int bytes = (int)(n * sizeof(float));
+    rlUpdateVertexBuffer(xVbo,    x.data(),    bytes, 0);
+    rlUpdateVertexBuffer(yVbo,    y.data(),    bytes, 0);
+    rlUpdateVertexBuffer(sizeVbo, size.data(), bytes, 0);
+
+    const float screen[2] = { (float)GetRenderWidth(), (float)GetRenderHeight() };
+    const float scale[2]  = { screen[0] / (float)std::max(1, GetScreenWidth()), screen[1] / (float)std::max(1, GetScreenHeight()) };
+    const float rgba[4]   = { color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+
+    rlEnableShader(shader);
+    rlSetUniform(locScreen, screen,  RL_SHADER_UNIFORM_VEC2,  1);
+    rlSetUniform(locScale,  scale,   RL_SHADER_UNIFORM_VEC2,  1);
+    rlSetUniform(locRadius, &radius, RL_SHADER_UNIFORM_FLOAT, 1);
+    rlSetUniform(locColor,  rgba,    RL_SHADER_UNIFORM_VEC4,  1);
+
+    rlEnableVertexArray(vao);
+    rlDrawVertexArrayInstanced(0, 6, (int)n);
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+void BgParticleField::Unload() {
+    for (unsigned int* vbo : { &xVbo, &yVbo, &sizeVbo, &quadVbo })
+        if (*vbo) { rlUnloadVertexBuffer(*vbo); *vbo = 0; }
+    if (vao)    { rlUnloadVertexArray(vao); vao = 0; }
+    if (shader) { rlUnloadShaderProgram(shader); shader = 0; }
+    capacity = 0;
+    tried = ok = false;
+}
@@ -0,0 +1,119 @@
+#include "shared_mapping.hpp"
+
+#include <cstdint>
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+
+static std::string OsName(const std::string& name) { return "Local\\" + name; }
+
+bool SharedMapping::Map(bool readOnly) {
+    ptr = MapViewOfFile((HANDLE)handle, readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!ptr) { Close(); return false; }
+    MEMORY_BASIC_INFORMATION mbi{};
+    if (bytes == 0 && VirtualQuery(ptr, &mbi, sizeof(mbi))) bytes = mbi.RegionSize;   // page-rounded
+    return true;
+}
+
+static HANDLE CreateMappingObject(const std::string& name, size_t bytes) {
+    return CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                              (DWORD)((uint64_t)bytes >> 32), (DWORD)(bytes & 0xFFFFFFFFu),
+                              OsName(name).c_str());
+}
+
+bool SharedMapping::Create(const std::string& n, size_t size) {
+    Close();
+    HANDLE h = CreateMappingObject(n, size);
+    if (!h) return false;
+    if (GetLastError() == ERROR_ALREADY_EXISTS) { CloseHandle(h); return false; }
+    handle = h; name = n; bytes = size;
+    return Map(false);
+}
+
+bool SharedMapping::CreateOrOpen(const std::string& n, size_t size, bool* created) {
+    Close();
+    HANDLE h = CreateMappingObject(n, size);
+    if (!h) return false;
+    if (created) *created = GetLastError() != ERROR_ALREADY_EXISTS;
+    handle = h; name = n; bytes = size;
+    return Map(false);
+}
+
+bool SharedMapping::Open(const std::string& n, bool readOnly) {
+    Close();
+    HANDLE h = OpenFileMappingA(readOnly ? FILE_MAP_READ : FILE_MAP_ALL_ACCESS, FALSE, OsName(n).c_str());
+    if (!h) return false;
+    handle = h; name = n; bytes = 0;
+    return Map(readOnly);
+}
+
+void SharedMapping::Unlink() {}
+
+void SharedMapping::Close() {
+    if (ptr)    UnmapViewOfFile(ptr);
+    if (handle) CloseHandle((HANDLE)handle);
+    ptr = nullptr; handle = nullptr; bytes = 0;
+}
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static std::string OsName(const std::string& name) { return "/" + name; }
+
+bool SharedMapping::Map(bool readOnly) {
+    void* p = mmap(nullptr, bytes, readOnly ? PROT_READ : (PROT_READ | PROT_WRITE), MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) { Close(); return false; }
+    ptr = p;
+    return true;
+}
+
+bool SharedMapping::Create(const std::string& n, size_t size) {
+    Close();
+    fd = shm_open(OsName(n).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    name = n; bytes = size;
+    if (ftruncate(fd, (off_t)size) != 0) { Unlink(); Close(); return false; }
+    return Map(false);
+}
+
+bool SharedMapping::CreateOrOpen(const std::string& n, size_t size, bool* created) {
+    Close();
+    fd = shm_open(OsName(n).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    const bool fresh = fd >= 0;
+    if (!fresh) fd = shm_open(OsName(n).c_str(), O_RDWR, 0600);
+    if (fd < 0) return false;
+    if (created) *created = fresh;
+    name = n; bytes = size;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || ((size_t)st.st_size < size && ftruncate(fd, (off_t)size) != 0)) { Close(); return false; }
+    return Map(false);
+}
+
+bool SharedMapping::Open(const std::string& n, bool readOnly) {
+    Close();
+    fd = shm_open(OsName(n).c_str(), readOnly ? O_RDONLY : O_RDWR, 0600);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) { Close(); return false; }
+    name = n; bytes = (size_t)st.st_size;
+    return Map(readOnly);
+}
+
+void SharedMapping::Unlink() {
+    if (!name.empty()) shm_unlink(OsName(name).c_str());
+}
+
+void SharedMapping::Close() {
+    if (ptr)     munmap(ptr, bytes);
+    if (fd >= 0) close(fd);
+    ptr = nullptr; fd = -1; bytes = 0;
+}
+
+#endif
@@ -185,4 +185,10 @@ void SmtcBridge::Shutdown() {
     impl = nullptr;
 }
 
-#endif // _WIN32
\ No newline at end of file
+#else
+
+#include "smtc_bridge.hpp"
+
+SmtcBridge g_Smtc;   // no-op stand-in
+
+#endif // _WIN32
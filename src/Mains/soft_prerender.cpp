@@ -0,0 +1,140 @@
+#include "soft_prerender.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+static double FramesPerTick(uint32_t usPerQuarter, float speed, uint32_t sampleRate, int ppq) {
+    return (double)usPerQuarter / (double)speed / 1000000.0 * (double)sampleRate / (double)std::max(1, ppq);
+}
+
+SoftPreRenderDecoder::SoftPreRenderDecoder(std::shared_ptr<const FilteredStream> s, float sp,
+                                           uint32_t sr, int maxVoices)
+    : stream(std::move(s)), events(stream->Events()), synth(sr, maxVoices),
+      sampleRate(sr ? sr : 48000), speed(std::max(0.01f, sp))
+{
+    snapshotFrames = std::max<uint64_t>(1, (uint64_t)(kSnapshotSec * sampleRate));
+    cur.framesPerTick = FramesPerTick(stream->initialTempo, speed, sampleRate, stream->ppq);
+
+    // Length: walk the tempo map once, then add the release tail
+    Cursor c = cur;
+    for (const auto& ev : events) {
+        if (ev.Type() != EventType::TEMPO) continue;
+        c.tempoFrame   += (double)(ev.tick - c.tempoTick) * c.framesPerTick;
+        c.tempoTick     = ev.tick;
+        c.framesPerTick = FramesPerTick(ev.Tempo(), speed, sampleRate, stream->ppq);
+    }
+    const uint32_t lastTick = events.empty() ? 0 : events.back().tick;
+    length = (uint64_t)(c.tempoFrame + (double)(lastTick - c.tempoTick) * c.framesPerTick)
+           + (uint64_t)(kTailSec * sampleRate);
+
+    // Frame 0 is always restorable, even before the first Read
+    Snapshot first;
+    first.cursor = cur;
+    synth.Capture(first.synth);
+    snapshotBytes += first.synth.Bytes();
+    snapshots.push_back(std::move(first));
+}
+
+uint64_t SoftPreRenderDecoder::FrameOf(uint32_t tick) const {
+    return (uint64_t)(cur.tempoFrame + (double)(tick - cur.tempoTick) * cur.framesPerTick);
+}
+
+void SoftPreRenderDecoder::Apply(const MidiEvent& ev, bool notes) {
+    switch (ev.Type()) {
+        case EventType::TEMPO:
+            cur.tempoFrame   += (double)(ev.tick - cur.tempoTick) * cur.framesPerTick;
+            cur.tempoTick     = ev.tick;
+            cur.framesPerTick = FramesPerTick(ev.Tempo(), speed, sampleRate, stream->ppq);
+            break;
+        case EventType::NOTE_ON:
+        case EventType::NOTE_OFF:
+            if (notes) synth.SendShort(ev.ShortMsg());
+            break;
+        case EventType::CC:
+        case EventType::PITCH_BEND:
+        case EventType::PROGRAM_CHANGE:
+            synth.SendShort(ev.ShortMsg());
+            break;
+        case EventType::SYSEX:
+            if (stream->sysex) {
+                const auto msg = stream->sysex->Get(ev.SysExEntry());
+                if (msg.size) synth.SendLong(msg.data, msg.size);
+            }
+            break;
+        default:
+            break;   // pressure: the built-in synth has no use for it
+    }
+}
+
+void SoftPreRenderDecoder::ApplyDue(bool notes) {
+    while (cur.event < events.size() && FrameOf(events[cur.event].tick) <= pos) {
+        Apply(events[cur.event], notes);
+        cur.event++;
+    }
+}
+
+void SoftPreRenderDecoder::Restore(const Snapshot& s) {
+    synth.Restore(s.synth);
+    cur = s.cursor;
+    pos = s.frame;
+}
+
+uint32_t SoftPreRenderDecoder::Read(float* stereo, uint32_t frames) {
+    if (pos >= length) return 0;
+    frames = (uint32_t)std::min<uint64_t>(frames, length - pos);
+
+    uint32_t done = 0;
+    while (done < frames) {
+        // Snapshot on the grid, before the events at this frame are applied,
+        // so a restore replays exactly what happened here
+        if (exact && pos % snapshotFrames == 0 && pos > snapshots.back().frame) {
+            Snapshot s;
+            s.frame  = pos;
+            s.cursor = cur;
+            synth.Capture(s.synth);
+            snapshotBytes += s.synth.Bytes();
+            snapshots.push_back(std::move(s));
+        }
+        ApplyDue(true);
+
+        // Render up to the next event, grid point or the end
+        uint64_t next = std::min(length, (pos / snapshotFrames + 1) * snapshotFrames);
+        if (cur.event < events.size()) next = std::min(next, FrameOf(events[cur.event].tick));
+        const uint32_t n = (uint32_t)std::min<uint64_t>(frames - done, next - pos);
+        synth.Render(stereo + (size_t)done * 2, n);
+        done += n;
+        pos  += n;
+    }
+    return done;
+}
+
+void SoftPreRenderDecoder::RenderDiscard(uint64_t toFrame) {
+    constexpr uint32_t kBlock = 4096;
+    scratch.resize((size_t)kBlock * 2);
+    while (pos < toFrame) {
+        if (Read(scratch.data(), (uint32_t)std::min<uint64_t>(kBlock, toFrame - pos)) == 0) break;
+    }
+}
+
+uint64_t SoftPreRenderDecoder::Seek(uint64_t frame) {
+    frame = std::min(frame, length);
+
+    // Last snapshot at or before the target (snapshots[0] is frame 0)
+    auto it = std::upper_bound(snapshots.begin(), snapshots.end(), frame,
+        [](uint64_t f, const Snapshot& s) { return f < s.frame; });
+    const Snapshot& base = *(it - 1);
+    Restore(base);
+    exact = true;
+
+    const uint64_t preRoll = (uint64_t)(kPreRollSec * sampleRate);
+    if (frame - base.frame > snapshotFrames && frame - base.frame > preRoll) {
+        // Past the rendered range: chase controllers without audio, drop the
+        // voices the skipped notes would have left, then render the pre-roll
+        pos   = frame - preRoll;
+        exact = false;
+        ApplyDue(false);
+        for (uint32_t ch = 0; ch < 16; ++ch) synth.SendShort(0xB0 | ch | (120u << 8));
+    }
+    RenderDiscard(frame);
+    return pos;
+}
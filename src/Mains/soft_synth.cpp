@@ -0,0 +1,244 @@
+#include "soft_synth.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+static constexpr float kSilenceFloor = 1.0e-4f;
+static constexpr float kMasterGain   = 0.15f;
+static constexpr float kTwoPi        = 6.28318530718f;
+
+SoftSynth::SoftSynth(uint32_t sr, int maxVoices)
+    : voices((size_t)std::max(1, maxVoices)), sampleRate(sr ? sr : 48000)
+{
+    // -60 dB after ~4 s while held, ~150 ms once released
+    decayMul   = std::pow(1.0e-3f, 1.0f / (4.0f  * (float)sampleRate));
+    releaseMul = std::pow(1.0e-3f, 1.0f / (0.15f * (float)sampleRate));
+}
+
+void SoftSynth::Reset() {
+    for (auto& v : voices) v = Voice{};
+    for (auto& c : channels) c = Channel{};
+    activeCount = 0;
+    ageCounter  = 0;
+}
+
+void SoftSynth::Capture(State& out) const {
+    out.voices.clear();
+    out.slots.clear();
+    out.voices.reserve((size_t)activeCount);
+    out.slots.reserve((size_t)activeCount);
+    for (size_t i = 0; i < voices.size(); ++i) {
+        if (!voices[i].active) continue;
+        out.voices.push_back(voices[i]);
+        out.slots.push_back((uint32_t)i);
+    }
+    std::copy(std::begin(channels), std::end(channels), std::begin(out.channels));
+    out.ageCounter = ageCounter;
+}
+
+void SoftSynth::Restore(const State& in) {
+    std::fill(voices.begin(), voices.end(), Voice{});
+    activeCount = 0;
+    for (size_t i = 0; i < in.voices.size(); ++i) {
+        if (in.slots[i] >= voices.size()) continue;   // captured with a larger voice pool
+        voices[in.slots[i]] = in.voices[i];
+        activeCount++;
+    }
+    std::copy(std::begin(in.channels), std::end(in.channels), std::begin(channels));
+    ageCounter = in.ageCounter;
+}
+
+float SoftSynth::KeyIncrement(uint8_t ch, uint8_t key) const {
+    float semis = (float)key - 69.0f + channels[ch].bend;
+    float hz    = 440.0f * std::exp2(semis / 12.0f);
+    return hz / (float)sampleRate;
+}
+
+void SoftSynth::NoteOn(uint8_t ch, uint8_t key, uint8_t vel) {
+    // Retrigger the same key on the same channel instead of stacking voices
+    Voice* slot = nullptr;
+    for (auto& v : voices) {
+        if (v.active && v.channel == ch && v.key == key) { slot = &v; break; }
+    }
+    if (!slot) {
+        for (auto& v : voices) {
+            if (!v.active) { slot = &v; break; }
+        }
+    }
+    if (!slot) {
+        // Steal the oldest voice, preferring ones already releasing
+        Voice* oldest = nullptr;
+        for (auto& v : voices) {
+            if (!oldest || (v.releasing && !oldest->releasing) ||
+                (v.releasing == oldest->releasing && v.age < oldest->age))
+                oldest = &v;
+        }
+        slot = oldest;
+    }
+
+    if (!slot->active) activeCount++;
+    slot->active    = true;
+    slot->held      = true;
+    slot->releasing = false;
+    slot->channel   = ch;
+    slot->key       = key;
+    slot->env       = 1.0f;
+    slot->gain      = (float)vel / 127.0f;
+    slot->phase     = 0.0f;
+    slot->inc       = KeyIncrement(ch, key);
+    slot->age       = ++ageCounter;
+    slot->noise     = 0x9E3779B9u ^ ((uint32_t)key << 8) ^ vel;
+}
+
+void SoftSynth::NoteOff(uint8_t ch, uint8_t key) {
+    for (auto& v : voices) {
+        if (!v.active || !v.held || v.channel != ch || v.key != key) continue;
+        v.held = false;
+        if (!channels[ch].sustain) v.releasing = true;
+    }
+}
+
+void SoftSynth::ReleaseSustained(uint8_t ch) {
+    for (auto& v : voices) {
+        if (v.active && v.channel == ch && !v.held) v.releasing = true;
+    }
+}
+
+void SoftSynth::RetuneChannel(uint8_t ch) {
+    for (auto& v : voices) {
+        if (v.active && v.channel == ch) v.inc = KeyIncrement(ch, v.key);
+    }
+}
+
+void SoftSynth::SendShort(uint32_t msg) {
+    const uint8_t status = msg & 0xFF;
+    const uint8_t d1     = (msg >> 8)  & 0x7F;
+    const uint8_t d2     = (msg >> 16) & 0x7F;
+    const uint8_t ch     = status & 0x0F;
+    Channel& c = channels[ch];
+
+    switch (status & 0xF0) {
+        case 0x90:
+            if (d2 > 0) NoteOn(ch, d1, d2);
+            else        NoteOff(ch, d1);
+            break;
+        case 0x80:
+            NoteOff(ch, d1);
+            break;
+        case 0xB0:
+            switch (d1) {
+                case 7:   c.volume     = d2 / 127.0f; break;
+                case 10:  c.pan        = d2 / 127.0f; break;
+                case 11:  c.expression = d2 / 127.0f; break;
+                case 64:
+                    c.sustain = (d2 >= 64);
+                    if (!c.sustain) ReleaseSustained(ch);
+                    break;
+                case 120: // All Sound Off — cut immediately
+                    for (auto& v : voices) {
+                        if (v.active && v.channel == ch) { v = Voice{}; activeCount--; }
+                    }
+                    break;
+                case 121: // Reset All Controllers
+                    c.expression = 1.0f;
+                    c.bend       = 0.0f;
+                    c.sustain    = false;
+                    ReleaseSustained(ch);
+                    RetuneChannel(ch);
+                    break;
+                case 123: // All Notes Off — release, keep tails
+                    for (auto& v : voices) {
+                        if (v.active && v.channel == ch) { v.held = false; v.releasing = true; }
+                    }
+                    break;
+                default: break;
+            }
+            break;
+        case 0xC0:
+            c.program = d1;
+            break;
+        case 0xE0: {
+            int raw = (int)d1 | ((int)d2 << 7);
+            c.bend  = (float)(raw - 8192) / 8192.0f * 2.0f;
+            RetuneChannel(ch);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void SoftSynth::SendLong(const uint8_t* data, uint32_t len) {
+    static const uint8_t kGmOn[]    = { 0xF0, 0x7E, 0x7F, 0x09, 0x01, 0xF7 };
+    static const uint8_t kGsReset[] = { 0xF0, 0x41, 0x10, 0x42, 0x12, 0x40, 0x00, 0x7F, 0x00, 0x41, 0xF7 };
+    static const uint8_t kXgOn[]    = { 0xF0, 0x43, 0x10, 0x4C, 0x00, 0x00, 0x7E, 0x00, 0xF7 };
+    auto is = [&](const uint8_t* msg, size_t n) {
+        if (len != n) return false;
+        // Device ID nibble (byte 2) varies between files; compare the rest
+        for (size_t i = 0; i < n; ++i)
+            if (i != 2 && data[i] != msg[i]) return false;
+        return true;
+    };
+    if (!is(kGmOn, sizeof(kGmOn)) && !is(kGsReset, sizeof(kGsReset)) && !is(kXgOn, sizeof(kXgOn))) return;
+
+    // System reset: controllers back to defaults, sustained tails released
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+        channels[ch] = Channel{};
+        ReleaseSustained(ch);
+        RetuneChannel(ch);
+    }
+}
+
+void SoftSynth::Render(float* stereo, uint32_t frames) {
+    std::memset(stereo, 0, (size_t)frames * 2 * sizeof(float));
+    if (activeCount == 0) return;
+
+    for (auto& v : voices) {
+        if (!v.active) continue;
+
+        const Channel& c   = channels[v.channel];
+        const float    amp = v.gain * c.volume * c.expression * kMasterGain;
+        const float    gl  = amp * std::sqrt(1.0f - c.pan);
+        const float    gr  = amp * std::sqrt(c.pan);
+        const bool     drum = (v.channel == 9);
+        const int      wave = c.program >> 5;
+        const float    mul  = (v.releasing || drum) ? releaseMul : decayMul;
+
+        float    phase = v.phase;
+        float    env   = v.env;
+        uint32_t noise = v.noise;
+        uint32_t i = 0;
+        for (; i < frames; ++i) {
+            float s;
+            if (drum) {
+                noise = noise * 1664525u + 1013904223u;
+                s = (float)(int32_t)noise * (1.0f / 2147483648.0f);
+            } else {
+                switch (wave) {
+                    case 0:  s = 4.0f * std::fabs(phase - 0.5f) - 1.0f; break;   // triangle
+                    case 1:  s = 2.0f * phase - 1.0f; break;                      // saw
+                    case 2:  s = (phase < 0.5f) ? 0.6f : -0.6f; break;            // square
+                    default: s = std::sin(kTwoPi * phase); break;                 // sine
+                }
+                phase += v.inc;
+                if (phase >= 1.0f) phase -= 1.0f;
+            }
+            s *= env;
+            stereo[2 * i]     += s * gl;
+            stereo[2 * i + 1] += s * gr;
+            env *= mul;
+            if (env < kSilenceFloor) break;
+        }
+
+        if (i < frames) {
+            v = Voice{};
+            activeCount--;
+        } else {
+            v.phase = phase;
+            v.env   = env;
+            v.noise = noise;
+        }
+    }
+}
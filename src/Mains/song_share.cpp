@@ -0,0 +1,341 @@
+#include "song_share.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+SongShare g_SongShare;
+
+static constexpr uint32_t kControlMagic  = 0x4A534843;   // 'JSHC'
+static constexpr uint32_t kSongMagic     = 0x4A534853;   // 'JSHS'
+static constexpr uint32_t kShareVersion  = 1;
+static constexpr int      kRequestSlots  = 32;
+static constexpr int64_t  kMaxExtrapolateNs = 250'000'000;   // a stalled primary freezes the views, it does not run away
+static constexpr int      kPublishTries  = 16;
+
+enum : uint32_t { kFlagPaused = 1, kFlagFinished = 2, kFlagWaiting = 4 };
+
+struct SongShare::Control {
+    uint32_t              magic;
+    uint32_t              version;
+    std::atomic<uint64_t> songGen;        // 0 = no song published
+
+    std::atomic<uint32_t> seq;            // odd while the primary is writing
+    std::atomic<uint32_t> flags;
+    std::atomic<uint64_t> tick;
+    std::atomic<int64_t>  stampNs;
+    std::atomic<uint32_t> tempo;
+    std::atomic<uint32_t> speedBits;
+    std::atomic<uint32_t> ppq;
+
+    std::atomic<uint64_t> requestHead;
+    struct Slot {
+        std::atomic<uint64_t> ready;      // index + 1 once written
+        std::atomic<uint32_t> type;
+        std::atomic<int64_t>  micros;
+    } slots[kRequestSlots];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "shared control block needs address-free atomics");
+
+struct SongHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t gen;
+    uint64_t bytes;
+    uint64_t noteTotal;
+    uint32_t ppq;
+    uint32_t initialTempo;
+    uint16_t timeSigNumerator;
+    uint16_t timeSigDenominator;
+    uint32_t trackCount;
+    uint32_t lastEventTick;
+    uint64_t trackIndexOff;   // uint64_t[trackCount + 1]: first note of each track
+    uint64_t notesOff;
+    uint64_t tempoOff, tempoCount;
+    uint64_t ccOff,    ccCount;
+    char     file[512];
+};
+
+static uint64_t Align64(uint64_t v) { return (v + 63) & ~uint64_t(63); }
+
+static int64_t SteadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string SongRegionName(const std::string& base, uint64_t gen) {
+    return base + ".song." + std::to_string(gen);
+}
+
+// ── Setup ─────────────────────────────────────────────────────────────────────
+
+bool SongShare::OpenControl(const std::string& n) {
+    bool created = false;
+    if (!control.CreateOrOpen(n, sizeof(Control), &created)) {
+        std::cout << "[warn] Song share: cannot open '" << n << "'" << std::endl;
+        return false;
+    }
+    Control* c = Ctl();
+    if (created || c->magic == 0) {        // fresh regions are zero-filled
+        c->magic   = kControlMagic;
+        c->version = kShareVersion;
+    } else if (c->magic != kControlMagic || c->version != kShareVersion) {
+        std::cout << "[warn] Song share: '" << n << "' belongs to another build" << std::endl;
+        control.Close();
+        return false;
+    }
+    name = n;
+    return true;
+}
+
+bool SongShare::StartPrimary(const std::string& n) {
+    Shutdown();
+    if (!OpenControl(n)) return false;
+    role        = Role::Primary;
+    requestTail = Ctl()->requestHead.load(std::memory_order_acquire);   // drop requests left from an earlier run
+    std::cout << "+ Song share: publishing as '" << n << "'" << std::endl;
+    return true;
+}
+
+bool SongShare::StartSecondary(const std::string& n) {
+    Shutdown();
+    if (!OpenControl(n)) return false;
+    role = Role::Secondary;
+    std::cout << "+ Song share: following '" << n << "'" << std::endl;
+    return true;
+}
+
+void SongShare::Shutdown() {
+    if (IsPrimary()) Unpublish();
+    if (IsSecondary()) Detach();
+    control.Close();
+    role = Role::None;
+}
+
+// ── Primary ───────────────────────────────────────────────────────────────────
+
+bool SongShare::Publish(std::vector<OptimizedTrackData>& tracks, const std::vector<TempoEvent>& tempo,
+                        const std::vector<CCEvent>& cc, const SharedSongInfo& info)
+{
+    if (!IsPrimary()) return false;
+    Unpublish();
+
+    uint64_t notes = 0;
+    for (const auto& t : tracks) notes += t.notes.size();
+
+    SongHeader h{};
+    h.magic              = kSongMagic;
+    h.version            = kShareVersion;
+    h.noteTotal          = info.noteTotal;
+    h.ppq                = (uint32_t)info.ppq;
+    h.initialTempo       = (uint32_t)info.initialTempo;
+    h.timeSigNumerator   = info.timeSigNumerator;
+    h.timeSigDenominator = info.timeSigDenominator;
+    h.trackCount         = (uint32_t)tracks.size();
+    h.lastEventTick      = info.lastEventTick;
+    h.trackIndexOff      = Align64(sizeof(SongHeader));
+    h.notesOff           = Align64(h.trackIndexOff + (tracks.size() + 1) * sizeof(uint64_t));
+    h.tempoOff           = Align64(h.notesOff + notes * sizeof(NoteEvent));
+    h.tempoCount         = tempo.size();
+    h.ccOff              = Align64(h.tempoOff + tempo.size() * sizeof(TempoEvent));
+    h.ccCount            = cc.size();
+    h.bytes              = h.ccOff + cc.size() * sizeof(CCEvent);
+    std::strncpy(h.file, info.file.c_str(), sizeof(h.file) - 1);
+
+    // A name can outlive its publisher while a secondary still maps it, so
+    // step past any generation that is taken
+    uint64_t gen = Ctl()->songGen.load(std::memory_order_acquire);
+    bool ok = false;
+    for (int i = 0; i < kPublishTries && !ok; ++i) {
+        gen = std::max<uint64_t>(gen, publishedGen) + 1;
+        ok  = song.Create(SongRegionName(name, gen), (size_t)h.bytes);
+    }
+    if (!ok) {
+        std::cout << "[warn] Song share: could not create a " << (h.bytes >> 20) << " MB region" << std::endl;
+        return false;
+    }
+    h.gen = gen;
+
+    uint8_t* base = (uint8_t*)song.Data();
+    std::memcpy(base, &h, sizeof(h));
+    uint64_t* index = (uint64_t*)(base + h.trackIndexOff);
+    NoteEvent* dst  = (NoteEvent*)(base + h.notesOff);
+    uint64_t at = 0;
+    for (size_t t = 0; t < tracks.size(); ++t) {
+        index[t] = at;
+        const auto& src = tracks[t].notes;
+        if (!src.empty()) std::memcpy(dst + at, src.data(), src.size() * sizeof(NoteEvent));
+        at += src.size();
+    }
+    index[tracks.size()] = at;
+    if (!tempo.empty()) std::memcpy(base + h.tempoOff, tempo.data(), tempo.size() * sizeof(TempoEvent));
+    if (!cc.empty())    std::memcpy(base + h.ccOff,    cc.data(),    cc.size() * sizeof(CCEvent));
+
+    // The region now holds the only copy this process needs
+    for (size_t t = 0; t < tracks.size(); ++t)
+        tracks[t].notes.View(dst + index[t], (size_t)(index[t + 1] - index[t]));
+
+    publishedGen = gen;
+    Ctl()->ppq.store(h.ppq, std::memory_order_relaxed);
+    Ctl()->songGen.store(gen, std::memory_order_release);
+    std::cout << "+ Song share: published " << notes << " notes (" << (h.bytes >> 20) << " MB) as '"
+              << SongRegionName(name, gen) << "'" << std::endl;
+    return true;
+}
+
+void SongShare::Unpublish() {
+    if (!IsPrimary() || publishedGen == 0) return;
+    Ctl()->songGen.store(0, std::memory_order_release);
+    song.Unlink();
+    song.Close();
+    publishedGen = 0;
+}
+
+void SongShare::WriteTransport(const SharedTransport& t) {
+    if (!IsPrimary()) return;
+    Control* c = Ctl();
+    const uint32_t s = c->seq.load(std::memory_order_relaxed);
+    c->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    c->tick.store(t.tick, std::memory_order_relaxed);
+    c->stampNs.store(SteadyNs(), std::memory_order_relaxed);
+    c->tempo.store(t.tempo, std::memory_order_relaxed);
+    c->speedBits.store(std::bit_cast<uint32_t>(t.speed), std::memory_order_relaxed);
+    c->flags.store((t.paused   ? (uint32_t)kFlagPaused   : 0u) |
+                   (t.finished ? (uint32_t)kFlagFinished : 0u) |
+                   (t.waiting  ? (uint32_t)kFlagWaiting  : 0u), std::memory_order_relaxed);
+    c->seq.store(s + 2, std::memory_order_release);
+}
+
+bool SongShare::PollCommand(ShareCommand& out) {
+    if (!IsPrimary()) return false;
+    Control* c = Ctl();
+    const uint64_t head = c->requestHead.load(std::memory_order_acquire);
+    if (head - requestTail > (uint64_t)kRequestSlots) requestTail = head - kRequestSlots;   // overrun: keep the newest
+    while (requestTail < head) {
+        const auto& slot = c->slots[requestTail % kRequestSlots];
+        if (slot.ready.load(std::memory_order_acquire) != requestTail + 1) return false;   // still being written
+        out.type   = (ShareRequest)slot.type.load(std::memory_order_relaxed);
+        out.micros = slot.micros.load(std::memory_order_relaxed);
+        requestTail++;
+        if (out.type != ShareRequest::None) return true;
+    }
+    return false;
+}
+
+// ── Secondary ─────────────────────────────────────────────────────────────────
+
+bool SongShare::SongWaiting() const {
+    if (!IsSecondary() || IsAttached()) return false;
+    const uint64_t gen = Ctl()->songGen.load(std::memory_order_acquire);
+    return gen != 0 && gen != leftGen;
+}
+
+bool SongShare::Attach(std::vector<OptimizedTrackData>& tracks, std::vector<TempoEvent>& tempo,
+                       std::vector<CCEvent>& cc, SharedSongInfo& info)
+{
+    if (!IsSecondary()) return false;
+    Detach();
+    const uint64_t gen = Ctl()->songGen.load(std::memory_order_acquire);
+    if (gen == 0) return false;
+    // A failed generation counts as left, so SongWaiting() stops offering it
+    if (!song.Open(SongRegionName(name, gen), true)) {
+        std::cout << "[warn] Song share: could not map '" << SongRegionName(name, gen) << "'" << std::endl;
+        leftGen = gen;
+        return false;
+    }
+
+    const uint8_t* base = (const uint8_t*)song.Data();
+    SongHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    if (song.Size() < sizeof(SongHeader) || h.magic != kSongMagic || h.version != kShareVersion ||
+        h.gen != gen || h.bytes > song.Size()) {
+        std::cout << "[warn] Song share: region '" << SongRegionName(name, gen) << "' is not usable" << std::endl;
+        song.Close();
+        leftGen = gen;
+        return false;
+    }
+
+    const uint64_t*  index = (const uint64_t*)(base + h.trackIndexOff);
+    const NoteEvent* notes = (const NoteEvent*)(base + h.notesOff);
+    tracks.clear();
+    tracks.resize(h.trackCount);
+    for (uint32_t t = 0; t < h.trackCount; ++t)
+        tracks[t].notes.View(notes + index[t], (size_t)(index[t + 1] - index[t]));
+
+    const TempoEvent* te = (const TempoEvent*)(base + h.tempoOff);
+    const CCEvent*    ce = (const CCEvent*)(base + h.ccOff);
+    tempo.assign(te, te + h.tempoCount);
+    cc.assign(ce, ce + h.ccCount);
+
+    h.file[sizeof(h.file) - 1] = '\0';
+    info.file               = h.file;
+    info.noteTotal          = h.noteTotal;
+    info.ppq                = (int)h.ppq;
+    info.initialTempo       = (int)h.initialTempo;
+    info.timeSigNumerator   = h.timeSigNumerator;
+    info.timeSigDenominator = h.timeSigDenominator;
+    info.lastEventTick      = h.lastEventTick;
+
+    attachedGen = gen;
+    std::cout << "+ Song share: attached '" << SongRegionName(name, gen) << "' (" << (song.Size() >> 20)
+              << " MB mapped, " << h.noteTotal << " notes)" << std::endl;
+    return true;
+}
+
+bool SongShare::SongGone() const {
+    return IsAttached() && Ctl()->songGen.load(std::memory_order_acquire) != attachedGen;
+}
+
+void SongShare::Detach() {
+    if (!IsAttached()) return;
+    leftGen     = attachedGen;
+    attachedGen = 0;
+    song.Close();
+}
+
+SharedTransport SongShare::ReadTransport() const {
+    SharedTransport t;
+    if (!IsSecondary()) return t;
+    const Control* c = Ctl();
+    uint32_t s0, s1, flags, speedBits, ppq;
+    int64_t  stamp;
+    do {
+        s0        = c->seq.load(std::memory_order_acquire);
+        t.tick    = c->tick.load(std::memory_order_relaxed);
+        stamp     = c->stampNs.load(std::memory_order_relaxed);
+        t.tempo   = c->tempo.load(std::memory_order_relaxed);
+        speedBits = c->speedBits.load(std::memory_order_relaxed);
+        flags     = c->flags.load(std::memory_order_relaxed);
+        ppq       = c->ppq.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        s1        = c->seq.load(std::memory_order_relaxed);
+    } while ((s0 & 1) || s0 != s1);
+
+    t.speed    = std::bit_cast<float>(speedBits);
+    t.paused   = (flags & kFlagPaused) != 0;
+    t.finished = (flags & kFlagFinished) != 0;
+    t.waiting  = (flags & kFlagWaiting) != 0;
+
+    // Carry the tick forward from the primary's sample to now
+    if (!t.paused && !t.finished && stamp != 0 && t.tempo != 0 && ppq != 0) {
+        const int64_t dt = std::clamp<int64_t>(SteadyNs() - stamp, 0, kMaxExtrapolateNs);
+        const double  nsPerTick = (double)t.tempo * 1000.0 / (double)ppq / (double)std::max(0.01f, t.speed);
+        t.tick += (uint64_t)((double)dt / nsPerTick);
+    }
+    return t;
+}
+
+void SongShare::SendCommand(const ShareCommand& cmd) {
+    if (!IsSecondary()) return;
+    Control* c = Ctl();
+    const uint64_t i = c->requestHead.fetch_add(1, std::memory_order_acq_rel);
+    auto& slot = c->slots[i % kRequestSlots];
+    slot.type.store((uint32_t)cmd.type, std::memory_order_relaxed);
+    slot.micros.store(cmd.micros, std::memory_order_relaxed);
+    slot.ready.store(i + 1, std::memory_order_release);
+}
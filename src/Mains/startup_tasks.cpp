@@ -0,0 +1,159 @@
+#include "startup_tasks.hpp"
+
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+
+StartupTasks g_Startup;
+
+static std::string TextLine(const char* fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    return buf;
+}
+
+size_t StartupTasks::Add(const char* name, Fn work, Fn onMain, std::vector<size_t> deps) {
+    std::lock_guard<std::mutex> lk(mtx);
+    Task t;
+    t.name   = name;
+    t.work   = std::move(work);
+    t.onMain = std::move(onMain);
+    t.deps   = std::move(deps);
+    tasks.push_back(std::move(t));
+    remaining.fetch_add(1, std::memory_order_acq_rel);
+    return tasks.size() - 1;
+}
+
+void StartupTasks::Start() {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (started) return;
+    started = true;
+    // The list is fixed from here on, so worker threads can index it freely
+    for (size_t i = 0; i < tasks.size(); ++i)
+        tasks[i].thread = std::thread(&StartupTasks::Run, this, i);
+}
+
+void StartupTasks::Run(size_t id) {
+    {
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait(lk, [&] {
+            if (cancelled) return true;
+            for (size_t d : tasks[id].deps)
+                if (tasks[d].state != State::Done) return false;
+            return true;
+        });
+        if (cancelled) return;
+        tasks[id].state   = State::Running;
+        tasks[id].startMs = NowMs();
+    }
+    if (tasks[id].work) tasks[id].work();
+
+    std::lock_guard<std::mutex> lk(mtx);
+    tasks[id].workEndMs = NowMs();
+    if (tasks[id].onMain && !cancelled) tasks[id].state = State::WaitingMain;
+    else                                Finish(id);
+}
+
+void StartupTasks::Finish(size_t id) {
+    tasks[id].state = State::Done;
+    tasks[id].endMs = NowMs();
+    tasks[id].detail.clear();
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+    cv.notify_all();
+}
+
+void StartupTasks::PumpMain() {
+    if (!started || cancelled) return;
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        Fn cont;
+        {
+            std::lock_guard<std::mutex> lk(mtx);
+            if (tasks[i].state != State::WaitingMain) continue;
+            cont = std::move(tasks[i].onMain);
+        }
+        cont();   // GL / window work, outside the lock
+        std::lock_guard<std::mutex> lk(mtx);
+        Finish(i);
+    }
+    std::vector<std::thread> finished;
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        for (auto& t : tasks)
+            if (t.state == State::Done && t.thread.joinable()) finished.push_back(std::move(t.thread));
+    }
+    for (auto& th : finished) th.join();
+
+    if (AllDone() && !reported) {
+        reported = true;
+        Mark("All startup tasks done");
+        PrintTimeline();
+    }
+}
+
+void StartupTasks::Wait() {
+    if (!started || cancelled) return;
+    while (!AllDone()) {
+        PumpMain();
+        std::unique_lock<std::mutex> lk(mtx);
+        cv.wait_for(lk, std::chrono::milliseconds(5));
+    }
+    PumpMain();
+    for (auto& t : tasks)
+        if (t.thread.joinable()) t.thread.join();
+}
+
+void StartupTasks::Cancel() {
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        if (!started || cancelled) return;
+        cancelled = true;
+        for (auto& t : tasks) t.onMain = {};
+    }
+    cv.notify_all();
+    for (auto& t : tasks)
+        if (t.thread.joinable()) t.thread.join();
+}
+
+bool StartupTasks::IsDone(size_t id) const {
+    std::lock_guard<std::mutex> lk(mtx);
+    return id < tasks.size() && tasks[id].state == State::Done;
+}
+
+void StartupTasks::SetDetail(size_t id, std::string detail) {
+    std::lock_guard<std::mutex> lk(mtx);
+    if (id < tasks.size()) tasks[id].detail = std::move(detail);
+}
+
+std::string StartupTasks::StatusLine() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    std::string out;
+    for (const auto& t : tasks) {
+        if (t.state == State::Done) continue;
+        if (!out.empty()) out += ", ";
+        out += t.name;
+        if (!t.detail.empty()) out += " (" + t.detail + ")";
+        if (t.state == State::Pending) out += " [queued]";
+    }
+    return out;
+}
+
+void StartupTasks::Mark(const char* phase) {
+    std::lock_guard<std::mutex> lk(mtx);
+    phases.push_back({ phase, NowMs() });
+}
+
+void StartupTasks::PrintTimeline() const {
+    std::lock_guard<std::mutex> lk(mtx);
+    std::cout << "+-[ Startup timeline ]-+" << std::endl;
+    for (const auto& p : phases)
+        std::cout << TextLine("  %8.1f ms  %s", p.ms, p.name.c_str()) << std::endl;
+    for (const auto& t : tasks) {
+        std::cout << TextLine("  %8.1f ms  %-22s %8.1f ms work", t.startMs, t.name.c_str(), t.workEndMs - t.startMs);
+        if (t.endMs > t.workEndMs + 0.05)
+            std::cout << TextLine(" + %.1f ms main (done %.1f ms)", t.endMs - t.workEndMs, t.endMs);
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,407 @@
+#include "synth_shard.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#  include <xmmintrin.h>
+#  define SHARD_MIX_SSE 1
+#endif
+
+// Hottest shard must be this much slower than the coolest before moving a key.
+static constexpr double   kImbalanceRatio = 1.3;
+// Inbox marker for a long message: 0xF0 | (offset into the shard's long inbox << 8).
+// Send() rejects status >= 0xF0, so a real short message never looks like one.
+static constexpr uint32_t kLongMarker     = 0xF0;
+static constexpr uint32_t kLongInboxMax   = 1u << 24;
+
+static int64_t NowMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MixAddFloats(float* dst, const float* src, size_t count) {
+    size_t i = 0;
+#ifdef SHARD_MIX_SSE
+    for (; i + 16 <= count; i += 16) {
+        __m128 a0 = _mm_loadu_ps(dst + i),      b0 = _mm_loadu_ps(src + i);
+        __m128 a1 = _mm_loadu_ps(dst + i + 4),  b1 = _mm_loadu_ps(src + i + 4);
+        __m128 a2 = _mm_loadu_ps(dst + i + 8),  b2 = _mm_loadu_ps(src + i + 8);
+        __m128 a3 = _mm_loadu_ps(dst + i + 12), b3 = _mm_loadu_ps(src + i + 12);
+        _mm_storeu_ps(dst + i,      _mm_add_ps(a0, b0));
+        _mm_storeu_ps(dst + i + 4,  _mm_add_ps(a1, b1));
+        _mm_storeu_ps(dst + i + 8,  _mm_add_ps(a2, b2));
+        _mm_storeu_ps(dst + i + 12, _mm_add_ps(a3, b3));
+    }
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+#endif
+    for (; i < count; ++i) dst[i] += src[i];
+}
+
+// ── Shard ─────────────────────────────────────────────────────────────────────
+struct ShardedSynth::Shard {
+    std::unique_ptr<SynthBackend> synth;
+    std::thread                   worker;
+
+    std::mutex            inboxMutex;
+    std::vector<uint32_t> inbox;      // filled by Send()
+    std::vector<uint32_t> draining;   // swapped in by the render side
+    std::vector<uint8_t>  longInbox;  // SysEx bytes ([uint32 len][bytes]) referenced by markers
+    std::vector<uint8_t>  longDraining;
+
+    std::vector<float>    buffer;     // interleaved stereo, owned by the render side
+
+    std::atomic<double>   renderUs{0.0};
+    std::atomic<uint64_t> events{0};
+    std::atomic<int>      voices{0};
+};
+
+ShardedSynth::ShardedSynth() {
+    for (int i = 0; i < kTrackBuckets; ++i) {
+        route[i].store(0, std::memory_order_relaxed);
+        keyEvents[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+ShardedSynth::~ShardedSynth() { Stop(); }
+
+bool ShardedSynth::Start(int shardCount, ShardKey k, const Factory& factory) {
+    Stop();
+    shardCount = std::clamp(shardCount, 1, kMaxShards);
+    key = k;
+
+    for (int i = 0; i < shardCount; ++i) {
+        auto s = std::make_unique<Shard>();
+        s->synth = factory();
+        if (!s->synth) {
+            std::cerr << "[Shard] backend factory failed for shard " << i << "\n";
+            shards.clear();
+            return false;
+        }
+        s->inbox.reserve(4096);
+        s->draining.reserve(4096);
+        shards.push_back(std::move(s));
+    }
+
+    // Round-robin initial ownership; Rebalance() refines it from measured load
+    const int keys = (key == ShardKey::Channel) ? 16 : kTrackBuckets;
+    for (int i = 0; i < kTrackBuckets; ++i) {
+        route[i].store((uint8_t)(i < keys ? i % shardCount : 0), std::memory_order_relaxed);
+        keyEvents[i].store(0, std::memory_order_relaxed);
+    }
+
+    held.assign((size_t)shardCount * 16 * 128, 0);
+    if (key == ShardKey::Track) heldTrack.assign((size_t)kTrackBuckets * 16 * 128, 0);
+    else                        heldTrack.clear();
+    std::memset(ccSeen, 0, sizeof(ccSeen));
+    std::memset(programSeen, 0, sizeof(programSeen));
+    std::memset(bendSeen, 0, sizeof(bendSeen));
+    sendsSinceBalance = 0;
+    lastBalanceUs     = NowMicros();
+
+    {
+        std::lock_guard<std::mutex> lk(jobMutex);
+        stopWorkers   = false;
+        jobPending    = 0;
+        jobGeneration = 0;
+    }
+    // Shard 0 is rendered inline by Render(); the rest get a worker each
+    for (size_t i = 1; i < shards.size(); ++i) {
+        Shard* s = shards[i].get();
+        s->worker = std::thread([this, s]() { WorkerLoop(s); });
+    }
+
+    running.store(true, std::memory_order_release);
+    std::cout << "+ Sharded synth: " << shardCount << " x " << shards[0]->synth->Name()
+              << " (" << (key == ShardKey::Channel ? "by channel" : "by track") << ")\n";
+    return true;
+}
+
+void ShardedSynth::Stop() {
+    running.store(false);
+    while (sendersInside.load() != 0) std::this_thread::yield();
+    {
+        std::lock_guard<std::mutex> lk(jobMutex);
+        stopWorkers = true;
+    }
+    jobCV.notify_all();
+    for (auto& s : shards) {
+        if (s->worker.joinable()) s->worker.join();
+    }
+    shards.clear();
+    held.clear();
+    heldTrack.clear();
+}
+
+// ── Playback-thread side ──────────────────────────────────────────────────────
+void ShardedSynth::Push(int shard, uint32_t msg) {
+    Shard& s = *shards[(size_t)shard];
+    std::lock_guard<std::mutex> lk(s.inboxMutex);
+    s.inbox.push_back(msg);
+}
+
+void ShardedSynth::PushLong(int shard, const uint8_t* data, uint32_t len) {
+    Shard& s = *shards[(size_t)shard];
+    std::lock_guard<std::mutex> lk(s.inboxMutex);
+    const size_t offset = s.longInbox.size();
+    if (offset + sizeof(uint32_t) + len > kLongInboxMax) return;   // render side stalled; drop
+    s.longInbox.resize(offset + sizeof(uint32_t) + len);
+    std::memcpy(s.longInbox.data() + offset, &len, sizeof(uint32_t));
+    std::memcpy(s.longInbox.data() + offset + sizeof(uint32_t), data, len);
+    s.inbox.push_back(kLongMarker | ((uint32_t)offset << 8));
+}
+
+int ShardedSynth::RouteFor(uint8_t ch, uint16_t track) const {
+    const int idx = (key == ShardKey::Channel) ? ch : (track & (kTrackBuckets - 1));
+    return route[idx].load(std::memory_order_relaxed);
+}
+
+void ShardedSynth::Send(uint32_t msg, uint16_t track) {
+    const uint8_t status = msg & 0xFF;
+    if (status < 0x80 || status >= 0xF0) return;
+
+    sendersInside.fetch_add(1);
+    if (!running.load()) {
+        sendersInside.fetch_sub(1);
+        return;
+    }
+
+    const uint8_t type = status & 0xF0;
+    const uint8_t ch   = status & 0x0F;
+    const uint8_t d1   = (msg >> 8)  & 0x7F;
+    const uint8_t d2   = (msg >> 16) & 0x7F;
+    const int     n    = (int)shards.size();
+
+    const int keyIdx = (key == ShardKey::Channel) ? ch : (track & (kTrackBuckets - 1));
+    keyEvents[keyIdx].fetch_add(1, std::memory_order_relaxed);
+
+    auto heldAt = [&](int shard) -> uint16_t& {
+        return held[((size_t)shard * 16 + ch) * 128 + d1];
+    };
+
+    if (key == ShardKey::Track && (type == 0x80 || type == 0x90)) {
+        uint32_t& h = heldTrack[((size_t)keyIdx * 16 + ch) * 128 + d1];
+        const uint32_t count = h >> 8;
+        const int s = count ? (int)(h & 0xFF) : RouteFor(ch, track);
+        if (type == 0x90 && d2 > 0) {
+            h = ((count + 1) << 8) | (uint32_t)s;
+        } else if (count) {
+            h = (count == 1) ? 0u : ((count - 1) << 8) | (uint32_t)s;
+        }
+        Push(s, msg);
+    } else if (type == 0x90 && d2 > 0) {
+        int s = RouteFor(ch, track);
+        heldAt(s)++;
+        Push(s, msg);
+    } else if (type == 0x80 || type == 0x90) {
+        // Note-off follows its note-on, even if the key has migrated since
+        int s = RouteFor(ch, track);
+        if (heldAt(s) == 0) {
+            for (int i = 0; i < n; ++i) {
+                if (heldAt(i) > 0) { s = i; break; }
+            }
+        }
+        if (heldAt(s) > 0) heldAt(s)--;
+        Push(s, msg);
+    } else if (type == 0xA0) {
+        // Poly pressure goes to the shard sounding the key, like its note-off
+        int s = RouteFor(ch, track);
+        if (key == ShardKey::Track) {
+            const uint32_t h = heldTrack[((size_t)keyIdx * 16 + ch) * 128 + d1];
+            if (h >> 8) s = (int)(h & 0xFF);
+        } else if (heldAt(s) == 0) {
+            for (int i = 0; i < n; ++i) {
+                if (heldAt(i) > 0) { s = i; break; }
+            }
+        }
+        Push(s, msg);
+    } else {
+        // Channel state — mirror it so a migrated channel can be restored
+        bool broadcast = (key == ShardKey::Track);
+        if (type == 0xB0) {
+            ccState[ch][d1] = d2;
+            ccSeen[ch][d1]  = true;
+            // Sustain / notes-off must also reach shards still holding tails
+            if (d1 == 64 || d1 >= 120) broadcast = true;
+            if (d1 == 120 || d1 == 123) {
+                for (int i = 0; i < n; ++i)
+                    std::memset(&held[((size_t)i * 16 + ch) * 128], 0, 128 * sizeof(uint16_t));
+                for (size_t b = 0; b * 16 * 128 < heldTrack.size(); ++b)
+                    std::memset(&heldTrack[(b * 16 + ch) * 128], 0, 128 * sizeof(uint32_t));
+            }
+        } else if (type == 0xC0) {
+            program[ch] = d1; programSeen[ch] = true;
+        } else if (type == 0xE0) {
+            bend[ch] = (uint16_t)(d1 | (d2 << 7)); bendSeen[ch] = true;
+        }
+
+        if (broadcast) {
+            for (int i = 0; i < n; ++i) Push(i, msg);
+        } else {
+            Push(RouteFor(ch, track), msg);
+        }
+    }
+
+    if (++sendsSinceBalance >= balanceEvery) {
+        sendsSinceBalance = 0;
+        int64_t now = NowMicros();
+        if (now - lastBalanceUs >= balanceMinUs) {
+            lastBalanceUs = now;
+            Rebalance();
+        }
+    }
+    sendersInside.fetch_sub(1);
+}
+
+void ShardedSynth::SendLong(const uint8_t* data, uint32_t len) {
+    if (!data || len == 0) return;
+    sendersInside.fetch_add(1);
+    if (running.load()) {
+        for (int i = 0; i < (int)shards.size(); ++i) PushLong(i, data, len);
+    }
+    sendersInside.fetch_sub(1);
+}
+
+void ShardedSynth::ReplayChannelState(uint8_t ch, int shard) {
+    if (programSeen[ch]) Push(shard, (uint32_t)(0xC0 | ch) | ((uint32_t)program[ch] << 8));
+    for (int c = 0; c < 120; ++c) {
+        if (ccSeen[ch][c])
+            Push(shard, (uint32_t)(0xB0 | ch) | ((uint32_t)c << 8) | ((uint32_t)ccState[ch][c] << 16));
+    }
+    if (bendSeen[ch])
+        Push(shard, (uint32_t)(0xE0 | ch) | ((uint32_t)(bend[ch] & 0x7F) << 8) | ((uint32_t)(bend[ch] >> 7) << 16));
+}
+
+// Moves at most one routing key per call from the slowest shard to the fastest.
+// The key is picked so its share of events roughly halves the gap; moving
+// one key at a time keeps the table from oscillating between two layouts.
+void ShardedSynth::Rebalance() {
+    const int n = (int)shards.size();
+    const int keys = (key == ShardKey::Channel) ? 16 : kTrackBuckets;
+
+    uint32_t weight[kTrackBuckets];
+    for (int k = 0; k < keys; ++k) weight[k] = keyEvents[k].exchange(0, std::memory_order_relaxed);
+    if (n < 2) return;
+
+    int hot = 0, cold = 0;
+    double load[kMaxShards];
+    for (int i = 0; i < n; ++i) {
+        load[i] = shards[(size_t)i]->renderUs.load(std::memory_order_relaxed);
+        if (load[i] > load[hot])  hot  = i;
+        if (load[i] < load[cold]) cold = i;
+    }
+    if (hot == cold || load[hot] < 1.0 || load[hot] <= load[cold] * kImbalanceRatio) return;
+
+    uint64_t hotEvents = 0;
+    for (int k = 0; k < keys; ++k)
+        if (route[k].load(std::memory_order_relaxed) == hot) hotEvents += weight[k];
+    if (hotEvents == 0) return;
+
+    const double target = (double)hotEvents * ((load[hot] - load[cold]) / 2.0) / load[hot];
+    int best = -1;
+    for (int k = 0; k < keys; ++k) {
+        if (route[k].load(std::memory_order_relaxed) != hot || weight[k] == 0) continue;
+        if ((double)weight[k] > target) continue;
+        if (best < 0 || weight[k] > weight[best]) best = k;
+    }
+    if (best < 0) return;
+
+    route[best].store((uint8_t)cold, std::memory_order_relaxed);
+    if (key == ShardKey::Channel) ReplayChannelState((uint8_t)best, cold);
+}
+
+// ── Render side ───────────────────────────────────────────────────────────────
+void ShardedSynth::RenderShard(Shard& s, uint32_t frames) {
+    {
+        std::lock_guard<std::mutex> lk(s.inboxMutex);
+        s.draining.swap(s.inbox);
+        s.longDraining.swap(s.longInbox);
+    }
+    for (uint32_t m : s.draining) {
+        if ((m & 0xFF) != kLongMarker) { s.synth->SendShort(m); continue; }
+        const size_t offset = m >> 8;
+        uint32_t len;
+        std::memcpy(&len, s.longDraining.data() + offset, sizeof(uint32_t));
+        s.synth->SendLong(s.longDraining.data() + offset + sizeof(uint32_t), len);
+    }
+    s.events.fetch_add(s.draining.size(), std::memory_order_relaxed);
+    s.draining.clear();
+    s.longDraining.clear();
+
+    if (s.buffer.size() < (size_t)frames * 2) s.buffer.resize((size_t)frames * 2);
+
+    auto t0 = std::chrono::steady_clock::now();
+    s.synth->Render(s.buffer.data(), frames);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    double prev = s.renderUs.load(std::memory_order_relaxed);
+    s.renderUs.store(prev == 0.0 ? us : prev * 0.9 + us * 0.1, std::memory_order_relaxed);
+    s.voices.store(s.synth->ActiveVoices(), std::memory_order_relaxed);
+}
+
+void ShardedSynth::WorkerLoop(Shard* s) {
+    uint64_t seen = 0;
+    while (true) {
+        uint32_t frames;
+        {
+            std::unique_lock<std::mutex> lk(jobMutex);
+            jobCV.wait(lk, [&]{ return stopWorkers || jobGeneration != seen; });
+            if (stopWorkers) return;
+            seen   = jobGeneration;
+            frames = jobFrames;
+        }
+        RenderShard(*s, frames);
+        {
+            std::lock_guard<std::mutex> lk(jobMutex);
+            if (--jobPending == 0) doneCV.notify_one();
+        }
+    }
+}
+
+void ShardedSynth::Render(float* stereo, uint32_t frames) {
+    const size_t n = shards.size();
+    if (!running.load(std::memory_order_acquire) || n == 0) {
+        std::memset(stereo, 0, (size_t)frames * 2 * sizeof(float));
+        return;
+    }
+
+    if (n > 1) {
+        {
+            std::lock_guard<std::mutex> lk(jobMutex);
+            jobFrames  = frames;
+            jobPending = (int)n - 1;
+            ++jobGeneration;
+        }
+        jobCV.notify_all();
+    }
+
+    RenderShard(*shards[0], frames);
+
+    if (n > 1) {
+        std::unique_lock<std::mutex> lk(jobMutex);
+        doneCV.wait(lk, [&]{ return jobPending == 0; });
+    }
+
+    std::memcpy(stereo, shards[0]->buffer.data(), (size_t)frames * 2 * sizeof(float));
+    for (size_t i = 1; i < n; ++i)
+        MixAddFloats(stereo, shards[i]->buffer.data(), (size_t)frames * 2);
+}
+
+std::vector<ShardStats> ShardedSynth::GetStats() const {
+    std::vector<ShardStats> out(shards.size());
+    const int keys = (key == ShardKey::Channel) ? 16 : kTrackBuckets;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        out[i].voices   = shards[i]->voices.load(std::memory_order_relaxed);
+        out[i].renderUs = shards[i]->renderUs.load(std::memory_order_relaxed);
+        out[i].events   = shards[i]->events.load(std::memory_order_relaxed);
+    }
+    for (int k = 0; k < keys; ++k) {
+        size_t s = route[k].load(std::memory_order_relaxed);
+        if (s < out.size()) out[s].routeKeys++;
+    }
+    return out;
+}
@@ -0,0 +1,117 @@
+#include "track_masks.hpp"
+
+TrackMasks g_TrackMasks;
+
+static inline void SetBit(std::atomic<uint64_t>* words, size_t i, bool on) {
+    const uint64_t bit = 1ull << (i & 63);
+    if (on) words[i >> 6].fetch_or(bit, std::memory_order_relaxed);
+    else    words[i >> 6].fetch_and(~bit, std::memory_order_relaxed);
+}
+
+void TrackMasks::Reset() {
+    for (auto& w : hiddenTracks) w.store(0, std::memory_order_relaxed);
+    for (auto& w : mutedTracks)  w.store(0, std::memory_order_relaxed);
+    for (auto& w : mutedNotes)   w.store(0, std::memory_order_relaxed);
+    hiddenChannels.store(0, std::memory_order_relaxed);
+    mutedChannels.store(0, std::memory_order_relaxed);
+    visibleEpoch.fetch_add(1, std::memory_order_release);
+    audibleEpoch.fetch_add(1, std::memory_order_release);
+    resetEpoch.fetch_add(1, std::memory_order_release);
+}
+
+// ── Visibility ────────────────────────────────────────────────────────────────
+void TrackMasks::SetTrackVisible(size_t t, bool visible) {
+    if (t >= kMaxTracks || TrackVisible(t) == visible) return;
+    SetBit(hiddenTracks, t, !visible);
+    visibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+void TrackMasks::SetChannelVisible(uint8_t ch, bool visible) {
+    if (ChannelVisible(ch) == visible) return;
+    uint16_t m = hiddenChannels.load(std::memory_order_relaxed);
+    m = visible ? (uint16_t)(m & ~(1u << (ch & 15))) : (uint16_t)(m | (1u << (ch & 15)));
+    hiddenChannels.store(m, std::memory_order_relaxed);
+    visibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+void TrackMasks::ShowAllTracks() {
+    for (auto& w : hiddenTracks) w.store(0, std::memory_order_relaxed);
+    hiddenChannels.store(0, std::memory_order_relaxed);
+    visibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+// ── Audibility ────────────────────────────────────────────────────────────────
+// A track's 16 channel bits are 16-aligned, so they always sit in one word.
+void TrackMasks::RebuildNoteWord(size_t t) {
+    const uint64_t bits  = TrackMuted(t) ? 0xFFFFull : (uint64_t)mutedChannels.load(std::memory_order_relaxed);
+    const size_t   i     = t << 4;
+    const uint64_t shift = i & 63;
+    auto& w = mutedNotes[i >> 6];
+    uint64_t v = w.load(std::memory_order_relaxed);
+    v = (v & ~(0xFFFFull << shift)) | (bits << shift);
+    w.store(v, std::memory_order_relaxed);
+}
+
+void TrackMasks::RebuildAllNoteWords() {
+    const uint64_t ch = mutedChannels.load(std::memory_order_relaxed);
+    const uint64_t rep = ch | (ch << 16) | (ch << 32) | (ch << 48);
+    for (size_t w = 0; w < kNoteWords; ++w) {
+        // Four tracks per word; fully muted tracks take all 16 of their bits
+        const uint64_t tm = (mutedTracks[w >> 4].load(std::memory_order_relaxed) >> ((w & 15) * 4)) & 0xFu;
+        uint64_t v = rep;
+        for (int k = 0; k < 4; ++k)
+            if ((tm >> k) & 1u) v |= 0xFFFFull << (16 * k);
+        mutedNotes[w].store(v, std::memory_order_relaxed);
+    }
+}
+
+void TrackMasks::SetTrackMuted(size_t t, bool muted) {
+    if (t >= kMaxTracks || TrackMuted(t) == muted) return;
+    SetBit(mutedTracks, t, muted);
+    RebuildNoteWord(t);
+    audibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+void TrackMasks::SetChannelMuted(uint8_t ch, bool muted) {
+    if (ChannelMuted(ch) == muted) return;
+    uint16_t m = mutedChannels.load(std::memory_order_relaxed);
+    m = muted ? (uint16_t)(m | (1u << (ch & 15))) : (uint16_t)(m & ~(1u << (ch & 15)));
+    mutedChannels.store(m, std::memory_order_relaxed);
+    RebuildAllNoteWords();
+    audibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+void TrackMasks::SoloTrack(size_t t, size_t trackCount) {
+    if (trackCount > kMaxTracks) trackCount = kMaxTracks;
+    for (size_t w = 0; w < kTrackWords; ++w) {
+        uint64_t v = 0;
+        for (size_t b = 0; b < 64; ++b) {
+            size_t idx = w * 64 + b;
+            if (idx < trackCount && idx != t) v |= 1ull << b;
+        }
+        mutedTracks[w].store(v, std::memory_order_relaxed);
+    }
+    RebuildAllNoteWords();
+    audibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+void TrackMasks::UnmuteAllTracks() {
+    for (auto& w : mutedTracks) w.store(0, std::memory_order_relaxed);
+    RebuildAllNoteWords();
+    audibleEpoch.fetch_add(1, std::memory_order_release);
+}
+
+bool TrackMasks::AnyMuted() const {
+    if (mutedChannels.load(std::memory_order_relaxed) != 0) return true;
+    for (const auto& w : mutedTracks)
+        if (w.load(std::memory_order_relaxed) != 0) return true;
+    return false;
+}
+
+std::vector<uint64_t> TrackMasks::MutedTrackWords() const {
+    size_t n = kTrackWords;
+    while (n > 0 && mutedTracks[n - 1].load(std::memory_order_relaxed) == 0) --n;
+    std::vector<uint64_t> out(n);
+    for (size_t i = 0; i < n; ++i) out[i] = mutedTracks[i].load(std::memory_order_relaxed);
+    return out;
+}
@@ -6,9 +6,30 @@
 #include "smtc_bridge.hpp"
 #include "bass_backend.hpp"       // BassMIDI pre-render engine + DispatchMidiOut
 #include "AudioConfigPanel.hpp"   // DrawAudioConfigPanel() / ToggleAudioConfigPanel()
+#include "EventFilterPanel.hpp"   // DrawEventFilterPanel()
+#include "TrackListPanel.hpp"     // DrawTrackListPanel()
+#include "CapturePanel.hpp"       // DrawCapturePanel() / g_FrameCapture
+#include "LibraryPanel.hpp"       // DrawLibraryPanel() / g_MidiLibrary (menu folder browser)
+#include "startup_tasks.hpp"      // g_Startup (deferred audio / asset init)
+#include "track_masks.hpp"
+#include "active_notes.hpp"      // ActiveNoteTracker (keyboard overlay)
+#include "cc_lanes.hpp"          // CCLaneIndex (CC lanes under the roll)
+#include "minimap.hpp"           // SongMinimap (whole-song overview strip)
+#include "note_window_index.hpp" // NoteWindowIndex (per-track window culling)
+#include "falling_notes.hpp"     // FallingNotesRenderer (ViewerType::FallingNotes)
+#include "particles.hpp"         // BgParticleField (instanced background particles)
+#include "note_time_columns.hpp" // NoteTimeColumns (time-domain scroll)
+#include "chunk_painter.hpp"     // PaintChunkRange, NoteAxis
+#include "song_share.hpp"        // g_SongShare (one parse, N windows)
+#include "load_telemetry.hpp"    // g_LoadTelemetry (per-stage load timings, load_log.jsonl)
+#include "frame_stats.hpp"       // g_FrameStats (frame-time percentiles, stutter log)
+#include "benchmark.hpp"         // g_Benchmark (--benchmark: scripted run, JSON report)
+#include "midi_watch.hpp"        // g_MidiWatch (--watch: reparse only the changed tracks)
+#include "event_splice.hpp"      // ReplaceRange (watch-mode window splices)
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 #include <random>
 #include <chrono>
 #include <map>
@@ -25,6 +46,7 @@
 #include <queue>
 #include <deque>
 #include <tuple>
+#include <bit>
 #include "raylib.h"
 #include "reasings.h"
 #include "icon_loader.hpp"
@@ -46,6 +68,7 @@ extern "C" {
     void TerminateKDMAPIStream();
     void SendDirectData(unsigned long data);
 }
+#ifdef _WIN32
 extern "C" {
     struct _PROCESS_MEMORY_COUNTERS_EX {
         unsigned long cb;
@@ -65,6 +88,7 @@ extern "C" {
     __declspec(dllimport) int __stdcall GetProcessMemoryInfo(void* Process, PROCESS_MEMORY_COUNTERS_EX* ppsmemCounters, unsigned long cb);
     __declspec(dllimport) void* __stdcall GetCurrentProcess();
 }
+#endif
 #define STRINGIFY(x) #x
 #define TOSTRING(x) STRINGIFY(x)
 struct MemoryUsage {
@@ -72,12 +96,16 @@ struct MemoryUsage {
     uint64_t privateUsageMB;
 };
 MemoryUsage GetMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc{};
     MemoryUsage result{};
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS_EX pmc{};
     if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
         result.workingSetMB   = pmc.WorkingSetSize / (1024 * 1024);
         result.privateUsageMB = pmc.PrivateUsage   / (1024 * 1024);
     }
+#else
+    result.workingSetMB = result.privateUsageMB = ProcessResidentBytes() / (1024 * 1024);
+#endif
     return result;
 }
 MemoryUsage MidiLoadUsage;
@@ -87,6 +115,10 @@ MidiOutputEngine g_AudioEngine;
 // Global state variables (static keyword removed)
 bool showGuide = true; // Toggle for guide
 bool showBeats = true; // Toggle for beats
+bool showKeyboard = false; // Toggle for keyboard overlay
+bool showCCLanes = false; // Toggle for CC lanes
+bool showMinimap = false; // Toggle for song minimap
+bool g_timeDomainScroll = false; // D key: scroll in real time instead of ticks
 bool showDebug = false; // Toggle for debug
 bool showPerformance = false; // Toggle for Performance
 bool showOptions = false;
@@ -105,7 +137,6 @@ float g_bgColorF[4] = { 0.031f, 0.031f, 0.031f, 1.0f }; // default: black
 Color g_backgroundColor = { 8, 8, 8, 255 };
 
 // ── Background Particle System ──────────────────────────
-struct BgParticle { float x, y, speedFactor, sizeFactor; };
 bool                    g_particleShow    = true;
 int                     g_particleCount   = 120;
 float                   g_particleSpeed   = 120.0f;  // px/sec at 120 BPM
@@ -113,7 +144,7 @@ bool                    g_particleBpm     = true;    // scale speed with live BP
 float                   g_particleSize    = 2.0f;
 float                   g_particleColorF[4] = { 1.0f, 1.0f, 1.0f, 0.25f };
 Color                   g_particleColor   = { 255, 255, 255, 64 };
-static std::vector<BgParticle> g_particles; // internal tracking remains static
+static BgParticleField  g_particles; // internal tracking remains static
 
 // ── Background Image ─────────────────────────────────────────────────
 bool        g_bgImageShow   = false;
@@ -162,7 +193,13 @@ float DWidth = 300.0f, DHeight = 125.0f;
 uint64_t noteCounter = 0, noteTotal = 0;
 static LoadProgress g_LoadProgress;
 static std::thread g_LoaderThread;
-static std::vector<CCEvent> g_loadedCCEvents;
+static SongMinimap g_Minimap;   // rebuilt asynchronously when g_paletteEpoch changes
+static uint32_t    g_minimapPaletteEpoch = 0;   // palette the current minimap build used
+static CCLaneIndex g_CCLanes;   // built from the loader's CCEvent list, which is then dropped
+static NoteWindowIndex      g_NoteWindow;     // built at load, feeds the falling-notes culling
+static NoteTimeColumns      g_NoteTimes;      // per-note start / end in time units (time-domain scroll)
+static FallingNotesRenderer g_FallingNotes;
+static uint32_t             g_fallingPaletteEpoch = UINT32_MAX;   // palette last uploaded to g_FallingNotes
 static std::vector<uint32_t> g_sortedNoteStartTicks;
 static std::vector<uint32_t> g_sortedNoteEndTicks;   // parallel sorted end-ticks for polyphony
 static uint32_t g_songLastTick = 0;    // max endTick across all notes — used for duration
@@ -170,11 +207,7 @@ extern uint32_t g_totalTicks;
 static double   g_songDurationSec = 0.0; // total song duration in seconds (computed once at load)
 
 // Tempo segment table for O(log M) tick→seconds. Built once at load time.
-struct VisualizerTempoSeg {
-    uint32_t tick;
-    double   accumSec;
-    double   usPerTick;
-};
+using VisualizerTempoSeg = TempoSeg;
 static std::vector<VisualizerTempoSeg> g_tempoSegs;
 static uint64_t g_currentNps  = 0;    // NPS at current tick (updated each frame)
 static uint64_t g_maxNps      = 0;    // peak NPS seen so far this file
@@ -183,6 +216,8 @@ static uint64_t g_maxNps      = 0;    // peak NPS seen so far this file
 static constexpr int   kNpsCellPx    = 10;       // fixed cell width in pixels
 static int             g_npsGridCells = 0;        // computed from bar width at load/resize
 static std::vector<float> g_npsGrid;              // normalized 0..1 per cell, dynamic size
+static std::vector<uint32_t> g_npsCounts;         // note starts per cell, kept for watch edits
+static double          g_npsCellSec = 0.0;        // cell length the counts were taken with
 static bool            g_npsGridReady = false;
 static int             g_npsGridBuiltWidth = 0;   // bar width used when grid was last built
 static uint64_t g_currentPoly = 0;    // polyphony at current tick
@@ -193,8 +228,10 @@ static uint64_t g_maxPoly     = 0;    // peak polyphony seen so far this file
 // ===================================================================
 
 static std::atomic<bool>  g_seekInvalidate{ false };
-static constexpr int      PIX_H     = 128;
+static constexpr int      PIX_H     = kChunkRows;
 static constexpr int      N_CHUNKS  = 4;   // 1 current + 3 ahead (matches diagram)
+static constexpr int      KEYBOARD_WIDTH = 48;   // keyboard overlay strip (Y key)
+static constexpr int      MINIMAP_HEIGHT = 48;   // song minimap strip (N key)
 
 static Texture2D             g_tex        = { 0 };
 static int                   g_texW       = 0;   // = N_CHUNKS * screenWidth
@@ -207,19 +244,32 @@ static std::vector<uint32_t> g_pixBuf;             // [PIX_H rows][g_texW cols]
 // g_chunkPainted[c] = true means chunk c is valid for the current g_bufOriginTick
 static bool     g_chunkPainted[N_CHUNKS]    = {};
 static uint32_t g_chunkOriginTick[N_CHUNKS] = {};  
+// Painted from a sampled subset of notes (progressive pass after a seek);
+// shown, but still queued for the exact paint.
+static bool     g_chunkCoarse[N_CHUNKS]     = {};
+
+// Progressive refinement: right after a seek the main thread paints the
+// visible chunks from at most kCoarseNotes notes (every Nth note of each
+// track) and uploads them, so a picture is up on the same frame. The bg
+// thread then repaints them exactly. Uploads are per chunk and, apart from
+// the visible chunks, limited to kUploadBudgetMs per frame.
+static constexpr uint64_t kCoarseNotes    = 60000;
+static constexpr double   kUploadBudgetMs = 2.0;
+static std::atomic<uint32_t> g_dirtyChunks{ 0 };   // bit c: chunk c changed since its last upload
+static std::vector<uint32_t> g_uploadStage;        // one chunk, packed for UpdateTextureRec
 
 // Background thread paints one chunk at a time
 static std::thread              g_paintThread;
 static std::atomic<bool>        g_paintStop{ false };
 static std::mutex               g_paintMtx;
 static std::condition_variable  g_paintCV;
-struct ChunkJob { int chunkIdx; uint32_t tickStart; }; // ONLY DECLARE THIS ONCE!
+struct ChunkJob { int chunkIdx; uint32_t tickStart; std::chrono::steady_clock::time_point queuedAt; }; // ONLY DECLARE THIS ONCE!
 static std::queue<ChunkJob>     g_paintQueue;
-static std::atomic<int>         g_lastPaintedChunk{ -1 };
 
 // Track data (read-only after load, shared with bg thread safely)
 static const std::vector<OptimizedTrackData>* g_tracks      = nullptr;
 static ViewerType                              g_bgViewerType = ViewerType::ChannelTrackLayer;
+static const NoteTimeColumns*                  g_bgTimes      = nullptr;   // non-null: painter axis is time units
 
 static bool     g_rtNeedsFullRedraw = true;
 static uint32_t g_ticksPerChunk     = 0;  // ticks that fit in one chunk width (integer approx)
@@ -231,10 +281,8 @@ static inline uint32_t ExactChunkOrigin(uint32_t bufOrigin, int c) {
 }
 
 // ---- helpers ---------------------------------------------------------------
-static inline uint32_t ToRGBA8(Color c) {
-    return (uint32_t)c.r | ((uint32_t)c.g << 8) | ((uint32_t)c.b << 16) | (0xFFu << 24);
-}
 inline Color GetTrackColorPFA(int track, int channel);
+static ChunkPaintContext PainterContext();   // defined after the colour table
 
 static std::atomic<bool> g_paintBusy{ false };
 static std::atomic<bool> g_paintCancel{ false };
@@ -247,157 +295,19 @@ static std::atomic<bool> g_paintCancel{ false };
 
 static uint64_t g_windowOffsetChunks = 0;
 
-static void PaintChunkRange(int chunkIdx, uint32_t tickStart, uint32_t tickEnd)
+static inline NoteAxis AxisFor(size_t t) {
+    return NoteAxis::For(*g_tracks, g_bgTimes, t);
+}
+
+// Paints one chunk-wide range into `out` (PIX_H rows, `outStride` pixels apart)
+// from the current globals; see chunk_painter.hpp.
+static void PaintChunk(uint32_t tickStart, uint32_t tickEnd, uint32_t* out, size_t outStride, uint32_t stride = 1)
 {
     if (!g_tracks || g_texW == 0 || tickEnd <= tickStart) return;
-    const int    W    = g_chunkW;
-    const int    base = chunkIdx * W;
-    const double ppt  = g_pixPerTick;
-
-    // Clear chunk
-    for (int y = 0; y < PIX_H; ++y)
-        std::memset(&g_pixBuf[(size_t)y * g_texW + base], 0, (size_t)W * sizeof(uint32_t));
-
-    uint64_t count = 0;
-
-    if (g_bgViewerType == ViewerType::TickLayer) {
-        struct NoteRef {
-            const NoteEvent* note;
-            uint16_t trackIdx;
-        };
-        
-        thread_local std::vector<NoteRef> chunkNotes;
-        chunkNotes.clear();
-        
-        if (chunkNotes.capacity() < 2000000) chunkNotes.reserve(2000000); 
-
-        for (size_t t = 0; t < g_tracks->size(); ++t) {
-            if (g_paintCancel.load(std::memory_order_relaxed)) return;
-            const auto& track = (*g_tracks)[t];
-            if (track.notes.empty()) continue;
-
-            auto it = std::lower_bound(track.notes.begin(), track.notes.end(), tickStart,
-                [](const NoteEvent& n, uint32_t v){ return n.startTick < v; });
-
-            auto ri = it;
-            while (ri != track.notes.begin()) {
-                --ri;
-                if (ri->endTick <= tickStart) { ++ri; break; }
-            }
-
-            for (; ri != track.notes.end() && ri->startTick < tickEnd; ++ri) {
-                const NoteEvent& n = *ri;
-                uint32_t rawEnd = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
-                uint32_t ds = (n.startTick > tickStart) ? n.startTick : tickStart;
-                uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
-                if (ds >= de) continue;
-
-                int px0 = (int)((double)(ds - tickStart) * ppt);
-                int px1 = (int)((double)(de - tickStart) * ppt) + 1;
-                if (px0 < 0)  px0 = 0;
-                if (px1 > W)  px1 = W;
-                if (px0 >= px1) continue;
-
-                int y = (PIX_H - 1) - (int)n.note;
-                if ((unsigned)y >= (unsigned)PIX_H) continue;
-
-                chunkNotes.push_back({&n, (uint16_t)t});
-            }
-        }
-
-        // Lux's fix: merge all tracks into one array, sort by startTick ascending,
-        // then draw in REVERSE (latest tick first = background, earliest tick last = foreground).
-        // "First note played = on top" — matches PFA layering behavior exactly.
-        // if (row[px] == 0) guard means first writer wins = earliest tick wins each pixel.
-        std::sort(chunkNotes.begin(), chunkNotes.end(), [](const NoteRef& a, const NoteRef& b){
-            if (a.note->startTick != b.note->startTick) return a.note->startTick < b.note->startTick;
-            return a.trackIdx < b.trackIdx; // same tick: track 0 drawn last = on top
-        });
-
-        for (int i = (int)chunkNotes.size() - 1; i >= 0; --i) {
-            if (g_paintCancel.load(std::memory_order_relaxed)) return;
-            const auto& ref = chunkNotes[i];
-            const NoteEvent& n = *ref.note;
-            uint32_t rawEnd = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
-            uint32_t ds = (n.startTick > tickStart) ? n.startTick : tickStart;
-            uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
-            if (ds >= de) continue;
-
-            int px0 = (int)((double)(ds - tickStart) * ppt);
-            int px1 = (int)((double)(de - tickStart) * ppt) + 1;
-            if (px0 < 0)  px0 = 0;
-            if (px1 > W)  px1 = W;
-            if (px0 >= px1) continue;
-
-            int y = (PIX_H - 1) - (int)n.note;
-            if ((unsigned)y >= (unsigned)PIX_H) continue;
-
-            Color col = GetTrackColorPFA(ref.trackIdx, n.channel);
-            uint32_t rgba = ToRGBA8(col);
-            uint32_t* row = g_pixBuf.data() + (size_t)y * g_texW + base;
-            
-            ++count;
-            for (int px = px0; px < px1; ++px) {
-                if (row[px] == 0) row[px] = rgba;
-            }
-        }
-    } else {
-        // Exact duplicate culling is safe here: ChannelTrackLayer draws directly
-        // in reverse order (track N-1 first), so the sort order is already correct.
-        struct LastNote { int px0; int px1; uint8_t channel; };
-
-        for (int t = (int)g_tracks->size() - 1; t >= 0; --t) {
-            if (g_paintCancel.load(std::memory_order_relaxed)) return;
-            const auto& track = (*g_tracks)[t];
-            if (track.notes.empty()) continue;
-
-            auto it = std::lower_bound(track.notes.begin(), track.notes.end(), tickStart,
-                [](const NoteEvent& n, uint32_t v){ return n.startTick < v; });
-
-            auto ri_start = it;
-            while (ri_start != track.notes.begin()) {
-                --ri_start;
-                if (ri_start->endTick <= tickStart) { ++ri_start; break; }
-            }
-            
-            auto ri_end = ri_start;
-            while (ri_end != track.notes.end() && ri_end->startTick < tickEnd) {
-                ++ri_end;
-            }
-
-            if (ri_start == ri_end) continue;
-
-            auto ri = ri_end;
-            do {
-                --ri;
-                const NoteEvent& n = *ri;
-                uint32_t rawEnd = (n.endTick > n.startTick) ? n.endTick : n.startTick + 1;
-                uint32_t ds = (n.startTick > tickStart) ? n.startTick : tickStart;
-                uint32_t de = (rawEnd < tickEnd)        ? rawEnd      : tickEnd;
-                if (ds >= de) continue;
-
-                int px0 = (int)((double)(ds - tickStart) * ppt);
-                int px1 = (int)((double)(de - tickStart) * ppt) + 1;
-                if (px0 < 0)  px0 = 0;
-                if (px1 > W)  px1 = W;
-                if (px0 >= px1) continue;
-
-                int y = (PIX_H - 1) - (int)n.note;
-                if ((unsigned)y >= (unsigned)PIX_H) continue;
-                Color col = GetTrackColorPFA((int)t, n.channel);
-                uint32_t rgba = ToRGBA8(col);
-                uint32_t* row = g_pixBuf.data() + (size_t)y * g_texW + base;
-                
-                ++count;
-				for (int px = px0; px < px1; ++px) {
-					if (row[px] == 0) row[px] = rgba; // already-painted pixel = skip, not black hole
-				}
-            } while (ri != ri_start);
-        }
-    }
-
+    const uint64_t count = PaintChunkRange(PainterContext(), tickStart, tickEnd, out, outStride, stride);
+    if (g_paintCancel.load(std::memory_order_relaxed)) return;
     renderNotes = count;
-    maxRenderNotes = std::max(maxRenderNotes, (uint64_t)count);
+    maxRenderNotes = std::max(maxRenderNotes, count);
 }
 
 static void BgPaintThreadFunc()
@@ -416,14 +326,24 @@ static void BgPaintThreadFunc()
         g_paintBusy.store(true, std::memory_order_seq_cst);
         g_paintCancel.store(false, std::memory_order_seq_cst);
 
+        // Paint off to the side so a coarse chunk stays on screen (and in
+        // uploads) until its exact replacement is complete
+        thread_local std::vector<uint32_t> scratch;
+        const int W = g_chunkW;
+        scratch.resize((size_t)W * PIX_H);
         uint32_t te = job.tickStart + g_ticksPerChunk;
-        PaintChunkRange(job.chunkIdx, job.tickStart, te);
+        PaintChunk(job.tickStart, te, scratch.data(), (size_t)W);
 
-        // Only mark as painted if the job wasn't cancelled mid-way.
+        // Only publish if the job wasn't cancelled mid-way.
         // A cancelled chunk has partial/corrupt data — don't expose it.
         if (!g_paintCancel.load(std::memory_order_acquire)) {
+            uint32_t* dst = g_pixBuf.data() + (size_t)job.chunkIdx * W;
+            for (int y = 0; y < PIX_H; ++y)
+                std::memcpy(dst + (size_t)y * g_texW, scratch.data() + (size_t)y * W, (size_t)W * sizeof(uint32_t));
             g_chunkPainted[job.chunkIdx] = true;
-            g_lastPaintedChunk.store(job.chunkIdx, std::memory_order_release);
+            g_chunkCoarse[job.chunkIdx]  = false;
+            g_dirtyChunks.fetch_or(1u << job.chunkIdx, std::memory_order_release);
+            g_Benchmark.RecordPaintLatency(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - job.queuedAt).count());
         }
         g_paintBusy.store(false, std::memory_order_release);
     }
@@ -436,10 +356,66 @@ static void EnqueueChunk(int chunkIdx, uint32_t tickStart, bool clearQueue = fal
     if (clearQueue) {
         while (!g_paintQueue.empty()) g_paintQueue.pop();
     }
-    g_paintQueue.push({ chunkIdx, tickStart });
+    g_paintQueue.push({ chunkIdx, tickStart, std::chrono::steady_clock::now() });
     g_paintCV.notify_one();
 }
 
+static void UploadChunk(int c)
+{
+    const int W = g_chunkW;
+    g_uploadStage.resize((size_t)W * PIX_H);
+    const uint32_t* src = g_pixBuf.data() + (size_t)c * W;
+    for (int y = 0; y < PIX_H; ++y)
+        std::memcpy(g_uploadStage.data() + (size_t)y * W, src + (size_t)y * g_texW, (size_t)W * sizeof(uint32_t));
+    UpdateTextureRec(g_tex, { (float)(c * W), 0.f, (float)W, (float)PIX_H }, g_uploadStage.data());
+}
+
+// Visible chunks are always uploaded; the others wait for budget (next frame).
+static void UploadDirtyChunks(int firstVisible, int lastVisible)
+{
+    uint32_t dirty = g_dirtyChunks.exchange(0, std::memory_order_acquire);
+    if (dirty == 0) return;
+    g_FrameStats.Mark(FrameEvent::TextureUpload);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int c = firstVisible; c <= lastVisible; ++c) {
+        if (dirty & (1u << c)) { UploadChunk(c); dirty &= ~(1u << c); }
+    }
+    for (int c = 0; c < N_CHUNKS && dirty; ++c) {
+        if (!(dirty & (1u << c))) continue;
+        if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count() >= kUploadBudgetMs) break;
+        UploadChunk(c);
+        dirty &= ~(1u << c);
+    }
+    if (dirty) g_dirtyChunks.fetch_or(dirty, std::memory_order_release);
+}
+
+// Main thread, bg painter idle. Paints the visible chunks from a sampled
+// subset of notes; when the window is small enough the pass is already exact
+// and the chunk needs no bg job.
+static void PaintVisibleCoarse(int firstVisible, int lastVisible)
+{
+    for (int c = firstVisible; c <= lastVisible; ++c) {
+        const uint32_t ts = g_chunkOriginTick[c];
+        const uint32_t te = ts + g_ticksPerChunk;
+        uint64_t inWindow = 0;
+        for (size_t t = 0; t < g_tracks->size(); ++t) {
+            const auto& notes = (*g_tracks)[t].notes;
+            if (notes.empty() || !g_TrackMasks.TrackVisible(t)) continue;
+            const NoteAxis ax = AxisFor(t);
+            auto lo = std::lower_bound(notes.begin(), notes.end(), ts,
+                [&ax](const NoteEvent& n, uint32_t v){ return ax.Start(n) < v; });
+            auto hi = std::lower_bound(lo, notes.end(), te,
+                [&ax](const NoteEvent& n, uint32_t v){ return ax.Start(n) < v; });
+            inWindow += (uint64_t)(hi - lo);
+        }
+        const uint32_t stride = (uint32_t)std::max<uint64_t>(1, (inWindow + kCoarseNotes - 1) / kCoarseNotes);
+        PaintChunk(ts, te, g_pixBuf.data() + (size_t)c * g_chunkW, (size_t)g_texW, stride);
+        g_chunkPainted[c] = true;
+        g_chunkCoarse[c]  = (stride > 1);
+        g_dirtyChunks.fetch_or(1u << c, std::memory_order_release);
+    }
+}
+
 // ===================================================================
 // SCROLL VISUALIZER — chunk sliding-window, bg thread, no limits
 // ===================================================================
@@ -467,9 +443,39 @@ void StopNoteRenderThread() {
     g_tracks = nullptr;
 }
 
+// Re-anchors the chunk window at leftTick after a seek or when the view left
+// the buffer. Caller has drained the queue and waited for the bg painter.
+static void RestartChunkWindow(uint64_t leftTick, int64_t sRight)
+{
+    g_FrameStats.Mark(FrameEvent::WindowRestart);
+    g_windowOffsetChunks = 0;
+    g_bufOriginTick = (uint32_t)((leftTick / g_ticksPerChunk) * g_ticksPerChunk);
+    int firstVisible = 0, lastVisible = 0;
+    for (int i = 0; i < N_CHUNKS; ++i) {
+        g_chunkPainted[i] = false;
+        g_chunkCoarse[i]  = false;
+        g_chunkOriginTick[i] = ExactChunkOrigin(g_bufOriginTick, i);
+        if (g_chunkOriginTick[i] <= leftTick) firstVisible = i;
+        if ((int64_t)g_chunkOriginTick[i] < sRight) lastVisible = i;
+    }
+    lastVisible = std::max(firstVisible, lastVisible);
+
+    g_paintCancel.store(false, std::memory_order_release);
+
+    // Nothing stale survives: off-screen chunks are cleared, visible ones get
+    // the coarse pass, and all of them are uploaded as budget allows
+    std::memset(g_pixBuf.data(), 0, g_pixBuf.size() * sizeof(uint32_t));
+    g_dirtyChunks.store((1u << N_CHUNKS) - 1, std::memory_order_release);
+    PaintVisibleCoarse(firstVisible, lastVisible);
+
+    for (int c = firstVisible; c < N_CHUNKS; ++c) {
+        if (!g_chunkPainted[c] || g_chunkCoarse[c]) EnqueueChunk(c, g_chunkOriginTick[c], false);
+    }
+}
+
 void DrawStreamingVisualizerNotes(
     const std::vector<OptimizedTrackData>& tracks,
-    uint64_t currentTick, int ppq, uint32_t currentTempo,
+    uint64_t songTick, int ppq, uint32_t currentTempo,
     ViewerType viewerType)
 {
     const int   sw = GetScreenWidth();
@@ -480,10 +486,16 @@ void DrawStreamingVisualizerNotes(
     ticksPerBeat = (ppq * 4) / timeSigDenominator;
     ticksPerMeasure = (ppq * 4 * timeSigNumerator) / timeSigDenominator;
 
+    // Time-domain scroll: everything below (chunks, window, blit) runs on the
+    // NoteTimeColumns axis, so "ticks" in this function are time units.
+    const NoteTimeColumns* times = (g_timeDomainScroll && g_NoteTimes.IsBuiltFor(tracks)) ? &g_NoteTimes : nullptr;
+    const uint64_t currentTick = times ? times->TickToUnits(songTick) : songTick;
+
     double uspt = MidiTiming::CalculateMicrosecondsPerTick(
         MidiTiming::DEFAULT_TEMPO_MICROSECONDS, ppq);
-    const uint32_t viewWindow = std::max(1U,
-        static_cast<uint32_t>((ScrollSpeed * 1500000.0) / uspt));
+    const uint32_t viewWindow = times
+        ? std::max(1U, static_cast<uint32_t>(ScrollSpeed * 1.5 * NoteTimeColumns::kUnitsPerSecond))
+        : std::max(1U, static_cast<uint32_t>((ScrollSpeed * 1500000.0) / uspt));
     const float  plx = (float)sw * 0.5f;
     const double ppt = (double)(sw - plx) / (double)viewWindow;
 
@@ -509,12 +521,16 @@ void DrawStreamingVisualizerNotes(
         img.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
         g_tex = LoadTextureFromImage(img);
         SetTextureFilter(g_tex, TEXTURE_FILTER_POINT);
-        for (int i = 0; i < N_CHUNKS; ++i) g_chunkPainted[i] = false;
+        for (int i = 0; i < N_CHUNKS; ++i) g_chunkPainted[i] = g_chunkCoarse[i] = false;
         g_rtNeedsFullRedraw = true;
     }
 
     g_tracks = &tracks;
     g_bgViewerType = viewerType;
+    if (g_bgTimes != times) {   // axis switched without an invalidate (e.g. columns just built)
+        g_bgTimes = times;
+        g_rtNeedsFullRedraw = true;
+    }
 
     // Visible tick window
     int64_t  sLeft = (int64_t)currentTick - (int64_t)(plx / ppt);
@@ -539,38 +555,11 @@ void DrawStreamingVisualizerNotes(
             std::this_thread::yield();
         }
 
-        g_windowOffsetChunks = 0;
-        g_bufOriginTick = (leftTick / g_ticksPerChunk) * g_ticksPerChunk;
-        for (int i = 0; i < N_CHUNKS; ++i) {
-            g_chunkPainted[i] = false;
-            g_chunkOriginTick[i] = ExactChunkOrigin(g_bufOriginTick, i);
-        }
-        int visibleChunk = 0;
-        for (int c = 0; c < N_CHUNKS; ++c) {
-            if (g_chunkOriginTick[c] <= leftTick) visibleChunk = c;
-            else break;
-        }
-
-        // 3. Reset cancel flag
-        g_paintCancel.store(false, std::memory_order_release);
-
-        // 4. Blackout texture immediately on main thread so we don't show old garbage
-        std::memset(g_pixBuf.data(), 0, g_pixBuf.size() * sizeof(uint32_t));
-        UpdateTexture(g_tex, g_pixBuf.data());
-
-        // 5. Enqueue all chunks asynchronously! 
-        EnqueueChunk(visibleChunk, g_chunkOriginTick[visibleChunk], false);
-        for (int nc = visibleChunk + 1; nc < N_CHUNKS; ++nc) {
-            EnqueueChunk(nc, g_chunkOriginTick[nc], false);
-        }
+        // 3. Coarse picture now, exact chunks from the bg thread
+        RestartChunkWindow(leftTick, sRight);
     }
     else {
-        // ---- Normal streaming: check if bg thread finished a chunk, upload ----
-        int lp = g_lastPaintedChunk.exchange(-1, std::memory_order_acquire);
-        if (lp >= 0) {
-            UpdateTexture(g_tex, g_pixBuf.data());
-        }
-
+        // ---- Normal streaming: finished chunks are uploaded below, before the blit ----
         // SLIDING WINDOW SHIFT - Smooth scrolling without panicking!
         // We shift when chunk 0 is entirely offscreen (leftTick >= chunkOriginTick[1])
         if (leftTick >= g_chunkOriginTick[1]) {
@@ -589,21 +578,25 @@ void DrawStreamingVisualizerNotes(
             }
 
             // Shift chunk metadata tracking
+            g_FrameStats.Mark(FrameEvent::ChunkSlide);
             g_windowOffsetChunks++;
             for (int i = 0; i < N_CHUNKS - 1; ++i) {
                 g_chunkOriginTick[i] = g_chunkOriginTick[i + 1];
                 g_chunkPainted[i] = g_chunkPainted[i + 1];
+                g_chunkCoarse[i]  = g_chunkCoarse[i + 1];
             }
             // Prepare new chunk N_CHUNKS-1
             g_chunkOriginTick[N_CHUNKS - 1] = ExactChunkOrigin(g_bufOriginTick, g_windowOffsetChunks + N_CHUNKS - 1);
             g_chunkPainted[N_CHUNKS - 1] = false;
+            g_chunkCoarse[N_CHUNKS - 1]  = false;
 
-            UpdateTexture(g_tex, g_pixBuf.data());
+            // Every chunk moved; the visible ones go up this frame, the rest within budget
+            g_dirtyChunks.store((1u << N_CHUNKS) - 1, std::memory_order_release);
 
-            // Enqueue all unpainted chunks (in case they were cancelled mid-paint)
+            // Enqueue all unpainted or coarse chunks (in case they were cancelled mid-paint)
             g_paintCancel.store(false, std::memory_order_release);
             for (int c = 0; c < N_CHUNKS; ++c) {
-                if (!g_chunkPainted[c]) {
+                if (!g_chunkPainted[c] || g_chunkCoarse[c]) {
                     EnqueueChunk(c, g_chunkOriginTick[c], false);
                 }
             }
@@ -620,32 +613,23 @@ void DrawStreamingVisualizerNotes(
                 g_paintCancel.store(true, std::memory_order_release);
                 while (g_paintBusy.load(std::memory_order_acquire)) { std::this_thread::yield(); }
 
-                g_windowOffsetChunks = 0;
-                g_bufOriginTick = (leftTick / g_ticksPerChunk) * g_ticksPerChunk;
-                for (int i = 0; i < N_CHUNKS; ++i) {
-                    g_chunkPainted[i] = false;
-                    g_chunkOriginTick[i] = ExactChunkOrigin(g_bufOriginTick, i);
-                }
-                int vc = 0;
-                for (int c = 0; c < N_CHUNKS; ++c) {
-                    if (g_chunkOriginTick[c] <= leftTick) vc = c;
-                    else break;
-                }
-
-                g_paintCancel.store(false, std::memory_order_release);
-                
-                // PREVENT JUMPSCARE (wipe screen cleanly instead of jumping old buffer)
-                std::memset(g_pixBuf.data(), 0, g_pixBuf.size() * sizeof(uint32_t));
-                UpdateTexture(g_tex, g_pixBuf.data());
-
-                EnqueueChunk(vc, g_chunkOriginTick[vc], false);
-                for (int nc = vc + 1; nc < N_CHUNKS; ++nc) {
-                    EnqueueChunk(nc, g_chunkOriginTick[nc], false);
-                }
+                // PREVENT JUMPSCARE (rebuild cleanly instead of jumping old buffer)
+                RestartChunkWindow(leftTick, sRight);
             }
         }
     }
 
+    // ---- Upload changed chunks (visible first, rest within budget) ----
+    {
+        const int64_t vl = std::max<int64_t>(0, sLeft);
+        int firstVisible = 0, lastVisible = 0;
+        for (int c = 0; c < N_CHUNKS; ++c) {
+            if ((int64_t)g_chunkOriginTick[c] <= vl) firstVisible = c;
+            if ((int64_t)g_chunkOriginTick[c] < sRight) lastVisible = c;
+        }
+        UploadDirtyChunks(firstVisible, std::max(firstVisible, lastVisible));
+    }
+
     // ---- Blit ----
     {
         float dstX = (sLeft < 0) ? (float)(-(double)sLeft * ppt) : 0.f;
@@ -701,13 +685,17 @@ void DrawStreamingVisualizerNotes(
     if (showBeats) {
         uint64_t tpm = (ppq * 4 * timeSigNumerator) / timeSigDenominator;
         uint64_t tpb = (ppq * 4) / timeSigDenominator;
+        // Beats live on the tick grid; map the window back to ticks in time-domain mode
         uint64_t le = (uint64_t)std::max((int64_t)0, sLeft);
+        uint64_t re = (uint64_t)std::max((int64_t)0, sRight);
+        if (times) { le = times->UnitsToTick(le); re = times->UnitsToTick(re) + 1; }
         uint64_t fm = (le / tpm) * tpm;
-        for (uint64_t mTick = fm; mTick <= (uint64_t)sRight; mTick += tpm) {
+        for (uint64_t mTick = fm; mTick <= re; mTick += tpm) {
             for (int i = 0; i < timeSigNumerator; ++i) {
                 uint64_t bTick = mTick + (uint64_t)(i * tpb);
                 if (bTick < le) continue;
-                float bx = plx + (float)((int64_t)bTick - (int64_t)currentTick) * (float)ppt;
+                const uint64_t bPos = times ? times->TickToUnits(bTick) : bTick;
+                float bx = plx + (float)((int64_t)bPos - (int64_t)currentTick) * (float)ppt;
                 if (bx < -1.f || bx > sw + 1.f) continue;
                 Color c = (i == 0) ? Color{ 255,255,255,40 } : Color{ 255,255,255,20 };
                 DrawRectangleRec({ bx, top, 1.f, uh }, c);
@@ -723,8 +711,9 @@ void DrawStreamingVisualizerNotes(
             if (ny < top || ny > sh - bot) continue;
             Color lc = (key == 60) ? Color{ 255,255,128,64 } : Color{ 128,128,128,64 };
             DrawLine(0, (int)ny, sw, (int)ny, lc);
-            if (key == 60) DrawText("C4", 5, (int)ny - 10, 10, Color{ 255,255,128,192 });
-            else DrawText(TextFormat("C%d", (key / 12) - 1), 5, (int)ny - 10, 10, Color{ 255,255,255,128 });
+            const int lx = showKeyboard ? KEYBOARD_WIDTH + 5 : 5;
+            if (key == 60) DrawText("C4", lx, (int)ny - 10, 10, Color{ 255,255,128,192 });
+            else DrawText(TextFormat("C%d", (key / 12) - 1), lx, (int)ny - 10, 10, Color{ 255,255,255,128 });
         }
     }
 
@@ -734,6 +723,179 @@ void DrawStreamingVisualizerNotes(
     DrawLine(0, sh - (int)bot, sw, sh - (int)bot, GRAY);
 }
 
+// ---- Falling notes (ViewerType::FallingNotes) ----
+// Vertical roll: keys left → right, notes fall onto the playhead at the bottom.
+// Notes are one instanced draw (FallingNotesRenderer); guides / beats are drawn
+// here with the same look as the horizontal viewers.
+void DrawFallingNotes(const std::vector<OptimizedTrackData>& tracks, uint64_t currentTick, int ppq)
+{
+    const int   sw = GetScreenWidth();
+    const int   sh = GetScreenHeight();
+    const float top = 30.f, bot = 30.f;
+    const float uh = (float)sh - top - bot;
+
+    ticksPerBeat = (ppq * 4) / timeSigDenominator;
+    ticksPerMeasure = (ppq * 4 * timeSigNumerator) / timeSigDenominator;
+
+    // Same time scale as the horizontal viewers: ScrollSpeed * 1.5 s at 120 BPM
+    double uspt = MidiTiming::CalculateMicrosecondsPerTick(
+        MidiTiming::DEFAULT_TEMPO_MICROSECONDS, ppq);
+    const uint32_t viewWindow = std::max(1U,
+        static_cast<uint32_t>((ScrollSpeed * 1500000.0) / uspt));
+    const double ppt = (double)uh / (double)viewWindow;
+    const float  kw  = (float)sw / 128.f;
+
+    g_FallingNotes.Draw(tracks, g_NoteWindow, currentTick, viewWindow, { 0.f, top, (float)sw, uh });
+    renderNotes = g_FallingNotes.LastInstanceCount();
+    if (renderNotes > maxRenderNotes) maxRenderNotes = renderNotes;
+
+    // ---- Beat lines ----
+    if (showBeats) {
+        uint64_t tpm = (ppq * 4 * timeSigNumerator) / timeSigDenominator;
+        uint64_t tpb = (ppq * 4) / timeSigDenominator;
+        uint64_t fm = (currentTick / tpm) * tpm;
+        for (uint64_t mTick = fm; mTick <= currentTick + viewWindow; mTick += tpm) {
+            for (int i = 0; i < timeSigNumerator; ++i) {
+                uint64_t bTick = mTick + (uint64_t)(i * tpb);
+                if (bTick < currentTick) continue;
+                float by = (float)sh - bot - (float)((double)(bTick - currentTick) * ppt);
+                if (by < top) break;
+                Color c = (i == 0) ? Color{ 255,255,255,40 } : Color{ 255,255,255,20 };
+                DrawRectangleRec({ 0.f, by, (float)sw, 1.f }, c);
+            }
+        }
+    }
+
+    // ---- Guide lines ----
+    if (showGuide) {
+        const uint8_t keys[] = { 0,12,24,36,48,60,72,84,96,108,120 };
+        for (uint8_t key : keys) {
+            const int nx = (int)((float)key * kw);
+            Color lc = (key == 60) ? Color{ 255,255,128,64 } : Color{ 128,128,128,64 };
+            DrawLine(nx, (int)top, nx, sh - (int)bot, lc);
+            if (key == 60) DrawText("C4", nx + 3, (int)top + 4, 10, Color{ 255,255,128,192 });
+            else DrawText(TextFormat("C%d", (key / 12) - 1), nx + 3, (int)top + 4, 10, Color{ 255,255,255,128 });
+        }
+    }
+
+    // ---- Playhead + borders ----
+    DrawLine(0, sh - (int)bot, sw, sh - (int)bot, RED);
+    DrawLine(0, (int)top, sw, (int)top, GRAY);
+}
+
+// ---- CC lanes ----
+// Stacked bands at the bottom of the roll, one per controller that has data,
+// one polyline per channel. Chunks follow g_ticksPerChunk so a polyline is
+// rebuilt only when a new chunk scrolls into view.
+void DrawCCLanes(uint64_t currentTick)
+{
+    if (g_CCLanes.Empty() || g_ticksPerChunk == 0 || g_pixPerTick <= 0.0) return;
+
+    const int   sw = GetScreenWidth();
+    const int   sh = GetScreenHeight();
+    const float top = 30.f, bot = 30.f;
+    const float uh = (float)sh - top - bot;
+    const float laneH = std::clamp(uh * 0.08f, 24.f, 48.f);
+    const float plx = (float)sw * 0.5f;
+    const double ppt = g_pixPerTick;
+
+    // g_pixPerTick is per time unit in time-domain mode; CC polylines stay in
+    // ticks (g_ticksPerChunk is only the cache granularity) and are mapped per point.
+    const NoteTimeColumns* times = g_bgTimes;
+    const uint64_t curPos = times ? times->TickToUnits(currentTick) : currentTick;
+    int64_t sLeft  = (int64_t)curPos - (int64_t)(plx / ppt);
+    int64_t sRight = (int64_t)curPos + (int64_t)((sw - plx) / ppt) + 1;
+    if (times) {
+        sLeft  = (int64_t)times->UnitsToTick((uint64_t)std::max<int64_t>(0, sLeft));
+        sRight = (int64_t)times->UnitsToTick((uint64_t)std::max<int64_t>(0, sRight)) + 1;
+    }
+    // Tick-axis chunk size: the painter's in tick mode, else the visible tick
+    // span rounded up to a power of two (only changes across big tempo swings)
+    const uint32_t chunkTicks = times
+        ? std::bit_ceil((uint32_t)std::clamp<int64_t>(sRight - sLeft, 1, INT32_MAX))
+        : g_ticksPerChunk;
+    const uint64_t firstChunk = (uint64_t)std::max<int64_t>(0, sLeft) / chunkTicks;
+    const uint64_t lastChunk  = (uint64_t)std::max<int64_t>(0, sRight) / chunkTicks;
+
+    static std::vector<Vector2> s_strip;
+    float bandBottom = (float)sh - bot - (showMinimap ? (float)MINIMAP_HEIGHT + 8.f : 0.f);
+    for (int l = CC_LANE_COUNT - 1; l >= 0; --l) {
+        const CCLane lane = (CCLane)l;
+        if (!g_CCLanes.LaneHasData(lane)) continue;
+        const float bandTop = bandBottom - laneH;
+        if (bandTop < top) break;
+
+        DrawRectangle(0, (int)bandTop, sw, (int)laneH, Color{ 0,0,0,140 });
+        DrawLine(0, (int)bandTop, sw, (int)bandTop, Color{ 128,128,128,96 });
+
+        for (uint8_t ch = 0; ch < 16; ++ch) {
+            if (!g_CCLanes.HasData(lane, ch) || !g_TrackMasks.ChannelVisible(ch)) continue;
+            const Color col = ColorFromHSV((float)ch * 22.5f, 0.65f, 1.0f);
+            for (uint64_t c = firstChunk; c <= lastChunk; ++c) {
+                const auto& pts = g_CCLanes.ChunkPolyline(lane, ch, c, chunkTicks);
+                s_strip.clear();
+                for (const auto& p : pts) {
+                    const uint64_t pos = times ? times->TickToUnits(p.tick) : p.tick;
+                    const float x = plx + (float)(((double)pos - (double)curPos) * ppt);
+                    const float y = bandBottom - 2.f - ((float)p.value / 127.f) * (laneH - 4.f);
+                    s_strip.push_back({ std::clamp(x, 0.f, (float)sw), y });
+                }
+                if (s_strip.size() >= 2) DrawLineStrip(s_strip.data(), (int)s_strip.size(), col);
+            }
+        }
+        const int lx = showKeyboard ? KEYBOARD_WIDTH + 5 : 5;
+        DrawText(CCLaneIndex::LaneName(lane), lx, (int)bandTop + 2, 10, Color{ 255,255,255,160 });
+        bandBottom = bandTop;
+    }
+}
+
+// ---- Keyboard overlay ----
+// Vertical strip at the left edge, one row per key on the same mapping as the
+// note texture. The tracker is advanced incrementally each frame; a seek or a
+// jump of more than a few measures rebuilds it from the block index instead.
+static ActiveNoteTracker g_ActiveNotes;
+
+void DrawKeyboardOverlay(const std::vector<OptimizedTrackData>& tracks, uint64_t currentTick, int ppq)
+{
+    static uint64_t s_bindEpoch = UINT64_MAX;
+    static const std::vector<OptimizedTrackData>* s_bound = nullptr;
+    if (s_bound != &tracks || s_bindEpoch != g_TrackMasks.ResetEpoch()) {
+        s_bound = &tracks;
+        s_bindEpoch = g_TrackMasks.ResetEpoch();
+        g_ActiveNotes.Bind(&tracks);
+    }
+    const uint32_t tick = (uint32_t)std::min<uint64_t>(currentTick, UINT32_MAX);
+    g_ActiveNotes.Update(tick, (uint32_t)std::max(1, ppq) * 16u);
+
+    const int   sh = GetScreenHeight();
+    const float top = 30.f, bot = 30.f;
+    const float uh = (float)sh - top - bot;
+    const float kh = uh / 128.f;
+    static const bool isBlack[12] = { 0,1,0,1,0,0,1,0,1,0,1,0 };
+
+    DrawRectangle(0, (int)top, KEYBOARD_WIDTH, (int)uh, Color{ 16,16,16,220 });
+    for (int key = 0; key < 128; ++key) {
+        const float y = (float)sh - bot - (float)(key + 1) * kh;
+        const bool  black = isBlack[key % 12];
+        const float w = black ? KEYBOARD_WIDTH * 0.62f : (float)KEYBOARD_WIDTH;
+        Color c = black ? Color{ 24,24,24,255 } : Color{ 230,230,230,255 };
+
+        // Top visible holder: highest (track, channel) ident is painted on top
+        const auto& holders = g_ActiveNotes.Holders((uint8_t)key);
+        for (auto it = holders.rbegin(); it != holders.rend(); ++it) {
+            const int t = (int)(it->ident >> 4), ch = (int)(it->ident & 15u);
+            if (!g_TrackMasks.TrackVisible((size_t)t) || !g_TrackMasks.ChannelVisible((uint8_t)ch)) continue;
+            c = GetTrackColorPFA(t, ch);
+            c.a = 255;
+            break;
+        }
+        DrawRectangleRec({ 0.f, y, w, std::max(1.f, kh) }, c);
+        if (!black && key % 12 == 0 && kh >= 2.f)
+            DrawLine(0, (int)(y + kh), KEYBOARD_WIDTH, (int)(y + kh), Color{ 96,96,96,255 });
+    }
+    DrawLine(KEYBOARD_WIDTH, (int)top, KEYBOARD_WIDTH, sh - (int)bot, GRAY);
+}
+
 std::string FormatWithCommas(uint64_t value) {
     // Build the string right-to-left into a fixed buffer to avoid repeated insertions
     char buf[32];
@@ -930,6 +1092,7 @@ void SendNotification(float width, float height, Color backgroundColor, const st
 // ===================================================================
 
 void InvalidateNoteBuffer() {
+    g_FrameStats.Mark(FrameEvent::Repaint);
     // Cancel any in-progress paint job and drain the queue so the bg thread
     // doesn't finish writing old chunk data AFTER we've already cleared and
     // re-enqueued new chunks. Without this, old jobs corrupt new chunk pixels.
@@ -979,6 +1142,7 @@ static Color extendedColors[] = {
 static Color currentTrackColors[MAX_TRACKS];
 static int maxTracksUsed = MAX_TRACKS;
 static bool colorsInitialized = false;
+static uint32_t g_paletteEpoch = 0;   // bumped on every colour table change (minimap rebuild)
 
 void InitializeTrackColors(int numTracks = 16) {
     maxTracksUsed = std::min(numTracks * 16, MAX_TRACKS);
@@ -987,6 +1151,7 @@ void InitializeTrackColors(int numTracks = 16) {
         currentTrackColors[i] = extendedColors[i % numExtendedColors];
     }
     colorsInitialized = true;
+    g_paletteEpoch++;
     std::cout << "Initialized colors for " << numTracks << " tracks x 16 channels (" << maxTracksUsed << " slots)" << std::endl;
 }
 
@@ -996,6 +1161,21 @@ inline Color GetTrackColorPFA(int track, int channel) {
     return currentTrackColors[colorIndex];
 }
 
+static ChunkPaintContext PainterContext() {
+    if (!colorsInitialized) InitializeTrackColors();
+    ChunkPaintContext ctx;
+    ctx.tracks      = g_tracks;
+    ctx.times       = g_bgTimes;
+    ctx.viewer      = g_bgViewerType;
+    ctx.width       = g_chunkW;
+    ctx.pixPerTick  = g_pixPerTick;
+    ctx.palette     = currentTrackColors;
+    ctx.paletteSize = maxTracksUsed;
+    ctx.masks       = &g_TrackMasks;
+    ctx.cancel      = &g_paintCancel;
+    return ctx;
+}
+
 void ResetTrackColors() {
     if (!colorsInitialized) InitializeTrackColors();
     const int numExtendedColors = sizeof(extendedColors) / sizeof(extendedColors[0]);
@@ -1003,6 +1183,7 @@ void ResetTrackColors() {
         currentTrackColors[i] = extendedColors[i % numExtendedColors];
     }
     InvalidateNoteBuffer();
+    g_paletteEpoch++;
     std::cout << "- Channel color change to default (" << maxTracksUsed << " tracks)" << std::endl;
 }
 
@@ -1020,6 +1201,7 @@ void RandomizeTrackColors() {
         currentTrackColors[i] = colorPool[i % numExtendedColors];
     }
     InvalidateNoteBuffer();
+    g_paletteEpoch++;
     std::cout << "- Channel color change to randomized (" << maxTracksUsed << " tracks)" << std::endl;
 }
 
@@ -1037,22 +1219,25 @@ void GenerateRandomTrackColors() {
         };
     }
     InvalidateNoteBuffer();
+    g_paletteEpoch++;
     std::cout << "- Channel color change to Generate random (" << maxTracksUsed << " tracks)" << std::endl;
 }
 
-bool LoadColorsFromPianoFromAbove() {
+// Parses the PFA palette from disk. Touches no globals, so the startup task
+// can prefetch it; LoadColorsFromPianoFromAbove() then applies the cache.
+static std::vector<Color> ParsePianoFromAboveColors() {
+    std::vector<Color> pfaColors;
     const char* appdata = std::getenv("APPDATA");
     if (!appdata) {
         std::cout << "- APPDATA env not found" << std::endl;
-        return false;
+        return pfaColors;
     }
     std::string configPath = std::string(appdata) + "\\Piano From Above\\Config.xml";
     std::ifstream file(configPath);
     if (!file.is_open()) {
         std::cout << "- Piano From Above config not found: " << configPath << std::endl;
-        return false;
+        return pfaColors;
     }
-    std::vector<Color> pfaColors;
     std::string line;
     bool inColorsBlock = false;
     while (std::getline(file, line)) {
@@ -1071,6 +1256,14 @@ bool LoadColorsFromPianoFromAbove() {
         if (r >= 0 && g >= 0 && b >= 0)
             pfaColors.push_back({ (unsigned char)r, (unsigned char)g, (unsigned char)b, 255 });
     }
+    return pfaColors;
+}
+
+static std::vector<Color> g_pfaColorsCache;          // filled by the "PFA palette" startup task
+static bool               g_pfaColorsCached = false;
+
+bool LoadColorsFromPianoFromAbove() {
+    std::vector<Color> pfaColors = g_pfaColorsCached ? g_pfaColorsCache : ParsePianoFromAboveColors();
     if (pfaColors.empty()) {
         std::cout << "- No colors found in Piano From Above config" << std::endl;
         return false;
@@ -1085,6 +1278,7 @@ bool LoadColorsFromPianoFromAbove() {
         currentTrackColors[i] = pfaColors[colorIndex];
     }
     InvalidateNoteBuffer();
+    g_paletteEpoch++;
     std::cout << "+ Loaded " << numPFA << " PFA colors" << std::endl;
     return true;
 }
@@ -1235,17 +1429,21 @@ void DrawModeSelectionMenu() {
         }
         UnloadDroppedFiles(droppedFiles);
     }
-    if (IsKeyPressed(KEY_ENTER) && !inputActive) currentState = STATE_LOADING;
+    if (IsKeyPressed(KEY_ENTER) && !inputActive && !s_LibraryOpen) currentState = STATE_LOADING;
     ClearBackground(JBG1A);
     DrawText("JIDI Player", 10, 10, 20, WHITE);
     DrawText(TextFormat("File: %s", GetFileName(selectedMidiFile.c_str())), GetScreenWidth()/2 - MeasureText(TextFormat("File: %s", GetFileName(selectedMidiFile.c_str())), 20)/2, 160, 20, LIGHTGRAY);
-    if (DrawButton({(float)GetScreenWidth() / 2 - 120, 200, 240, 50}, "Load midi input", JBG1B)) {
+    // The library window floats over the buttons; it takes the clicks while open
+    if (DrawButton({(float)GetScreenWidth() / 2 - 120, 200, 240, 50}, "Load midi input", JBG1B) && !s_LibraryOpen) {
         showInputBox = true;
         inputActive = true;
     }
-    if (DrawButton({(float)GetScreenWidth() / 2 - 120, 265, 240, 50}, "Start Playback", JBG1B)) {
+    if (DrawButton({(float)GetScreenWidth() / 2 - 120, 265, 240, 50}, "Start Playback", JBG1B) && !s_LibraryOpen) {
         currentState = STATE_LOADING;
     }
+    if (DrawButton({(float)GetScreenWidth() / 2 - 120, 330, 240, 50}, "Browse library", JBG1B) && !s_LibraryOpen) {
+        s_LibraryOpen = true;
+    }
     InformationVersion();
     if (showInputBox) {
         Rectangle inputRect = { GetScreenWidth()/2 - 320.0f, GetScreenHeight() - 60.0f, 640.0f, 40 };
@@ -1289,28 +1487,71 @@ void DrawDetailedLoadingScreen() {
     DrawText(phaseText, barX, textY, 20, YELLOW); textY += 25;
     
     MemoryUsage mem = GetMemoryUsage();
-    DrawText(TextFormat("Memory Usage: %llu MB (Committed: %llu MB)", mem.workingSetMB, mem.privateUsageMB), barX, textY, 20, LIGHTGRAY); 
+    DrawText(TextFormat("Memory Usage: %llu MB (Committed: %llu MB)", mem.workingSetMB, mem.privateUsageMB), barX, textY, 20, LIGHTGRAY); textY += 25;
+
+    // Stage timeline + ETA (g_LoadTelemetry)
+    const double eta = g_LoadTelemetry.EtaSeconds(g_LoadProgress.bytesRead.load(), g_LoadProgress.totalBytes.load(),
+                                                  g_LoadProgress.currentNotes.load());
+    const double elapsedSec = g_LoadTelemetry.ElapsedMs() / 1000.0;
+    if (eta >= 0.0) DrawText(TextFormat("Elapsed: %.1f s ~ ETA: %.1f s", elapsedSec, eta), barX, textY, 20, JLIGHTLIME);
+    else            DrawText(TextFormat("Elapsed: %.1f s ~ ETA: estimating...", elapsedSec), barX, textY, 20, JLIGHTLIME);
+    textY += 30;
+    DrawText(TextFormat("%-22s %9s %9s %9s %11s %8s", "Stage", "Wall ms", "CPU ms", "MB/s", "Notes/s", "Peak MB"), barX, textY, 10, GRAY);
+    textY += 14;
+    for (const auto& st : g_LoadTelemetry.Stages()) {
+        const double sec = st.wallMs / 1000.0;
+        const char* mbps  = (st.bytes && sec > 0) ? TextFormat("%9.1f", (double)st.bytes / 1048576.0 / sec) : "        -";
+        const char* nps   = (st.notes && sec > 0) ? TextFormat("%11.0f", (double)st.notes / sec) : "          -";
+        DrawText(TextFormat("%-22s %9.1f %9.1f %s %s %8llu", st.name.c_str(), st.wallMs, st.cpuMs, mbps, nps,
+                            (unsigned long long)st.rssPeakMB), barX, textY, 10, st.running ? YELLOW : LIGHTGRAY);
+        textY += 12;
+    }
 }
 
-static void BuildTempoSegs(int ppq) {
+// Tempo changes of the loaded song (an attached window gets them from the share)
+static std::vector<TempoEvent> SongTempoEvents() {
+    std::vector<TempoEvent> out;
+    for (const auto& ev : GetGlobalMidiEvents())
+        if (ev.Type() == EventType::TEMPO) out.push_back({ ev.tick, ev.Tempo() });
+    return out;
+}
+
+static void BuildTempoSegs(int ppq, const std::vector<TempoEvent>& tempo) {
     g_tempoSegs.clear();
     double usPerTick = MidiTiming::CalculateMicrosecondsPerTick(MidiTiming::DEFAULT_TEMPO_MICROSECONDS, ppq);
     g_tempoSegs.push_back({ 0, 0.0, usPerTick });
     double   accumSec = 0.0;
     uint32_t lastTick = 0;
-    for (const auto& ev : GetGlobalMidiEvents()) {
-        if (ev.type != (uint8_t)EventType::TEMPO) continue;
+    for (const auto& ev : tempo) {
         accumSec += (ev.tick - lastTick) * usPerTick / 1000000.0;
         lastTick  = ev.tick;
-        usPerTick = MidiTiming::CalculateMicrosecondsPerTick(ev.data.tempo, ppq);
+        usPerTick = MidiTiming::CalculateMicrosecondsPerTick(ev.tempoMicroseconds, ppq);
         g_tempoSegs.push_back({ ev.tick, accumSec, usPerTick });
     }
 }
-// Bake the 20-cell NPS grid from all note tracks. Called once after load.
-// Each cell covers an equal time slice of the song; value = notes/sec in that slice.
+// Bake the NPS grid from the sorted note start ticks. Called after load and
+// on resize. Each cell covers an equal time slice of the song; value =
+// notes/sec in that slice. A note's cell grows with its tick, so each cell
+// count is two binary searches apart: O(cells · log notes).
 static double TicksToSeconds(uint64_t tick); // forward decl for BuildNpsGrid
 
-static void BuildNpsGrid(const std::vector<OptimizedTrackData>& tracks, int barWidthPx = 0) {
+static int NpsCellOf(uint32_t tick) {
+    return (int)(TicksToSeconds(tick) / g_npsCellSec);
+}
+
+static void NormalizeNpsGrid() {
+    const int cells = g_npsGridCells;
+    float maxNps = 0.f;
+    for (int i = 0; i < cells; ++i) {
+        g_npsGrid[i] = (g_npsCellSec > 0.0) ? g_npsCounts[i] / (float)g_npsCellSec : 0.f;
+        maxNps = std::max(maxNps, g_npsGrid[i]);
+    }
+    if (maxNps > 0.f)
+        for (int i = 0; i < cells; ++i) g_npsGrid[i] /= maxNps;
+    g_npsGridReady = true;
+}
+
+static void BuildNpsGrid(int barWidthPx = 0) {
     g_npsGrid.clear();
     g_npsGridReady = false;
     if (g_songDurationSec <= 0.0 || g_tempoSegs.empty()) return;
@@ -1319,27 +1560,36 @@ static void BuildNpsGrid(const std::vector<OptimizedTrackData>& tracks, int barW
     int cells = (barWidthPx > 0) ? std::max(1, barWidthPx / kNpsCellPx) : 126;
     g_npsGridCells      = cells;
     g_npsGridBuiltWidth = barWidthPx;
+    g_npsCellSec        = g_songDurationSec / cells;
     g_npsGrid.assign(cells, 0.f);
+    g_npsCounts.assign(cells, 0);
 
-    double cellSec = g_songDurationSec / cells;
-    std::vector<float> counts(cells, 0.f);
-
-    for (const auto& track : tracks) {
-        for (const auto& n : track.notes) {
-            double sec = TicksToSeconds(n.startTick);
-            int cell = (int)(sec / cellSec);
-            if (cell >= 0 && cell < cells) counts[cell]++;
-        }
-    }
-    float maxNps = 0.f;
+    const auto& starts = g_sortedNoteStartTicks;
+    auto from = starts.begin();
     for (int i = 0; i < cells; ++i) {
-        g_npsGrid[i] = (cellSec > 0.0) ? counts[i] / (float)cellSec : 0.f;
-        maxNps = std::max(maxNps, g_npsGrid[i]);
+        auto to = std::partition_point(from, starts.end(), [i](uint32_t t) { return NpsCellOf(t) <= i; });
+        g_npsCounts[i] = (uint32_t)(to - from);
+        from = to;
     }
-    if (maxNps > 0.f)
-        for (int i = 0; i < cells; ++i) g_npsGrid[i] /= maxNps;
+    NormalizeNpsGrid();
+}
 
-    g_npsGridReady = true;
+// Watch edit: move the changed notes between cells. A new song length moves
+// every cell boundary, so then the grid is baked again.
+static void UpdateNpsGrid(const std::vector<uint32_t>& goneStarts, const std::vector<uint32_t>& newStarts) {
+    if (!g_npsGridReady || g_npsGridCells <= 0 || g_songDurationSec / g_npsGridCells != g_npsCellSec) {
+        BuildNpsGrid(g_npsGridBuiltWidth);
+        return;
+    }
+    for (uint32_t t : goneStarts) {
+        const int cell = NpsCellOf(t);
+        if (cell >= 0 && cell < g_npsGridCells && g_npsCounts[cell] > 0) g_npsCounts[cell]--;
+    }
+    for (uint32_t t : newStarts) {
+        const int cell = NpsCellOf(t);
+        if (cell >= 0 && cell < g_npsGridCells) g_npsCounts[cell]++;
+    }
+    NormalizeNpsGrid();
 }
 
 static double TicksToSeconds(uint64_t tick) {
@@ -1382,6 +1632,151 @@ static uint32_t TicksMinusSeconds(uint64_t targetTick, double seconds) {
     return (uint32_t)std::min(resultTick, (uint64_t)UINT32_MAX);
 }
 
+// ===================================================================
+// WATCH MODE — splice re-parsed tracks into the loaded song
+// ===================================================================
+// Everything that reads the notes or the event list is parked first (playback
+// and pre-render, minimap builder, bg painter). Per-track data (time columns,
+// window index, active notes) is rebuilt for the changed tracks only; the
+// song-wide parts are spliced over the edit (see midi_watch.hpp): the event
+// list, filtered stream and CC lanes over [editLo, editHi], the sorted ticks
+// over the span of the changed notes, the NPS grid per cell. The note
+// texture repaints just the chunks that overlap the notes that actually differ.
+static bool SameNote(const NoteEvent& a, const NoteEvent& b) {
+    return a.startTick == b.startTick && a.endTick == b.endTick && a.note == b.note &&
+           a.velocity == b.velocity && a.channel == b.channel;
+}
+
+static void ApplyWatchReload(TrackReload& r, std::vector<OptimizedTrackData>& tracks)
+{
+    const auto t0 = std::chrono::steady_clock::now();
+    g_FrameStats.Mark(FrameEvent::WatchReload);
+
+    g_AudioEngine.Hold();
+    g_Minimap.Cancel();
+    g_paintCancel.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lk(g_paintMtx);
+        while (!g_paintQueue.empty()) g_paintQueue.pop();
+    }
+    while (g_paintBusy.load(std::memory_order_acquire)) { std::this_thread::yield(); }
+    g_paintCancel.store(false, std::memory_order_release);
+
+    std::vector<CCEvent> cc;
+    ApplyTrackReload(r, tracks, noteTotal, cc);
+
+    // Old vs new notes of each rebuilt track: skip the common head and tail;
+    // what is left in between is the edit
+    std::vector<uint32_t> goneStarts, newStarts, goneEnds, newEnds;
+    uint32_t editLo = UINT32_MAX, editHi = 0;
+    for (size_t k = 0; k < r.tracks.size(); ++k) {
+        const std::vector<NoteEvent>& was = r.notes[k];
+        const NoteList&               now = tracks[r.tracks[k]].notes;
+        size_t head = 0;
+        while (head < was.size() && head < now.size() && SameNote(was[head], now[head])) ++head;
+        size_t tail = 0;
+        while (tail < was.size() - head && tail < now.size() - head &&
+               SameNote(was[was.size() - 1 - tail], now[now.size() - 1 - tail])) ++tail;
+        auto take = [&](const NoteEvent* b, const NoteEvent* e, std::vector<uint32_t>& starts, std::vector<uint32_t>& ends) {
+            for (const NoteEvent* n = b; n != e; ++n) {
+                starts.push_back(n->startTick);
+                ends.push_back(n->endTick);
+                editLo = std::min(editLo, n->startTick);
+                editHi = std::max(editHi, (n->endTick > n->startTick) ? n->endTick : n->startTick + 1);
+            }
+        };
+        take(was.data() + head, was.data() + was.size() - tail, goneStarts, goneEnds);
+        take(now.data() + head, now.data() + now.size() - tail, newStarts, newEnds);
+    }
+    r.notes.clear();
+
+    // Sorted tick arrays: over the span of the changed values, drop the old
+    // notes and merge the new ones in
+    auto splice = [](std::vector<uint32_t>& sorted, std::vector<uint32_t>& gone, std::vector<uint32_t>& added) {
+        if (gone.empty() && added.empty()) return;
+        std::sort(gone.begin(), gone.end());
+        std::sort(added.begin(), added.end());
+        const uint32_t lo = std::min(gone.empty() ? UINT32_MAX : gone.front(), added.empty() ? UINT32_MAX : added.front());
+        const uint32_t hi = std::max(gone.empty() ? 0u : gone.back(), added.empty() ? 0u : added.back());
+        const auto first = std::lower_bound(sorted.begin(), sorted.end(), lo);
+        const auto last  = std::upper_bound(first, sorted.end(), hi);
+        std::vector<uint32_t> kept;
+        kept.reserve((size_t)(last - first));
+        std::set_difference(first, last, gone.begin(), gone.end(), std::back_inserter(kept));
+        std::vector<uint32_t> span;
+        span.reserve(kept.size() + added.size());
+        std::merge(kept.begin(), kept.end(), added.begin(), added.end(), std::back_inserter(span));
+        ReplaceRange(sorted, (size_t)(first - sorted.begin()), (size_t)(last - sorted.begin()), span);
+    };
+    splice(g_sortedNoteStartTicks, goneStarts, newStarts);
+    splice(g_sortedNoteEndTicks,   goneEnds,   newEnds);
+    g_songLastTick    = g_sortedNoteEndTicks.empty() ? 0 : g_sortedNoteEndTicks.back();
+    g_songDurationSec = TicksToSeconds(g_songLastTick);
+
+    g_NoteTimes.Rebuild(tracks, r.tracks);
+    g_NoteWindow.Rebuild(tracks, r.tracks);
+    g_ActiveNotes.Refresh(r.tracks);
+    UpdateNpsGrid(goneStarts, newStarts);
+    if (r.ccTouched) g_CCLanes.Splice(r.editLo, r.editHi, cc);
+    g_Minimap.BuildAsync(tracks, GetTrackColorPFA, TicksToSeconds, g_songDurationSec);
+
+    // Note texture: repaint the chunks over the edit, requeue the rest the
+    // drain above may have dropped
+    if (g_tex.id != 0 && g_ticksPerChunk > 0) {
+        if (editLo < editHi) {
+            const uint64_t lo = g_bgTimes ? g_bgTimes->TickToUnits(editLo) : editLo;
+            const uint64_t hi = g_bgTimes ? g_bgTimes->TickToUnits(editHi) + 1 : editHi;
+            for (int c = 0; c < N_CHUNKS; ++c) {
+                const uint64_t cs = g_chunkOriginTick[c];
+                if (cs < hi && cs + g_ticksPerChunk > lo) g_chunkPainted[c] = false;
+            }
+        }
+        for (int c = 0; c < N_CHUNKS; ++c)
+            if (!g_chunkPainted[c] || g_chunkCoarse[c]) EnqueueChunk(c, g_chunkOriginTick[c], false);
+    }
+
+    // Same tempo map, so the held position is still the same tick and the
+    // player keeps its tempo index
+    g_EventFilter.SpliceTracks(r.oldEvents, r.events, r.editLo, r.editHi);
+    g_AudioEngine.Rebind(g_EventFilter.Get());
+
+    const double applyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::string line = TextFormat("%zu track(s) reparsed (%.1f KB) in %.1f ms + %.1f ms apply",
+                                  r.tracks.size(), (double)r.bytesParsed / 1024.0, r.prepareMs, applyMs);
+    std::cout << "+ Watch: " << line << std::endl;
+    SendNotification(420, 50, SSUCCESS, "File changed: " + line, 3.0f);
+    g_MidiWatch.SetLastResult(std::move(line));
+}
+
+// Main thread, once per frame while playing. True when the edit needs a full
+// reload (the caller unloads and goes back through STATE_LOADING).
+static bool PollMidiWatch(std::vector<OptimizedTrackData>& tracks)
+{
+    if (!g_MidiWatch.Poll(GetTime())) return false;
+    TrackReload& r = g_MidiWatch.Pending();
+    bool full = false;
+    switch (r.result) {
+    case TrackReload::Result::Unchanged:
+        g_MidiWatch.SetLastResult("Saved, no track changed");
+        break;
+    case TrackReload::Result::Failed:
+        std::cout << "[warn] Watch: " << r.why << std::endl;
+        SendNotification(400, 50, SERROR, "File changed but could not be read", 3.0f);
+        g_MidiWatch.SetLastResult("Read failed: " + r.why);
+        break;
+    case TrackReload::Result::Full:
+        std::cout << "+ Watch: full reload (" << r.why << ")" << std::endl;
+        g_MidiWatch.SetLastResult("Full reload: " + r.why);
+        full = true;
+        break;
+    case TrackReload::Result::Tracks:
+        ApplyWatchReload(r, tracks);
+        break;
+    }
+    g_MidiWatch.Done();
+    return full;
+}
+
 // ===================================================================
 // DEBUG PANEL
 // ===================================================================
@@ -1422,7 +1817,7 @@ void DrawDebugPanel(uint64_t currentVisualizerTick, int ppq, uint32_t currentTem
     currentY += lineHeight;
     DrawText(TextFormat("Scroll speed: %.2fx", scrollSpeed), (int)(panelX + padding), (int)currentY, 10, WHITE);
     currentY += lineHeight;
-    DrawText(TextFormat("Render notes: %llu / %llu (Textures)", renderNotes, maxRenderNotes), (int)(panelX + padding), (int)currentY, 10, WHITE);
+    DrawText(TextFormat("Render notes: %llu / %llu (%s)", renderNotes, maxRenderNotes, g_viewerType == ViewerType::FallingNotes ? "Instanced" : "Textures"), (int)(panelX + padding), (int)currentY, 10, WHITE);
 }
 
 // ===================================================================
@@ -1431,50 +1826,24 @@ void DrawDebugPanel(uint64_t currentVisualizerTick, int ppq, uint32_t currentTem
 
 #define MAX_PERF_HISTORY 360
 
+// Graph history only: a ring written in O(1) per frame. The numbers printed
+// next to the graphs come from g_FrameStats (percentiles, not averages).
 static int perfFpsHistory[MAX_PERF_HISTORY] = {0};
 static float perfFtHistory[MAX_PERF_HISTORY] = {0.0f};
 static int perfTpsHistory[MAX_PERF_HISTORY] = {0};
 static float perfBufHistory[MAX_PERF_HISTORY] = {0.0f};
-
-// Rolling min / max / avg computed from the history window
-static int   perfFpsMin = 0, perfFpsMax = 0;
-static float perfFpsAvg = 0.0f;
-static float perfFtMin  = 0.0f, perfFtMax = 0.0f, perfFtAvg = 0.0f;
-static int   perfTpsMin = 0, perfTpsMax = 0;
-static float perfTpsAvg = 0.0f;
+static int perfHead = 0;   // oldest sample; the newest is at perfHead - 1
 static uint64_t lastCurrentVisualizerTick = 0;
 
+static inline int PerfAt(int i) { return (perfHead + i) % MAX_PERF_HISTORY; }   // i = 0 is the oldest
+static inline int PerfLatest()  { return PerfAt(MAX_PERF_HISTORY - 1); }
+
 void UpdatePerformanceHistory(int fps, float ft, int tps, float bufHealth) {
-    for (int i = 0; i < MAX_PERF_HISTORY - 1; i++) {
-        perfFpsHistory[i] = perfFpsHistory[i + 1];
-        perfFtHistory[i]  = perfFtHistory[i + 1];
-        perfTpsHistory[i] = perfTpsHistory[i + 1];
-        perfBufHistory[i] = perfBufHistory[i + 1];
-    }
-    perfFpsHistory[MAX_PERF_HISTORY - 1] = fps;
-    perfFtHistory[MAX_PERF_HISTORY - 1]  = ft;
-    perfTpsHistory[MAX_PERF_HISTORY - 1] = tps;
-    perfBufHistory[MAX_PERF_HISTORY - 1] = bufHealth;
-
-    // Recompute min / max / avg over the full window
-    int   fpsMin = perfFpsHistory[0], fpsMax = perfFpsHistory[0];
-    float ftMin  = perfFtHistory[0],  ftMax  = perfFtHistory[0];
-    int   tpsMin = perfTpsHistory[0], tpsMax = perfTpsHistory[0];
-    double fpsSum = 0.0, ftSum = 0.0, tpsSum = 0.0;
-    for (int i = 0; i < MAX_PERF_HISTORY; i++) {
-        fpsSum += perfFpsHistory[i];
-        ftSum  += perfFtHistory[i];
-        tpsSum += perfTpsHistory[i];
-        if (perfFpsHistory[i] < fpsMin) fpsMin = perfFpsHistory[i];
-        if (perfFpsHistory[i] > fpsMax) fpsMax = perfFpsHistory[i];
-        if (perfFtHistory[i]  < ftMin)  ftMin  = perfFtHistory[i];
-        if (perfFtHistory[i]  > ftMax)  ftMax  = perfFtHistory[i];
-        if (perfTpsHistory[i] < tpsMin) tpsMin = perfTpsHistory[i];
-        if (perfTpsHistory[i] > tpsMax) tpsMax = perfTpsHistory[i];
-    }
-    perfFpsMin = fpsMin; perfFpsMax = fpsMax; perfFpsAvg = (float)(fpsSum / MAX_PERF_HISTORY);
-    perfFtMin  = ftMin;  perfFtMax  = ftMax;  perfFtAvg  = (float)(ftSum  / MAX_PERF_HISTORY);
-    perfTpsMin = tpsMin; perfTpsMax = tpsMax; perfTpsAvg = (float)(tpsSum / MAX_PERF_HISTORY);
+    perfFpsHistory[perfHead] = fps;
+    perfFtHistory[perfHead]  = ft;
+    perfTpsHistory[perfHead] = tps;
+    perfBufHistory[perfHead] = bufHealth;
+    perfHead = (perfHead + 1) % MAX_PERF_HISTORY;
 }
 
 // ===================================================================
@@ -1529,7 +1898,7 @@ void Draw100PercentStackedColumn(int x, int y, int height, float val, const std:
 
 void DrawPerformanceDebugPanel() {
     int width = 380;
-    int height = 305;
+    int height = 331;
     int px = GetScreenWidth() - width - 10;
     int py = GetScreenHeight() - height - 40;
     DrawRectangleRounded(Rectangle{(float)px, (float)py, (float)width, (float)height}, 0.1f, 32, Color{64, 64, 64, 128});
@@ -1567,24 +1936,28 @@ void DrawPerformanceDebugPanel() {
         {7680.0f, PCyan}, {15360.0f, PMagenta}, {30000.0f, PWhite} // Upper cap
     };
 
+    const FrameStats::Percentiles ftp = g_FrameStats.FrameTime();
+
     // ---- FPS graph ----
+    // "1% low" / "0.1% low": the rate the p99 / p99.9 frame would sustain
     cy += 25;
-    DrawText(TextFormat("Frame Per Seconds: %d  (%d / %d / %.0f)", perfFpsHistory[MAX_PERF_HISTORY - 1], perfFpsMin, perfFpsMax, perfFpsAvg), cx, cy, 10, WHITE);
+    DrawText(TextFormat("Frame Per Seconds: %d  (1%% low %.0f / 0.1%% low %.0f)", perfFpsHistory[PerfLatest()],
+        ftp.p99 > 0.0 ? 1000.0 / ftp.p99 : 0.0, ftp.p999 > 0.0 ? 1000.0 / ftp.p999 : 0.0), cx, cy, 10, WHITE);
     cy += 13;
 
     DrawRectangle(cx, cy, GW, GH, Color{0, 0, 0, 128});
     for (int i = 0; i < MAX_PERF_HISTORY; i++) {
-        Draw100PercentStackedColumn(cx + i, cy, GH, (float)perfFpsHistory[i], fpsTiers);
+        Draw100PercentStackedColumn(cx + i, cy, GH, (float)perfFpsHistory[PerfAt(i)], fpsTiers);
     }
 
     // ---- Frame Time graph ----
     cy += GH + 5;
-    DrawText(TextFormat("Frame Time: %.2f ms  (%.2f ms / %.2f ms / %.2f ms)", perfFtHistory[MAX_PERF_HISTORY - 1], perfFtMin, perfFtMax, perfFtAvg), cx, cy, 10, WHITE);
+    DrawText(TextFormat("Frame Time: %.2f ms  (p50 %.2f / p99 %.2f / p99.9 %.2f ms)", perfFtHistory[PerfLatest()], ftp.p50, ftp.p99, ftp.p999), cx, cy, 10, WHITE);
     cy += 13;
 
     DrawRectangle(cx, cy, GW, GH, Color{0, 0, 0, 128});
     for (int i = 0; i < MAX_PERF_HISTORY; i++) {
-        Draw100PercentStackedColumn(cx + i, cy, GH, perfFtHistory[i], ftTiers);
+        Draw100PercentStackedColumn(cx + i, cy, GH, perfFtHistory[PerfAt(i)], ftTiers);
     }
 
     // ---- Bottom graph: TPS or Buffer Health ----
@@ -1595,7 +1968,7 @@ void DrawPerformanceDebugPanel() {
         DrawText("Pre-Render", px + width - 12 - mw, cy, 20, WHITE);
         cy += 25;
         auto prSt = g_BassEngine.GetPreRenderStatus();
-        float curHealth = perfBufHistory[MAX_PERF_HISTORY - 1];
+        float curHealth = perfBufHistory[PerfLatest()];
         float maxHealth = g_BassEngine.GetConfig().preRenderBufferSec;
         {
             const BassConfig& cfg = g_BassEngine.GetConfig();
@@ -1613,62 +1986,58 @@ void DrawPerformanceDebugPanel() {
                 cx, cy, 10, WHITE);
         }
         cy += 13;
+        const FrameStats::Percentiles low = g_FrameStats.BufferHealthLow();
+        DrawText(TextFormat("Buffer low: p50 %.2f s / p1 %.2f s / p0.1 %.2f s / min %.2f s",
+            low.p50 / 1000.0, low.p99 / 1000.0, low.p999 / 1000.0, low.max / 1000.0), cx, cy, 10, WHITE);
+        cy += 13;
         DrawRectangle(cx, cy, GW, GH, Color{0, 0, 0, 128});
         for (int i = 0; i < MAX_PERF_HISTORY; i++) {
-            Draw100PercentStackedColumn(cx + i, cy, GH, perfBufHistory[i], bufTiers);
+            Draw100PercentStackedColumn(cx + i, cy, GH, perfBufHistory[PerfAt(i)], bufTiers);
         }
     } else {
         int mw = MeasureText("MIDI Output", 20);
         DrawText("MIDI Output", px + width - 12 - mw, cy, 20, WHITE);
         cy += 25;
-        DrawText(TextFormat("Tick Per Seconds: %d  (%d / %d / %.0f)", perfTpsHistory[MAX_PERF_HISTORY - 1], perfTpsMin, perfTpsMax, perfTpsAvg), cx, cy, 10, WHITE);
+        DrawText(TextFormat("Tick Per Seconds: %d", perfTpsHistory[PerfLatest()]), cx, cy, 10, WHITE);
+        cy += 13;
+        const FrameStats::Percentiles late = g_FrameStats.DispatchLateness();
+        DrawText(TextFormat("Dispatch late: p50 %.2f / p99 %.2f / p99.9 %.2f / max %.2f ms",
+            late.p50, late.p99, late.p999, late.max), cx, cy, 10, WHITE);
         cy += 13;
         DrawRectangle(cx, cy, GW, GH, Color{0, 0, 0, 128});
         for (int i = 0; i < MAX_PERF_HISTORY; i++) {
-            Draw100PercentStackedColumn(cx + i, cy, GH, (float)perfTpsHistory[i], tpsTiers);
+            Draw100PercentStackedColumn(cx + i, cy, GH, (float)perfTpsHistory[PerfAt(i)], tpsTiers);
         }
     }
+
+    // ---- Stutters: frames over the threshold and what happened in them ----
+    cy += GH + 5;
+    if (const FrameStats::Stutter* s = g_FrameStats.LastStutter()) {
+        DrawText(TextFormat("Stutters >= %.0f ms: %llu  (last %.1f ms at %.1f s: %s)", g_FrameStats.StutterThresholdMs(),
+            (unsigned long long)g_FrameStats.StutterCount(), s->ms, s->atSec, FrameStats::EventNames(s->events).c_str()),
+            cx, cy, 10, s->ms >= 100.0 ? PRed : POrange);
+    } else {
+        DrawText(TextFormat("Stutters >= %.0f ms: none", g_FrameStats.StutterThresholdMs()), cx, cy, 10, WHITE);
+    }
 }
 
 
 // ===================================================================
 // BACKGROUND PARTICLE SYSTEM
 // ===================================================================
-static void SpawnParticle(BgParticle& p, bool randomX) {
-    int sw = std::max(GetScreenWidth(),  1);
-    int sh = std::max(GetScreenHeight(), 1);
-    p.x           = randomX ? (float)(rand() % sw)
-                             : (float)(sw + rand() % 300);
-    p.y           = (float)(rand() % sh);
-    p.speedFactor = 0.5f + (rand() % 1000) / 1000.0f; // [0.50 – 1.50]
-    p.sizeFactor  = 0.5f + (rand() % 1000) / 1000.0f;
-}
-
 // bpmFactor  = (currentBpm / 120.0f) * MidiSpeed  when g_particleBpm is on
 //            = 1.0f                                when g_particleBpm is off
 // paused     = true  -> every particle freezes in place (speed = 0)
 static void UpdateAndDrawParticles(float dt, float bpmFactor, bool paused) {
     if (!g_particleShow) return;
 
-    // Resize pool on-the-fly when count changes
-    int count = std::clamp(g_particleCount, 1, 512);
-    int old   = (int)g_particles.size();
-    if (old != count) {
-        g_particles.resize(count);
-        for (int i = old; i < count; ++i)
-            SpawnParticle(g_particles[i], /*randomX=*/true);
-    }
-
     // Pause = hard freeze; BPM flag = whether bpmFactor modulates speed
     float speedBase = paused ? 0.0f
                      : g_particleSpeed * (g_particleBpm ? bpmFactor : 1.0f);
 
-    for (auto& p : g_particles) {
-        p.x -= speedBase * p.speedFactor * dt;
-        if (p.x < -(g_particleSize * p.sizeFactor * 4.0f))
-            SpawnParticle(p, /*randomX=*/false);
-        DrawCircleV({ p.x, p.y }, g_particleSize * p.sizeFactor, g_particleColor);
-    }
+    // The pool follows g_particleCount on the fly
+    g_particles.Update(g_particleCount, speedBase * dt, g_particleSize, GetScreenWidth(), GetScreenHeight());
+    g_particles.Draw(g_particleSize, g_particleColor);
 }
 
 // ===================================================================
@@ -1676,14 +2045,36 @@ static void UpdateAndDrawParticles(float dt, float bpmFactor, bool paused) {
 // ===================================================================
 int main(int argc, char* argv[]) {
     std::cout << "+ Starting..." << std::endl;
-    // KDMAPI is the default audio backend. If it fails we continue anyway —
-    // the user can switch to BassMIDI from the Audio Config panel at runtime.
-    bool kdmapiOk = InitializeKDMAPIStream();
-    if (kdmapiOk) std::cout << "+ KDMAPI Initialized!" << std::endl;
-    else           std::cout << "[warn] KDMAPI init failed - switch to BassMIDI in Audio Config.\n";
-    if (argc > 1) {
-        selectedMidiFile = argv[1];
-        std::cout << "+ File selection alived!" << std::endl;
+    // jidi-player [file.mid] [--share <name> | --attach <name>] [--null-audio] [--watch]
+    //             [--benchmark <file.mid> [--speed X] [--duration S] [--report out.json] [--with-audio]]
+    bool nullAudio = false, withAudio = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--null-audio") {
+            nullAudio = true;
+        } else if (arg == "--with-audio") {
+            withAudio = true;
+        } else if (arg == "--watch") {
+            g_MidiWatch.SetEnabled(true);
+        } else if (g_Benchmark.ParseArg(i, argc, argv)) {
+            continue;
+        } else if ((arg == "--share" || arg == "--attach") && i + 1 < argc) {
+            const std::string shareName = argv[++i];
+            if (arg == "--share") g_SongShare.StartPrimary(shareName);
+            else                  g_SongShare.StartSecondary(shareName);
+        } else {
+            selectedMidiFile = arg;
+            std::cout << "+ File selection alived!" << std::endl;
+        }
+    }
+    // The benchmark measures the player, not the synth: null sink unless asked
+    if (g_Benchmark.Enabled()) {
+        selectedMidiFile = g_Benchmark.File();
+        nullAudio = nullAudio || !withAudio;
+    }
+    if (nullAudio) {
+        g_NullSink.SetEnabled(true);
+        std::cout << "+ Null audio: MIDI output is counted and discarded" << std::endl;
     }
     std::cout << "+ Opening window..." << std::endl;
     SetTraceLogLevel(LOG_WARNING);
@@ -1695,19 +2086,18 @@ int main(int argc, char* argv[]) {
 	}
     SetWindowMinSize(450, 240);
     SetWindowState(FLAG_VSYNC_HINT);
+    if (g_Benchmark.Enabled()) ClearWindowState(FLAG_VSYNC_HINT);   // frame time is the work, not the display
     SetExitKey(KEY_NULL);
+    g_Startup.Mark("Window open");
+	// Settings only — soundfonts and the background texture load on startup tasks
 	PreInitAudioConfig();
-	if (g_BassEngine.Init(GetWindowHandle())) {
-        std::cout << "+ BassMIDI engine ready\n";
-        LoadAudioConfig();
-    } else {
-        std::cout << "[warn] BassMIDI engine init failed - pre-render unavailable.\n";
-    }
+	LoadAudioConfig(true);
+    g_LoadTelemetry.LoadHistory(GetConfigPath("load_log.jsonl"));   // seeds the loading-screen ETA
+    g_MidiLibrary.Open(GetConfigPath("library_cache.tsv"));
+    g_Startup.Mark("Config applied");
     rlImGuiSetup(true);
-	#ifdef _WIN32
     static std::string imguiPath = GetConfigPath("imgui.ini");
     ImGui::GetIO().IniFilename = imguiPath.c_str();
-	#endif
 	// ImGui Global Styles (my made this themes)
 	ImGuiStyle& style = ImGui::GetStyle();
 	style.WindowBorderSize = 3.0f;
@@ -1734,19 +2124,103 @@ int main(int argc, char* argv[]) {
 	uint32_t g_totalTicks = 0;
     bool isFirstCheck = true;
 	g_Smtc.UpdateMetadata("No played", "JIDI-Player");
-    while (!WindowShouldClose()) {
+
+    // ── Deferred startup ──────────────────────────────────────────────────────
+    // Nothing below blocks the first frame. Playback waits for these in
+    // STATE_LOADING, since the engines must be up before Start().
+    {
+        static size_t      s_fontTask = 0;
+        static Image       s_bgImage  = { 0 };
+        static std::vector<Color> s_pfaColors;
+        // An attached window is silent: the primary owns the audio devices.
+        // Under the null sink nothing would reach them either.
+        if (!g_SongShare.IsSecondary() && !g_NullSink.IsEnabled()) {
+            // KDMAPI is the default audio backend. If it fails we continue anyway —
+            // the user can switch to BassMIDI from the Audio Config panel at runtime.
+            g_Startup.Add("KDMAPI", [] {
+                if (InitializeKDMAPIStream()) std::cout << "+ KDMAPI Initialized!" << std::endl;
+                else std::cout << "[warn] KDMAPI init failed - switch to BassMIDI in Audio Config.\n";
+            });
+            const size_t bassTask = g_Startup.Add("BASS init", [hwnd = GetWindowHandle()] {
+                if (g_BassEngine.Init(hwnd)) {
+                    g_BassEngine.SetVolume(g_BassEngine.GetVolume());   // streams made by Init pick up the loaded volume
+                    std::cout << "+ BassMIDI engine ready\n";
+                } else {
+                    std::cout << "[warn] BassMIDI engine init failed - pre-render unavailable.\n";
+                }
+            });
+            s_fontTask = g_Startup.Add("Soundfonts", [] {
+                if (!g_BassEngine.IsInitialized()) { s_PendingSoundFonts.clear(); return; }
+                LoadPendingSoundFonts([](size_t done, size_t total) {
+                    g_Startup.SetDetail(s_fontTask, std::to_string(done) + "/" + std::to_string(total));
+                });
+            }, {}, { bassTask });
+        }
+        g_Startup.Add("Background image", [] {
+            if (g_bgImageShow && strlen(g_bgImagePath) > 0) s_bgImage = LoadImage(g_bgImagePath);   // CPU decode
+        }, [] {
+            if (s_bgImage.data == nullptr) return;
+            if (g_bgImageTex.id != 0) UnloadTexture(g_bgImageTex);
+            g_bgImageTex = LoadTextureFromImage(s_bgImage);                                        // GL upload
+            if (g_bgImageTex.id != 0) SetTextureFilter(g_bgImageTex, TEXTURE_FILTER_BILINEAR);
+            UnloadImage(s_bgImage);
+            s_bgImage = { 0 };
+        });
+        g_Startup.Add("PFA palette", [] {
+            s_pfaColors = ParsePianoFromAboveColors();
+        }, [] {
+            g_pfaColorsCache  = std::move(s_pfaColors);
+            g_pfaColorsCached = !g_pfaColorsCache.empty();
+        });
+        g_Startup.Start();
+    }
+
+    while (!WindowShouldClose() && !g_Benchmark.Done()) {
+        g_Startup.PumpMain();
         switch (currentState) {
             case STATE_MENU: {
                 BeginDrawing();
                 DrawModeSelectionMenu();
+                if (s_LibraryOpen) {
+                    rlImGuiBegin();
+                    std::string chosen;
+                    const std::string startFolder = selectedMidiFile == "Empty" ? std::string() : std::string(GetDirectoryPath(selectedMidiFile.c_str()));
+                    if (DrawLibraryPanel(chosen, startFolder)) {
+                        selectedMidiFile = chosen;
+                        currentState = STATE_LOADING;
+                    }
+                    rlImGuiEnd();
+                }
+                if (!g_Startup.AllDone()) {
+                    const std::string status = "Starting: " + g_Startup.StatusLine();
+                    DrawText(status.c_str(), 10, GetScreenHeight() - 50, 10, Color{ 255,255,128,192 });
+                }
+                if (g_Benchmark.Enabled()) {
+                    // Straight to the load; back here means the load failed
+                    static bool s_benchLoading = false;
+                    if (s_benchLoading) g_Benchmark.Abort("could not load the song");
+                    else { s_benchLoading = true; currentState = STATE_LOADING; }
+                }
+                if (g_SongShare.IsSecondary()) {
+                    // Follow the primary: load whatever it publishes next
+                    const std::string status = "Attached to '" + g_SongShare.Name() + "' - waiting for a song";
+                    DrawText(status.c_str(), 10, GetScreenHeight() - 35, 10, Color{ 128,255,255,192 });
+                    if (g_SongShare.SongWaiting()) currentState = STATE_LOADING;
+                }
                 g_NotificationManager.Update();
                 g_NotificationManager.Draw();
                 EndDrawing();
+                {
+                    static bool s_firstFrame = true;
+                    if (s_firstFrame) { s_firstFrame = false; g_Startup.Mark("First menu frame"); }
+                }
                 break;
             }
             case STATE_LOADING: {
 				// START THE THREAD ONCE
 				static bool isThreadStarted = false;
+				static std::vector<TempoEvent> s_songTempo;   // feeds the tempo segs (and the share)
+				static std::vector<CCEvent>    s_shareCC;     // kept only until published
 				
 				if (!isThreadStarted) {
 					isThreadStarted = true;
@@ -1757,8 +2231,30 @@ int main(int argc, char* argv[]) {
 					// Launch thread
 					g_LoaderThread = std::thread([&]() {
 						int iPpq = 480, iTempo = (int)MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
-						g_loadedCCEvents = loadStreamingMidiData(selectedMidiFile, noteTracks, iPpq, iTempo, noteTotal,
-                                    timeSigNumerator, timeSigDenominator, &g_LoadProgress);
+						g_LoadTelemetry.Begin(selectedMidiFile);
+						if (g_SongShare.IsSecondary()) {
+							// Map the primary's song instead of parsing
+							SharedSongInfo info;
+							std::vector<CCEvent> cc;
+							g_LoadTelemetry.Stage("Attach share");
+							if (g_SongShare.Attach(noteTracks, s_songTempo, cc, info)) {
+								g_LoadTelemetry.Stage("Build CC lanes", cc.size() * sizeof(CCEvent));
+								g_CCLanes.Build(cc);
+								selectedMidiFile   = info.file;
+								noteTotal          = info.noteTotal;
+								iPpq               = info.ppq;
+								iTempo             = info.initialTempo;
+								timeSigNumerator   = info.timeSigNumerator;
+								timeSigDenominator = info.timeSigDenominator;
+							}
+						} else {
+							s_shareCC = loadStreamingMidiData(selectedMidiFile, noteTracks, iPpq, iTempo, noteTotal,
+                                    timeSigNumerator, timeSigDenominator, &g_LoadProgress, &g_LoadTelemetry);
+							g_LoadTelemetry.Stage("Build CC lanes", s_shareCC.size() * sizeof(CCEvent));
+							g_CCLanes.Build(s_shareCC);
+							if (!g_SongShare.IsPrimary()) s_shareCC = {};
+							s_songTempo = SongTempoEvents();
+						}
 						
 						// Assign out variables carefully
 						ppq = (uint16_t)iPpq;
@@ -1767,6 +2263,7 @@ int main(int argc, char* argv[]) {
 						// Finish Up
 						MidiLoadUsage = GetMemoryUsage();
 						TotalLoadUsage = GetMemoryUsage();
+						g_LoadTelemetry.Stage("Wait for startup");   // closed by the first post-load stage
 						
 						g_LoadProgress.isFinished = true;
 					});
@@ -1775,17 +2272,39 @@ int main(int argc, char* argv[]) {
 				// DRAW THE LOADING CHUNK (Runs 60FPS to keep OS happy)
 				BeginDrawing();
 				DrawDetailedLoadingScreen();
+				if (g_LoadProgress.isFinished && !g_Startup.AllDone()) {
+					const std::string status = "Waiting for audio: " + g_Startup.StatusLine();
+					DrawText(status.c_str(), 10, GetScreenHeight() - 50, 10, Color{ 255,255,128,192 });
+				}
 				g_NotificationManager.Update();
 				g_NotificationManager.Draw();
 				EndDrawing();
 				
-				// CHECK IF DONE
-				if (g_LoadProgress.isFinished) {
+				// CHECK IF DONE (audio engines must be up before playback starts)
+				if (g_LoadProgress.isFinished && g_Startup.AllDone()) {
 					g_LoaderThread.join(); // Safely close the thread
 					isThreadStarted = false; // reset for next time
+
+					// Publish before anything indexes the notes: from here on the
+					// tracks view the shared region
+					if (g_SongShare.IsPrimary() && !noteTracks.empty()) {
+						g_LoadTelemetry.Stage("Publish share", noteTotal * sizeof(NoteEvent), noteTotal);
+						SharedSongInfo info;
+						info.file               = selectedMidiFile;
+						info.noteTotal          = noteTotal;
+						info.ppq                = ppq;
+						info.initialTempo       = (int)currentTempo;
+						info.timeSigNumerator   = timeSigNumerator;
+						info.timeSigDenominator = timeSigDenominator;
+						info.lastEventTick      = GetGlobalMidiEvents().empty() ? 0 : GetGlobalMidiEvents().back().tick;
+						g_SongShare.Publish(noteTracks, s_songTempo, s_shareCC, info);
+					}
+					s_shareCC = {};
 					
 					// Execute post-load configurations synchronously on the main thread now
+					g_LoadTelemetry.Stage("Tick arrays", noteTotal * sizeof(uint32_t) * 2, noteTotal);
 					InitializeTrackColors(static_cast<int>(noteTracks.size()));
+					g_TrackMasks.Reset();
 					
 					g_sortedNoteStartTicks.clear();
 					g_sortedNoteStartTicks.reserve(noteTotal);
@@ -1803,11 +2322,22 @@ int main(int argc, char* argv[]) {
 						
 					std::sort(g_sortedNoteStartTicks.begin(), g_sortedNoteStartTicks.end());
 					std::sort(g_sortedNoteEndTicks.begin(),   g_sortedNoteEndTicks.end());
-					BuildTempoSegs(ppq);
+					g_LoadTelemetry.Stage("Tempo + time columns", noteTotal * sizeof(float) * 2, noteTotal);
+					BuildTempoSegs(ppq, s_songTempo);
+					g_NoteTimes.Build(noteTracks, g_tempoSegs);
 					g_songDurationSec = TicksToSeconds(g_songLastTick);
-					BuildNpsGrid(noteTracks, (int)(GetScreenWidth() - 20)); // bake NPS grid at 10px/cell
+					g_LoadTelemetry.Stage("NPS grid", 0, noteTotal);
+					BuildNpsGrid((int)(GetScreenWidth() - 20)); // bake NPS grid at 10px/cell
+					g_LoadTelemetry.Stage("Minimap dispatch");
+					g_Minimap.BuildAsync(noteTracks, GetTrackColorPFA, TicksToSeconds, g_songDurationSec);
+					g_minimapPaletteEpoch = g_paletteEpoch;
+					g_LoadTelemetry.Stage("Note window index", 0, noteTotal);
+					g_NoteWindow.Build(noteTracks);
+					g_LoadTelemetry.Stage("Audio start");
 					
 					if (noteTracks.size() == 0) {
+						g_LoadTelemetry.Finish(0, 0);
+						if (g_SongShare.IsSecondary()) g_SongShare.Detach();
 						currentState = STATE_MENU;
 						SendNotification(400, 75, SERROR, "You need to load MIDI files first", 5.0f);
 						break;
@@ -1815,16 +2345,26 @@ int main(int argc, char* argv[]) {
 					
 				// Start playing immediately!
                 firstPause = true;
-                currentTempo = MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
-                {
-                    const auto& evs = GetGlobalMidiEvents();
-                    if (!evs.empty() && evs[0].type == (uint8_t)EventType::TEMPO)
-                        currentTempo = evs[0].data.tempo;
-                    g_AudioEngine.Start(evs, ppq, currentTempo);
+                g_FrameStats.Reset();
+                if (g_Benchmark.Enabled()) MidiSpeed = g_Benchmark.BaseSpeed();
+                if (!g_SongShare.IsSecondary()) {   // an attached window takes its transport from the primary
+                    currentTempo = MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
+                    {
+                        const auto& evs = GetGlobalMidiEvents();
+                        if (!evs.empty() && evs[0].Type() == EventType::TEMPO)
+                            currentTempo = evs[0].Tempo();
+                        g_EventFilter.SetSource(&evs, ppq, currentTempo, &GetSysExArena());
+                        g_AudioEngine.Start(g_EventFilter.Get());
+                    }
+                    g_AudioEngine.SetSpeed(MidiSpeed);
+                    g_AudioEngine.SetLooping(isLoop);
+                    g_AudioEngine.Pause();
                 }
-                g_AudioEngine.SetSpeed(MidiSpeed);
-                g_AudioEngine.SetLooping(isLoop);
-                g_AudioEngine.Pause();
+                // Shared songs are views of one parse: only a private load can be spliced
+                if (!g_SongShare.IsPrimary() && !g_SongShare.IsSecondary()) g_MidiWatch.Arm(selectedMidiFile);
+                g_LoadTelemetry.Finish(noteTotal, noteTracks.size());
+                g_LoadTelemetry.AppendLog(GetConfigPath("load_log.jsonl"));
+                if (g_Benchmark.Enabled() && !g_Benchmark.Running()) g_Benchmark.Begin(g_songDurationSec, noteTotal, noteTracks.size());
                 std::cout << "+-[ Help controller ]-+" << std::endl << std::endl;
 
                 std::cout << "--[ Playback ]--" << std::endl;
@@ -1845,9 +2385,13 @@ int main(int argc, char* argv[]) {
                 std::cout << "O = Slower scroll speed (+0.05x)" << std::endl;
                 std::cout << "I = Faster scroll speeds (-0.05x)" << std::endl;
                 std::cout << "P = Reset scroll speeds (0.50x)" << std::endl;
-                std::cout << "T = Change layer" << std::endl;
+                std::cout << "T = Change layer (Channel/Track, Tick, Falling Notes)" << std::endl;
                 std::cout << "V = Toggle guide" << std::endl;
-                std::cout << "B = Toggle beats" << std::endl << std::endl;
+                std::cout << "B = Toggle beats" << std::endl;
+                std::cout << "Y = Toggle keyboard" << std::endl;
+                std::cout << "C = Toggle CC lanes" << std::endl;
+                std::cout << "N = Toggle minimap (click to seek)" << std::endl;
+                std::cout << "D = Toggle time-domain scroll (tempo-aware)" << std::endl << std::endl;
 
                 std::cout << "--[ Color ]--" << std::endl;
                 std::cout << "Keypad 1 = Randomize track colors" << std::endl;
@@ -1857,7 +2401,7 @@ int main(int argc, char* argv[]) {
 
                 std::cout << "--[ Misc ]--" << std::endl;
 				std::cout << "F1 = Toggle HUD" << std::endl;
-                std::cout << "F2 = Take Screenshot" << std::endl;
+                std::cout << "F2 = Take Screenshot (Shift+F2 = Start/Stop burst capture)" << std::endl;
 				std::cout << "F3 = Show Information" << std::endl;
                 std::cout << "F4 = Show Performance" << std::endl;
                 std::cout << "F8 = Audio Config (Show Options only)" << std::endl;
@@ -1883,7 +2427,140 @@ int main(int argc, char* argv[]) {
 				break;
 			}
             case STATE_PLAYING: {
-                if (IsKeyPressed(KEY_R) && !firstPause) {
+                // Song share: an attached window cannot drive g_AudioEngine (it
+                // never started), so transport input becomes a request to the primary
+                const bool ownsTransport = !g_SongShare.IsSecondary();
+
+                // Frame stats first: GetFrameTime() is the frame that just ended, and
+                // the events marked during it must not mix with this frame's
+                {
+                    const bool dispatching = ownsTransport && !g_AudioEngine.IsPaused() && !g_AudioEngine.IsFinished();
+                    const uint32_t lateUs  = g_AudioEngine.TakeDispatchLatenessMicros();
+                    const bool preRender   = g_BassEngine.IsInitialized() && g_BassEngine.GetActiveMode() == AudioMode::BassMIDI_PreRender;
+                    g_FrameStats.EndFrame(GetFrameTime() * 1000.0, dispatching ? lateUs / 1000.0 : -1.0,
+                                          preRender ? g_BassEngine.GetBufferHealthSeconds() : -1.0);
+                }
+                if (IsWindowResized()) g_FrameStats.Mark(FrameEvent::Resize);
+
+                auto seekBy = [&](int64_t us) {
+                    if (ownsTransport) g_AudioEngine.Seek(us);
+                    else               g_SongShare.SendCommand({ ShareRequest::Seek, us });
+                };
+                auto seekTo = [&](uint64_t us) {
+                    if (ownsTransport) g_AudioEngine.SeekAbsolute(us);
+                    else               g_SongShare.SendCommand({ ShareRequest::SeekAbsolute, (int64_t)us });
+                };
+                auto toggleTimeDomain = [&] {
+                    g_timeDomainScroll = !g_timeDomainScroll;
+                    InvalidateNoteBuffer();
+                    std::cout << "- Scroll: " << (g_timeDomainScroll ? "time domain" : "tick domain") << std::endl;
+                };
+                auto cycleViewer = [&] {
+                    g_viewerType = (g_viewerType == ViewerType::ChannelTrackLayer) ? ViewerType::TickLayer
+                                 : (g_viewerType == ViewerType::TickLayer)         ? ViewerType::FallingNotes
+                                                                                   : ViewerType::ChannelTrackLayer;
+                    InvalidateNoteBuffer();
+                    std::cout << "- Viewer: " << (g_viewerType == ViewerType::ChannelTrackLayer ? "Channel+Track Layer"
+                                                : g_viewerType == ViewerType::TickLayer         ? "Tick Layer"
+                                                : g_FallingNotes.Available()                    ? "Falling Notes"
+                                                                                                : "Falling Notes (unavailable, using Tick Layer)") << std::endl;
+                };
+
+                // Benchmark script: the same transport / view changes the keys make
+                if (g_Benchmark.Running() && ownsTransport) {
+                    g_Benchmark.OnFrame(GetFrameTime() * 1000.0);
+                    BenchStep step;
+                    while (g_Benchmark.NextStep(step)) {
+                        switch (step.action) {
+                            case BenchAction::Play:
+                                firstPause = false;
+                                g_AudioEngine.Resume();
+                                break;
+                            case BenchAction::SeekBy:
+                                seekBy((int64_t)(step.value * 1e6));
+                                if (step.value < 0.0) g_seekInvalidate.store(true);
+                                break;
+                            case BenchAction::SeekTo:
+                                seekTo((uint64_t)(step.value * g_songDurationSec * 1e6));
+                                InvalidateNoteBuffer();
+                                break;
+                            case BenchAction::Speed:
+                                MidiSpeed = g_Benchmark.BaseSpeed() * (float)step.value;
+                                g_AudioEngine.SetSpeed(MidiSpeed);
+                                break;
+                            case BenchAction::CycleViewer: cycleViewer();      break;
+                            case BenchAction::TimeDomain:  toggleTimeDomain(); break;
+                        }
+                    }
+                    if (g_Benchmark.Expired(g_AudioEngine.IsFinished())) {
+                        g_FrameStats.PrintSummary();
+                        g_Benchmark.Finish(g_AudioEngine.IsFinished());
+                    }
+                }
+                if (g_SongShare.IsPrimary()) {
+                    ShareCommand cmd;
+                    while (g_SongShare.PollCommand(cmd)) {
+                        if (cmd.type == ShareRequest::TogglePause) {
+                            firstPause = false;
+                            if (g_AudioEngine.IsPaused()) g_AudioEngine.Resume();
+                            else                          g_AudioEngine.Pause();
+                        } else if (cmd.type == ShareRequest::Seek) {
+                            g_AudioEngine.Seek(cmd.micros);
+                            if (cmd.micros < 0) g_seekInvalidate.store(true);
+                        } else if (cmd.type == ShareRequest::SeekAbsolute) {
+                            g_AudioEngine.SeekAbsolute((uint64_t)std::max<int64_t>(0, cmd.micros));
+                            InvalidateNoteBuffer();
+                        }
+                    }
+                }
+                const bool sharedSongGone = g_SongShare.SongGone();   // primary closed or replaced the song
+
+                // Track / channel masks: hidden → repaint; muted → the dispatcher
+                // handles it live, except in pre-render where the mutes are baked
+                // into the filtered stream (rebuild only when the mask changes).
+                {
+                    static uint64_t s_maskVisEpoch = 0, s_maskAudEpoch = 0;
+                    static bool     s_maskBaked    = false;
+                    if (g_TrackMasks.VisibleEpoch() != s_maskVisEpoch) {
+                        s_maskVisEpoch = g_TrackMasks.VisibleEpoch();
+                        InvalidateNoteBuffer();
+                    }
+                    const bool bake = g_BassEngine.IsInitialized() &&
+                                      g_BassEngine.GetActiveMode() == AudioMode::BassMIDI_PreRender;
+                    if (g_TrackMasks.AudibleEpoch() != s_maskAudEpoch || bake != s_maskBaked) {
+                        s_maskAudEpoch = g_TrackMasks.AudibleEpoch();
+                        s_maskBaked    = bake;
+                        if (bake) g_EventFilter.SetMuteOverlay(g_TrackMasks.MutedTrackWords(), g_TrackMasks.MutedChannels());
+                        else      g_EventFilter.SetMuteOverlay({}, 0);
+                    }
+                }
+                // Song minimap: upload a finished build; rebuild on palette change
+                {
+                    if (g_minimapPaletteEpoch != g_paletteEpoch) {
+                        g_minimapPaletteEpoch = g_paletteEpoch;
+                        g_Minimap.BuildAsync(noteTracks, GetTrackColorPFA, TicksToSeconds, g_songDurationSec);
+                    }
+                    g_Minimap.Poll();
+                }
+                // Falling-notes palette texture follows the colour table
+                if (g_viewerType == ViewerType::FallingNotes && g_fallingPaletteEpoch != g_paletteEpoch) {
+                    g_fallingPaletteEpoch = g_paletteEpoch;
+                    g_FrameStats.Mark(FrameEvent::PaletteUpload);
+                    std::vector<uint32_t> pal((size_t)maxTracksUsed);
+                    for (int i = 0; i < maxTracksUsed; ++i) pal[(size_t)i] = ToRGBA8(currentTrackColors[i]);
+                    g_FallingNotes.SetPalette(pal);
+                }
+
+                // Event filter settings changed → swap in the recompiled stream
+                if (ownsTransport && g_EventFilter.Generation() != g_AudioEngine.GetStreamGeneration()) {
+                    g_FrameStats.Mark(FrameEvent::StreamRebind);
+                    g_AudioEngine.Rebind(g_EventFilter.Get());
+                }
+                // Watch mode: a saved edit replaces only the tracks it touched
+                // (armed only for a song this window parsed itself)
+                const bool watchFullReload = PollMidiWatch(noteTracks);
+
+                if (IsKeyPressed(KEY_R) && !firstPause && ownsTransport) {
                     noteCounter = 0;
 					maxRenderNotes = 0;
 					g_maxNps = 0;
@@ -1893,15 +2570,17 @@ int main(int argc, char* argv[]) {
                     currentTempo = MidiTiming::DEFAULT_TEMPO_MICROSECONDS;
                     {
                         const auto& evs = GetGlobalMidiEvents();
-                        if (!evs.empty() && evs[0].type == (uint8_t)EventType::TEMPO)
-                            currentTempo = evs[0].data.tempo;
-                        g_AudioEngine.Start(evs, ppq, currentTempo);
+                        if (!evs.empty() && evs[0].Type() == EventType::TEMPO)
+                            currentTempo = evs[0].Tempo();
+                        g_AudioEngine.Start(g_EventFilter.Get());
                     }
                     g_AudioEngine.SetSpeed(MidiSpeed);
                     g_AudioEngine.SetLooping(isLoop);
                     if (!isLoop) std::cout << "- Playback Restarted" << std::endl;
                 }
-                if (IsKeyPressed(KEY_SPACE)) {
+                if (IsKeyPressed(KEY_SPACE) && !ownsTransport) {
+                    g_SongShare.SendCommand({ ShareRequest::TogglePause, 0 });
+                } else if (IsKeyPressed(KEY_SPACE)) {
                     if (firstPause) firstPause = false;
                     if (g_AudioEngine.IsPaused()) {
                         g_AudioEngine.Resume();
@@ -1909,17 +2588,26 @@ int main(int argc, char* argv[]) {
                         g_AudioEngine.Pause();
                     }
                 }
-                if (IsKeyPressed(KEY_BACKSPACE) && (!showOptions)) { 
-                    std::cout << "- Returning menu..." << std::endl; 
+                if ((IsKeyPressed(KEY_BACKSPACE) && (!showOptions)) || sharedSongGone || watchFullReload) { 
+                    std::cout << (watchFullReload ? "- Reloading changed file..." : "- Returning menu...") << std::endl; 
+                    if (!g_AudioEngine.IsFinished()) g_FrameStats.PrintSummary();
+                    g_MidiWatch.Disarm();
                     InvalidateNoteBuffer(); // reset texture for next song
+                    g_Minimap.Reset();      // builder reads noteTracks
                     g_AudioEngine.Stop();
                     g_AudioEngine.ClearLoopPoints();
                     g_loopPointA = g_loopPointB = UINT64_MAX;
-                    SetWindowState(FLAG_VSYNC_HINT);
-                    ClearWindowState(FLAG_WINDOW_RESIZABLE);
-                    SetWindowSize(1280, 720);
+                    if (!watchFullReload) {   // a reload keeps the window as it is
+                        SetWindowState(FLAG_VSYNC_HINT);
+                        ClearWindowState(FLAG_WINDOW_RESIZABLE);
+                        SetWindowSize(1280, 720);
+                    }
+                    g_NoteWindow.Clear();
+                    g_NoteTimes.Clear();
                     noteTracks.clear();
                     noteTracks.shrink_to_fit();
+                    g_SongShare.Unpublish();    // the tracks viewed the region; nothing reads it now
+                    g_SongShare.Detach();
                     g_sortedNoteStartTicks.clear();
                     g_sortedNoteStartTicks.shrink_to_fit();
                     g_sortedNoteEndTicks.clear();
@@ -1927,7 +2615,7 @@ int main(int argc, char* argv[]) {
                     g_songLastTick = 0; g_songDurationSec = 0.0; g_tempoSegs.clear(); g_maxNps = 0; g_maxPoly = 0; g_npsGridReady = false;
                     SetWindowTitle("JIDI Player - v1.0.4 (Build: " TOSTRING(BUILD_NUMBER) ")"); 
 					g_Smtc.UpdateMetadata("No played", "JIDI-Player");
-					currentState = STATE_MENU;
+					currentState = watchFullReload ? STATE_LOADING : STATE_MENU;
                 }
                 if (IsFileDropped()) {
                     FilePathList droppedFiles = LoadDroppedFiles();
@@ -1937,12 +2625,19 @@ int main(int argc, char* argv[]) {
                         if (TextIsEqual(ext, ".mid") || TextIsEqual(ext, ".midi") || 
                             TextIsEqual(ext, ".MID") || TextIsEqual(ext, ".MIDI")) {
                             std::cout << "- Returning menu after file drop files" << std::endl; 
+                            g_MidiWatch.Disarm();
+                            InvalidateNoteBuffer();
+                            g_Minimap.Reset();
                             g_AudioEngine.Stop();
                             SetWindowState(FLAG_VSYNC_HINT);
                             ClearWindowState(FLAG_WINDOW_RESIZABLE);
                             SetWindowSize(1280, 720);
+                            g_NoteWindow.Clear();
+                            g_NoteTimes.Clear();
                             noteTracks.clear();
                             noteTracks.shrink_to_fit();
+                            g_SongShare.Unpublish();
+                            g_SongShare.Detach();
                             g_sortedNoteStartTicks.clear();
                             g_sortedNoteStartTicks.shrink_to_fit();
                             g_sortedNoteEndTicks.clear();
@@ -1980,23 +2675,23 @@ int main(int argc, char* argv[]) {
                     if (IsKeyPressed(KEY_O) || IsKeyPressedRepeat(KEY_O)) { ScrollSpeed += 0.05f; InvalidateNoteBuffer(); }
                     if (IsKeyPressed(KEY_P)) { ScrollSpeed = 0.50f; InvalidateNoteBuffer(); }
                     if (IsKeyPressed(KEY_LEFT) || IsKeyPressedRepeat(KEY_LEFT)) {
-                        g_AudioEngine.Seek(-3'000'000);
+                        seekBy(-3'000'000);
                         std::cout << "- Seeked backward 3 seconds" << std::endl;
                         g_seekInvalidate.store(true); // triggers full redraw next frame
                     }
                     if (IsKeyPressed(KEY_RIGHT) || IsKeyPressedRepeat(KEY_RIGHT)) {
-                        g_AudioEngine.Seek(3'000'000);
+                        seekBy(3'000'000);
                         std::cout << "+ Seeked forward 3 seconds" << std::endl;
                     }
-                    if (IsKeyPressed(KEY_UP) || IsKeyPressedRepeat(KEY_UP)) {
+                    if (ownsTransport && (IsKeyPressed(KEY_UP) || IsKeyPressedRepeat(KEY_UP))) {
                         MidiSpeed += 0.01f;
                         g_AudioEngine.SetSpeed(MidiSpeed);
                     }
-                    if (IsKeyPressed(KEY_DOWN) || IsKeyPressedRepeat(KEY_DOWN)) {
+                    if (ownsTransport && (IsKeyPressed(KEY_DOWN) || IsKeyPressedRepeat(KEY_DOWN))) {
                         MidiSpeed = std::max(0.01f, MidiSpeed - 0.01f);
                         g_AudioEngine.SetSpeed(MidiSpeed);
                     }
-                    if (IsKeyPressed(KEY_S)) {
+                    if (ownsTransport && IsKeyPressed(KEY_S)) {
                         MidiSpeed = 1.00f;
                         g_AudioEngine.SetSpeed(MidiSpeed);
                     }
@@ -2006,16 +2701,23 @@ int main(int argc, char* argv[]) {
                     if (IsKeyPressed(KEY_B)) { 
                         showBeats = !showBeats; 
                         std::cout << "- Beats " << (showBeats ? "visible" : "invisible") << std::endl; }
-                    if (IsKeyPressed(KEY_T)) {
-                        g_viewerType = (g_viewerType == ViewerType::ChannelTrackLayer) ? ViewerType::TickLayer : ViewerType::ChannelTrackLayer;
-                        InvalidateNoteBuffer();
-                        std::cout << "- Viewer: " << (g_viewerType == ViewerType::ChannelTrackLayer ? "Channel+Track Layer" : "Tick Layer") << std::endl; }
-                    if (IsKeyPressed(KEY_L)) { 
+                    if (IsKeyPressed(KEY_Y)) { 
+                        showKeyboard = !showKeyboard; 
+                        std::cout << "- Keyboard " << (showKeyboard ? "visible" : "invisible") << std::endl; }
+                    if (IsKeyPressed(KEY_C)) { 
+                        showCCLanes = !showCCLanes; 
+                        std::cout << "- CC lanes " << (showCCLanes ? "visible" : "invisible") << std::endl; }
+                    if (IsKeyPressed(KEY_N)) { 
+                        showMinimap = !showMinimap; 
+                        std::cout << "- Minimap " << (showMinimap ? "visible" : "invisible") << std::endl; }
+                    if (IsKeyPressed(KEY_D)) toggleTimeDomain();
+                    if (IsKeyPressed(KEY_T)) cycleViewer();
+                    if (ownsTransport && IsKeyPressed(KEY_L)) { 
                         isLoop = !isLoop;
                         g_AudioEngine.SetLooping(isLoop);
                         std::cout << "- Loops " << (isLoop ? "enabled" : "disabled") << std::endl; }
                     // J = Set loop point A  /  K = Set loop point B
-                    if (IsKeyPressed(KEY_J)) {
+                    if (ownsTransport && IsKeyPressed(KEY_J)) {
                         uint64_t rawTick = g_AudioEngine.GetCurrentTick();
                         g_loopPointA = g_loopSnapToBeats
                             ? LoopSnapToBeat(rawTick, g_loopBeatOffsetA, ppq, timeSigDenominator)
@@ -2029,7 +2731,7 @@ int main(int argc, char* argv[]) {
                         std::cout << "- Loop A set at tick " << g_loopPointA << " (beat " << beatNum << ")" << std::endl;
                         SendNotification(420, 50, SDEBUG, TextFormat("Loop A: beat %llu (tick %llu)", (uint64_t)beatNum, (uint64_t)g_loopPointA), 3.0f);
                     }
-                    if (IsKeyPressed(KEY_K)) {
+                    if (ownsTransport && IsKeyPressed(KEY_K)) {
                         uint64_t rawTick = g_AudioEngine.GetCurrentTick();
                         g_loopPointB = g_loopSnapToBeats
                             ? LoopSnapToBeat(rawTick, g_loopBeatOffsetB, ppq, timeSigDenominator)
@@ -2043,7 +2745,7 @@ int main(int argc, char* argv[]) {
                         std::cout << "- Loop B set at tick " << g_loopPointB << " (beat " << beatNum << ")" << std::endl;
                         SendNotification(420, 50, SDEBUG, TextFormat("Loop B: beat %llu (tick %llu)", (uint64_t)beatNum, (uint64_t)g_loopPointB), 3.0f);
                     }
-                    if (IsKeyPressed(KEY_E)) {
+                    if (ownsTransport && IsKeyPressed(KEY_E)) {
                         isAntiSlowdown = !isAntiSlowdown;
                         g_AudioEngine.ToggleAntiSlowdown(isAntiSlowdown);
                         std::cout << "- Anti-Slowdown " << (isAntiSlowdown ? "enabled" : "disabled") << std::endl; }
@@ -2073,14 +2775,32 @@ int main(int argc, char* argv[]) {
 					g_maxPoly = 0;
                     std::cout << "- Max render notes reset" << std::endl; }
                 if (IsKeyPressed(KEY_F2)) {
-                    time_t now = time(0);
-                    struct tm tstruct;
-                    char buf[64];
-                    localtime_s(&tstruct, &now);
-                    strftime(buf, sizeof(buf), "Jidi-Screenshot_%Y-%m-%d_%H-%M-%S.png", &tstruct);
-                    TakeScreenshot(buf);
-                     SendNotification(300, 50, SINFORMATION, "Screenshot saved files!", 5.0f);
-                    std::cout << "+ Screenshot saved files: " << buf << std::endl; }
+                    // Read back at the end of this frame; encode + write run on the capture worker
+                    if (IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT)) {
+                        if (g_FrameCapture.IsBursting()) {
+                            g_FrameCapture.StopBurst();
+                            SendNotification(300, 50, SINFORMATION, "Burst capture stopped", 3.0f);
+                        } else {
+                            g_FrameCapture.StartBurst(s_CaptureBurstEvery, s_CaptureBurstFormat);
+                            if (g_FrameCapture.IsBursting()) SendNotification(300, 50, SINFORMATION, "Burst capture started", 3.0f);
+                        }
+                    } else {
+                        g_FrameCapture.RequestScreenshot(s_CaptureShotFormat);
+                        std::cout << "+ Screenshot queued" << std::endl;
+                    } }
+                {
+                    // Reported once the capture worker has written (or failed to write) the file
+                    FrameCapture::ShotResult shot;
+                    while (g_FrameCapture.PollShotResult(shot)) {
+                        if (shot.ok) {
+                            std::cout << "+ Screenshot saved: " << shot.path << std::endl;
+                            SendNotification(420, 50, SSUCCESS, "Screenshot saved: " + shot.path, 5.0f);
+                        } else {
+                            std::cout << "[warn] Screenshot failed" << (shot.path.empty() ? "" : ": " + shot.path) << std::endl;
+                            SendNotification(300, 50, SERROR, "Screenshot could not be saved", 5.0f);
+                        }
+                    }
+                }
                 if (IsKeyPressed(KEY_F10)) {
                     if (IsWindowState(FLAG_VSYNC_HINT)) {ClearWindowState(FLAG_VSYNC_HINT); std::cout << "- VSync disabled" << std::endl; }
                     else {SetWindowState(FLAG_VSYNC_HINT); std::cout << "+ VSync enabled" << std::endl; } }
@@ -2101,6 +2821,22 @@ int main(int argc, char* argv[]) {
                 bool isFinished = g_AudioEngine.IsFinished();
                 uint64_t currentVisualizerTick = g_AudioEngine.GetCurrentTick();
                 uint32_t currentTempo = g_AudioEngine.GetCurrentTempo();
+                if (g_SongShare.IsPrimary()) {
+                    g_SongShare.WriteTransport({ currentVisualizerTick, currentTempo, MidiSpeed, isPaused, isFinished, firstPause });
+                } else if (g_SongShare.IsSecondary()) {
+                    static uint64_t s_sharedTick = 0;
+                    SharedTransport t = g_SongShare.ReadTransport();
+                    isPaused     = t.paused;
+                    isFinished   = t.finished;
+                    currentTempo = t.tempo;
+                    MidiSpeed    = t.speed;
+                    firstPause   = t.waiting;
+                    // Extrapolation can run a hair past the next sample; hold the
+                    // tick rather than repaint. A real step back is a seek.
+                    if (t.tick + ppq < s_sharedTick)  InvalidateNoteBuffer();
+                    else if (t.tick < s_sharedTick)   t.tick = s_sharedTick;
+                    s_sharedTick = currentVisualizerTick = t.tick;
+                }
 				int tps = 0;
                 if (!isPaused && !isFinished) {
                     float dt = GetFrameTime();
@@ -2117,6 +2853,7 @@ int main(int argc, char* argv[]) {
                 static bool finishedPrinted = false;
                 if (isFinished && !finishedPrinted) {
                     std::cout << "- Playback Finished" << std::endl;
+                    g_FrameStats.PrintSummary();
                     finishedPrinted = true;
                 } else if (!isFinished && finishedPrinted) {
                     finishedPrinted = false;
@@ -2216,7 +2953,15 @@ int main(int argc, char* argv[]) {
                     DrawTexturePro(g_bgImageTex, src, dst, { 0.0f, 0.0f }, 0.0f, g_bgImageTint);
                 }
                 UpdateAndDrawParticles(GetFrameTime(), bpmFactor, isPaused);
-                DrawStreamingVisualizerNotes(noteTracks, currentVisualizerTick, ppq, currentTempo, g_viewerType);
+                if (g_viewerType == ViewerType::FallingNotes && g_FallingNotes.Available()) {
+                    DrawFallingNotes(noteTracks, currentVisualizerTick, ppq);   // CC lanes / keyboard are horizontal-only
+                } else {
+                    // Without instancing the falling view falls back to the tick layer
+                    const ViewerType vt = (g_viewerType == ViewerType::FallingNotes) ? ViewerType::TickLayer : g_viewerType;
+                    DrawStreamingVisualizerNotes(noteTracks, currentVisualizerTick, ppq, currentTempo, vt);
+                    if (showCCLanes) DrawCCLanes(currentVisualizerTick);
+                    if (showKeyboard) DrawKeyboardOverlay(noteTracks, currentVisualizerTick, ppq);
+                }
                 rlImGuiBegin();
                 if (isHUD) {
 				DrawRectangleRounded({10.0f, 10.0f, 450.0f, 10.0f}, 1.0f, 32, Color{64,96,64,128});
@@ -2259,7 +3004,7 @@ int main(int argc, char* argv[]) {
 					{
                         int curBarW = (int)barW;
                         if (g_npsGridBuiltWidth != curBarW && g_songDurationSec > 0.0)
-                            BuildNpsGrid(noteTracks, curBarW); // rebuild for new width
+                            BuildNpsGrid(curBarW); // rebuild for new width
                     }
                     if (g_npsGridReady && g_npsGridCells > 0) {
                         const float cellW = (float)kNpsCellPx;
@@ -2280,11 +3025,23 @@ int main(int argc, char* argv[]) {
                             float    seekFrac = std::clamp((mp.x - barX) / barW, 0.f, 1.f);
                             // Use time fraction directly — tick->seconds is non-linear with tempo changes
                             uint64_t seekUs = (uint64_t)((double)seekFrac * g_songDurationSec * 1'000'000.0);
-                            g_AudioEngine.SeekAbsolute(seekUs);
+                            seekTo(seekUs);
                             InvalidateNoteBuffer();
                             lastCounterTick = UINT64_MAX;
                         }
                     }
+                    if (showMinimap && g_Minimap.IsReady()) {
+                        const Rectangle mm = { barX, sh - 30.0f - 4.0f - (float)MINIMAP_HEIGHT, barW, (float)MINIMAP_HEIGHT };
+                        g_Minimap.Draw(mm, (g_songDurationSec > 0.0) ? (float)(TicksToSeconds(currentVisualizerTick) / g_songDurationSec) : 0.f);
+                        if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !ImGui::GetIO().WantCaptureMouse) {
+                            const float seekFrac = SongMinimap::HitTest(mm, GetMousePosition());
+                            if (seekFrac >= 0.f) {
+                                seekTo((uint64_t)((double)seekFrac * g_songDurationSec * 1'000'000.0));
+                                InvalidateNoteBuffer();
+                                lastCounterTick = UINT64_MAX;
+                            }
+                        }
+                    }
                 } // end bottom progress bar scope
                 DrawText(TextFormat("Notes: %s / %s", FormatWithCommas(noteCounter).c_str(), FormatWithCommas(noteTotal).c_str()), 10, 23, 20, JLIGHTBLUE);
                 double curSec = TicksToSeconds(currentVisualizerTick);
@@ -2321,7 +3078,9 @@ int main(int argc, char* argv[]) {
 					
                     if (ImGui::Begin("Options [F9]", &showOptions, wflags)) {
 						// ── Playback ─────────────────────────────────────────────────────
-						if (ImGui::CollapsingHeader("Playback", ImGuiTreeNodeFlags_DefaultOpen)) {
+						if (!ownsTransport) {
+							ImGui::TextDisabled("Playback follows the primary window '%s'", g_SongShare.Name().c_str());
+						} else if (ImGui::CollapsingHeader("Playback", ImGuiTreeNodeFlags_DefaultOpen)) {
 				 
 							// Speed slider (0.01x – 10.0x)
 							if (ImGui::SliderFloat("Speed", &MidiSpeed, 0.01f, 10.0f, "%.2fx")) {
@@ -2442,6 +3201,14 @@ int main(int argc, char* argv[]) {
 							if (ImGui::Checkbox("Anti-Slowdown", &isAntiSlowdown)) {
 								g_AudioEngine.ToggleAntiSlowdown(isAntiSlowdown);
 							}
+							// Watch file: re-read it when saved, splicing in only the changed tracks
+							bool watch = g_MidiWatch.Enabled();
+							if (ImGui::Checkbox("Watch file", &watch)) g_MidiWatch.SetEnabled(watch);
+							if (g_SongShare.IsPrimary() || g_SongShare.IsSecondary()) {
+								ImGui::SameLine(); ImGui::TextDisabled("(off while the song is shared)");
+							} else if (!g_MidiWatch.LastResult().empty()) {
+								ImGui::SameLine(); ImGui::TextDisabled("%s", g_MidiWatch.LastResult().c_str());
+							}
 				 
 							// Seek buttons
 							ImGui::Spacing();
@@ -2456,6 +3223,13 @@ int main(int argc, char* argv[]) {
 						
 						// Audio Config window (BassMIDI pre-render) -- toggled by F8
 						DrawAudioConfigPanel();
+
+						// Event filter (mutes / key range / stripping) -- applies to every audio mode
+						DrawEventFilterPanel();
+
+						// Per-track show / mute / solo (virtual-scrolled list)
+						DrawTrackListPanel(noteTracks, GetTrackColorPFA);
+						DrawCapturePanel();
 						
 						// Lag Simulator -- hidden when BassMIDI audio mode is active
 						if (g_BassEngine.GetActiveMode() == AudioMode::KDMAPI)
@@ -2463,6 +3237,8 @@ int main(int argc, char* argv[]) {
 						else {
 							ImGui::TextDisabled("Lag Simulator disabled (BassMIDI mode active).");
 						}
+						DrawEmulatedSinkPanel();
+						DrawBurstSpreadPanel(g_AudioEngine);
 				 
 						// ── Render ───────────────────────────────────────────────────────
 						if (ImGui::CollapsingHeader("Render", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -2478,6 +3254,13 @@ int main(int argc, char* argv[]) {
 							ImGui::Checkbox("Show Guide", &showGuide);
 							ImGui::SameLine();
 							ImGui::Checkbox("Show Beats", &showBeats);
+							ImGui::SameLine();
+							ImGui::Checkbox("Show Keyboard", &showKeyboard);
+							ImGui::SameLine();
+							ImGui::Checkbox("Show CC Lanes", &showCCLanes);
+							ImGui::SameLine();
+							ImGui::Checkbox("Show Minimap", &showMinimap);
+							if (ImGui::Checkbox("Time-Domain Scroll", &g_timeDomainScroll)) InvalidateNoteBuffer();
 				 
 							// Beat subdivisions (only relevant when beats are on, But no change update)
 							if (showBeats) {
@@ -2489,13 +3272,14 @@ int main(int argc, char* argv[]) {
 				 
 							// Layer selector: matches the T key toggle
 							// No updates at render after change layer.
-							int layerIdx = (g_viewerType == ViewerType::TickLayer) ? 1 : 0;
-							const char* layers[] = { "Channel / Track", "Tick Layer" };
+							int layerIdx = (int)g_viewerType;
+							const char* layers[] = { "Channel / Track", "Tick Layer", "Falling Notes" };
 							if (ImGui::Combo("Layer", &layerIdx, layers, IM_ARRAYSIZE(layers))) {
-								g_viewerType = (layerIdx == 1)
-											 ? ViewerType::TickLayer
-											 : ViewerType::ChannelTrackLayer;
+								g_viewerType = (ViewerType)layerIdx;
+								InvalidateNoteBuffer();
 							}
+							if (g_viewerType == ViewerType::FallingNotes && !g_FallingNotes.Available())
+								ImGui::TextDisabled("Instancing unavailable (needs GL 3.3 / GLES 3.0) - using Tick Layer");
 						}
 				 
 						// ── Display ──────────────────────────────────────────────────────
@@ -2571,9 +3355,9 @@ int main(int argc, char* argv[]) {
 							ImGui::Checkbox("Show##Particle", &g_particleShow);
 							if (g_particleShow) {
 								ImGui::SameLine();
-								ImGui::SetNextItemWidth(70.0f);
-								if (ImGui::DragInt("Count##P", &g_particleCount, 1, 1, 512))
-									g_particleCount = std::clamp(g_particleCount, 1, 512);
+								ImGui::SetNextItemWidth(90.0f);
+								if (ImGui::DragInt("Count##P", &g_particleCount, 10, 1, BgParticleField::kMaxParticles))
+									g_particleCount = std::clamp(g_particleCount, 1, BgParticleField::kMaxParticles);
 								ImGui::SetNextItemWidth(110.0f);
 								ImGui::DragFloat("Speed##P", &g_particleSpeed, 1.0f, 10.0f, 2000.0f, "%.0f px/s");
 								ImGui::SameLine();
@@ -2634,18 +3418,29 @@ int main(int argc, char* argv[]) {
 					ImGui::End();
 				}
                 rlImGuiEnd();
+                g_FrameCapture.OnFrameEnd();
                 EndDrawing();
                 break;
             }
         }
     }
     std::cout << "- Exiting..." << std::endl;
-	SaveAudioConfig();
+    g_Startup.Wait();           // soundfonts must be registered before they are saved back
+	// An attached window or a null-audio run never loaded the soundfonts; a benchmark leaves the user's settings alone
+	if (!g_SongShare.IsSecondary() && !g_Benchmark.Enabled() && !g_NullSink.IsEnabled()) SaveAudioConfig();
     g_AudioEngine.Stop();
     StopNoteRenderThread();
+    g_Minimap.Reset();          // its builder may still read shared notes
+    g_MidiWatch.Disarm();       // joins a re-parse still reading the file
+    noteTracks.clear();
+    g_SongShare.Shutdown();
+    g_MidiLibrary.Cancel();     // saves what the scan probed so far
+    g_FrameCapture.Shutdown();  // flush pending captures while the GL context is alive
+    g_FallingNotes.Unload();
+    g_particles.Unload();
     g_BassEngine.Shutdown();    // shut down BassMIDI / pre-render before KDMAPI
     TerminateKDMAPIStream();    // KDMAPI last (nothing routes through it after above)
 	rlImGuiShutdown();
     CloseWindow();
-    return 0;
+    return g_Benchmark.ExitCode();   // 0 outside --benchmark
 }
\ No newline at end of file
@@ -0,0 +1,333 @@
+// Chunk painter golden-image test
+// Paints chunks of synthetic songs (and of a format-1 file run through the
+// loader) with both texture viewers, several pixels-per-tick values, the tick
+// and time axes, a coarse stride and hidden tracks / channels, then compares
+// an FNV-1a hash of each case's pixels with src/Test/golden/chunk_painter.txt.
+// Paint time is reported per case, so a faster painter can be shown to give
+// the same pixels.
+//
+//   painter-test                      compare against the goldens
+//   painter-test --update             (re)record the goldens
+//   painter-test --golden <file>      use another golden file
+//   painter-test a.mid b.mid ...      also paint these (keyed by name and size;
+//                                     record them locally with --update)
+
+#include "chunk_painter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static constexpr int    kChunkW      = 1024;   // a 512 px window: chunks are twice the screen width
+static constexpr int    kChunksCase  = 6;      // spread over the song
+static constexpr int    kReps        = 3;      // timing: best of; every rep must hash the same
+static constexpr int    kPpq         = 480;
+static const double     kPixPerTick[] = { 0.02, 0.25, 1.333, 6.0 };
+
+// ── Songs ────────────────────────────────────────────────────────────────────
+// Start ticks are unique within a track: the loader's note sort and the
+// TickLayer sort are not stable, and equal keys would make the pixels depend
+// on the standard library.
+struct Song {
+    string                     name;
+    vector<OptimizedTrackData> tracks;
+    uint32_t                   span = 0;   // last end tick
+};
+
+struct Lcg {
+    uint32_t s;
+    explicit Lcg(uint32_t seed) : s(seed * 2654435761u + 1) {}
+    uint32_t operator()() { s = s * 1664525u + 1013904223u; return s >> 8; }
+};
+
+// `notes` per track, start ticks `gap` apart on average, lengths up to maxLen.
+// Every dupEvery-th track repeats the previous track's notes (same key, start
+// and end) so layering between identical notes is covered.
+static Song MakeSong(const string& name, int trackCount, int notes, uint32_t gap, uint32_t maxLen, int dupEvery, uint32_t seed) {
+    Song song;
+    song.name = name;
+    song.tracks.resize((size_t)trackCount);
+    for (int t = 0; t < trackCount; ++t) {
+        auto& out = song.tracks[(size_t)t].notes;
+        if (dupEvery && t > 0 && t % dupEvery == 0) {
+            for (size_t i = 0; i < song.tracks[(size_t)t - 1].notes.size(); ++i) {
+                NoteEvent n = song.tracks[(size_t)t - 1].notes[i];
+                n.channel = (uint8_t)(t % 16);
+                out.push_back(n);
+            }
+            continue;
+        }
+        Lcg rng((uint32_t)t + seed);
+        uint32_t tick = rng() % gap;
+        for (int i = 0; i < notes; ++i) {
+            NoteEvent n{};
+            n.startTick   = tick;
+            n.endTick     = tick + (rng() % 8 == 0 ? 0 : 1 + rng() % maxLen);   // some zero-length
+            n.note        = (uint8_t)(rng() % 128);
+            n.velocity    = (uint8_t)(1 + rng() % 127);
+            n.channel     = (uint8_t)((t + (int)(rng() % 4 == 0)) % 16);
+            n.visualTrack = (uint8_t)t;
+            out.push_back(n);
+            song.span = max(song.span, n.endTick);
+            tick += 1 + rng() % (2 * gap);
+        }
+    }
+    return song;
+}
+
+// ── SMF writer (the loader path) ─────────────────────────────────────────────
+static void Put32(vector<uint8_t>& o, uint32_t v) { for (int i = 3; i >= 0; --i) o.push_back((uint8_t)(v >> (i * 8))); }
+static void Put16(vector<uint8_t>& o, uint16_t v) { o.push_back((uint8_t)(v >> 8)); o.push_back((uint8_t)v); }
+static void PutVlq(vector<uint8_t>& o, uint32_t v) {
+    uint8_t b[5]; int n = 0;
+    b[n++] = v & 0x7F;
+    while (v >>= 7) b[n++] = (uint8_t)(0x80 | (v & 0x7F));
+    while (n) o.push_back(b[--n]);
+}
+
+static void WriteSmf(const string& path, const Song& song) {
+    vector<uint8_t> f;
+    Put32(f, 0x4D546864); Put32(f, 6); Put16(f, 1); Put16(f, (uint16_t)song.tracks.size()); Put16(f, kPpq);
+    for (const auto& track : song.tracks) {
+        struct Ev { uint32_t tick; uint8_t status, key, vel; };
+        vector<Ev> evs;
+        for (size_t i = 0; i < track.notes.size(); ++i) {
+            const NoteEvent& n = track.notes[i];
+            if (n.endTick <= n.startTick) continue;   // an off on the start tick would sort before its own on
+            evs.push_back({ n.startTick, (uint8_t)(0x90 | n.channel), n.note, n.velocity });
+            evs.push_back({ n.endTick,   (uint8_t)(0x80 | n.channel), n.note, 0 });
+        }
+        // Offs before ons on the same tick, so a retrigger pairs with the right off
+        stable_sort(evs.begin(), evs.end(), [](const Ev& a, const Ev& b) {
+            if (a.tick != b.tick) return a.tick < b.tick;
+            return (a.status & 0xF0) < (b.status & 0xF0);
+        });
+        vector<uint8_t> data;
+        uint32_t last = 0;
+        for (const auto& e : evs) {
+            PutVlq(data, e.tick - last);
+            last = e.tick;
+            data.insert(data.end(), { e.status, e.key, e.vel });
+        }
+        data.insert(data.end(), { 0x00, 0xFF, 0x2F, 0x00 });
+        Put32(f, 0x4D54726B);
+        Put32(f, (uint32_t)data.size());
+        f.insert(f.end(), data.begin(), data.end());
+    }
+    FILE* fp = fopen(path.c_str(), "wb");
+    fwrite(f.data(), 1, f.size(), fp);
+    fclose(fp);
+}
+
+static bool LoadSong(const string& path, const string& name, Song& song) {
+    int ppq = 0, tempo = 0;
+    uint64_t total = 0;
+    uint16_t num = 4, den = 4;
+    song.name = name;
+    song.tracks.clear();
+    loadStreamingMidiData(path, song.tracks, ppq, tempo, total, num, den);
+    song.span = 0;
+    for (const auto& t : song.tracks)
+        for (size_t i = 0; i < t.notes.size(); ++i) song.span = max(song.span, t.notes[i].endTick);
+    return total > 0;
+}
+
+// ── Cases ────────────────────────────────────────────────────────────────────
+// 120 BPM, then 168 BPM from bar 51: enough for the time axis to differ from
+// the tick axis by more than a scale.
+static vector<TempoSeg> TempoMap() {
+    const double slow = 500000.0 / kPpq, fast = 357143.0 / kPpq;
+    const uint32_t change = 96000;
+    return { { 0, 0.0, slow }, { change, change * slow / 1000000.0, fast } };
+}
+
+static vector<Color> Palette(size_t tracks) {
+    vector<Color> pal(min<size_t>(tracks * 16, 65535));
+    Lcg rng(7);
+    for (auto& c : pal) c = { (unsigned char)(1 + rng() % 255), (unsigned char)(rng() % 256), (unsigned char)(rng() % 256), 255 };
+    return pal;
+}
+
+// ~140 KB each: kept off the stack
+static TrackMasks s_allVisible, s_someHidden;
+
+static uint64_t Fnv1a(uint64_t h, const void* p, size_t n) {
+    const uint8_t* b = (const uint8_t*)p;
+    for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 0x100000001B3ull; }
+    return h;
+}
+
+struct CaseResult {
+    uint64_t hash  = 0;
+    uint64_t notes = 0;
+    double   msPerChunk = 0.0;
+    bool     stable = true;   // every rep gave the same pixels
+};
+
+static CaseResult PaintCase(const ChunkPaintContext& ctx, uint32_t axisSpan, uint32_t stride) {
+    const uint32_t ticksPerChunk = (uint32_t)((double)ctx.width / ctx.pixPerTick) + 1;
+    vector<uint32_t> buf((size_t)ctx.width * kChunkRows);
+    CaseResult r;
+    double best = 1e30;
+    for (int rep = 0; rep < kReps; ++rep) {
+        uint64_t h = 0xCBF29CE484222325ull, notes = 0;
+        double ms = 0.0;
+        for (int c = 0; c < kChunksCase; ++c) {
+            const uint32_t ts = (uint32_t)((uint64_t)axisSpan * c / kChunksCase);
+            const auto t0 = chrono::steady_clock::now();
+            notes += PaintChunkRange(ctx, ts, ts + ticksPerChunk, buf.data(), (size_t)ctx.width, stride);
+            ms += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            h = Fnv1a(h, buf.data(), buf.size() * sizeof(uint32_t));
+        }
+        if (rep == 0) { r.hash = h; r.notes = notes; }
+        else r.stable &= (h == r.hash && notes == r.notes);
+        best = min(best, ms);
+    }
+    r.msPerChunk = best / kChunksCase;
+    return r;
+}
+
+// ── Goldens ──────────────────────────────────────────────────────────────────
+// One "<case> <hash>" line per case; '#' starts a comment. Case names may hold
+// spaces (file names), so the hash is the last field.
+static map<string, string> ReadGoldens(const string& path) {
+    map<string, string> g;
+    ifstream in(path);
+    string line;
+    while (getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        const size_t sp = line.rfind(' ');
+        if (sp == string::npos) continue;
+        g[line.substr(0, sp)] = line.substr(sp + 1);
+    }
+    return g;
+}
+
+static string Hex(uint64_t v) {
+    ostringstream o;
+    o << hex << setw(16) << setfill('0') << v;
+    return o.str();
+}
+
+int main(int argc, char** argv) {
+    cout << "Chunk Painter Golden Test" << endl;
+    cout << "=========================" << endl << endl;
+
+    bool update = false;
+    string goldenPath = "src/Test/golden/chunk_painter.txt";
+    vector<string> files;
+    for (int i = 1; i < argc; ++i) {
+        const string a = argv[i];
+        if (a == "--update") update = true;
+        else if (a == "--golden" && i + 1 < argc) goldenPath = argv[++i];
+        else files.push_back(a);
+    }
+
+    vector<Song> songs;
+    songs.push_back(MakeSong("sparse", 8, 2000, 100, 2000, 0, 1));
+    songs.push_back(MakeSong("dense", 64, 6000, 30, 240, 4, 2));
+    {
+        const string path = (filesystem::temp_directory_path() / "jidi_painter_test.mid").string();
+        WriteSmf(path, MakeSong("smf", 40, 3000, 60, 960, 5, 3));
+        Song s;
+        if (!LoadSong(path, "smf", s)) { cout << "loader returned no notes" << endl << "FAILED" << endl; return 1; }
+        songs.push_back(move(s));
+        filesystem::remove(path);
+    }
+    for (const auto& f : files) {
+        error_code ec;
+        const auto size = filesystem::file_size(f, ec);
+        Song s;
+        if (ec || !LoadSong(f, "file:" + filesystem::path(f).filename().string() + ":" + to_string(size), s)) {
+            cout << "  [warn] cannot load " << f << endl;
+            continue;
+        }
+        songs.push_back(move(s));
+    }
+
+    const map<string, string> goldens = update ? map<string, string>{} : ReadGoldens(goldenPath);
+    if (!update && goldens.empty()) cout << "  [warn] no goldens in " << goldenPath << "; run with --update to record them" << endl;
+    vector<pair<string, string>> recorded;
+    const vector<TempoSeg> tempo = TempoMap();
+    s_someHidden.SetTrackVisible(1, false);
+    s_someHidden.SetChannelVisible(9, false);
+    int mismatches = 0, fresh = 0;
+
+    for (const auto& song : songs) {
+        uint64_t noteTotal = 0;
+        for (const auto& t : song.tracks) noteTotal += t.notes.size();
+        cout << song.name << ": " << song.tracks.size() << " tracks, " << noteTotal << " notes" << endl;
+
+        NoteTimeColumns times;
+        times.Build(song.tracks, tempo);
+        const vector<Color> pal = Palette(song.tracks.size());
+
+        auto run = [&](const string& caseName, ViewerType viewer, bool timeAxis, double ppt, uint32_t stride, const TrackMasks& masks) {
+            ChunkPaintContext ctx;
+            ctx.tracks      = &song.tracks;
+            ctx.times       = timeAxis ? &times : nullptr;
+            ctx.viewer      = viewer;
+            ctx.width       = kChunkW;
+            ctx.pixPerTick  = ppt;
+            ctx.palette     = pal.data();
+            ctx.paletteSize = (int)pal.size();
+            ctx.masks       = &masks;
+            const uint32_t axisSpan = timeAxis ? (uint32_t)times.TickToUnits(song.span) : song.span;
+            const CaseResult r = PaintCase(ctx, axisSpan, stride);
+
+            const string key  = song.name + "/" + caseName;
+            const string hash = Hex(r.hash);
+            const auto   it   = goldens.find(key);
+            string verdict;
+            if (!r.stable)               { verdict = "UNSTABLE"; ++mismatches; }
+            else if (update)             { verdict = "recorded"; }
+            else if (it == goldens.end()) { verdict = "NEW";      ++fresh; }
+            else if (it->second == hash)  { verdict = "OK"; }
+            else                          { verdict = "MISMATCH (golden " + it->second + ")"; ++mismatches; }
+            recorded.emplace_back(key, hash);
+            cout << "  " << left << setw(28) << caseName << right << fixed << setprecision(3)
+                 << setw(9) << r.msPerChunk << " ms/chunk" << setw(10) << r.notes << " notes  " << hash << "  " << verdict << endl;
+        };
+
+        for (ViewerType viewer : { ViewerType::ChannelTrackLayer, ViewerType::TickLayer }) {
+            const string v = viewer == ViewerType::TickLayer ? "tick-layer" : "track-layer";
+            for (bool timeAxis : { false, true })
+                for (double ppt : kPixPerTick) {
+                    ostringstream name;
+                    name << v << "/" << (timeAxis ? "time" : "tick") << "/ppt=" << ppt;
+                    run(name.str(), viewer, timeAxis, ppt, 1, s_allVisible);
+                }
+            run(v + "/coarse-7", viewer, false, 0.25, 7, s_allVisible);
+            run(v + "/masked", viewer, false, 1.333, 1, s_someHidden);
+        }
+        cout << endl;
+    }
+
+    if (update) {
+        filesystem::create_directories(filesystem::path(goldenPath).parent_path());
+        // Keep goldens of files not given this run (local real-file entries)
+        map<string, string> all = ReadGoldens(goldenPath);
+        for (const auto& [k, h] : recorded) all[k] = h;
+        ofstream out(goldenPath);
+        out << "# PaintChunkRange golden hashes: FNV-1a 64 over every chunk of a case.\n"
+            << "# Regenerate with `painter-test --update` only when a pixel change is intended.\n";
+        for (const auto& [k, h] : all) out << k << " " << h << "\n";
+        cout << "Recorded " << recorded.size() << " cases in " << goldenPath << endl;
+    }
+    if (fresh) cout << fresh << " case(s) have no golden yet" << endl;
+
+    const bool ok = mismatches == 0;
+    cout << endl << (ok ? "All tests passed!" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
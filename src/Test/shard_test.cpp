@@ -0,0 +1,184 @@
+// Sharded synthesis test program
+// Renders the same event stream through one SoftSynth and through a
+// ShardedSynth (channel and track routing) and checks the mixes match.
+// Then forces a track bucket to migrate while it holds a note and checks the
+// note-off still reaches the shard that plays it. Needs no BASS and no soundfont.
+
+#include "soft_synth.hpp"
+#include "synth_shard.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+static constexpr uint32_t kSampleRate = 48000;
+static constexpr uint32_t kBlock      = 480;     // 10 ms
+static constexpr int      kBlocks     = 600;     // 6 s
+static constexpr int      kVoices     = 1024;
+
+struct Msg { uint32_t msg; uint16_t track; };
+
+// Deterministic stream: 32 tracks spread over 16 channels. Each track owns its
+// own key range so no two tracks ever hold the same (channel, key) at once.
+static vector<vector<Msg>> BuildStream() {
+    vector<vector<Msg>> blocks(kBlocks);
+    uint32_t rng = 12345;
+    auto next = [&]() { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+
+    struct Held { int offBlock; uint8_t ch, key; uint16_t track; };
+    vector<Held> held;
+
+    for (int b = 0; b < kBlocks; ++b) {
+        auto& out = blocks[b];
+        for (size_t i = 0; i < held.size();) {
+            if (held[i].offBlock == b) {
+                out.push_back({ (uint32_t)(0x80 | held[i].ch) | ((uint32_t)held[i].key << 8), held[i].track });
+                held[i] = held.back(); held.pop_back();
+            } else ++i;
+        }
+        int count = 2 + (int)(next() % 24);
+        for (int e = 0; e < count; ++e) {
+            uint16_t track = (uint16_t)(next() % 32);
+            uint8_t  ch    = (uint8_t)(track % 16);
+            uint32_t r     = next() % 100;
+            if (r < 80) {
+                uint8_t key = (uint8_t)(24 + (track / 16) * 48 + next() % 48);
+                bool busy = false;
+                for (auto& h : held) if (h.ch == ch && h.key == key) { busy = true; break; }
+                if (busy) continue;
+                uint8_t vel = (uint8_t)(1 + next() % 127);
+                out.push_back({ (uint32_t)(0x90 | ch) | ((uint32_t)key << 8) | ((uint32_t)vel << 16), track });
+                held.push_back({ b + 1 + (int)(next() % 40), ch, key, track });
+            } else if (r < 90) {
+                uint8_t cc  = (next() & 1) ? 7 : 10;
+                out.push_back({ (uint32_t)(0xB0 | ch) | ((uint32_t)cc << 8) | ((uint32_t)(next() % 128) << 16), track });
+            } else if (r < 96) {
+                uint32_t bend = next() % 16384;
+                out.push_back({ (uint32_t)(0xE0 | ch) | ((bend & 0x7F) << 8) | ((bend >> 7) << 16), track });
+            } else {
+                out.push_back({ (uint32_t)(0xC0 | ch) | ((uint32_t)(next() % 128) << 8), track });
+            }
+        }
+    }
+    return blocks;
+}
+
+static vector<float> RenderReference(const vector<vector<Msg>>& blocks) {
+    SoftSynth synth(kSampleRate, kVoices);
+    vector<float> out((size_t)kBlocks * kBlock * 2);
+    for (int b = 0; b < kBlocks; ++b) {
+        for (const auto& m : blocks[b]) synth.SendShort(m.msg);
+        synth.Render(&out[(size_t)b * kBlock * 2], kBlock);
+    }
+    return out;
+}
+
+static bool RunSharded(const vector<vector<Msg>>& blocks, const vector<float>& ref,
+                       int shardCount, ShardKey key) {
+    ShardedSynth shards;
+    shards.Start(shardCount, key, [] { return make_unique<SoftSynth>(kSampleRate, kVoices); });
+
+    vector<float> out((size_t)kBlocks * kBlock * 2);
+    auto t0 = chrono::steady_clock::now();
+    for (int b = 0; b < kBlocks; ++b) {
+        for (const auto& m : blocks[b]) shards.Send(m.msg, m.track);
+        shards.Render(&out[(size_t)b * kBlock * 2], kBlock);
+    }
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+    double maxDiff = 0.0, peak = 0.0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        maxDiff = max(maxDiff, (double)fabs(out[i] - ref[i]));
+        peak    = max(peak, (double)fabs(ref[i]));
+    }
+
+    bool ok = maxDiff < 1e-4;
+    cout << (key == ShardKey::Channel ? "channel" : "track  ") << "  shards " << setw(2) << shardCount
+         << "  render " << fixed << setprecision(2) << setw(8) << ms << " ms"
+         << "  max diff " << scientific << setprecision(2) << maxDiff
+         << "  (peak " << fixed << setprecision(3) << peak << ")  "
+         << (ok ? "OK" : "MISMATCH") << endl;
+
+    auto stats = shards.GetStats();
+    for (size_t i = 0; i < stats.size(); ++i) {
+        cout << "    #" << i << " keys " << stats[i].routeKeys << "  events " << stats[i].events
+             << "  avg block " << fixed << setprecision(1) << stats[i].renderUs << " us" << endl;
+    }
+    shards.Stop();
+    return ok;
+}
+
+// Track mode, 2 shards (buckets alternate). Track 0 holds ch 0 key 60 on shard
+// 0 next to a heavy track; a rebalance moves bucket 0 to shard 1, where track
+// 1 then holds the same ch 0 key 60. Track 0's note-off must release its own
+// note on shard 0, not track 1's on shard 1.
+static bool RunMigration() {
+    ShardedSynth shards;
+    shards.Start(2, ShardKey::Track, [] { return make_unique<SoftSynth>(kSampleRate, kVoices); });
+    vector<float> out((size_t)kBlock * 2);
+    auto render = [&](int blocks) { for (int b = 0; b < blocks; ++b) shards.Render(out.data(), kBlock); };
+    auto on  = [](uint8_t ch, uint8_t key) { return (uint32_t)(0x90 | ch) | ((uint32_t)key << 8) | (100u << 16); };
+    auto off = [](uint8_t ch, uint8_t key) { return (uint32_t)(0x80 | ch) | ((uint32_t)key << 8); };
+
+    shards.Send(on(0, 60), 0);
+    for (uint8_t ch = 1; ch < 16; ++ch)
+        for (uint8_t key = 20; key < 80; ++key) shards.Send(on(ch, key), 2);   // bucket 2: shard 0
+    render(10);
+
+    // Next send rebalances: shard 0 is far busier, bucket 0 is its lightest key
+    shards.SetBalanceInterval(1, 0);
+    shards.Send(0xA0u | (60u << 8) | (10u << 16), 0);
+    shards.SetBalanceInterval(ShardedSynth::kBalanceEvery, ShardedSynth::kBalanceMinUs);
+    const bool moved = shards.GetStats()[1].routeKeys == ShardedSynth::kTrackBuckets / 2 + 1;
+
+    // Aftertouch on the migrated key still reaches the shard sounding it
+    render(1);
+    const auto pre = shards.GetStats();
+    shards.Send(0xA0u | (60u << 8) | (20u << 16), 0);
+    render(1);
+    const auto post = shards.GetStats();
+    const bool pressure = post[0].events == pre[0].events + 1 && post[1].events == pre[1].events;
+
+    shards.Send(on(0, 60), 1);    // bucket 1: shard 1
+    shards.Send(off(0, 60), 0);   // must go to shard 0
+    for (uint8_t ch = 1; ch < 16; ++ch)
+        for (uint8_t key = 20; key < 80; ++key) shards.Send(off(ch, key), 2);
+    render(60);                   // releases fade in ~150 ms
+
+    const auto stats = shards.GetStats();
+    const bool ok = moved && pressure && stats[0].voices == 0 && stats[1].voices == 1;
+    cout << "migration  bucket moved " << (moved ? "yes" : "no") << "  aftertouch to #0 " << (pressure ? "yes" : "no")
+         << "  voices after release: #0 "
+         << stats[0].voices << " (want 0)  #1 " << stats[1].voices << " (want 1)  " << (ok ? "OK" : "MISMATCH") << endl;
+    shards.Stop();
+    return ok;
+}
+
+int main() {
+    cout << "Sharded Synth Test" << endl;
+    cout << "==================" << endl << endl;
+
+    auto blocks = BuildStream();
+    size_t total = 0;
+    for (auto& b : blocks) total += b.size();
+    cout << "Events: " << total << " over " << kBlocks << " blocks of " << kBlock << " frames" << endl << endl;
+
+    auto ref = RenderReference(blocks);
+
+    bool ok = true;
+    for (int n : { 1, 2, 4, 8 }) {
+        ok &= RunSharded(blocks, ref, n, ShardKey::Channel);
+        ok &= RunSharded(blocks, ref, n, ShardKey::Track);
+    }
+    cout << endl;
+    ok &= RunMigration();
+
+    cout << endl << (ok ? "All tests passed!" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
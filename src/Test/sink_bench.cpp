@@ -0,0 +1,174 @@
+// Emulated sink benchmark
+// Replays deterministic workloads through SinkModel in virtual time and prints
+// how each overflow policy copes: drops, sender stall, latency percentiles and
+// how far the sender drifted behind the song. No audio device is involved, so
+// every run prints the same numbers; the program checks that too.
+// The second table replays the chord workloads with same-tick bursts spread
+// across a window (BurstSpreader, as the playback thread applies it) and shows
+// what that does to the sink's peak queue depth.
+
+#include "burst_spread.hpp"
+#include "emulated_sink.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+struct TimedMsg { uint64_t ns; uint32_t msg; };
+
+static uint32_t NoteOn(uint8_t ch, uint8_t key, uint8_t vel) { return (uint32_t)(0x90 | ch) | ((uint32_t)key << 8) | ((uint32_t)vel << 16); }
+static uint32_t NoteOff(uint8_t ch, uint8_t key)             { return (uint32_t)(0x80 | ch) | ((uint32_t)key << 8); }
+
+// 2 s of evenly spaced short notes at `eps` events per second
+static vector<TimedMsg> Steady(uint64_t eps) {
+    vector<TimedMsg> out;
+    const uint64_t gap = 1'000'000'000ull / eps;
+    for (uint64_t i = 0, t = 0; t < 2'000'000'000ull; ++i, t += gap) {
+        const uint64_t n = i / 2;   // on, then off for the same key
+        const uint8_t ch = (uint8_t)(n % 16), key = (uint8_t)(36 + n % 48);
+        out.push_back({ t, (i & 1) ? NoteOff(ch, key) : NoteOn(ch, key, 100) });
+    }
+    return out;
+}
+
+// Black-MIDI style: every 100 ms a `chord`-note wall lands on one instant and
+// is released 80 ms later
+static vector<TimedMsg> Bursts(uint32_t chord) {
+    vector<TimedMsg> out;
+    uint32_t rng = 12345;
+    for (uint64_t t = 0; t < 5'000'000'000ull; t += 100'000'000ull) {
+        vector<pair<uint8_t, uint8_t>> keys;
+        for (uint32_t i = 0; i < chord; ++i) {
+            rng = rng * 1664525u + 1013904223u;
+            keys.push_back({ (uint8_t)((rng >> 8) % 16), (uint8_t)((rng >> 16) % 128) });
+            out.push_back({ t, NoteOn(keys.back().first, keys.back().second, 1 + (uint8_t)((rng >> 24) % 127)) });
+        }
+        for (auto& k : keys) out.push_back({ t + 80'000'000ull, NoteOff(k.first, k.second) });
+    }
+    return out;
+}
+
+// Back-to-back walls: every 50 ms the previous `chord` notes are released and
+// a new wall starts on the same instant, offs first as the loader sorts them
+static vector<TimedMsg> Walls(uint32_t chord) {
+    vector<TimedMsg> out;
+    vector<pair<uint8_t, uint8_t>> held;
+    uint32_t rng = 777;
+    for (uint64_t t = 0; t < 5'000'000'000ull; t += 50'000'000ull) {
+        for (auto& k : held) out.push_back({ t, NoteOff(k.first, k.second) });
+        held.clear();
+        for (uint32_t i = 0; i < chord; ++i) {
+            rng = rng * 1664525u + 1013904223u;
+            held.push_back({ (uint8_t)((rng >> 8) % 16), (uint8_t)((rng >> 16) % 128) });
+            out.push_back({ t, NoteOn(held.back().first, held.back().second, 1 + (uint8_t)((rng >> 24) % 127)) });
+        }
+    }
+    return out;
+}
+
+// Send times after burst spreading; the order of the events is unchanged
+static vector<TimedMsg> Spread(const vector<TimedMsg>& events, uint64_t windowNs, uint32_t minEvents) {
+    vector<TimedMsg> out = events;
+    BurstSpreader spreader;
+    for (size_t i = 0; i < events.size(); ++i)
+        out[i].ns += (uint64_t)spreader.Offset(events, i, (double)windowNs, minEvents,
+            [](const TimedMsg& e) { return e.ns; });
+    return out;
+}
+
+// Sender model: sends each event at its song time unless a previous block
+// pushed it later (the playback thread runs late behind a full sink)
+static SinkStats Run(const vector<TimedMsg>& events, const SinkModelConfig& cfg, uint64_t& driftNs) {
+    SinkModel sink(cfg);
+    uint64_t now = 0;
+    for (const auto& e : events) {
+        if (e.ns > now) now = e.ns;
+        now += sink.Submit(e.msg, now).blockedNs;
+    }
+    driftNs = events.empty() ? 0 : now - events.back().ns;
+    return sink.Stats();
+}
+
+int main() {
+    struct Workload { string name; vector<TimedMsg> events; };
+    vector<Workload> workloads = {
+        { "steady 200k eps", Steady(200'000) },
+        { "steady 4M eps",   Steady(4'000'000) },
+        { "bursts 2k notes", Bursts(2'000) },
+        { "bursts 20k notes", Bursts(20'000) },
+    };
+    struct Policy { const char* name; SinkOverflow overflow; };
+    const Policy policies[] = {
+        { "block",       SinkOverflow::Block },
+        { "drop-newest", SinkOverflow::DropNewest },
+        { "drop-ons",    SinkOverflow::DropNoteOns },
+    };
+
+    SinkModelConfig base;
+    base.queueDepth  = 4096;
+    base.eventCostNs = 400.0;
+    base.voiceCostNs = 0.5;
+    base.maxVoices   = 4096;
+
+    printf("queue %u  cost %.0f ns + %.1f ns/voice  max voices %u\n\n",
+           base.queueDepth, base.eventCostNs, base.voiceCostNs, base.maxVoices);
+    printf("%-17s %-12s %10s %9s %10s %9s %9s %9s %10s %7s\n",
+           "workload", "policy", "accepted", "dropped", "stall ms", "p50 ms", "p99 ms", "max ms", "drift ms", "voices");
+
+    bool deterministic = true;
+    for (const auto& w : workloads) {
+        for (const auto& p : policies) {
+            SinkModelConfig cfg = base;
+            cfg.overflow = p.overflow;
+            uint64_t drift = 0, drift2 = 0;
+            const SinkStats st  = Run(w.events, cfg, drift);
+            const SinkStats st2 = Run(w.events, cfg, drift2);
+            if (!(st == st2) || drift != drift2) deterministic = false;
+
+            printf("%-17s %-12s %10llu %9llu %10.2f %9.3f %9.3f %9.3f %10.2f %7u\n",
+                   w.name.c_str(), p.name,
+                   (unsigned long long)st.accepted, (unsigned long long)st.dropped,
+                   st.blockedNs / 1e6, st.p50LatencyNs / 1e6, st.p99LatencyNs / 1e6,
+                   st.maxLatencyNs / 1e6, drift / 1e6, st.peakVoices);
+        }
+    }
+
+    // ── Same-tick burst spreading ──
+    struct Chords { string name; vector<TimedMsg> events; };
+    vector<Chords> chords = {
+        { "bursts 2k notes",  Bursts(2'000) },
+        { "bursts 20k notes", Bursts(20'000) },
+        { "walls 4k notes",   Walls(4'000) },
+    };
+    const uint64_t windowsUs[] = { 0, 100, 250, 500, 1000 };
+
+    printf("\nsame-tick spread (block policy, min %u events)\n", BurstSpreader::kDefaultMinEvents);
+    printf("%-17s %-9s %10s %10s %9s %9s %10s\n",
+           "workload", "window", "max queue", "stall ms", "p99 ms", "max ms", "drift ms");
+
+    bool ordered = true;
+    for (const auto& c : chords) {
+        for (uint64_t us : windowsUs) {
+            const vector<TimedMsg> spread = Spread(c.events, us * 1000, BurstSpreader::kDefaultMinEvents);
+            for (size_t i = 1; i < spread.size(); ++i)
+                if (spread[i].ns < spread[i - 1].ns) ordered = false;
+
+            SinkModelConfig cfg = base;
+            cfg.overflow = SinkOverflow::Block;
+            uint64_t drift = 0;
+            const SinkStats st = Run(spread, cfg, drift);
+            char window[16];
+            snprintf(window, sizeof(window), us ? "%llu us" : "off", (unsigned long long)us);
+            printf("%-17s %-9s %10llu %10.2f %9.3f %9.3f %10.2f\n",
+                   c.name.c_str(), window, (unsigned long long)st.maxQueue, st.blockedNs / 1e6,
+                   st.p99LatencyNs / 1e6, st.maxLatencyNs / 1e6, drift / 1e6);
+        }
+    }
+
+    printf("\n%s\n", deterministic ? "PASS: repeated runs identical" : "FAIL: repeated runs differ");
+    printf("%s\n", ordered ? "PASS: spreading kept send order" : "FAIL: spreading reordered events");
+    return deterministic && ordered ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+// Watch mode test program
+// Writes a format-1 file, loads it, then saves edited versions and checks
+// that PrepareTrackReload + ApplyTrackReload (with the CC lane and event
+// filter splices) give the same events, notes, lanes and filtered stream as
+// loading the edited file from scratch. Also checks the cases that must fall
+// back to a full reload, and that the apply time follows the edit size.
+
+#include "cc_lanes.hpp"
+#include "event_filter.hpp"
+#include "midi_watch.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+static constexpr int      kChunks     = 300;   // > 256: chunks t and t + 256 share a visual track
+static constexpr int      kNotesTrack = 400;
+static constexpr uint32_t kSpanTicks  = 40000;
+
+// ── SMF writer ───────────────────────────────────────────────────────────────
+static void Put32(vector<uint8_t>& o, uint32_t v) { for (int i = 3; i >= 0; --i) o.push_back((uint8_t)(v >> (i * 8))); }
+static void Put16(vector<uint8_t>& o, uint16_t v) { o.push_back((uint8_t)(v >> 8)); o.push_back((uint8_t)v); }
+static void PutVlq(vector<uint8_t>& o, uint32_t v) {
+    uint8_t b[5]; int n = 0;
+    b[n++] = v & 0x7F;
+    while (v >>= 7) b[n++] = (uint8_t)(0x80 | (v & 0x7F));
+    while (n) o.push_back(b[--n]);
+}
+
+struct RawEvent { uint32_t tick; vector<uint8_t> bytes; };
+
+static vector<uint8_t> TrackChunk(vector<RawEvent> evs) {
+    stable_sort(evs.begin(), evs.end(), [](const RawEvent& a, const RawEvent& b) { return a.tick < b.tick; });
+    vector<uint8_t> data;
+    uint32_t last = 0;
+    for (const auto& e : evs) {
+        PutVlq(data, e.tick - last);
+        last = e.tick;
+        data.insert(data.end(), e.bytes.begin(), e.bytes.end());
+    }
+    data.insert(data.end(), { 0x00, 0xFF, 0x2F, 0x00 });
+    vector<uint8_t> chunk;
+    Put32(chunk, 0x4D54726B);
+    Put32(chunk, (uint32_t)data.size());
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    return chunk;
+}
+
+// Notes (and every third track some CC 7) from a seeded LCG. Notes starting
+// before `tweakBelow` get another velocity: an edit confined to that span.
+static vector<RawEvent> NoteTrack(uint32_t seed, uint8_t ch, bool withCC, int notes, uint32_t tweakBelow) {
+    uint32_t rng = seed * 2654435761u + 1;
+    auto next = [&]() { rng = rng * 1664525u + 1013904223u; return rng >> 8; };
+    vector<RawEvent> evs;
+    for (int i = 0; i < notes; ++i) {
+        const uint32_t t   = next() % kSpanTicks;
+        const uint32_t len = 1 + next() % 960;
+        const uint8_t  key = (uint8_t)(next() % 128);
+        uint8_t        vel = (uint8_t)(1 + next() % 127);
+        if (t < tweakBelow) vel = (uint8_t)(vel % 127 + 1);
+        evs.push_back({ t,       { (uint8_t)(0x90 | ch), key, vel } });
+        evs.push_back({ t + len, { (uint8_t)(0x80 | ch), key, 0 } });
+        if (withCC && i % 5 == 0) evs.push_back({ t, { (uint8_t)(0xB0 | ch), 7, (uint8_t)(next() % 128) } });
+    }
+    return evs;
+}
+
+// Chunk 0 holds the tempo map. `seeds[t]` picks the notes of chunk t, and
+// `tweaks[t]` (if given) its edited span.
+static void WriteSong(const string& path, const vector<uint32_t>& seeds, int notes = kNotesTrack,
+                      const vector<uint32_t>& tweaks = {}) {
+    vector<uint8_t> f;
+    Put32(f, 0x4D546864); Put32(f, 6); Put16(f, 1); Put16(f, (uint16_t)seeds.size()); Put16(f, 480);
+    auto tempo = TrackChunk({ { 0,    { 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20 } },
+                              { 9600, { 0xFF, 0x51, 0x03, 0x05, 0x16, 0x15 } } });
+    f.insert(f.end(), tempo.begin(), tempo.end());
+    for (size_t t = 1; t < seeds.size(); ++t) {
+        auto c = TrackChunk(NoteTrack(seeds[t], (uint8_t)(t % 16), t % 3 == 0, notes, t < tweaks.size() ? tweaks[t] : 0));
+        f.insert(f.end(), c.begin(), c.end());
+    }
+    FILE* fp = fopen(path.c_str(), "wb");
+    fwrite(f.data(), 1, f.size(), fp);
+    fclose(fp);
+}
+
+// ── Comparison ───────────────────────────────────────────────────────────────
+// The loader's sorts are not stable, so same-key runs are compared as sets.
+// CC lanes are compared through the polylines the roll draws.
+static constexpr uint32_t kLaneChunkTicks = 4096;
+
+struct Snapshot {
+    vector<MidiEvent>         events;
+    vector<vector<NoteEvent>> notes;
+    vector<uint32_t>          lanes;   // (tick, value) corners of every lane chunk, flattened
+    size_t                    laneSteps = 0;
+    uint64_t                  noteTotal = 0;
+};
+
+static void SortEvents(vector<MidiEvent>& v) {
+    sort(v.begin(), v.end(), [](const MidiEvent& a, const MidiEvent& b) {
+        return tie(a.tick, a.word) < tie(b.tick, b.word);
+    });
+}
+
+static vector<MidiEvent> Sorted(const FilteredStream& stream) {
+    vector<MidiEvent> v = stream.Events();
+    SortEvents(v);
+    return v;
+}
+
+static Snapshot Take(const vector<OptimizedTrackData>& tracks, CCLaneIndex& lanes, uint64_t total) {
+    Snapshot s;
+    s.events = GetGlobalMidiEvents();
+    SortEvents(s.events);
+    for (const auto& t : tracks) {
+        s.notes.emplace_back(t.notes.begin(), t.notes.end());
+        sort(s.notes.back().begin(), s.notes.back().end(), [](const NoteEvent& a, const NoteEvent& b) {
+            return memcmp(&a, &b, sizeof a) < 0;
+        });
+    }
+    for (int l = 0; l < CC_LANE_COUNT; ++l)
+        for (uint8_t ch = 0; ch < 16; ++ch)
+            for (uint64_t c = 0; c * kLaneChunkTicks < kSpanTicks + 2000; ++c)
+                for (const auto& p : lanes.ChunkPolyline((CCLane)l, ch, c, kLaneChunkTicks)) {
+                    s.lanes.push_back(p.tick);
+                    s.lanes.push_back(p.value);
+                }
+    s.laneSteps = lanes.EventCount();
+    s.noteTotal = total;
+    return s;
+}
+
+static bool SameEvents(const vector<MidiEvent>& a, const vector<MidiEvent>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].tick != b[i].tick || a[i].word != b[i].word) return false;
+    return true;
+}
+
+static bool Same(const Snapshot& a, const Snapshot& b) {
+    if (a.noteTotal != b.noteTotal || a.notes.size() != b.notes.size() ||
+        a.laneSteps != b.laneSteps || a.lanes != b.lanes) return false;
+    if (!SameEvents(a.events, b.events)) return false;
+    for (size_t t = 0; t < a.notes.size(); ++t) {
+        if (a.notes[t].size() != b.notes[t].size()) return false;
+        if (!a.notes[t].empty() && memcmp(a.notes[t].data(), b.notes[t].data(), a.notes[t].size() * sizeof(NoteEvent))) return false;
+    }
+    return true;
+}
+
+static double MsSince(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+}
+
+struct Song {
+    vector<OptimizedTrackData> tracks;
+    vector<CCEvent>            cc;
+    uint64_t                   noteTotal = 0;
+    double                     loadMs    = 0.0;
+    CCLaneIndex                lanes;
+};
+
+static Song Load(const string& path) {
+    Song s;
+    int ppq = 0, tempo = 0;
+    uint16_t num = 4, den = 4;
+    const auto t0 = chrono::steady_clock::now();
+    s.cc = loadStreamingMidiData(path, s.tracks, ppq, tempo, s.noteTotal, num, den);
+    s.loadMs = MsSince(t0);
+    s.lanes.Build(s.cc);
+    return s;
+}
+
+// Drops short and quiet notes, so the filtered stream differs from the source
+// and note-on / note-off pairing is part of what the splice must get right.
+// Pairing follows list order, so the reference is a compile of the spliced
+// list itself: a fresh load may order same-tick notes differently.
+static EventFilterConfig TestFilter() {
+    EventFilterConfig cfg;
+    cfg.velocityIgnore = 20;
+    cfg.minNoteTicks   = 120;
+    return cfg;
+}
+
+// The watch apply as the visualizer runs it: merged list, notes, CC lanes,
+// filtered stream.
+static double Apply(TrackReload& r, Song& s, EventFilterPipeline& filter) {
+    vector<CCEvent> cc;
+    const auto t0 = chrono::steady_clock::now();
+    ApplyTrackReload(r, s.tracks, s.noteTotal, cc);
+    if (r.ccTouched) s.lanes.Splice(r.editLo, r.editHi, cc);
+    filter.SpliceTracks(r.oldEvents, r.events, r.editLo, r.editHi);
+    return MsSince(t0);
+}
+
+static shared_ptr<const FilteredStream> Compile(EventFilterPipeline& filter) {
+    filter.SetSource(&GetGlobalMidiEvents(), 480, 500000);
+    filter.SetConfig(TestFilter());
+    return filter.Get();
+}
+
+int main() {
+    cout << "Watch Mode Test" << endl;
+    cout << "===============" << endl << endl;
+
+    const string path = (filesystem::temp_directory_path() / "jidi_watch_test.mid").string();
+    vector<uint32_t> seeds(kChunks);
+    for (int t = 0; t < kChunks; ++t) seeds[t] = (uint32_t)t;
+    WriteSong(path, seeds);
+
+    Song live = Load(path);
+    EventFilterPipeline liveFilter;
+    Compile(liveFilter);
+    cout << "Song: " << kChunks << " chunks, " << live.noteTotal << " notes, "
+         << GetGlobalMidiEvents().size() << " events, full load " << fixed << setprecision(2) << live.loadMs << " ms" << endl << endl;
+
+    bool ok = true;
+    // Edited chunks per round: plain, with CC, aliased pair (4 and 260), several at once
+    const vector<vector<int>> rounds = { { 5 }, { 9 }, { 260 }, { 4, 260 }, { 1, 2, 3, 150 } };
+    uint32_t nextSeed = 1000;
+    for (const auto& edit : rounds) {
+        for (int c : edit) seeds[c] = nextSeed++;
+        WriteSong(path, seeds);
+
+        TrackReload r;
+        PrepareTrackReload(path, r);
+        const double applyMs = Apply(r, live, liveFilter);
+        EventFilterPipeline recompiled;
+        const bool sameFilter = SameEvents(Sorted(*liveFilter.Get()), Sorted(*Compile(recompiled)));
+        const Snapshot spliced = Take(live.tracks, live.lanes, live.noteTotal);
+
+        // Also records the index the next round diffs against. The reload
+        // may reorder same-tick runs, so the live stream is compiled again.
+        Song fresh = Load(path);
+        Compile(liveFilter);
+        const bool same = r.result == TrackReload::Result::Tracks && sameFilter &&
+                          Same(spliced, Take(fresh.tracks, fresh.lanes, fresh.noteTotal));
+        cout << "  edit {";
+        for (size_t i = 0; i < edit.size(); ++i) cout << (i ? "," : "") << edit[i];
+        cout << "}: " << r.chunks.size() << " chunk(s) changed, " << r.tracks.size() << " track(s) reparsed ("
+             << r.bytesParsed / 1024 << " KB), prepare " << r.prepareMs << " ms + apply " << applyMs
+             << " ms vs full load " << fresh.loadMs << " ms  " << (same ? "OK" : "MISMATCH") << endl;
+        ok &= same;
+    }
+
+    // Nothing changed → Unchanged
+    {
+        TrackReload r;
+        PrepareTrackReload(path, r);
+        const bool pass = r.result == TrackReload::Result::Unchanged;
+        cout << "  same bytes: " << (pass ? "OK" : "FAILED") << endl;
+        ok &= pass;
+    }
+    // Tempo chunk edited, or a chunk added → full reload
+    {
+        vector<uint8_t> f(filesystem::file_size(path));
+        FILE* fp = fopen(path.c_str(), "rb");
+        fread(f.data(), 1, f.size(), fp);
+        fclose(fp);
+        f[14 + 8 + 5] ^= 1;   // low byte of the first tempo
+        fp = fopen(path.c_str(), "wb");
+        fwrite(f.data(), 1, f.size(), fp);
+        fclose(fp);
+        TrackReload r;
+        PrepareTrackReload(path, r);
+        const bool pass = r.result == TrackReload::Result::Full;
+        cout << "  tempo edited: " << (pass ? "full reload (" + r.why + ")" : "FAILED") << endl;
+        ok &= pass;
+
+        seeds.push_back(nextSeed++);
+        WriteSong(path, seeds);
+        TrackReload r2;
+        PrepareTrackReload(path, r2);
+        const bool pass2 = r2.result == TrackReload::Result::Full;
+        cout << "  chunk added: " << (pass2 ? "full reload (" + r2.why + ")" : "FAILED") << endl;
+        ok &= pass2;
+    }
+
+    filesystem::remove(path);
+
+    // Apply time follows the edit: each step re-velocities the notes of one
+    // chunk further in, so the changed tick window grows ~10x per step while
+    // the song stays the same. The small edits must not pay for the song.
+    {
+        constexpr int kBigChunks = 32, kBigNotes = 20000;
+        const string big = (filesystem::temp_directory_path() / "jidi_watch_scale.mid").string();
+        vector<uint32_t> bigSeeds(kBigChunks), tweaks(kBigChunks, 0);
+        for (int t = 0; t < kBigChunks; ++t) bigSeeds[t] = (uint32_t)t;
+        WriteSong(big, bigSeeds, kBigNotes);
+        Song song = Load(big);
+        EventFilterPipeline filter;
+        Compile(filter);
+        cout << endl << "Scaling: " << song.noteTotal << " notes, " << GetGlobalMidiEvents().size()
+             << " events, full load " << song.loadMs << " ms" << endl;
+
+        vector<double> applyMs;
+        bool pass = true;
+        for (uint32_t span : { kSpanTicks / 1000, kSpanTicks / 100, kSpanTicks / 10, kSpanTicks }) {
+            tweaks[3] = span;   // chunk 3 carries CC, so the lanes are spliced too
+            WriteSong(big, bigSeeds, kBigNotes, tweaks);
+            TrackReload r;
+            PrepareTrackReload(big, r);
+            pass &= r.result == TrackReload::Result::Tracks && r.editLo <= r.editHi;
+            applyMs.push_back(Apply(r, song, filter));
+            cout << "  edit ticks [" << r.editLo << ", " << r.editHi << "]: apply " << applyMs.back() << " ms" << endl;
+        }
+        EventFilterPipeline recompiled;
+        pass &= SameEvents(Sorted(*filter.Get()), Sorted(*Compile(recompiled)));
+        const Snapshot spliced = Take(song.tracks, song.lanes, song.noteTotal);
+        Song fresh = Load(big);
+        pass &= Same(spliced, Take(fresh.tracks, fresh.lanes, fresh.noteTotal));
+        // Generous: timings are noisy, the gap is not
+        pass &= applyMs.front() * 4.0 < applyMs.back();
+        cout << "  " << (pass ? "OK" : "FAILED") << endl;
+        ok &= pass;
+        filesystem::remove(big);
+    }
+
+    cout << endl << (ok ? "All tests passed!" : "FAILED") << endl;
+    return ok ? 0 : 1;
+}
@@ -64,6 +64,7 @@ target("jidi-player")
     -- NOTE: no top-level local helpers — after_build runs in a sandboxed scope
     -- and cannot see locals defined outside the target block.
     after_build(function(target)
+        if not target:is_plat("windows") then return end
         local out_dir  = target:targetdir()
         local bass_bin = "external/bass/bin/x64"
         for _, dll in ipairs({ "bass.dll", "bassmidi.dll" }) do
@@ -102,15 +103,24 @@ target("jidi-player")
     )
 
     -- ── Libraries ─────────────────────────────────────────────────────────────
-    add_links(
-        "OmniMIDI_Win64",          -- KDMAPI (original path; kept for fallback)
-        "bass",                    -- BASS audio engine
-        "bassmidi"                 -- BASS MIDI plugin
-    )
-    add_syslinks("winmm", "Psapi", "runtimeobject")
+    -- Elsewhere there is no KDMAPI / BASS / SMTC: bass_backend.cpp and
+    -- smtc_bridge.cpp build no-op stand-ins and the player runs with
+    -- --null-audio (the benchmark does), e.g. under xvfb-run on Linux.
+    if is_plat("windows") then
+        add_links(
+            "OmniMIDI_Win64",          -- KDMAPI (original path; kept for fallback)
+            "bass",                    -- BASS audio engine
+            "bassmidi"                 -- BASS MIDI plugin
+        )
+        add_syslinks("winmm", "Psapi", "runtimeobject")
+    else
+        add_syslinks("pthread")
+    end
 
     -- ── Compiler flags ────────────────────────────────────────────────────────
-    add_cxxflags("/EHsc", { force = true })
+    if is_plat("windows") then
+        add_cxxflags("/EHsc", { force = true })
+    end
     set_optimize("fastest")
 
 -- ── MIDI core player target ───────────────────────────────────────────────────
@@ -155,6 +165,51 @@ target("track-test")
     add_includedirs("header")
     set_optimize("fastest")
 
+-- ── Sharded synthesis test (built-in synth, no BASS) ──────────────────────────
+target("shard-test")
+    set_kind("binary")
+    set_languages("c++23")
+    add_files("src/Test/shard_test.cpp", "src/Mains/soft_synth.cpp", "src/Mains/synth_shard.cpp")
+    add_includedirs("header")
+    set_optimize("fastest")
+
+-- ── Pre-render seek test (built-in synth snapshots, no BASS) ──────────────────
+target("prerender-test")
+    set_kind("binary")
+    set_languages("c++23")
+    add_files("src/Test/prerender_test.cpp", "src/Mains/soft_synth.cpp", "src/Mains/soft_prerender.cpp",
+              "src/Mains/event_filter.cpp")
+    add_includedirs("header")
+    set_optimize("fastest")
+
+-- ── Emulated sink benchmark (overflow policies, virtual time, no audio) ──────
+target("sink-bench")
+    set_kind("binary")
+    set_languages("c++23")
+    add_files("src/Test/sink_bench.cpp", "src/Mains/emulated_sink.cpp")
+    add_includedirs("header")
+    set_optimize("fastest")
+
+-- ── Watch mode test (track-level reparse vs full load) ────────────────────────
+target("watch-test")
+    set_kind("binary")
+    set_languages("c++23")
+    add_files("src/Test/watch_test.cpp", "src/Mains/load.cpp", "src/Mains/midi_watch.cpp", "src/Mains/load_telemetry.cpp",
+              "src/Mains/event_filter.cpp", "src/Mains/cc_lanes.cpp")
+    add_includedirs("header")
+    set_optimize("fastest")
+
+-- ── Chunk painter golden test (pixel hashes + paint time per case) ────────────
+target("painter-test")
+    set_kind("binary")
+    set_languages("c++23")
+    add_files("src/Test/painter_test.cpp", "src/Mains/chunk_painter.cpp", "src/Mains/track_masks.cpp",
+              "src/Mains/note_time_columns.cpp", "src/Mains/load.cpp", "src/Mains/midi_watch.cpp",
+              "src/Mains/load_telemetry.cpp")
+    add_includedirs("header")
+    set_rundir("$(projectdir)")   -- goldens: src/Test/golden/chunk_painter.txt
+    set_optimize("fastest")
+
 --
 -- If you want to known more usage about xmake, please see https://xmake.io
 --
\ No newline at end of file